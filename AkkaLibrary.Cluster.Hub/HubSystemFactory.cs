@@ -6,6 +6,7 @@ using Akka.Cluster.Routing;
 using Akka.Cluster.Tools.Client;
 using Akka.Cluster.Tools.Singleton;
 using Akka.Configuration;
+using AkkaLibrary.Common.Serialization;
 using Serilog;
 
 namespace AkkaLibrary.Cluster.Hub
@@ -77,7 +78,8 @@ namespace AkkaLibrary.Cluster.Hub
                 string.Format("akka.remote.dot-netty.tcp.public-hostname = {0}, akka.remote.dot-netty.tcp.port = {1}", hostname, port)
                 )
                 .WithFallback(ConfigurationFactory.ParseString(injectedClusterConfigString))
-                .WithFallback(clusterConfig);
+                .WithFallback(clusterConfig)
+                .WithFallback(SampleSerializer.Configuration);
 
             // Create the actor system
             var system = ActorSystem.Create(systemName, finalConfig);
@@ -9,6 +9,7 @@ using AkkaLibrary.Cluster.Actors;
 using AkkaLibrary.Cluster.Configuration;
 using AkkaLibrary.Common.Configuration;
 using AkkaLibrary.Common.Logging;
+using AkkaLibrary.Common.Metrics;
 using AkkaLibrary.Common.Utilities;
 using Serilog;
 using Serilog.Sinks.Elasticsearch;
@@ -79,6 +80,10 @@ namespace AkkaLibrary.Cluster.Worker
             var system = ActorSystem.Create(systemName, cfg);
             var configurator = system.ActorOf(Props.Create(() => new NodeConfigurator()), "configurator");
 
+            // Publishes the load of this worker for plugin placement
+            var mediator = DistributedPubSub.Get(system).Mediator;
+            var loadReporter = system.ActorOf(Props.Create(() => new NodeLoadReporter(mediator, MetricsRegistry.Default)), "load-reporter");
+
             Console.CancelKeyPress += async (sender, eventArgs) =>
             {
                 Console.WriteLine("Stopping Cluster Worker...");
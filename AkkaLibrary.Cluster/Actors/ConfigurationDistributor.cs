@@ -4,23 +4,64 @@ using System.Linq;
 using Akka.Actor;
 using Akka.Event;
 using Akka.Logger.Serilog;
+using AkkaLibrary.Cluster.Configuration;
 using AkkaLibrary.Common.Interfaces;
 using AkkaLibrary.Common.Logging;
 using AkkaLibrary.Common.Utilities;
 
 namespace AkkaLibrary.Cluster.Actors
 {
+    /// <summary>
+    /// Distributes role configurations to the configurators of registered nodes
+    ///
+    /// Configurations are packaged once per change as a hashed, versioned
+    /// <see cref="ConfigurationPackage"/>. Each node is offered only the hash
+    /// of each of its roles and replies with the hash it has applied for each
+    /// role, so the payload travels only to nodes that are not on it. Offers
+    /// to all nodes go out at once, and every node has its own transfer that
+    /// is retried on timeout until its retry budget is spent. The manager is told as each node is configured or given up on.
+    /// A single node can also be sent a configuration of its own with
+    /// <see cref="ConfigureNode"/>, as placement does. The manager is told at
+    /// once when the node already holds it.
+    /// </summary>
     public class ConfigurationDistributor : ReceiveActor
     {
         private readonly ILoggingAdapter _logger;
         private readonly IActorRef _manager;
+        private readonly int _retryBudget;
+        private readonly TimeSpan _retryTimeout;
+        private readonly int _compressionThreshold;
         private Dictionary<string, HashSet<string>> _nodeRoles = new Dictionary<string, HashSet<string>>();
         private Dictionary<string, HashSet<string>> _roleNodes = new Dictionary<string, HashSet<string>>();
         private Dictionary<string, IActorRef> _nodeRefs = new Dictionary<string, IActorRef>();
+        private Dictionary<string, Address> _nodeAddresses = new Dictionary<string, Address>();
 
-        public ConfigurationDistributor(IActorRef manager)
+        /// <summary>
+        /// Key under which a configuration sent to a single node is applied, alongside its roles
+        /// </summary>
+        public const string NodeKey = "$node";
+
+        // Current package of each role and the id of its configuration, the
+        // hash each node reported applying for each key, and the transfers
+        // under way to each node by key
+        private Dictionary<string, ConfigurationPackage> _rolePackages = new Dictionary<string, ConfigurationPackage>();
+        private Dictionary<string, Guid> _roleConfigurationIds = new Dictionary<string, Guid>();
+        private Dictionary<string, Dictionary<string, string>> _nodeApplied = new Dictionary<string, Dictionary<string, string>>();
+        private Dictionary<string, Dictionary<string, Transfer>> _transfers = new Dictionary<string, Dictionary<string, Transfer>>();
+        private long _version;
+
+        public ConfigurationDistributor(IActorRef manager) : this(manager, 3, TimeSpan.FromSeconds(5), 4096) { }
+
+        /// <param name="manager">Told of every node configured or given up on</param>
+        /// <param name="retryBudget">Times a configuration is sent again to a node that did not reply in time</param>
+        /// <param name="retryTimeout">Time to wait for a node to reply before sending again</param>
+        /// <param name="compressionThreshold">Serialized length above which payloads are compressed</param>
+        public ConfigurationDistributor(IActorRef manager, int retryBudget, TimeSpan retryTimeout, int compressionThreshold)
         {
             _manager = manager;
+            _retryBudget = retryBudget;
+            _retryTimeout = retryTimeout;
+            _compressionThreshold = compressionThreshold;
             _logger = Context.WithIdentity(GetType().Name);
             
             Receive<RegisterNode>(msg =>
@@ -35,6 +76,7 @@ namespace AkkaLibrary.Cluster.Actors
                     }
                     _logger.Info("Node:{ActorPath} with roles:{ClusterRoles} has been registered.", path, msg.Roles);
                     _nodeRoles.Add(path, msg.Roles.ToHashSet());
+                    _nodeAddresses[path] = msg.Address;
 
                     foreach (var role in msg.Roles)
                     {
@@ -47,6 +89,12 @@ namespace AkkaLibrary.Cluster.Actors
                             _roleNodes[role] = new HashSet<string> { path };
                         }
                     }
+
+                    // Bring the new node up to date with its roles
+                    foreach (var role in msg.Roles.Where(_rolePackages.ContainsKey))
+                    {
+                        Distribute(path, role, _rolePackages[role], _roleConfigurationIds[role]);
+                    }
                 }
                 else
                 {
@@ -61,6 +109,10 @@ namespace AkkaLibrary.Cluster.Actors
                 {
                     _logger.Info("Node:{ActorPath} with roles :{ClusterRoles} has been un-registered.", path, _nodeRoles[path].ToArray());
                     _nodeRoles.Remove(path);
+                    _nodeRefs.Remove(path);
+                    _nodeAddresses.Remove(path);
+                    _nodeApplied.Remove(path);
+                    _transfers.Remove(path);
 
                     foreach (var nameSets in _roleNodes.Values)
                     {
@@ -88,6 +140,7 @@ namespace AkkaLibrary.Cluster.Actors
                     }
                     _logger.Info("Node:{ActorPath} has been updated with roles:{ClusterRoles}.", path, msg.Roles);
                     _nodeRoles.Add(path, msg.Roles.ToHashSet());
+                    _nodeAddresses[path] = msg.Address;
 
                     foreach (var nameSets in _roleNodes.Where(x => !msg.Roles.Contains(x.Key)).Select(x => x.Value))
                     {
@@ -105,40 +158,198 @@ namespace AkkaLibrary.Cluster.Actors
 
             Receive<ConfigureRole>(msg =>
             {
-                _logger.Error("Role was null in Configure Role Message. Roles:{ClusterRoles}", msg.Roles);
+                if (msg.Roles.Any(x => x == null))
+                {
+                    _logger.Error("Role was null in Configure Role Message. Roles:{ClusterRoles}", msg.Roles);
+                }
 
                 // Get all distinct nodes that need configuring - i.e. don't configure twice unnecessarily
                 var nonNullRoles = msg.Roles.Where(x => x != null).ToHashSet();
 
-                var nodes = _nodeRoles.Where(kvp => kvp.Value.Intersect(nonNullRoles).Any()).Select(kvp => kvp.Key);
+                var package = ConfigurationPackage.Create(msg.RoleConfiguration, Context.System.Serialization, _version + 1, _compressionThreshold);
+                var current = _rolePackages.Values.FirstOrDefault(x => x.Hash == package.Hash);
+                if (current != null)
+                {
+                    package = current;
+                }
+                else
+                {
+                    _version++;
+                }
 
-                foreach (var node in nodes)
+                foreach (var role in nonNullRoles)
                 {
-                    // Get the actor selection for the given node.
-                    var selection = Context.ActorSelection(node);
+                    _rolePackages[role] = package;
+                    _roleConfigurationIds[role] = msg.RoleConfiguration.Id;
+                }
 
-                    // Check it exists by touching it. This also gives the actor ref which is preferred.
-                    try
+                var nodes = _nodeRoles.Where(kvp => kvp.Value.Intersect(nonNullRoles).Any()).Select(kvp => kvp.Key).ToList();
+                var stale = 0;
+                foreach (var node in nodes)
+                {
+                    var offered = false;
+                    foreach (var role in _nodeRoles[node].Intersect(nonNullRoles))
                     {
-                        selection.Tell(msg.RoleConfiguration);
+                        if (Distribute(node, role, package, msg.RoleConfiguration.Id))
+                        {
+                            offered = true;
+                        }
+                        else if (Holds(node, role, package.Hash))
+                        {
+                            _manager.Tell(new NodeConfigured(_nodeAddresses[node], package.Hash, package.Version, msg.RoleConfiguration.Id));
+                        }
                     }
-                    catch (Exception ex)
+
+                    if (offered)
                     {
-                        _logger.Error(ex, "Could not touch Configurator actor at {ActorPath}.", node);
-                        continue;
+                        stale++;
                     }
                 }
+
+                _logger.Info("Configuration {ConfigurationPackage} of {Bytes} bytes for roles:{ClusterRoles} offered to {StaleCount} of {NodeCount} nodes.", package, package.Payload.Length, nonNullRoles.ToArray(), stale, nodes.Count);
+            });
+
+            Receive<ConfigureNode>(msg =>
+            {
+                var node = CreateConfiguratorPath(msg.Address);
+                if (!_nodeRoles.ContainsKey(node))
+                {
+                    _logger.Warning("Configuration for unregistered node:{ActorPath} dropped.", node);
+                    return;
+                }
+
+                var package = ConfigurationPackage.Create(msg.Configuration, Context.System.Serialization, ++_version, _compressionThreshold);
+                var stale = Distribute(node, NodeKey, package, msg.Configuration.Id);
+                if (!stale && Holds(node, NodeKey, package.Hash))
+                {
+                    _manager.Tell(new NodeConfigured(msg.Address, package.Hash, package.Version, msg.Configuration.Id));
+                }
+
+                _logger.Info("Configuration {ConfigurationPackage} of {Bytes} bytes for node:{ActorPath} offered:{Offered}.", package, package.Payload.Length, node, stale);
+            });
+
+            Receive<ConfigurationReport>(msg =>
+            {
+                var node = CreateConfiguratorPath(Sender.Path.Address);
+                if (!_nodeRoles.ContainsKey(node))
+                {
+                    return;
+                }
+
+                _nodeRefs[node] = Sender;
+                _nodeApplied[node] = new Dictionary<string, string>(msg.Applied);
+
+                if (!_transfers.TryGetValue(node, out var transfers)
+                    || !transfers.TryGetValue(msg.Key, out var transfer)
+                    || transfer.Package.Hash != msg.Hash)
+                {
+                    return;
+                }
+
+                if (msg.Applied.TryGetValue(msg.Key, out var applied) && applied == msg.Hash)
+                {
+                    transfers.Remove(msg.Key);
+                    _logger.Info("Node:{ActorPath} holds configuration {ConfigurationPackage} after {Attempts} sends.", node, transfer.Package, transfer.Attempts);
+                    _manager.Tell(new NodeConfigured(Sender.Path.Address, transfer.Package.Hash, transfer.Package.Version, transfer.ConfigurationId));
+                }
+                else if (!transfer.PayloadRequested)
+                {
+                    transfer.PayloadRequested = true;
+                    Send(node, transfer);
+                }
+            });
+
+            Receive<TransferTimeout>(msg =>
+            {
+                if (!_transfers.TryGetValue(msg.Node, out var transfers)
+                    || !transfers.TryGetValue(msg.Key, out var transfer)
+                    || transfer.Package.Hash != msg.Hash
+                    || transfer.Attempts != msg.Attempt)
+                {
+                    // Completed or sent again since
+                    return;
+                }
+
+                if (transfer.Retries >= _retryBudget)
+                {
+                    transfers.Remove(msg.Key);
+                    _logger.Error("Node:{ActorPath} did not take configuration {ConfigurationPackage} after {Attempts} sends.", msg.Node, transfer.Package, transfer.Attempts);
+                    _manager.Tell(new NodeConfigurationFailed(transfer.Address, transfer.Package.Hash, transfer.Package.Version, transfer.ConfigurationId));
+                    return;
+                }
+
+                // The cached reference may be stale, so resolve the node again
+                _nodeRefs.Remove(msg.Node);
+                transfer.Retries++;
+                Send(msg.Node, transfer);
             });
 
             Receive<IConfirmation<IRoleConfiguration>>(msg =>
             {
-                if(_nodeRoles.ContainsKey(Sender.Path.ToStringWithAddress()))
+                var node = CreateConfiguratorPath(Sender.Path.Address);
+                if(_nodeRoles.ContainsKey(node))
                 {
-                    _nodeRefs[Sender.Path.ToStringWithAddress()] = Sender;
+                    _nodeRefs[node] = Sender;
                 }
             });
         }
 
+        /// <summary>
+        /// Starts a transfer of the package to a node under a role or <see cref="NodeKey"/>,
+        /// unless the node has it applied under that key or the transfer is already under way.
+        /// A transfer replaces any earlier one under the same key, and one already
+        /// under way is reported under the latest configuration id. Returns true if
+        /// a transfer was started.
+        /// </summary>
+        private bool Distribute(string node, string key, ConfigurationPackage package, Guid configurationId)
+        {
+            if (Holds(node, key, package.Hash))
+            {
+                return false;
+            }
+
+            if (!_transfers.TryGetValue(node, out var transfers))
+            {
+                _transfers[node] = transfers = new Dictionary<string, Transfer>();
+            }
+            if (transfers.TryGetValue(key, out var current) && current.Package.Hash == package.Hash)
+            {
+                current.ConfigurationId = configurationId;
+                return false;
+            }
+
+            var transfer = new Transfer(_nodeAddresses[node], key, package, configurationId);
+            transfers[key] = transfer;
+            Send(node, transfer);
+            return true;
+        }
+
+        private bool Holds(string node, string key, string hash)
+            => _nodeApplied.TryGetValue(node, out var applied) && applied.TryGetValue(key, out var current) && current == hash;
+
+        /// <summary>
+        /// Sends the offer or, once the node has asked for it, the payload and
+        /// schedules the retry
+        /// </summary>
+        private void Send(string node, Transfer transfer)
+        {
+            object message = transfer.PayloadRequested
+                ? (object)new ConfigurationPayload(transfer.Key, transfer.Package)
+                : new OfferConfiguration(transfer.Key, transfer.Package.Hash, transfer.Package.Version);
+
+            if (_nodeRefs.TryGetValue(node, out var nodeRef))
+            {
+                nodeRef.Tell(message);
+            }
+            else
+            {
+                Context.ActorSelection(node).Tell(message);
+            }
+
+            transfer.Attempts++;
+            Context.System.Scheduler.ScheduleTellOnce(_retryTimeout, Self, new TransferTimeout(node, transfer.Key, transfer.Package.Hash, transfer.Attempts), Self);
+        }
+
         private string CreateConfiguratorPath(Address nodeAddress)
         {
             return $"{nodeAddress}/*/configurator";
@@ -261,5 +472,181 @@ namespace AkkaLibrary.Cluster.Actors
 
             public IRoleConfiguration RoleConfiguration { get; }
         }
+
+        /// <summary>
+        /// Applies a configuration to a single registered node, replacing the
+        /// previous configuration sent to that node
+        /// </summary>
+        public sealed class ConfigureNode
+        {
+            public ConfigureNode(Address address, IRoleConfiguration configuration)
+            {
+                Address = address;
+                Configuration = configuration;
+            }
+
+            public Address Address { get; }
+
+            public IRoleConfiguration Configuration { get; }
+        }
+
+        /// <summary>
+        /// Offers a node a configuration by hash for one of its roles or for
+        /// <see cref="NodeKey"/>. The node replies with a <see cref="ConfigurationReport"/>.
+        /// </summary>
+        public sealed class OfferConfiguration
+        {
+            public OfferConfiguration(string key, string hash, long version)
+            {
+                Key = key;
+                Hash = hash;
+                Version = version;
+            }
+
+            public string Key { get; }
+
+            public string Hash { get; }
+
+            public long Version { get; }
+        }
+
+        /// <summary>
+        /// A configuration sent to a node that reported it has not applied it under the key
+        /// </summary>
+        public sealed class ConfigurationPayload
+        {
+            public ConfigurationPayload(string key, ConfigurationPackage package)
+            {
+                Key = key;
+                Package = package;
+            }
+
+            public string Key { get; }
+
+            public ConfigurationPackage Package { get; }
+        }
+
+        /// <summary>
+        /// A node's reply to an offer or payload, giving the hash it currently
+        /// has applied under each key
+        /// </summary>
+        public sealed class ConfigurationReport
+        {
+            public ConfigurationReport(string key, string hash, IDictionary<string, string> applied)
+            {
+                Key = key;
+                Hash = hash;
+                Applied = new Dictionary<string, string>(applied);
+            }
+
+            /// <summary>
+            /// Key and hash of the offer or payload replied to
+            /// </summary>
+            public string Key { get; }
+
+            public string Hash { get; }
+
+            public IReadOnlyDictionary<string, string> Applied { get; }
+        }
+
+        /// <summary>
+        /// Sent to the manager when a node holds a configuration
+        /// </summary>
+        public sealed class NodeConfigured
+        {
+            public NodeConfigured(Address address, string hash, long version, Guid configurationId)
+            {
+                Address = address;
+                Hash = hash;
+                Version = version;
+                ConfigurationId = configurationId;
+            }
+
+            public Address Address { get; }
+
+            public string Hash { get; }
+
+            public long Version { get; }
+
+            /// <summary>
+            /// Id of the latest <see cref="IRoleConfiguration"/> with this content sent to the node
+            /// </summary>
+            public Guid ConfigurationId { get; }
+        }
+
+        /// <summary>
+        /// Sent to the manager when a node spent its retry budget without taking a configuration
+        /// </summary>
+        public sealed class NodeConfigurationFailed
+        {
+            public NodeConfigurationFailed(Address address, string hash, long version, Guid configurationId)
+            {
+                Address = address;
+                Hash = hash;
+                Version = version;
+                ConfigurationId = configurationId;
+            }
+
+            public Address Address { get; }
+
+            public string Hash { get; }
+
+            public long Version { get; }
+
+            /// <summary>
+            /// Id of the latest <see cref="IRoleConfiguration"/> with this content sent to the node
+            /// </summary>
+            public Guid ConfigurationId { get; }
+        }
+
+        private sealed class TransferTimeout
+        {
+            public TransferTimeout(string node, string key, string hash, int attempt)
+            {
+                Node = node;
+                Key = key;
+                Hash = hash;
+                Attempt = attempt;
+            }
+
+            public string Node { get; }
+
+            public string Key { get; }
+
+            public string Hash { get; }
+
+            public int Attempt { get; }
+        }
+
+        /// <summary>
+        /// Progress of one configuration to one node
+        /// </summary>
+        private sealed class Transfer
+        {
+            public Transfer(Address address, string key, ConfigurationPackage package, Guid configurationId)
+            {
+                Address = address;
+                Key = key;
+                Package = package;
+                ConfigurationId = configurationId;
+            }
+
+            public Address Address { get; }
+
+            public string Key { get; }
+
+            public ConfigurationPackage Package { get; }
+
+            public Guid ConfigurationId { get; set; }
+
+            public bool PayloadRequested { get; set; }
+
+            /// <summary>
+            /// Messages sent, used to tell current timeouts from stale ones
+            /// </summary>
+            public int Attempts { get; set; }
+
+            public int Retries { get; set; }
+        }
     }
 }
\ No newline at end of file
@@ -6,33 +6,72 @@ using Akka;
 using Akka.Actor;
 using Akka.Cluster;
 using Akka.Event;
+using AkkaLibrary.Cluster.Gossip;
 using AkkaLibrary.Common.Logging;
-using AkkaLibrary.Common.Utilities;
+using AkkaLibrary.Common.Metrics;
 
 namespace AkkaLibrary.Cluster.Actors
 {
     /// <summary>
-    /// Gossip actor started on all nodes that transmits a state object to other
-    /// gossip actors in a pair-wise fashion
+    /// Gossip actor started on all nodes that replicates keyed state to the
+    /// gossip actors of the other nodes by delta-based anti-entropy
+    ///
+    /// Each round the actor opens an exchange with a few random peers by
+    /// sending the one-number summary of its <see cref="GossipStore{TKey, TValue}"/>.
+    /// A peer with the same summary ends the exchange there. Otherwise the
+    /// peer answers with its per-key digests, the opener sends the entries
+    /// the peer is missing together with the keys it is missing itself, and
+    /// the peer answers with those entries. Only keys that differ are sent.
+    ///
+    /// Peers are resolved to <see cref="IActorRef"/>s once and cached until
+    /// they leave the cluster. When a registry is given, rounds, messages and
+    /// entries sent are counted under "Gossip.{name}". Counting the serialized
+    /// size of every message serializes it a second time, so BytesSent is
+    /// only counted when asked for.
     /// </summary>
-    public class GossipActor<TState> : ReceiveActor
+    public class GossipActor<TKey, TValue> : ReceiveActor
     {
         private readonly ILoggingAdapter _logger;
         private readonly string _name;
         private readonly IActorRef _manager;
-        private readonly Func<TState, TState, TState> _stateUpdater;
-        private TState _gossipState;
+        private readonly GossipStore<TKey, TValue> _store;
+        private readonly int _fanOut;
         private readonly Akka.Cluster.Cluster _cluster = Akka.Cluster.Cluster.Get(Context.System);
-        private readonly HashSet<ActorPath> _currentNodes = new HashSet<ActorPath>();
-        private HashSet<ActorPath> _actorsToTell = new HashSet<ActorPath>();
-        private HashSet<ActorPath> _actorsTold = new HashSet<ActorPath>();
-
-        public GossipActor(string name, IActorRef manager, Func<TState, TState, TState> stateUpdater)
+        private readonly HashSet<Address> _members = new HashSet<Address>();
+        private readonly Dictionary<Address, IActorRef> _peers = new Dictionary<Address, IActorRef>();
+        private readonly Random _random = new Random();
+        private readonly ICancelable _gossipTask;
+
+        private readonly Counter _rounds;
+        private readonly Counter _messagesSent;
+        private readonly Counter _entriesSent;
+        private readonly Counter _bytesSent;
+
+        /// <param name="name">Name of the gossiped state, used for metrics</param>
+        /// <param name="manager">Told of every key changed by gossip. May be <see cref="ActorRefs.Nobody"/>.</param>
+        /// <param name="merge">Combines concurrent values of a key. Must be commutative.</param>
+        /// <param name="fanOut">Number of peers gossiped with each round</param>
+        /// <param name="interval">Time between rounds. Defaults to five seconds.</param>
+        /// <param name="registry">Registry to count gossip traffic in. Null disables the counts.</param>
+        /// <param name="countBytes">Also count the serialized size of every message sent. Meant for test harnesses.</param>
+        public GossipActor(string name, IActorRef manager, Func<TValue, TValue, TValue> merge, int fanOut = 3, TimeSpan? interval = null, MetricsRegistry registry = null, bool countBytes = false)
         {
             _name = "GossipActor_" + _cluster.SelfAddress;
             _logger = Context.WithIdentity(_name);
             _manager = manager;
-            _stateUpdater = stateUpdater;
+            _fanOut = fanOut;
+            _store = new GossipStore<TKey, TValue>($"{_cluster.SelfAddress}#{_cluster.SelfUniqueAddress.Uid}", merge);
+
+            if (registry != null)
+            {
+                _rounds = registry.Counter($"Gossip.{name}.Rounds");
+                _messagesSent = registry.Counter($"Gossip.{name}.MessagesSent");
+                _entriesSent = registry.Counter($"Gossip.{name}.EntriesSent");
+                if (countBytes)
+                {
+                    _bytesSent = registry.Counter($"Gossip.{name}.BytesSent");
+                }
+            }
 
             Receive<ClusterEvent.IMemberEvent>(msg =>
             {
@@ -49,41 +88,40 @@ namespace AkkaLibrary.Cluster.Actors
                 _logger.Debug("Cluster Domain Event:{ClusterEvent} received.", msg);
             });
 
-            Receive<InitiateStateUpdate>(msg =>
+            Receive<ActorIdentity>(msg =>
             {
-                if (_gossipState != null)
+                var address = msg.MessageId as Address;
+                if (msg.Subject != null && address != null && _members.Contains(address))
                 {
-                    SendStateUpdate();
+                    _peers[address] = msg.Subject;
+                    Context.Watch(msg.Subject);
                 }
             });
-            Receive<NewState>(msg => 
+
+            Receive<Terminated>(msg =>
             {
-                _gossipState = msg.State;
-                // Reset the hash set
-                _actorsTold = new HashSet<ActorPath>();
+                _peers.Remove(msg.ActorRef.Path.Address);
             });
-            Receive<StateUpdate>(msg => ReplyToGossip(msg));
-            Receive<StateUpdateReply>(msg => HandleGossipReply(msg));
-            Receive<StateRequest>(msg => Sender.Tell(new StateRequestResponse(_name, Self, _currentNodes, _gossipState)));
 
-            // Get a snapshot of the cluster system and add all nodes to the _currentNodes set
-            foreach (var item in _cluster.State.Members.Select(x => CreateFormedPath(x)))
+            Receive<InitiateStateUpdate>(msg => SendStateUpdate());
+            Receive<Update>(msg => _store.Set(msg.Key, msg.Value));
+            Receive<Status>(msg => ReplyToStatus(msg));
+            Receive<Digest>(msg => ReplyToDigest(msg));
+            Receive<Delta>(msg => HandleDelta(msg));
+            Receive<StateRequest>(msg => Sender.Tell(new StateRequestResponse(_name, Self, _members.Select(CreateFormedPath), _store.Values(), _store.Summary)));
+
+            // Get a snapshot of the cluster system and add all other nodes
+            foreach (var member in _cluster.State.Members.Where(x => x.Address != _cluster.SelfAddress))
             {
-                _currentNodes.Add(item);
+                _members.Add(member.Address);
             }
-
-            // Initialise gossip
-            // Create the set of actors to tell from the snapshot of the system
-            _actorsToTell = new HashSet<ActorPath>(_currentNodes);
-            _logger.Debug("{Name} knows {Number} actors to tell. {ActorsToTell}", _name, _actorsToTell.Count, _actorsToTell.Select(x => x.Address).ToArray());
-            
-            // Set told actors to empty
-            _actorsTold = new HashSet<ActorPath>();
+            _logger.Debug("{Name} knows {Number} members to gossip with.", _name, _members.Count);
 
             //Start gossiping at periodic intervals
-            Context.System.Scheduler.ScheduleTellRepeatedlyCancelable(
-                TimeSpan.Zero,
-                TimeSpan.FromSeconds(5),
+            var period = interval ?? TimeSpan.FromSeconds(5);
+            _gossipTask = Context.System.Scheduler.ScheduleTellRepeatedlyCancelable(
+                period,
+                period,
                 Self,
                 new InitiateStateUpdate(),
                 Self
@@ -91,108 +129,126 @@ namespace AkkaLibrary.Cluster.Actors
         }
 
         /// <summary>
-        /// Receives the reply from a partner gossip actor and updates
-        /// the current state accordingly
+        /// Opens an exchange with a bounded random set of peers and
+        /// identifies members not yet resolved
         /// </summary>
-        /// <param name="msg"></param>
-        private void HandleGossipReply(StateUpdateReply msg)
+        private void SendStateUpdate()
         {
-            // Update items.
-            UpdateCurrentState(msg);
+            foreach (var address in _members.Where(x => !_peers.ContainsKey(x)))
+            {
+                Context.ActorSelection(CreateFormedPath(address)).Tell(new Identify(address));
+            }
+
+            if (_peers.Count == 0)
+            {
+                return;
+            }
+
+            _logger.Debug("{Name} is sending new gossip message", _name);
+            _rounds?.Increment();
+
+            var status = new Status(_store.Summary);
+            foreach (var peer in SelectPeers())
+            {
+                Send(peer, status, 0);
+            }
         }
 
         /// <summary>
-        /// Uses the snapshot of current nodes to start gossiping with 
+        /// Partial Fisher-Yates shuffle of the cached peers
         /// </summary>
-        private void SendStateUpdate()
+        private IEnumerable<IActorRef> SelectPeers()
         {
-            _logger.Debug("{Name} is sending new gossip message", _name);
-
-            // If there are actors still to tell..
-            if (_actorsToTell.Any())
+            var peers = _peers.Values.ToArray();
+            var count = Math.Min(_fanOut, peers.Length);
+            for (int i = 0; i < count; i++)
             {
-                // Randomly select an actor to tell...
-                // ...and remove it from the set and add it to "told"
-                _actorsToTell = _actorsToTell.RemoveAtRandom(out ActorPath actor);
-                _actorsTold.Add(actor);
+                var j = _random.Next(i, peers.Length);
+                var peer = peers[j];
+                peers[j] = peers[i];
+                yield return peer;
             }
+        }
 
-            // Create status update
-            var data = new StateUpdate(_currentNodes, _gossipState);
-            // Send the message to all told actors
-            foreach (var item in _actorsTold)
+        /// <summary>
+        /// Answers a status with this store's digests unless the stores already agree
+        /// </summary>
+        private void ReplyToStatus(Status msg)
+        {
+            if (msg.Summary != _store.Summary)
             {
-                Context.ActorSelection(item).Tell(data);
+                Send(Sender, new Digest(_store.Digests()), 0);
             }
         }
 
         /// <summary>
-        /// Upon receipt of a StateUpdate, send a reply containing internal state
-        /// then update internal state with received state
+        /// Sends the peer the entries it lacks and asks for the ones this store lacks
         /// </summary>
-        /// <param name="msg"></param>
-        private void ReplyToGossip(StateUpdate msg)
+        private void ReplyToDigest(Digest msg)
         {
-            _logger.Debug("{Name} is sending new gossip reply", _name);
-            _logger.Debug("Data:{Data} from:{Sender} on {Self}", msg.State, Sender.Path, Self.Path);
-            // Send current state
-            Sender.Tell(new StateUpdateReply(msg, _currentNodes, _gossipState));
-            // Update internal state
-            UpdateCurrentState(msg);
+            _store.Compare(msg.Digests, out var send, out var request);
+            if (send.Count > 0 || request.Count > 0)
+            {
+                Send(Sender, new Delta(_store.Entries(send), request), send.Count);
+            }
         }
 
         /// <summary>
-        /// Compare the received state and the current state and update the internal state
-        /// with the union of the two.
-        /// 
-        /// Update the known other nodes list with those in the state message
+        /// Merges the received entries then sends any entries that were requested
         /// </summary>
-        /// <param name="data"></param>
-        private void UpdateCurrentState(IState data)
+        private void HandleDelta(Delta msg)
         {
-            _logger.Debug("Previous state:{PreviousState} and new state:{NewState}", _gossipState, data.State);
-
-            _gossipState = _stateUpdater(_gossipState, data.State);
+            var changed = _store.Merge(msg.Entries);
+            if (changed.Count > 0)
+            {
+                _logger.Debug("{Name} merged {Count} changed keys. Store now holds {Total}.", _name, changed.Count, _store.Count);
+                foreach (var key in changed)
+                {
+                    _store.TryGetValue(key, out var value);
+                    _manager.Tell(new Changed(key, value));
+                }
+            }
 
-            // Update the current nodes with any that are unknown
-            _currentNodes.UnionWith(data.Nodes);
-            _logger.Debug("{Name} knows about:{NumberNodes}", _name, _currentNodes.Count);
+            if (msg.Requested.Count > 0)
+            {
+                var entries = _store.Entries(msg.Requested);
+                Send(Sender, new Delta(entries, Enumerable.Empty<TKey>()), entries.Count);
+            }
+        }
 
-            // Find the actors that have not been told
-            var prevCount = _actorsToTell.Count;
-            _actorsToTell = _currentNodes.Except(_actorsTold).ToHashSet();
-            if (prevCount != _actorsToTell.Count)
+        private void Send(IActorRef peer, object message, int entries)
+        {
+            peer.Tell(message);
+            _messagesSent?.Increment();
+            _entriesSent?.Add(entries);
+            if (_bytesSent != null)
             {
-                _logger.Info("{Name} had to tell {PrevCount}. Now has {CurrentCount}", _name, prevCount, _actorsToTell.Count);
+                _bytesSent.Add(Context.System.Serialization.FindSerializerFor(message).ToBinary(message).Length);
             }
         }
 
         /// <summary>
-        /// If a node is removed, remove it from the current nodes and from
-        /// the actors told and to be told
+        /// If a node is removed, forget it and its cached gossip actor
         /// </summary>
         private void HandleMemberRemoved(ClusterEvent.MemberRemoved memberEvent)
         {
-            var path = CreateFormedPath(memberEvent.Member);
-            // Remove the node from the current nodes,
-            _currentNodes.Remove(path);
-            // actorsToBeTold and actorsTold
-            _actorsTold.Remove(path);
-            _actorsToTell.Remove(path);
+            var address = memberEvent.Member.Address;
+            _members.Remove(address);
+            if (_peers.TryGetValue(address, out var peer))
+            {
+                Context.Unwatch(peer);
+                _peers.Remove(address);
+            }
         }
 
         private void HandleNewMemberEvent(ClusterEvent.IMemberEvent memberEvent)
         {
-            var path = CreateFormedPath(memberEvent.Member);
-            // Add that path to the hash set
-            _currentNodes.Add(path);
-            _actorsToTell.Add(path);
+            if (memberEvent.Member.Address != _cluster.SelfAddress)
+            {
+                _members.Add(memberEvent.Member.Address);
+            }
         }
 
-        // Creates the path of the gossip actor for the given cluster member
-        private ActorPath CreateFormedPath(Member member)
-            => CreateFormedPath(member.Address);
-
         // Creates the path of the gossip actor for the given address
         private ActorPath CreateFormedPath(Address address)
             => ActorPath.Parse($"{address}/{ActorPath.FormatPathElements(Self.Path.Elements)}");
@@ -210,6 +266,7 @@ namespace AkkaLibrary.Cluster.Actors
 
         protected override void PostStop()
         {
+            _gossipTask.Cancel();
             _cluster.Unsubscribe(Self);
         }
 
@@ -217,55 +274,77 @@ namespace AkkaLibrary.Cluster.Actors
 
         #region Messages
 
-        public interface IState
+        /// <summary>
+        /// Writes a value on this node
+        /// </summary>
+        public sealed class Update
         {
-            Guid Id { get; }
-            TState State { get; }
-            ImmutableHashSet<ActorPath> Nodes { get; }
+            public TKey Key { get; }
+            public TValue Value { get; }
+
+            public Update(TKey key, TValue value)
+            {
+                Key = key;
+                Value = value;
+            }
         }
 
-        public sealed class NewState
+        /// <summary>
+        /// Sent to the manager when gossip changes the value of a key
+        /// </summary>
+        public sealed class Changed
         {
-            public TState State { get; }
-            
-            public NewState(TState state)
+            public TKey Key { get; }
+            public TValue Value { get; }
+
+            public Changed(TKey key, TValue value)
             {
-                State = state;
+                Key = key;
+                Value = value;
             }
         }
 
         public sealed class InitiateStateUpdate { }
 
-        public sealed class StateUpdate : IState
+        /// <summary>
+        /// Opens an exchange with the summary of the sender's store
+        /// </summary>
+        public sealed class Status
         {
-            public Guid Id { get; }
-            public TState State { get; }
-
-            public ImmutableHashSet<ActorPath> Nodes { get; }
+            public long Summary { get; }
 
-            public StateUpdate(IEnumerable<ActorPath> nodes, TState state)
+            public Status(long summary)
             {
-                Nodes = nodes.ToImmutableHashSet();
-                State = state;
-                Id = Guid.NewGuid();
+                Summary = summary;
             }
         }
 
-        public sealed class StateUpdateReply : IState
+        /// <summary>
+        /// Digest of every key of the sender's store
+        /// </summary>
+        public sealed class Digest
         {
-            public TState State { get; }
+            public ImmutableDictionary<TKey, long> Digests { get; }
 
-            public Guid Id { get; }
+            public Digest(ImmutableDictionary<TKey, long> digests)
+            {
+                Digests = digests;
+            }
+        }
 
-            public ImmutableHashSet<ActorPath> Nodes { get; }
+        /// <summary>
+        /// Entries the receiver lacks and the keys the sender wants in return
+        /// </summary>
+        public sealed class Delta
+        {
+            public ImmutableDictionary<TKey, GossipEntry<TValue>> Entries { get; }
 
-            public StateUpdateReply(StateUpdate data, IEnumerable<ActorPath> nodes, TState state) : this(data.Id, nodes, state) { }
+            public ImmutableHashSet<TKey> Requested { get; }
 
-            public StateUpdateReply(Guid id, IEnumerable<ActorPath> nodes, TState state)
+            public Delta(ImmutableDictionary<TKey, GossipEntry<TValue>> entries, IEnumerable<TKey> requested)
             {
-                Nodes = nodes.ToImmutableHashSet();
-                State = state;
-                Id = id;
+                Entries = entries;
+                Requested = requested.ToImmutableHashSet();
             }
         }
 
@@ -279,17 +358,23 @@ namespace AkkaLibrary.Cluster.Actors
 
             public ImmutableHashSet<ActorPath> Nodes { get; }
 
-            public object State { get; }
+            public ImmutableDictionary<TKey, TValue> State { get; }
+
+            /// <summary>
+            /// Summary of the store. Replicas that have converged report the same summary.
+            /// </summary>
+            public long Summary { get; }
 
-            public StateRequestResponse(string name, IActorRef sender, IEnumerable<ActorPath> nodes, object state)
+            public StateRequestResponse(string name, IActorRef sender, IEnumerable<ActorPath> nodes, ImmutableDictionary<TKey, TValue> state, long summary)
             {
                 Name = name;
                 Nodes = nodes.ToImmutableHashSet();
                 Sender = sender;
                 State = state;
+                Summary = summary;
             }
         }
 
         #endregion
     }
-}
\ No newline at end of file
+}
@@ -1,4 +1,6 @@
 ﻿using System;
+using System.Collections.Generic;
+using System.IO;
 using System.Linq;
 using Akka.Actor;
 using Akka.Configuration;
@@ -18,6 +20,8 @@ namespace AkkaLibrary.Cluster.Actors
         private IPropsFactory _actorPropsFactory;
         private readonly ILoggingAdapter _logger;
         private readonly Config _systemConfiguration;
+        // Hash of the configuration applied for each role, and for placement under ConfigurationDistributor.NodeKey
+        private readonly Dictionary<string, string> _applied = new Dictionary<string, string>();
 
         /// <summary>
         /// Creates an instance of <see cref="NodeConfigurator"/>
@@ -41,25 +45,35 @@ namespace AkkaLibrary.Cluster.Actors
         /// Default behaviour of the configurator
         /// 
         /// Receives an <see cref="IRoleConfiguration"/> and creates children from the
-        /// <see cref="IPluginConfiguration"/> list supplied
+        /// <see cref="IPluginConfiguration"/> list supplied. Configurations offered by
+        /// hash are only requested when they are not the ones applied for the role.
         /// </summary>
         private void DefaultBehaviour()
         {
-            Receive<IRoleConfiguration>(msg =>
+            Receive<IRoleConfiguration>(msg => ApplyConfiguration(msg));
+
+            Receive<ConfigurationDistributor.OfferConfiguration>(msg =>
             {
-                msg.Confirm(Sender);
-                if (msg.Configs.Select(x => x.Name).Distinct().Count() != msg.Configs.Length)
-                {
-                    var ex = new ArgumentException("Configuration names are not distinct.");
-                    _logger.Error(ex, "Configuration names are not distinct:{ConfigurationNames}", msg.Configs.Select(x => x.Name).ToArray());
-                    throw ex;
-                }
+                Sender.Tell(new ConfigurationDistributor.ConfigurationReport(msg.Key, msg.Hash, _applied));
+            });
 
-                foreach (var cfg in msg.Configs)
+            Receive<ConfigurationDistributor.ConfigurationPayload>(msg =>
+            {
+                if (!_applied.TryGetValue(msg.Key, out var applied) || applied != msg.Package.Hash)
                 {
-                    var actor = CreateChildIfNotExist(cfg);
-                    actor.Tell(cfg, Sender);
+                    try
+                    {
+                        ApplyConfiguration(msg.Package.Unpack(Context.System.Serialization));
+                        _applied[msg.Key] = msg.Package.Hash;
+                        _logger.Info("Applied configuration {ConfigurationPackage}.", msg.Package);
+                    }
+                    catch (InvalidDataException ex)
+                    {
+                        // Reported as not applied so the distributor sends it again
+                        _logger.Error(ex, "Configuration {ConfigurationPackage} was corrupt.", msg.Package);
+                    }
                 }
+                Sender.Tell(new ConfigurationDistributor.ConfigurationReport(msg.Key, msg.Package.Hash, _applied));
             });
 
             Receive<INodeCommand>(msg =>
@@ -77,6 +91,23 @@ namespace AkkaLibrary.Cluster.Actors
             Receive<IConfirmable>(msg => msg.Confirm(Sender));
         }
 
+        private void ApplyConfiguration(IRoleConfiguration msg)
+        {
+            msg.Confirm(Sender);
+            if (msg.Configs.Select(x => x.Name).Distinct().Count() != msg.Configs.Length)
+            {
+                var ex = new ArgumentException("Configuration names are not distinct.");
+                _logger.Error(ex, "Configuration names are not distinct:{ConfigurationNames}", msg.Configs.Select(x => x.Name).ToArray());
+                throw ex;
+            }
+
+            foreach (var cfg in msg.Configs)
+            {
+                var actor = CreateChildIfNotExist(cfg);
+                actor.Tell(cfg, Sender);
+            }
+        }
+
         /// <summary>
         /// Node specific commands that are handled here by the <see cref="NodeConfigurator"/>
         /// </summary>
@@ -85,6 +116,14 @@ namespace AkkaLibrary.Cluster.Actors
         {
             switch (msg)
             {
+                case StopPlugin stop:
+                    var child = Context.Child(stop.PluginName);
+                    if (!child.IsNobody())
+                    {
+                        _logger.Info("Stopping plugin:{PluginName}", stop.PluginName);
+                        Context.Stop(child);
+                    }
+                    break;
                 default:
                     _logger.Warning("Received unknown command:{MessageType} - ID:{MessageId}", msg.GetType(), msg.Id);
                     break;
@@ -121,5 +160,37 @@ namespace AkkaLibrary.Cluster.Actors
             }
             return child;
         }
+
+        /// <summary>
+        /// Stops a plugin of this node, such as one placed on another node
+        /// </summary>
+        public sealed class StopPlugin : INodeCommand
+        {
+            public StopPlugin(string pluginName)
+            {
+                PluginName = pluginName;
+            }
+
+            public string PluginName { get; }
+
+            public Guid Id { get; } = Guid.NewGuid();
+
+            public IConfirmation<INodeCommand> GetConfirmation() => new StopPluginConfirmation(Id, PluginName);
+
+            IConfirmation IConfirmable.GetConfirmation() => GetConfirmation();
+
+            private class StopPluginConfirmation : IConfirmation<StopPlugin>
+            {
+                public StopPluginConfirmation(Guid id, string pluginName)
+                {
+                    ConfirmationId = id;
+                    Description = $"Stop {pluginName}";
+                }
+
+                public Guid ConfirmationId { get; }
+
+                public string Description { get; }
+            }
+        }
     }
 }
\ No newline at end of file
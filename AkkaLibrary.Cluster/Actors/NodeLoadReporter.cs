@@ -0,0 +1,106 @@
+using System;
+using System.Diagnostics;
+using System.Linq;
+using Akka.Actor;
+using Akka.Cluster.Tools.PublishSubscribe;
+using Akka.Event;
+using AkkaLibrary.Cluster.Placement;
+using AkkaLibrary.Common.Logging;
+using AkkaLibrary.Common.Metrics;
+
+namespace AkkaLibrary.Cluster.Actors
+{
+    /// <summary>
+    /// Publishes the load of this node to <see cref="Topic"/> at regular intervals
+    ///
+    /// Processor use is the process time spent since the last report over
+    /// the time elapsed on all cores. The mailbox depth is the sum of the
+    /// registry gauges named "*.QueueDepth". Every stage of a pipeline counts
+    /// the same samples, so the throughput is the rate of the "*.Samples"
+    /// counters of one stage per pipeline only: those whose name starts with
+    /// the source stage, <see cref="DefaultSourceStage"/> unless given.
+    /// </summary>
+    public class NodeLoadReporter : ReceiveActor
+    {
+        public const string Topic = "node-load";
+
+        /// <summary>
+        /// Metric name prefix of the stage that takes samples into an acquisition pipeline
+        /// </summary>
+        public const string DefaultSourceStage = "FpgaSampleAssembler";
+
+        private readonly ILoggingAdapter _logger;
+        private readonly IActorRef _mediator;
+        private readonly MetricsRegistry _registry;
+        private readonly Address _address = ((ExtendedActorSystem)Context.System).Provider.DefaultAddress;
+        private readonly Process _process = Process.GetCurrentProcess();
+        private readonly ICancelable _reportTask;
+        private readonly string _sourceStage;
+
+        private TimeSpan _lastCpuTime;
+        private long _lastSamples;
+        private long _lastTimestamp;
+
+        public NodeLoadReporter(IActorRef mediator, MetricsRegistry registry) : this(mediator, registry, TimeSpan.FromSeconds(5)) { }
+
+        public NodeLoadReporter(IActorRef mediator, MetricsRegistry registry, TimeSpan interval) : this(mediator, registry, interval, DefaultSourceStage) { }
+
+        /// <param name="mediator">Mediator the loads are published through</param>
+        /// <param name="registry">Registry of the node's pipeline stages</param>
+        /// <param name="interval">Time between reports</param>
+        /// <param name="sourceStage">Name prefix of the one stage per pipeline whose samples are counted</param>
+        public NodeLoadReporter(IActorRef mediator, MetricsRegistry registry, TimeSpan interval, string sourceStage)
+        {
+            _logger = Context.WithIdentity(GetType().Name);
+            _mediator = mediator;
+            _registry = registry;
+            _sourceStage = sourceStage;
+
+            _lastCpuTime = _process.TotalProcessorTime;
+            _lastSamples = CountSamples(_registry.Snapshot());
+            _lastTimestamp = Stopwatch.GetTimestamp();
+
+            Receive<Report>(msg =>
+            {
+                var load = Measure();
+                _logger.Debug("Publishing {NodeLoad}", load);
+                _mediator.Tell(new Publish(Topic, load));
+            });
+
+            _reportTask = Context.System.Scheduler.ScheduleTellRepeatedlyCancelable(interval, interval, Self, new Report(), Self);
+        }
+
+        private NodeLoad Measure()
+        {
+            _process.Refresh();
+            var snapshot = _registry.Snapshot();
+
+            var timestamp = Stopwatch.GetTimestamp();
+            var elapsed = Math.Max(1e-3, (double)(timestamp - _lastTimestamp) / Stopwatch.Frequency);
+            var cpuTime = _process.TotalProcessorTime;
+            var samples = CountSamples(snapshot);
+
+            var cpu = (cpuTime - _lastCpuTime).TotalSeconds / (elapsed * Environment.ProcessorCount);
+            var throughput = (samples - _lastSamples) / elapsed;
+            var mailboxDepth = snapshot.Gauges.Where(x => x.Key.EndsWith(".QueueDepth", StringComparison.Ordinal)).Sum(x => x.Value);
+
+            _lastTimestamp = timestamp;
+            _lastCpuTime = cpuTime;
+            _lastSamples = samples;
+
+            return new NodeLoad(_address, DateTime.UtcNow, cpu, _process.WorkingSet64, mailboxDepth, throughput);
+        }
+
+        private long CountSamples(MetricsSnapshot snapshot)
+            => snapshot.Counters.Where(x => x.Key.StartsWith(_sourceStage, StringComparison.Ordinal) && x.Key.EndsWith(".Samples", StringComparison.Ordinal))
+                                .Sum(x => x.Value);
+
+        protected override void PostStop()
+        {
+            _reportTask.Cancel();
+            _process.Dispose();
+        }
+
+        private sealed class Report { }
+    }
+}
@@ -8,6 +8,7 @@ using Akka.Cluster.Tools.Client;
 using Akka.Cluster.Tools.PublishSubscribe;
 using Akka.Event;
 using Akka.Logger.Serilog;
+using AkkaLibrary.Cluster.Placement;
 using AkkaLibrary.Common.Interfaces;
 using AkkaLibrary.Common.Logging;
 using AkkaLibrary.Common.Messages;
@@ -20,19 +21,22 @@ namespace AkkaLibrary.Cluster.Actors
         private readonly ILoggingAdapter _logger;
         private IActorRef _clusterMonitor;
         private IActorRef _configurationDistributor;
+        private IActorRef _placementManager;
 
         private readonly IActorRef _mediator = DistributedPubSub.Get(Context.System).Mediator;
 
-        private Dictionary<string, HashSet<Address>> _upNodesPerRole = new Dictionary<string, HashSet<Address>>();
         private Dictionary<string, IRoleConfiguration> _roleConfigPerNode = new Dictionary<string, IRoleConfiguration>();
-        private Dictionary<Address, IRoleConfiguration> _configuredNodes = new Dictionary<Address, IRoleConfiguration>();
 
-        public NodeManager()
+        public NodeManager() : this(PlacementSettings.Default) { }
+
+        /// <param name="placementSettings">Tuning of the placement of plugins sent with <see cref="PlacePlugins"/></param>
+        public NodeManager(PlacementSettings placementSettings)
         {
             _logger = Context.WithIdentity(GetType().Name);
 
             _clusterMonitor = Context.ActorOf(Props.Create(() => new ClusterMonitor(Self)), "cluster-monitor");
             _configurationDistributor = Context.ActorOf(Props.Create(() => new ConfigurationDistributor(Self)), "config-distributor");
+            _placementManager = Context.ActorOf(Props.Create(() => new PlacementManager(_configurationDistributor, _mediator, placementSettings)), "placement-manager");
 
             Receive<NodeJoined>(msg =>
             {
@@ -40,28 +44,15 @@ namespace AkkaLibrary.Cluster.Actors
 
             Receive<NodeUp>(msg =>
             {
-                /// For each role, add the up node to the hash set for that role if it doesn't already exist.
-                foreach (var role in msg.NodeRoles)
-                {
-                    if(_upNodesPerRole.ContainsKey(role))
-                    {
-                        _upNodesPerRole[role].Add(msg.NodeAddress);
-                    }
-                    else
-                    {
-                        _upNodesPerRole[role] = new HashSet<Address> { msg.NodeAddress };
-                    }
-                }
-
-                // Find all configurations for the roles of this new node.
-                var configurations = _roleConfigPerNode.Where(kvp => msg.NodeRoles.Contains(kvp.Key)).Select(kvp => kvp.Value);
-
-                // Configure the newly up node
-                ConfigureNewUpNode(configurations, msg.NodeAddress);
+                // The distributor sends the new node the configurations of its roles that it lacks
+                _configurationDistributor.Tell(new ConfigurationDistributor.RegisterNode(msg.NodeAddress, msg.NodeRoles));
+                _placementManager.Tell(msg);
             });
 
             Receive<NodeRemoved>(msg =>
             {
+                _configurationDistributor.Tell(new ConfigurationDistributor.UnregisterNode(msg.NodeAddress));
+                _placementManager.Tell(msg);
             });
 
             Receive<ConfigureRoles>(msg =>
@@ -73,58 +64,36 @@ namespace AkkaLibrary.Cluster.Actors
                         _logger.Info("Replacing {OldRoleConfiguration} with {NewRoleConfiguration} for {ClusterRole}", _roleConfigPerNode[role], msg.Configuration, role);
                     }
                     _roleConfigPerNode[role] = msg.Configuration;
-
-                    // If there are any nodes up that have this role...
-                    if(_upNodesPerRole.ContainsKey(role))
-                    {
-                        // All nodes that need configuration sent
-                        var nodes = _upNodesPerRole[role];
-
-                        // Filter out nodes that have already been sent the same configuration
-                        var nodesToConfigure = _configuredNodes.Where(kvp => nodes.Contains(kvp.Key)).Where(kvp => kvp.Value.Equals(msg.Configuration)).Select(x => x.Key);
-
-                        ConfigureNodesWithNewConfiguration(nodesToConfigure, msg.Configuration);
-                    }
                 }
-            });
 
-            Receive<IConfirmation<IRoleConfiguration>>(msg =>
-            {
-                _logger.Info("Received confirmation of RoleConfiguration with ID:{ConfirmationId}", msg.ConfirmationId);
+                // Only nodes that do not already hold the configuration are sent it
+                _configurationDistributor.Tell(new ConfigurationDistributor.ConfigureRole(msg.NodeRoles.ToArray(), msg.Configuration));
             });
-        }
 
-        private void ConfigureNodesWithNewConfiguration(IEnumerable<Address> nodesToConfigure, IRoleConfiguration configuration)
-        {
-            foreach (var node in nodesToConfigure)
+            Receive<PlacePlugins>(msg =>
             {
-                ConfigureNode(node, configuration);
-            }
-        }
+                // Each plugin runs on one node of the role, chosen by load
+                _placementManager.Forward(msg);
+            });
 
-        private void ConfigureNewUpNode(IEnumerable<IRoleConfiguration> configurations, Address nodeAddress)
-        {
-            foreach (var cfg in configurations)
+            Receive<ConfigurationDistributor.NodeConfigured>(msg =>
             {
-                ConfigureNode(nodeAddress, cfg);
-            }
-        }
-
-        private void ConfigureNode(Address nodeAddress, IRoleConfiguration configuration)
-        {
-            // Create the path of the configurator
-            var path = $"{nodeAddress}/*/configurator";
-
-            var actorSelection = Context.ActorSelection(path);
+                _logger.Info("Configured {ClusterNode} with configuration {ConfigurationHash} version {ConfigurationVersion}", msg.Address, msg.Hash, msg.Version);
 
-            // Touch the actor to check it's there
-            var confirmation = actorSelection.Ask<IConfirmation<Touch>>(new Touch(), TimeSpan.FromSeconds(5));
-
-            var result = confirmation.Result;
+                // Placement stops a moved plugin only once its new node holds it
+                _placementManager.Tell(msg);
+            });
 
-            actorSelection.Tell(configuration);
+            Receive<ConfigurationDistributor.NodeConfigurationFailed>(msg =>
+            {
+                _logger.Error("Could not configure {ClusterNode} with configuration {ConfigurationHash} version {ConfigurationVersion}", msg.Address, msg.Hash, msg.Version);
+                _placementManager.Tell(msg);
+            });
 
-            _logger.Info("Attempted to configure {ClusterNode} with {RoleConfiguration} with ID:{MessageId}", nodeAddress, configuration, configuration.Id);
+            Receive<IConfirmation<IRoleConfiguration>>(msg =>
+            {
+                _logger.Info("Received confirmation of RoleConfiguration with ID:{ConfirmationId}", msg.ConfirmationId);
+            });
         }
     }
 
@@ -141,6 +110,22 @@ namespace AkkaLibrary.Cluster.Actors
         public HashSet<string> NodeRoles { get; }
     }
 
+    /// <summary>
+    /// Runs each plugin on the least loaded node of a role rather than on every node of the role
+    /// </summary>
+    public sealed class PlacePlugins
+    {
+        public PlacePlugins(string role, params IPluginConfiguration[] plugins)
+        {
+            Role = role;
+            Plugins = plugins;
+        }
+
+        public string Role { get; }
+
+        public IPluginConfiguration[] Plugins { get; }
+    }
+
     #region Messages
 
     public sealed class NodeJoined : INodeMessage
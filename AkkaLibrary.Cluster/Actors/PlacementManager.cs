@@ -0,0 +1,271 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Akka.Actor;
+using Akka.Cluster.Tools.PublishSubscribe;
+using Akka.Event;
+using AkkaLibrary.Cluster.Configuration;
+using AkkaLibrary.Cluster.Placement;
+using AkkaLibrary.Common.Interfaces;
+using AkkaLibrary.Common.Logging;
+
+namespace AkkaLibrary.Cluster.Actors
+{
+    /// <summary>
+    /// Places plugins on the least loaded nodes of their role and moves them
+    /// as the load of the nodes changes
+    ///
+    /// Loads are taken from the <see cref="NodeLoadReporter"/> topic and the
+    /// decisions from a <see cref="PlacementScheduler"/>. Every node that
+    /// gains or loses a plugin is sent the configuration of all of its plugins
+    /// through the <see cref="ConfigurationDistributor"/>, and a node a plugin
+    /// was moved off is told to stop it once the node it moved to holds its new
+    /// configuration. If that node cannot be configured, the plugin is left
+    /// running where it was. Plugins of nodes that leave are placed again on
+    /// the remaining nodes.
+    /// </summary>
+    public class PlacementManager : ReceiveActor
+    {
+        private readonly ILoggingAdapter _logger;
+        private readonly IActorRef _distributor;
+        private readonly IActorRef _mediator;
+        private readonly PlacementScheduler _scheduler;
+        private readonly Dictionary<string, IPluginConfiguration> _plugins = new Dictionary<string, IPluginConfiguration>();
+        private readonly ICancelable _rebalanceTask;
+
+        // Configurations sent to each node that it does not hold yet, oldest
+        // first, and the plugins to stop once each is held
+        private readonly Dictionary<Address, List<Guid>> _unconfirmed = new Dictionary<Address, List<Guid>>();
+        private readonly Dictionary<Guid, List<(Address Node, string Plugin)>> _stops = new Dictionary<Guid, List<(Address Node, string Plugin)>>();
+
+        /// <param name="distributor">Distributor the node configurations are sent through</param>
+        /// <param name="mediator">Mediator to subscribe to node loads with</param>
+        /// <param name="settings">Tuning of the scheduler</param>
+        public PlacementManager(IActorRef distributor, IActorRef mediator, PlacementSettings settings)
+        {
+            _logger = Context.WithIdentity(GetType().Name);
+            _distributor = distributor;
+            _mediator = mediator;
+            _scheduler = new PlacementScheduler(settings);
+
+            Receive<NodeUp>(msg =>
+            {
+                _scheduler.AddNode(msg.NodeAddress, msg.NodeRoles);
+                PlaceAll(_scheduler.Unplaced.ToList());
+            });
+
+            Receive<NodeRemoved>(msg =>
+            {
+                // Moves to the node will not complete, so their plugins are stopped
+                // once they are held by the nodes they are placed on instead
+                var waiting = Unconfirmed(msg.NodeAddress, Guid.Empty);
+
+                var orphaned = _scheduler.RemoveNode(msg.NodeAddress);
+                var sent = new Dictionary<Address, Guid>();
+                if (orphaned.Count > 0)
+                {
+                    _logger.Info("Node:{ClusterNode} left with plugins:{PluginNames}. Placing them again.", msg.NodeAddress, orphaned);
+                    sent = PlaceAll(orphaned);
+                }
+
+                foreach (var stop in waiting.Where(x => !x.Node.Equals(_scheduler.NodeOf(x.Plugin))))
+                {
+                    StopAfter(_scheduler.NodeOf(stop.Plugin), sent, stop.Node, stop.Plugin);
+                }
+            });
+
+            Receive<NodeLoad>(msg => _scheduler.Report(msg, DateTime.UtcNow));
+
+            Receive<PlacePlugins>(msg =>
+            {
+                foreach (var plugin in msg.Plugins)
+                {
+                    _plugins[plugin.Name] = plugin;
+                }
+                PlaceAll(msg.Plugins.Select(x => x.Name).ToList(), msg.Role);
+            });
+
+            Receive<Rebalance>(msg =>
+            {
+                var moves = _scheduler.Rebalance(DateTime.UtcNow);
+                foreach (var move in moves)
+                {
+                    _logger.Info("Moving plugin {PlacementMove}", move);
+                }
+
+                var sent = SendConfigurations(moves.Select(x => x.To).Concat(moves.Select(x => x.From)));
+                foreach (var move in moves)
+                {
+                    StopAfter(move.To, sent, move.From, move.Plugin);
+                }
+            });
+
+            Receive<ConfigurationDistributor.NodeConfigured>(msg =>
+            {
+                foreach (var stop in Unconfirmed(msg.Address, msg.ConfigurationId))
+                {
+                    StopPlugin(stop.Node, stop.Plugin);
+                }
+            });
+
+            Receive<ConfigurationDistributor.NodeConfigurationFailed>(msg =>
+            {
+                var stops = Unconfirmed(msg.Address, msg.ConfigurationId);
+                if (stops.Count == 0)
+                {
+                    return;
+                }
+
+                // A later configuration of the node also carries the moves
+                if (_unconfirmed.TryGetValue(msg.Address, out var later))
+                {
+                    foreach (var stop in stops)
+                    {
+                        Await(later[0], stop.Node, stop.Plugin);
+                    }
+                    return;
+                }
+
+                _logger.Warning("Node:{ClusterNode} was not configured, so plugins:{PluginNames} keep running on their previous nodes.", msg.Address, stops.Select(x => x.Plugin).ToArray());
+            });
+
+            Receive<SubscribeAck>(msg => _logger.Info("Subscribed to node loads on topic:{Topic}", msg.Subscribe.Topic));
+
+            _rebalanceTask = Context.System.Scheduler.ScheduleTellRepeatedlyCancelable(settings.RebalanceInterval, settings.RebalanceInterval, Self, new Rebalance(), Self);
+        }
+
+        /// <summary>
+        /// Places the plugins and sends the nodes they were placed on their new
+        /// configurations, returning the id of the configuration sent to each node
+        /// </summary>
+        private Dictionary<Address, Guid> PlaceAll(IReadOnlyList<string> plugins, string role = null)
+        {
+            var changed = new HashSet<Address>();
+            var stopped = new List<(Address Node, string Plugin, Address Target)>();
+            var now = DateTime.UtcNow;
+
+            foreach (var plugin in plugins)
+            {
+                var previous = _scheduler.NodeOf(plugin);
+                var node = _scheduler.Place(plugin, role ?? _scheduler.RoleOf(plugin), now);
+
+                // A plugin given a new role may have to leave its node
+                if (previous != null && !previous.Equals(node))
+                {
+                    changed.Add(previous);
+                    stopped.Add((previous, plugin, node));
+                }
+
+                if (node == null)
+                {
+                    _logger.Warning("No node can run plugin:{PluginName} yet.", plugin);
+                    continue;
+                }
+
+                changed.Add(node);
+                _logger.Info("Placed plugin:{PluginName} on node:{ClusterNode}", plugin, node);
+            }
+
+            var sent = SendConfigurations(changed);
+            foreach (var stop in stopped)
+            {
+                StopAfter(stop.Target, sent, stop.Node, stop.Plugin);
+            }
+            return sent;
+        }
+
+        private Dictionary<Address, Guid> SendConfigurations(IEnumerable<Address> nodes)
+        {
+            var sent = new Dictionary<Address, Guid>();
+            foreach (var node in nodes.Distinct())
+            {
+                var configuration = new SystemConfiguration(_scheduler.PluginsOn(node).Select(x => _plugins[x]).ToArray());
+                _distributor.Tell(new ConfigurationDistributor.ConfigureNode(node, configuration));
+
+                if (!_unconfirmed.TryGetValue(node, out var ids))
+                {
+                    _unconfirmed[node] = ids = new List<Guid>();
+                }
+                ids.Add(configuration.Id);
+                sent[node] = configuration.Id;
+            }
+            return sent;
+        }
+
+        /// <summary>
+        /// Stops a plugin once the node it moved to holds the configuration sent
+        /// to it, or at once if it moved to no node
+        /// </summary>
+        private void StopAfter(Address target, IReadOnlyDictionary<Address, Guid> sent, Address node, string plugin)
+        {
+            if (target == null || !sent.TryGetValue(target, out var id))
+            {
+                StopPlugin(node, plugin);
+                return;
+            }
+            Await(id, node, plugin);
+        }
+
+        private void Await(Guid configurationId, Address node, string plugin)
+        {
+            if (!_stops.TryGetValue(configurationId, out var stops))
+            {
+                _stops[configurationId] = stops = new List<(Address Node, string Plugin)>();
+            }
+            stops.Add((node, plugin));
+        }
+
+        /// <summary>
+        /// Forgets the configurations of a node up to and including the one with
+        /// the id, or all of them for <see cref="Guid.Empty"/>, returning their
+        /// waiting stops. A node that holds a configuration no longer needs the
+        /// ones sent before it, which carried the same moves.
+        /// </summary>
+        private List<(Address Node, string Plugin)> Unconfirmed(Address node, Guid id)
+        {
+            var stops = new List<(Address Node, string Plugin)>();
+            if (!_unconfirmed.TryGetValue(node, out var ids) || (id != Guid.Empty && !ids.Contains(id)))
+            {
+                return stops;
+            }
+
+            var count = id == Guid.Empty ? ids.Count : ids.IndexOf(id) + 1;
+            foreach (var done in ids.Take(count))
+            {
+                if (_stops.TryGetValue(done, out var waiting))
+                {
+                    stops.AddRange(waiting);
+                    _stops.Remove(done);
+                }
+            }
+
+            ids.RemoveRange(0, count);
+            if (ids.Count == 0)
+            {
+                _unconfirmed.Remove(node);
+            }
+            return stops;
+        }
+
+        private void StopPlugin(Address node, string plugin)
+        {
+            Context.ActorSelection($"{node}/*/configurator").Tell(new NodeConfigurator.StopPlugin(plugin));
+        }
+
+        #region Actor Method Overrides
+
+        protected override void PreStart()
+        {
+            _mediator.Tell(new Subscribe(NodeLoadReporter.Topic, Self));
+        }
+
+        protected override void PostStop()
+        {
+            _rebalanceTask.Cancel();
+        }
+
+        #endregion
+
+        private sealed class Rebalance { }
+    }
+}
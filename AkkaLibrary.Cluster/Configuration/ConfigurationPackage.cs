@@ -0,0 +1,186 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Compression;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Security.Cryptography;
+using Akka.Actor;
+using Akka.Serialization;
+using Akka.Util;
+using AkkaLibrary.Common.Interfaces;
+
+namespace AkkaLibrary.Cluster.Configuration
+{
+    /// <summary>
+    /// A serialized <see cref="IRoleConfiguration"/> addressed by the SHA-256 hash of its content
+    ///
+    /// Two packages with the same <see cref="Hash"/> carry the same configuration,
+    /// so a node that holds the hash never needs the payload again. The hash
+    /// covers a copy of the configuration serialized with the
+    /// <see cref="IConfirmable.Id"/> of every message in it set to
+    /// <see cref="Guid.Empty"/>, so reissuing the same content under new
+    /// message ids gives the same hash. The
+    /// <see cref="Checksum"/> covers the bytes as sent. Payloads longer than the
+    /// compression threshold are gzipped; both are always of the uncompressed bytes.
+    /// </summary>
+    public sealed class ConfigurationPackage
+    {
+        public string Hash { get; }
+
+        /// <summary>
+        /// SHA-256 of the serialized payload, used to detect corruption
+        /// </summary>
+        public string Checksum { get; }
+
+        /// <summary>
+        /// Distributor version of the configuration. Later configurations have higher versions.
+        /// </summary>
+        public long Version { get; }
+
+        public int SerializerId { get; }
+
+        public string Manifest { get; }
+
+        public bool Compressed { get; }
+
+        public byte[] Payload { get; }
+
+        public ConfigurationPackage(string hash, string checksum, long version, int serializerId, string manifest, bool compressed, byte[] payload)
+        {
+            Hash = hash;
+            Checksum = checksum;
+            Version = version;
+            SerializerId = serializerId;
+            Manifest = manifest;
+            Compressed = compressed;
+            Payload = payload;
+        }
+
+        public static ConfigurationPackage Create(IRoleConfiguration configuration, Akka.Serialization.Serialization serialization, long version, int compressionThreshold)
+        {
+            var serializer = serialization.FindSerializerFor(configuration);
+            var bytes = serializer.ToBinary(configuration);
+            var manifest = serializer is SerializerWithStringManifest named ? named.Manifest(configuration)
+                         : serializer.IncludeManifest ? configuration.GetType().TypeQualifiedName()
+                         : string.Empty;
+
+            var hash = ComputeHash(WithoutIds(bytes, serializer, manifest, serialization));
+
+            var compress = bytes.Length > compressionThreshold;
+            return new ConfigurationPackage(hash, ComputeHash(bytes), version, serializer.Identifier, manifest, compress, compress ? Compress(bytes) : bytes);
+        }
+
+        /// <summary>
+        /// Restores the configuration, checking it against <see cref="Checksum"/>
+        /// </summary>
+        /// <exception cref="InvalidDataException">The payload does not match the checksum</exception>
+        public IRoleConfiguration Unpack(Akka.Serialization.Serialization serialization)
+        {
+            var bytes = Compressed ? Decompress(Payload) : Payload;
+            if (ComputeHash(bytes) != Checksum)
+            {
+                throw new InvalidDataException($"Configuration payload {Hash} does not match its checksum.");
+            }
+
+            return (IRoleConfiguration)serialization.Deserialize(bytes, SerializerId, Manifest);
+        }
+
+        private static string ComputeHash(byte[] bytes)
+        {
+            using (var sha = SHA256.Create())
+            {
+                return BitConverter.ToString(sha.ComputeHash(bytes)).Replace("-", string.Empty);
+            }
+        }
+
+        /// <summary>
+        /// The configuration serialized again after clearing the ids of a
+        /// deserialized copy, leaving the configuration itself unchanged
+        /// </summary>
+        private static byte[] WithoutIds(byte[] bytes, Serializer serializer, string manifest, Akka.Serialization.Serialization serialization)
+        {
+            var copy = serialization.Deserialize(bytes, serializer.Identifier, manifest);
+            ClearIds(copy, new HashSet<object>(ReferenceComparer.Instance));
+            return serializer.ToBinary(copy);
+        }
+
+        /// <summary>
+        /// Sets the Id of every <see cref="IConfirmable"/> reachable from
+        /// <paramref name="value"/> to <see cref="Guid.Empty"/>. Ids are
+        /// auto-properties, so their backing fields are cleared.
+        /// </summary>
+        private static void ClearIds(object value, HashSet<object> visited)
+        {
+            if (value == null || value is string || value is MemberInfo || value is Delegate || value is IActorRef || value is ActorSystem
+                || value.GetType().IsValueType || !visited.Add(value))
+            {
+                return;
+            }
+
+            if (value is Array array)
+            {
+                if (array.GetType().GetElementType().IsValueType)
+                {
+                    return;
+                }
+
+                foreach (var item in array)
+                {
+                    ClearIds(item, visited);
+                }
+                return;
+            }
+
+            for (var type = value.GetType(); type != null; type = type.BaseType)
+            {
+                foreach (var field in type.GetFields(BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic | BindingFlags.DeclaredOnly))
+                {
+                    if (value is IConfirmable && field.FieldType == typeof(Guid) && field.Name == IdField)
+                    {
+                        field.SetValue(value, Guid.Empty);
+                    }
+                    else if (!field.FieldType.IsValueType)
+                    {
+                        ClearIds(field.GetValue(value), visited);
+                    }
+                }
+            }
+        }
+
+        private const string IdField = "<" + nameof(IConfirmable.Id) + ">k__BackingField";
+
+        private sealed class ReferenceComparer : IEqualityComparer<object>
+        {
+            public static ReferenceComparer Instance { get; } = new ReferenceComparer();
+
+            public new bool Equals(object x, object y) => ReferenceEquals(x, y);
+
+            public int GetHashCode(object obj) => RuntimeHelpers.GetHashCode(obj);
+        }
+
+        private static byte[] Compress(byte[] bytes)
+        {
+            using (var output = new MemoryStream())
+            {
+                using (var gzip = new GZipStream(output, CompressionLevel.Fastest, true))
+                {
+                    gzip.Write(bytes, 0, bytes.Length);
+                }
+                return output.ToArray();
+            }
+        }
+
+        private static byte[] Decompress(byte[] bytes)
+        {
+            using (var input = new GZipStream(new MemoryStream(bytes), CompressionMode.Decompress))
+            using (var output = new MemoryStream())
+            {
+                input.CopyTo(output);
+                return output.ToArray();
+            }
+        }
+
+        public override string ToString() => $"{Hash.Substring(0, 12)} v{Version}";
+    }
+}
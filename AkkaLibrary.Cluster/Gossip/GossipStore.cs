@@ -0,0 +1,180 @@
+using System;
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+
+namespace AkkaLibrary.Cluster.Gossip
+{
+    /// <summary>
+    /// A gossiped value and the version it was written or merged at
+    /// </summary>
+    public sealed class GossipEntry<TValue>
+    {
+        public TValue Value { get; }
+
+        public VersionVector Version { get; }
+
+        /// <summary>
+        /// Hash of <see cref="Version"/>, compared in place of the value
+        /// </summary>
+        public long Digest { get; }
+
+        public GossipEntry(TValue value, VersionVector version)
+        {
+            Value = value;
+            Version = version;
+            Digest = version.Digest();
+        }
+    }
+
+    /// <summary>
+    /// Keyed state replicated by anti-entropy gossip
+    ///
+    /// Every local write takes the next version of a counter shared by all the
+    /// keys of the node, so no two writes carry the same version and an
+    /// entry's version vector identifies its value. Replicas therefore compare
+    /// per-key digests of the vectors rather than the values, and the sum of
+    /// the digests summarises the whole store in a single number. Concurrent
+    /// versions are combined with the merge function, which must be
+    /// commutative so that every replica settles on the same value.
+    /// </summary>
+    public sealed class GossipStore<TKey, TValue>
+    {
+        private readonly Dictionary<TKey, GossipEntry<TValue>> _entries = new Dictionary<TKey, GossipEntry<TValue>>();
+        private readonly Func<TValue, TValue, TValue> _merge;
+        private long _clock;
+
+        /// <summary>
+        /// Name of this replica in the version vectors
+        /// </summary>
+        public string Node { get; }
+
+        /// <summary>
+        /// Order independent hash of every entry. Equal summaries mean equal stores.
+        /// </summary>
+        public long Summary { get; private set; }
+
+        public int Count => _entries.Count;
+
+        public IEnumerable<TKey> Keys => _entries.Keys;
+
+        public GossipStore(string node, Func<TValue, TValue, TValue> merge)
+        {
+            Node = node;
+            _merge = merge;
+        }
+
+        public bool TryGetValue(TKey key, out TValue value)
+        {
+            var found = _entries.TryGetValue(key, out var entry);
+            value = found ? entry.Value : default(TValue);
+            return found;
+        }
+
+        /// <summary>
+        /// Copies the current values
+        /// </summary>
+        public ImmutableDictionary<TKey, TValue> Values()
+            => _entries.ToImmutableDictionary(x => x.Key, x => x.Value.Value);
+
+        /// <summary>
+        /// Writes a value locally, superseding every version of the key seen so far
+        /// </summary>
+        public void Set(TKey key, TValue value)
+        {
+            var version = _entries.TryGetValue(key, out var entry) ? entry.Version : VersionVector.Empty;
+            Replace(key, new GossipEntry<TValue>(value, version.With(Node, ++_clock)));
+        }
+
+        public ImmutableDictionary<TKey, long> Digests()
+            => _entries.ToImmutableDictionary(x => x.Key, x => x.Value.Digest);
+
+        /// <summary>
+        /// Compares the digests of another replica with this store. Keys the other
+        /// replica lacks or holds at another version are to be sent to it, and
+        /// keys this store lacks or holds at another version are to be requested.
+        /// </summary>
+        public void Compare(IReadOnlyDictionary<TKey, long> digests, out List<TKey> send, out List<TKey> request)
+        {
+            send = new List<TKey>();
+            request = new List<TKey>();
+
+            foreach (var entry in _entries)
+            {
+                if(!digests.TryGetValue(entry.Key, out var digest))
+                {
+                    send.Add(entry.Key);
+                }
+                else if(digest != entry.Value.Digest)
+                {
+                    send.Add(entry.Key);
+                    request.Add(entry.Key);
+                }
+            }
+
+            request.AddRange(digests.Keys.Where(x => !_entries.ContainsKey(x)));
+        }
+
+        public ImmutableDictionary<TKey, GossipEntry<TValue>> Entries(IEnumerable<TKey> keys)
+            => keys.Where(_entries.ContainsKey).ToImmutableDictionary(x => x, x => _entries[x]);
+
+        /// <summary>
+        /// Merges entries from another replica, returning the keys whose value changed
+        /// </summary>
+        public List<TKey> Merge(IEnumerable<KeyValuePair<TKey, GossipEntry<TValue>>> entries)
+        {
+            var changed = new List<TKey>();
+
+            foreach (var remote in entries)
+            {
+                if(!_entries.TryGetValue(remote.Key, out var local))
+                {
+                    Replace(remote.Key, remote.Value);
+                    changed.Add(remote.Key);
+                    continue;
+                }
+
+                switch (local.Version.Compare(remote.Value.Version))
+                {
+                    case VersionOrder.Before:
+                        Replace(remote.Key, remote.Value);
+                        changed.Add(remote.Key);
+                        break;
+                    case VersionOrder.Concurrent:
+                        Replace(remote.Key, new GossipEntry<TValue>(_merge(local.Value, remote.Value.Value), local.Version.Merge(remote.Value.Version)));
+                        changed.Add(remote.Key);
+                        break;
+                }
+            }
+
+            return changed;
+        }
+
+        private void Replace(TKey key, GossipEntry<TValue> entry)
+        {
+            unchecked
+            {
+                if(_entries.TryGetValue(key, out var previous))
+                {
+                    Summary -= Mix(previous.Digest);
+                }
+                Summary += Mix(entry.Digest);
+            }
+            _entries[key] = entry;
+        }
+
+        /// <summary>
+        /// Spreads the bits of a digest so that sums of digests rarely collide
+        /// </summary>
+        private static long Mix(long digest)
+        {
+            unchecked
+            {
+                var z = (ulong)digest + 0x9E3779B97F4A7C15UL;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+                return (long)(z ^ (z >> 31));
+            }
+        }
+    }
+}
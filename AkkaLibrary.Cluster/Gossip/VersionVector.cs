@@ -0,0 +1,90 @@
+using System;
+using System.Collections.Immutable;
+using System.Linq;
+
+namespace AkkaLibrary.Cluster.Gossip
+{
+    /// <summary>
+    /// Result of comparing two <see cref="VersionVector"/>s
+    /// </summary>
+    public enum VersionOrder
+    {
+        Same,
+        Before,
+        After,
+        Concurrent
+    }
+
+    /// <summary>
+    /// Immutable map of node to the latest write of that node seen by a value
+    /// </summary>
+    public sealed class VersionVector
+    {
+        public static VersionVector Empty { get; } = new VersionVector(ImmutableSortedDictionary<string, long>.Empty.WithComparers(StringComparer.Ordinal));
+
+        public ImmutableSortedDictionary<string, long> Versions { get; }
+
+        public VersionVector(ImmutableSortedDictionary<string, long> versions)
+        {
+            Versions = versions;
+        }
+
+        public long this[string node] => Versions.TryGetValue(node, out var version) ? version : 0;
+
+        /// <summary>
+        /// This vector with the version of <paramref name="node"/> set to <paramref name="version"/>
+        /// </summary>
+        public VersionVector With(string node, long version)
+            => new VersionVector(Versions.SetItem(node, Math.Max(version, this[node])));
+
+        /// <summary>
+        /// The pointwise maximum of the two vectors
+        /// </summary>
+        public VersionVector Merge(VersionVector other)
+            => new VersionVector(other.Versions.Aggregate(Versions, (versions, x) => versions.SetItem(x.Key, Math.Max(x.Value, this[x.Key]))));
+
+        public VersionOrder Compare(VersionVector other)
+        {
+            var before = false;
+            var after = false;
+
+            foreach (var node in Versions.Keys.Union(other.Versions.Keys))
+            {
+                var mine = this[node];
+                var theirs = other[node];
+                before |= mine < theirs;
+                after |= mine > theirs;
+            }
+
+            return before && after ? VersionOrder.Concurrent
+                 : before ? VersionOrder.Before
+                 : after ? VersionOrder.After
+                 : VersionOrder.Same;
+        }
+
+        /// <summary>
+        /// FNV-1a hash of the vector that is stable across processes
+        /// </summary>
+        public long Digest()
+        {
+            unchecked
+            {
+                var hash = (long)14695981039346656037UL;
+                foreach (var version in Versions)
+                {
+                    foreach (var c in version.Key)
+                    {
+                        hash = (hash ^ c) * 1099511628211L;
+                    }
+                    for (int shift = 0; shift < 64; shift += 8)
+                    {
+                        hash = (hash ^ ((version.Value >> shift) & 0xFF)) * 1099511628211L;
+                    }
+                }
+                return hash;
+            }
+        }
+
+        public override string ToString() => $"[{string.Join(", ", Versions.Select(x => $"{x.Key}:{x.Value}"))}]";
+    }
+}
@@ -0,0 +1,51 @@
+using System;
+using Akka.Actor;
+
+namespace AkkaLibrary.Cluster.Placement
+{
+    /// <summary>
+    /// Load of a node published periodically by its <see cref="Actors.NodeLoadReporter"/>
+    /// </summary>
+    public sealed class NodeLoad
+    {
+        public NodeLoad(Address address, DateTime time, double cpu, long memoryBytes, long mailboxDepth, double throughput)
+        {
+            Address = address;
+            Time = time;
+            Cpu = cpu;
+            MemoryBytes = memoryBytes;
+            MailboxDepth = mailboxDepth;
+            Throughput = throughput;
+        }
+
+        public Address Address { get; }
+
+        /// <summary>
+        /// UTC time the load was measured on the node
+        /// </summary>
+        public DateTime Time { get; }
+
+        /// <summary>
+        /// Processor time used by the node since its last report, as a fraction of all its cores
+        /// </summary>
+        public double Cpu { get; }
+
+        /// <summary>
+        /// Working set of the node's process
+        /// </summary>
+        public long MemoryBytes { get; }
+
+        /// <summary>
+        /// Messages queued in the node's pipeline stages
+        /// </summary>
+        public long MailboxDepth { get; }
+
+        /// <summary>
+        /// Samples per second through the node's pipeline stages
+        /// </summary>
+        public double Throughput { get; }
+
+        public override string ToString()
+            => $"{Address} cpu:{Cpu:P0} memory:{MemoryBytes / (1024 * 1024)}MB mailbox:{MailboxDepth} throughput:{Throughput:F0}/s";
+    }
+}
@@ -0,0 +1,295 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Akka.Actor;
+
+namespace AkkaLibrary.Cluster.Placement
+{
+    /// <summary>
+    /// Moves a plugin from one node to another
+    /// </summary>
+    public sealed class PlacementMove
+    {
+        public PlacementMove(string plugin, Address from, Address to)
+        {
+            Plugin = plugin;
+            From = from;
+            To = to;
+        }
+
+        public string Plugin { get; }
+
+        public Address From { get; }
+
+        public Address To { get; }
+
+        public override string ToString() => $"{Plugin}: {From} -> {To}";
+    }
+
+    /// <summary>
+    /// Chooses the node of each plugin from the load the nodes report
+    ///
+    /// A plugin is placed on the least loaded node with its role. Reports
+    /// arrive only every few seconds, so every plugin placed on or moved to a
+    /// node since its last report adds its estimated cost to the node's score,
+    /// and every plugin moved off takes that cost away. A new plugin is
+    /// assumed to cost <see cref="PlacementSettings.PluginCost"/>.
+    /// That spreads a burst of placements rather than stacking them on the
+    /// node that was idle when the burst began.
+    ///
+    /// Rebalancing moves a plugin only when the gap between its node and the
+    /// least loaded eligible node exceeds <see cref="PlacementSettings.Hysteresis"/>,
+    /// when the move would narrow that gap rather than reverse it, and when
+    /// the plugin has stayed put for <see cref="PlacementSettings.MinimumDwell"/>.
+    /// Together these stop plugins from bouncing between nodes of similar load.
+    ///
+    /// The scheduler holds no actor state and takes the time as an argument,
+    /// so it is driven by the <see cref="Actors.PlacementManager"/> and by tests alike.
+    /// </summary>
+    public sealed class PlacementScheduler
+    {
+        private readonly PlacementSettings _settings;
+        private readonly Dictionary<Address, NodeState> _nodes = new Dictionary<Address, NodeState>();
+        private readonly Dictionary<string, PluginState> _plugins = new Dictionary<string, PluginState>();
+
+        public PlacementScheduler(PlacementSettings settings)
+        {
+            _settings = settings ?? throw new ArgumentNullException(nameof(settings));
+        }
+
+        public IEnumerable<Address> Nodes => _nodes.Keys;
+
+        /// <summary>
+        /// Plugins that have no node with their role to run on
+        /// </summary>
+        public IEnumerable<string> Unplaced => _plugins.Where(x => x.Value.Node == null).Select(x => x.Key);
+
+        public void AddNode(Address address, IEnumerable<string> roles)
+        {
+            if (!_nodes.ContainsKey(address))
+            {
+                _nodes[address] = new NodeState(roles);
+            }
+        }
+
+        /// <summary>
+        /// Forgets a node, returning the plugins it ran. They are left unplaced.
+        /// </summary>
+        public IReadOnlyList<string> RemoveNode(Address address)
+        {
+            if (!_nodes.Remove(address))
+            {
+                return new string[0];
+            }
+
+            var orphaned = _plugins.Where(x => address.Equals(x.Value.Node)).Select(x => x.Key).ToList();
+            foreach (var plugin in orphaned)
+            {
+                _plugins[plugin].Node = null;
+            }
+            return orphaned;
+        }
+
+        /// <summary>
+        /// Records the latest load of a node. Reports from unknown nodes are ignored.
+        /// </summary>
+        public void Report(NodeLoad load, DateTime now)
+        {
+            if (_nodes.TryGetValue(load.Address, out var node))
+            {
+                node.Load = load;
+                node.ReportedAt = now;
+                node.Departures.Clear();
+            }
+        }
+
+        /// <summary>
+        /// Places a plugin on the least loaded node with the role. A plugin that
+        /// is already placed on a node with the role stays there. Returns null,
+        /// leaving the plugin unplaced, when no node has the role.
+        /// </summary>
+        public Address Place(string plugin, string role, DateTime now)
+        {
+            if (_plugins.TryGetValue(plugin, out var state) && state.Role == role && state.Node != null)
+            {
+                return state.Node;
+            }
+
+            state = new PluginState(role);
+            _plugins[plugin] = state;
+
+            var node = LeastLoaded(role, null);
+            if (node != null)
+            {
+                state.Node = node;
+                state.PlacedAt = now;
+                state.Cost = _settings.PluginCost;
+            }
+            return node;
+        }
+
+        /// <summary>
+        /// Forgets a plugin, returning the node it was placed on or null
+        /// </summary>
+        public Address Remove(string plugin)
+        {
+            if (!_plugins.TryGetValue(plugin, out var state))
+            {
+                return null;
+            }
+            _plugins.Remove(plugin);
+            return state.Node;
+        }
+
+        public Address NodeOf(string plugin) => _plugins.TryGetValue(plugin, out var state) ? state.Node : null;
+
+        public string RoleOf(string plugin) => _plugins.TryGetValue(plugin, out var state) ? state.Role : null;
+
+        public IEnumerable<string> PluginsOn(Address address)
+            => _plugins.Where(x => address.Equals(x.Value.Node)).Select(x => x.Key).OrderBy(x => x, StringComparer.Ordinal);
+
+        /// <summary>
+        /// Reported load of a node adjusted for the plugins moved since the report
+        /// </summary>
+        public double Score(Address address)
+        {
+            var node = _nodes[address];
+            var arrivals = _plugins.Values.Where(x => address.Equals(x.Node) && x.PlacedAt > node.ReportedAt).Sum(x => x.Cost);
+            return Reported(node) + arrivals - node.Departures.Sum();
+        }
+
+        /// <summary>
+        /// Moves up to <see cref="PlacementSettings.MovesPerRound"/> plugins from
+        /// busy nodes to idle ones, largest gap first
+        /// </summary>
+        public IReadOnlyList<PlacementMove> Rebalance(DateTime now)
+        {
+            var moves = new List<PlacementMove>();
+            while (moves.Count < _settings.MovesPerRound)
+            {
+                var move = FindMove(now, out var cost);
+                if (move == null)
+                {
+                    break;
+                }
+
+                _nodes[move.From].Departures.Add(cost);
+                var state = _plugins[move.Plugin];
+                state.Node = move.To;
+                state.PlacedAt = now;
+                state.Cost = cost;
+                moves.Add(move);
+            }
+            return moves;
+        }
+
+        private PlacementMove FindMove(DateTime now, out double cost)
+        {
+            PlacementMove best = null;
+            var bestGap = 0.0;
+            cost = 0;
+
+            foreach (var plugin in _plugins.OrderBy(x => x.Key, StringComparer.Ordinal))
+            {
+                var state = plugin.Value;
+                if (state.Node == null || now - state.PlacedAt < _settings.MinimumDwell)
+                {
+                    continue;
+                }
+
+                var target = LeastLoaded(state.Role, state.Node);
+                if (target == null)
+                {
+                    continue;
+                }
+
+                var gap = Score(state.Node) - Score(target);
+                var estimate = EstimateCost(state.Node);
+
+                // The move takes the estimate off one node and adds it to the
+                // other, so it narrows the gap only if twice the estimate fits
+                if (gap > _settings.Hysteresis && 2 * estimate < gap && gap > bestGap)
+                {
+                    best = new PlacementMove(plugin.Key, state.Node, target);
+                    bestGap = gap;
+                    cost = estimate;
+                }
+            }
+            return best;
+        }
+
+        /// <summary>
+        /// Share of a node's reported load taken by each of its plugins
+        /// </summary>
+        private double EstimateCost(Address address)
+        {
+            var plugins = _plugins.Values.Count(x => address.Equals(x.Node));
+            return Math.Max(_settings.PluginCost, Reported(_nodes[address]) / Math.Max(1, plugins));
+        }
+
+        private double Reported(NodeState node)
+            => node.Load == null ? 0 : node.Load.Cpu + node.Load.MailboxDepth * _settings.MailboxWeight;
+
+        private Address LeastLoaded(string role, Address exclude)
+        {
+            Address best = null;
+            var bestScore = double.MaxValue;
+
+            foreach (var node in _nodes)
+            {
+                if (node.Key.Equals(exclude)
+                    || !node.Value.Roles.Contains(role)
+                    || (node.Value.Load != null && node.Value.Load.MemoryBytes > _settings.MemoryLimitBytes))
+                {
+                    continue;
+                }
+
+                var score = Score(node.Key);
+                if (score < bestScore || (score == bestScore && string.CompareOrdinal(node.Key.ToString(), best.ToString()) < 0))
+                {
+                    best = node.Key;
+                    bestScore = score;
+                }
+            }
+            return best;
+        }
+
+        private sealed class NodeState
+        {
+            public NodeState(IEnumerable<string> roles)
+            {
+                Roles = new HashSet<string>(roles);
+            }
+
+            public HashSet<string> Roles { get; }
+
+            public NodeLoad Load { get; set; }
+
+            public DateTime ReportedAt { get; set; } = DateTime.MinValue;
+
+            /// <summary>
+            /// Estimated costs of the plugins moved off the node since its last report
+            /// </summary>
+            public List<double> Departures { get; } = new List<double>();
+        }
+
+        private sealed class PluginState
+        {
+            public PluginState(string role)
+            {
+                Role = role;
+            }
+
+            public string Role { get; }
+
+            public Address Node { get; set; }
+
+            public DateTime PlacedAt { get; set; }
+
+            /// <summary>
+            /// Score the plugin adds to its node until the node next reports
+            /// </summary>
+            public double Cost { get; set; }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+using System;
+
+namespace AkkaLibrary.Cluster.Placement
+{
+    /// <summary>
+    /// Tuning of the <see cref="PlacementScheduler"/>
+    ///
+    /// A node's score is its processor fraction plus
+    /// <see cref="MailboxWeight"/> for every queued message, so with the
+    /// defaults a thousand queued messages weigh as much as a busy core set.
+    /// </summary>
+    public sealed class PlacementSettings
+    {
+        public static PlacementSettings Default { get; } = new PlacementSettings();
+
+        /// <param name="hysteresis">Score difference between two nodes below which no plugin is moved</param>
+        /// <param name="minimumDwell">Time a plugin stays on a node before it can be moved. Defaults to one minute.</param>
+        /// <param name="mailboxWeight">Score of one queued message</param>
+        /// <param name="pluginCost">Score assumed for a plugin placed on a node that has not reported since</param>
+        /// <param name="memoryLimitBytes">Nodes using more memory are not given plugins</param>
+        /// <param name="movesPerRound">Most plugins moved by one rebalance</param>
+        /// <param name="rebalanceInterval">Time between rebalances. Defaults to fifteen seconds.</param>
+        public PlacementSettings(
+            double hysteresis = 0.25,
+            TimeSpan? minimumDwell = null,
+            double mailboxWeight = 0.001,
+            double pluginCost = 0.1,
+            long memoryLimitBytes = long.MaxValue,
+            int movesPerRound = 1,
+            TimeSpan? rebalanceInterval = null)
+        {
+            Hysteresis = hysteresis;
+            MinimumDwell = minimumDwell ?? TimeSpan.FromMinutes(1);
+            MailboxWeight = mailboxWeight;
+            PluginCost = pluginCost;
+            MemoryLimitBytes = memoryLimitBytes;
+            MovesPerRound = movesPerRound;
+            RebalanceInterval = rebalanceInterval ?? TimeSpan.FromSeconds(15);
+        }
+
+        public double Hysteresis { get; }
+
+        public TimeSpan MinimumDwell { get; }
+
+        public double MailboxWeight { get; }
+
+        public double PluginCost { get; }
+
+        public long MemoryLimitBytes { get; }
+
+        public int MovesPerRound { get; }
+
+        public TimeSpan RebalanceInterval { get; }
+    }
+}
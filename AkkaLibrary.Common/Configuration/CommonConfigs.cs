@@ -2,6 +2,7 @@
 using System.Linq;
 using Akka.Configuration;
 using AkkaLibrary.Common.Interfaces;
+using AkkaLibrary.Common.Serialization;
 
 namespace AkkaLibrary.Common.Configuration
 {
@@ -11,6 +12,9 @@ namespace AkkaLibrary.Common.Configuration
     /// </summary>
     public static class CommonConfigs
     {
+        /// <summary>
+        /// Hyperion for all messages, except samples which use the <see cref="SampleSerializer"/>
+        /// </summary>
         public static Config BasicConfig()
             => ConfigurationFactory
                 .ParseString(
@@ -29,7 +33,8 @@ namespace AkkaLibrary.Common.Configuration
                                 ""System.Object"" = hyperion
                             }
                         }
-                    }");
+                    }")
+                .WithFallback(SampleSerializer.Configuration);
 
         /// <summary>
         /// Creates a <see cref="Config"/> from an <see cref="ILoggingConfig"/> object
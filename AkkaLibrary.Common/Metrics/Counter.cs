@@ -0,0 +1,25 @@
+using System.Threading;
+
+namespace AkkaLibrary.Common.Metrics
+{
+    /// <summary>
+    /// Monotonic lock-free count
+    /// </summary>
+    public sealed class Counter
+    {
+        private long _value;
+
+        public string Name { get; }
+
+        public long Value => Interlocked.Read(ref _value);
+
+        public Counter(string name)
+        {
+            Name = name;
+        }
+
+        public void Increment() => Interlocked.Increment(ref _value);
+
+        public void Add(long amount) => Interlocked.Add(ref _value, amount);
+    }
+}
@@ -0,0 +1,29 @@
+using System.Threading;
+
+namespace AkkaLibrary.Common.Metrics
+{
+    /// <summary>
+    /// Lock-free value that can move both ways, such as a queue depth
+    /// </summary>
+    public sealed class Gauge
+    {
+        private long _value;
+
+        public string Name { get; }
+
+        public long Value => Interlocked.Read(ref _value);
+
+        public Gauge(string name)
+        {
+            Name = name;
+        }
+
+        public void Set(long value) => Interlocked.Exchange(ref _value, value);
+
+        public void Increment() => Interlocked.Increment(ref _value);
+
+        public void Decrement() => Interlocked.Decrement(ref _value);
+
+        public void Add(long amount) => Interlocked.Add(ref _value, amount);
+    }
+}
@@ -0,0 +1,178 @@
+using System;
+using System.Diagnostics;
+using System.Threading;
+
+namespace AkkaLibrary.Common.Metrics
+{
+    /// <summary>
+    /// Lock-free log-linear histogram of latencies in microseconds
+    ///
+    /// As in HDR histograms, every power of two range is split into
+    /// <see cref="SubBuckets"/> linear buckets, so any recorded value is
+    /// reported to within 1/<see cref="SubBuckets"/> of itself using a fixed
+    /// number of counters. Recording is two interlocked operations.
+    /// </summary>
+    public sealed class LatencyHistogram
+    {
+        public const int SubBuckets = 32;
+        private const int SubBucketBits = 5;
+        private const int Magnitudes = 64 - SubBucketBits;
+
+        private static readonly double MicrosecondsPerTick = 1_000_000.0 / Stopwatch.Frequency;
+
+        private readonly long[] _buckets = new long[(Magnitudes + 1) * SubBuckets];
+        private long _count;
+        private long _max;
+
+        public string Name { get; }
+
+        public long Count => Interlocked.Read(ref _count);
+
+        public LatencyHistogram(string name)
+        {
+            Name = name;
+        }
+
+        /// <summary>
+        /// Records a latency in microseconds. Negative values are recorded as zero.
+        /// </summary>
+        public void Record(long microseconds)
+        {
+            var value = Math.Max(0, microseconds);
+            Interlocked.Increment(ref _buckets[BucketOf(value)]);
+            Interlocked.Increment(ref _count);
+
+            var max = Interlocked.Read(ref _max);
+            while(value > max)
+            {
+                var previous = Interlocked.CompareExchange(ref _max, value, max);
+                if(previous == max)
+                {
+                    break;
+                }
+                max = previous;
+            }
+        }
+
+        /// <summary>
+        /// Records the time since a <see cref="Stopwatch.GetTimestamp"/> value
+        /// </summary>
+        public void RecordSince(long timestamp) => Record((long)((Stopwatch.GetTimestamp() - timestamp) * MicrosecondsPerTick));
+
+        /// <summary>
+        /// Copies the current counts. Concurrent records may be partly included.
+        /// </summary>
+        public HistogramSnapshot Snapshot()
+        {
+            var buckets = new long[_buckets.Length];
+            for (int i = 0; i < buckets.Length; i++)
+            {
+                buckets[i] = Interlocked.Read(ref _buckets[i]);
+            }
+
+            long count = 0;
+            foreach (var bucket in buckets)
+            {
+                count += bucket;
+            }
+
+            return new HistogramSnapshot(
+                Name,
+                count,
+                Percentile(buckets, count, 0.5),
+                Percentile(buckets, count, 0.9),
+                Percentile(buckets, count, 0.99),
+                Percentile(buckets, count, 0.999),
+                Interlocked.Read(ref _max));
+        }
+
+        /// <summary>
+        /// Values below <see cref="SubBuckets"/> have their own buckets. Above
+        /// that the top <see cref="SubBucketBits"/> bits below the leading one
+        /// select the bucket within the value's power of two.
+        /// </summary>
+        internal static int BucketOf(long value)
+        {
+            if(value < SubBuckets)
+            {
+                return (int)value;
+            }
+
+            var magnitude = HighestBit(value) - SubBucketBits + 1;
+            var sub = (int)(value >> (magnitude - 1)) & (SubBuckets - 1);
+            return magnitude * SubBuckets + sub;
+        }
+
+        /// <summary>
+        /// Largest value that falls in <paramref name="bucket"/>
+        /// </summary>
+        internal static long UpperBoundOf(int bucket)
+        {
+            var magnitude = bucket / SubBuckets;
+            var sub = bucket % SubBuckets;
+            if(magnitude == 0)
+            {
+                return sub;
+            }
+
+            var shift = magnitude - 1;
+            return ((long)(SubBuckets + sub) << shift) + (1L << shift) - 1;
+        }
+
+        private static long Percentile(long[] buckets, long count, double percentile)
+        {
+            if(count == 0)
+            {
+                return 0;
+            }
+
+            var rank = (long)Math.Ceiling(percentile * count);
+            long seen = 0;
+            for (int i = 0; i < buckets.Length; i++)
+            {
+                seen += buckets[i];
+                if(seen >= rank)
+                {
+                    return UpperBoundOf(i);
+                }
+            }
+            return UpperBoundOf(buckets.Length - 1);
+        }
+
+        private static int HighestBit(long value)
+        {
+            var bit = 0;
+            for (var shift = 32; shift > 0; shift >>= 1)
+            {
+                if(value >> shift != 0)
+                {
+                    value >>= shift;
+                    bit += shift;
+                }
+            }
+            return bit;
+        }
+    }
+
+    public sealed class HistogramSnapshot
+    {
+        public string Name { get; }
+        public long Count { get; }
+        public long P50 { get; }
+        public long P90 { get; }
+        public long P99 { get; }
+        public long P999 { get; }
+        public long Max { get; }
+
+        public HistogramSnapshot(string name, long count, long p50, long p90, long p99, long p999, long max)
+        {
+            Name = name;
+            Count = count;
+            P50 = p50;
+            P90 = p90;
+            P99 = p99;
+            P999 = p999;
+            Max = max;
+        }
+    }
+}
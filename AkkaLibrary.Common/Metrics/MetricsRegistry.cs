@@ -0,0 +1,45 @@
+using System;
+using System.Collections.Concurrent;
+using System.Linq;
+using System.Threading;
+
+namespace AkkaLibrary.Common.Metrics
+{
+    /// <summary>
+    /// Named counters, gauges and latency histograms
+    ///
+    /// Metrics are created on first use and live for the life of the
+    /// registry, so stages look them up once and keep the reference.
+    /// Names are dotted, stage first, e.g. "ChannelAdjuster[/user/adjuster].QueueDepth".
+    /// Each instance of a stage publishes under its own prefix, so figures
+    /// from separate pipelines are not merged.
+    /// </summary>
+    public sealed class MetricsRegistry
+    {
+        public static MetricsRegistry Default { get; } = new MetricsRegistry();
+
+        private static int _instances;
+
+        /// <summary>
+        /// Metric prefix for an instance of a stage that has no name of its own, e.g. "FusedChannelAdjuster-3"
+        /// </summary>
+        public static string InstanceName(string stage) => $"{stage}-{Interlocked.Increment(ref _instances)}";
+
+        private readonly ConcurrentDictionary<string, Counter> _counters = new ConcurrentDictionary<string, Counter>();
+        private readonly ConcurrentDictionary<string, Gauge> _gauges = new ConcurrentDictionary<string, Gauge>();
+        private readonly ConcurrentDictionary<string, LatencyHistogram> _histograms = new ConcurrentDictionary<string, LatencyHistogram>();
+
+        public Counter Counter(string name) => _counters.GetOrAdd(name, x => new Counter(x));
+
+        public Gauge Gauge(string name) => _gauges.GetOrAdd(name, x => new Gauge(x));
+
+        public LatencyHistogram Histogram(string name) => _histograms.GetOrAdd(name, x => new LatencyHistogram(x));
+
+        public MetricsSnapshot Snapshot()
+            => new MetricsSnapshot(
+                DateTime.UtcNow,
+                _counters.Values.OrderBy(x => x.Name).ToDictionary(x => x.Name, x => x.Value),
+                _gauges.Values.OrderBy(x => x.Name).ToDictionary(x => x.Name, x => x.Value),
+                _histograms.Values.OrderBy(x => x.Name).Select(x => x.Snapshot()).ToList());
+    }
+}
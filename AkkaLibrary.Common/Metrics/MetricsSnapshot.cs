@@ -0,0 +1,28 @@
+using System;
+using System.Collections.Generic;
+
+namespace AkkaLibrary.Common.Metrics
+{
+    /// <summary>
+    /// Values of every metric in a <see cref="MetricsRegistry"/> at one time
+    /// </summary>
+    public sealed class MetricsSnapshot
+    {
+        public DateTime Time { get; }
+        public IReadOnlyDictionary<string, long> Counters { get; }
+        public IReadOnlyDictionary<string, long> Gauges { get; }
+
+        /// <summary>
+        /// Latency summaries in microseconds
+        /// </summary>
+        public IReadOnlyList<HistogramSnapshot> Histograms { get; }
+
+        public MetricsSnapshot(DateTime time, IReadOnlyDictionary<string, long> counters, IReadOnlyDictionary<string, long> gauges, IReadOnlyList<HistogramSnapshot> histograms)
+        {
+            Time = time;
+            Counters = counters;
+            Gauges = gauges;
+            Histograms = histograms;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+using System.Diagnostics;
+using System.Threading;
+
+namespace AkkaLibrary.Common.Metrics
+{
+    /// <summary>
+    /// Lock-free table of the <see cref="Stopwatch"/> time recent blocks of
+    /// samples were acquired, keyed on the block's first SampleIndex
+    ///
+    /// The acquiring stage marks each block once and later stages look it up
+    /// by sample index to record time in the pipeline. Sample indices are
+    /// only unique within a pipeline, so each pipeline has its own table. Slots are direct
+    /// mapped, so a lookup for a block that has been overwritten or was never
+    /// marked fails rather than returning another block's time.
+    /// </summary>
+    public sealed class SampleArrivals
+    {
+        public const int Capacity = 1 << 14;
+
+        private readonly long[] _sampleIndices = new long[Capacity];
+        private readonly long[] _timestamps = new long[Capacity];
+
+        public SampleArrivals()
+        {
+            for (int i = 0; i < Capacity; i++)
+            {
+                _sampleIndices[i] = -1;
+            }
+        }
+
+        public void Mark(long sampleIndex, long timestamp)
+        {
+            var slot = (int)(sampleIndex & (Capacity - 1));
+            Volatile.Write(ref _sampleIndices[slot], -1);
+            Volatile.Write(ref _timestamps[slot], timestamp);
+            Volatile.Write(ref _sampleIndices[slot], sampleIndex);
+        }
+
+        public bool TryGet(long sampleIndex, out long timestamp)
+        {
+            var slot = (int)(sampleIndex & (Capacity - 1));
+            if(Volatile.Read(ref _sampleIndices[slot]) != sampleIndex)
+            {
+                timestamp = 0;
+                return false;
+            }
+
+            timestamp = Volatile.Read(ref _timestamps[slot]);
+            return Volatile.Read(ref _sampleIndices[slot]) == sampleIndex;
+        }
+
+        /// <summary>
+        /// Records the time since <paramref name="sampleIndex"/> was acquired
+        /// in <paramref name="histogram"/> if its arrival is still known
+        /// </summary>
+        public void RecordLatency(long sampleIndex, LatencyHistogram histogram)
+        {
+            if(TryGet(sampleIndex, out var timestamp))
+            {
+                histogram.RecordSince(timestamp);
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace AkkaLibrary.Common.Objects
+{
+    /// <summary>
+    /// Immutable description of the channels carried by a <see cref="SampleBlock{TData}"/>
+    ///
+    /// A schema is created once per channel configuration and shared by every
+    /// block, so channel names and units are not repeated per sample.
+    /// </summary>
+    public sealed class ChannelSchema
+    {
+        private readonly Dictionary<string, int> _analogIndices;
+        private readonly Dictionary<string, int> _digitalIndices;
+
+        public IReadOnlyList<string> AnalogNames { get; }
+        public IReadOnlyList<Unit> AnalogUnits { get; }
+        public IReadOnlyList<string> DigitalNames { get; }
+
+        public int AnalogCount => AnalogNames.Count;
+        public int DigitalCount => DigitalNames.Count;
+
+        public ChannelSchema(IEnumerable<string> analogNames, IEnumerable<string> digitalNames)
+            : this(analogNames, null, digitalNames) { }
+
+        public ChannelSchema(IEnumerable<string> analogNames, IEnumerable<Unit> analogUnits, IEnumerable<string> digitalNames)
+        {
+            AnalogNames = analogNames.ToArray();
+            DigitalNames = digitalNames.ToArray();
+            AnalogUnits = analogUnits?.ToArray() ?? Enumerable.Repeat(Unit.None, AnalogNames.Count).ToArray();
+
+            if(AnalogUnits.Count != AnalogNames.Count)
+            {
+                throw new ArgumentException($"{AnalogUnits.Count} units given for {AnalogNames.Count} analog channels.", nameof(analogUnits));
+            }
+
+            _analogIndices = IndexNames(AnalogNames);
+            _digitalIndices = IndexNames(DigitalNames);
+        }
+
+        /// <summary>
+        /// Creates a schema describing the channels of a single sample
+        /// </summary>
+        public static ChannelSchema FromSample<TData>(ChannelData<TData> sample)
+            => new ChannelSchema(
+                sample.Analogs.Select(x => x.Name),
+                sample.Analogs.Select(x => x.Units),
+                sample.Digitals.Select(x => x.Name));
+
+        /// <summary>
+        /// True when the sample carries exactly the channels of this schema, in order
+        /// </summary>
+        public bool Describes<TData>(ChannelData<TData> sample)
+        {
+            if(sample.Analogs.Count != AnalogCount || sample.Digitals.Count != DigitalCount)
+            {
+                return false;
+            }
+
+            for (int i = 0; i < AnalogCount; i++)
+            {
+                if(sample.Analogs[i].Name != AnalogNames[i] || sample.Analogs[i].Units != AnalogUnits[i])
+                {
+                    return false;
+                }
+            }
+
+            for (int i = 0; i < DigitalCount; i++)
+            {
+                if(sample.Digitals[i].Name != DigitalNames[i])
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// Column index of the named analog channel, or -1 if it is not in the schema
+        /// </summary>
+        public int IndexOfAnalog(string name) => _analogIndices.TryGetValue(name, out var index) ? index : -1;
+
+        /// <summary>
+        /// Column index of the named digital channel, or -1 if it is not in the schema
+        /// </summary>
+        public int IndexOfDigital(string name) => _digitalIndices.TryGetValue(name, out var index) ? index : -1;
+
+        private static Dictionary<string, int> IndexNames(IReadOnlyList<string> names)
+        {
+            var indices = new Dictionary<string, int>(names.Count);
+            for (int i = 0; i < names.Count; i++)
+            {
+                if(indices.ContainsKey(names[i]))
+                {
+                    throw new ArgumentException($"Channel {names[i]} appears more than once in the schema.");
+                }
+                indices.Add(names[i], i);
+            }
+            return indices;
+        }
+    }
+}
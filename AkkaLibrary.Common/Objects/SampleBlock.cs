@@ -0,0 +1,176 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace AkkaLibrary.Common.Objects
+{
+    /// <summary>
+    /// A block of consecutive samples stored as contiguous per-channel columns
+    ///
+    /// Channel names and units live in the shared <see cref="Schema"/>. Values are
+    /// column-major, so the value of channel c for sample s is at
+    /// [c * <see cref="Length"/> + s] and each channel can be processed as one
+    /// contiguous span. The sync data of each sample is held in parallel columns.
+    /// </summary>
+    public sealed class SampleBlock<TData>
+    {
+        public ChannelSchema Schema { get; }
+
+        /// <summary>
+        /// Number of samples in the block
+        /// </summary>
+        public int Length { get; }
+
+        public TData[] Analogs { get; }
+        public bool[] Digitals { get; }
+
+        #region Sync Columns
+
+        public long[] TimeStamps { get; }
+        public uint[] TachometerCounts { get; }
+        public long[] MasterSyncIncrements { get; }
+        public bool[] MasterSyncStates { get; }
+        public long[] SampleIndices { get; }
+
+        #endregion
+
+        /// <summary>
+        /// Creates an empty block of <paramref name="length"/> samples
+        /// </summary>
+        public SampleBlock(ChannelSchema schema, int length)
+            : this(
+                schema,
+                length,
+                new TData[schema.AnalogCount * length],
+                new bool[schema.DigitalCount * length],
+                new long[length],
+                new uint[length],
+                new long[length],
+                new bool[length],
+                new long[length])
+        {
+        }
+
+        /// <summary>
+        /// Creates a block over existing columns. The arrays are not copied.
+        /// </summary>
+        public SampleBlock(
+            ChannelSchema schema,
+            int length,
+            TData[] analogs,
+            bool[] digitals,
+            long[] timestamps,
+            uint[] tachometerCounts,
+            long[] masterSyncIncrements,
+            bool[] masterSyncStates,
+            long[] sampleIndices)
+        {
+            if(length < 0)
+            {
+                throw new ArgumentException("Block length cannot be negative.", nameof(length));
+            }
+            if(analogs.Length != schema.AnalogCount * length)
+            {
+                throw new ArgumentException($"Expected {schema.AnalogCount * length} analog values but got {analogs.Length}.", nameof(analogs));
+            }
+            if(digitals.Length != schema.DigitalCount * length)
+            {
+                throw new ArgumentException($"Expected {schema.DigitalCount * length} digital values but got {digitals.Length}.", nameof(digitals));
+            }
+            if(new[] { timestamps.Length, tachometerCounts.Length, masterSyncIncrements.Length, masterSyncStates.Length, sampleIndices.Length }.Any(x => x != length))
+            {
+                throw new ArgumentException($"Every sync column must hold {length} values.");
+            }
+
+            Schema = schema;
+            Length = length;
+            Analogs = analogs;
+            Digitals = digitals;
+            TimeStamps = timestamps;
+            TachometerCounts = tachometerCounts;
+            MasterSyncIncrements = masterSyncIncrements;
+            MasterSyncStates = masterSyncStates;
+            SampleIndices = sampleIndices;
+        }
+
+        /// <summary>
+        /// Wraps a single sample as a block of length one
+        /// </summary>
+        /// <param name="sample">Sample to wrap</param>
+        /// <param name="schema">Schema shared between blocks. Must describe the sample.</param>
+        public static SampleBlock<TData> FromSample(ChannelData<TData> sample, ChannelSchema schema)
+        {
+            var block = new SampleBlock<TData>(schema, 1);
+
+            for (int c = 0; c < schema.AnalogCount; c++)
+            {
+                block.Analogs[c] = sample.Analogs[c].Value;
+            }
+            for (int c = 0; c < schema.DigitalCount; c++)
+            {
+                block.Digitals[c] = sample.Digitals[c].Value;
+            }
+
+            block.TimeStamps[0] = sample.TimeStamp;
+            block.TachometerCounts[0] = sample.TachometerCount;
+            block.MasterSyncIncrements[0] = sample.MasterSyncIncrement;
+            block.MasterSyncStates[0] = sample.MasterSyncState;
+            block.SampleIndices[0] = sample.SampleIndex;
+            return block;
+        }
+
+        /// <summary>
+        /// The values of one analog channel for every sample in the block
+        /// </summary>
+        public Span<TData> Analog(int channel) => new Span<TData>(Analogs, channel * Length, Length);
+
+        /// <summary>
+        /// The values of one digital channel for every sample in the block
+        /// </summary>
+        public Span<bool> Digital(int channel) => new Span<bool>(Digitals, channel * Length, Length);
+
+        /// <summary>
+        /// Materialises a single sample as <see cref="ChannelData{TData}"/>
+        /// for consumers that still work sample by sample
+        /// </summary>
+        public ChannelData<TData> GetSample(int sample)
+        {
+            if(sample < 0 || sample >= Length)
+            {
+                throw new ArgumentOutOfRangeException(nameof(sample));
+            }
+
+            var analogs = new List<DataChannel<TData>>(Schema.AnalogCount);
+            for (int c = 0; c < Schema.AnalogCount; c++)
+            {
+                analogs.Add(new DataChannel<TData>(Schema.AnalogNames[c], Analogs[c * Length + sample], Schema.AnalogUnits[c]));
+            }
+
+            var digitals = new List<DataChannel<bool>>(Schema.DigitalCount);
+            for (int c = 0; c < Schema.DigitalCount; c++)
+            {
+                digitals.Add(new DataChannel<bool>(Schema.DigitalNames[c], Digitals[c * Length + sample]));
+            }
+
+            return new ChannelData<TData>(
+                analogs,
+                digitals,
+                TimeStamps[sample],
+                TachometerCounts[sample],
+                MasterSyncIncrements[sample],
+                MasterSyncStates[sample],
+                SampleIndices[sample]);
+        }
+
+        /// <summary>
+        /// Materialises every sample in the block in order
+        /// </summary>
+        public IEnumerable<ChannelData<TData>> ToChannelData()
+        {
+            for (int s = 0; s < Length; s++)
+            {
+                yield return GetSample(s);
+            }
+        }
+    }
+}
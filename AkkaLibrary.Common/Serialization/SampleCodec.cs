@@ -0,0 +1,590 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Runtime.Serialization;
+using AkkaLibrary.Common.BaseClasses;
+using AkkaLibrary.Common.Objects;
+using AkkaLibrary.Common.Utilities;
+
+namespace AkkaLibrary.Common.Serialization
+{
+    /// <summary>
+    /// Compact binary encoding of <see cref="ChannelData{TData}"/>, <see cref="FpgaSample"/>
+    /// and <see cref="SampleBlock{TData}"/>
+    ///
+    /// Each message starts with a type tag and the id of its <see cref="WireSchema"/>.
+    /// The sync fields and values follow as packed little-endian columns, with
+    /// booleans packed eight to a byte. Channel names are only sent when a
+    /// schema is announced: with the first message that uses it and then once
+    /// per announce interval, so receivers that join later learn it. Other
+    /// messages carry the id alone, and the decoder resolves it from the
+    /// schemas it has cached; an id it has not seen announced is rejected
+    /// with a <see cref="SerializationException"/>, which remoting logs and
+    /// drops. Decoded blocks with the same channels share one <see cref="ChannelSchema"/>.
+    ///
+    /// At most <see cref="MaxSchemas"/> schemas are cached; the cache is
+    /// emptied when it is full and schemas are learned again from their next
+    /// announcement. The codec is thread safe.
+    /// </summary>
+    public sealed class SampleCodec
+    {
+        private const byte ChannelDataTag = 1;
+        private const byte FpgaSampleTag = 2;
+        private const byte SampleBlockTag = 3;
+
+        private const byte SingleCode = 1;
+        private const byte DoubleCode = 2;
+        private const byte Int16Code = 3;
+        private const byte Int32Code = 4;
+        private const byte Int64Code = 5;
+        private const byte UInt32Code = 6;
+
+        // Tag, value code, schema id and schema length
+        private const int HeaderSize = 10;
+        private const int SchemaLengthOffset = 6;
+
+        /// <summary>
+        /// Most schemas the codec caches before it empties its cache
+        /// </summary>
+        public const int MaxSchemas = 1024;
+
+        // Timestamp, tacho, master sync increment, master sync state and sample index
+        private const int SyncSize = 29;
+
+        private readonly ConcurrentDictionary<uint, WireSchema> _schemas = new ConcurrentDictionary<uint, WireSchema>();
+        private readonly ConcurrentDictionary<uint, long> _announced = new ConcurrentDictionary<uint, long>();
+        private readonly long _announceTicks;
+        private readonly ConditionalWeakTable<ChannelSchema, WireSchema> _blockSchemas = new ConditionalWeakTable<ChannelSchema, WireSchema>();
+        private readonly ConditionalWeakTable<ChannelSchema, WireSchema>.CreateValueCallback _createBlockSchema;
+
+        // Consecutive samples almost always have the same channels
+        [ThreadStatic] private static WireSchema _lastChannels;
+        [ThreadStatic] private static WireSchema _lastFpga;
+
+        /// <summary>
+        /// Types the codec can encode
+        /// </summary>
+        public static IReadOnlyList<Type> SupportedTypes { get; } = new[]
+        {
+            typeof(ChannelData<float>),
+            typeof(ChannelData<double>),
+            typeof(ChannelData<short>),
+            typeof(ChannelData<int>),
+            typeof(ChannelData<long>),
+            typeof(ChannelData<uint>),
+            typeof(FpgaSample),
+            typeof(SampleBlock<float>),
+            typeof(SampleBlock<double>)
+        };
+
+        public SampleCodec() : this(TimeSpan.FromSeconds(1))
+        {
+        }
+
+        /// <param name="announceInterval">How often the channel names of a schema in use are sent again</param>
+        public SampleCodec(TimeSpan announceInterval)
+        {
+            _announceTicks = (long)(announceInterval.TotalSeconds * Stopwatch.Frequency);
+            _createBlockSchema = channels => Intern(WireSchema.FromChannels(channels));
+        }
+
+        /// <summary>
+        /// Number of schema bytes an encoded message carries, zero unless it announces its schema
+        /// </summary>
+        public static int SchemaLength(byte[] message)
+        {
+            if(message.Length < HeaderSize)
+            {
+                throw new ArgumentException("Message is truncated.", nameof(message));
+            }
+            return BitConverter.ToInt32(message, SchemaLengthOffset);
+        }
+
+        public byte[] Encode(object message)
+        {
+            switch(message)
+            {
+                case ChannelData<float> sample: return EncodeChannelData(sample, SingleCode);
+                case ChannelData<double> sample: return EncodeChannelData(sample, DoubleCode);
+                case ChannelData<short> sample: return EncodeChannelData(sample, Int16Code);
+                case ChannelData<int> sample: return EncodeChannelData(sample, Int32Code);
+                case ChannelData<long> sample: return EncodeChannelData(sample, Int64Code);
+                case ChannelData<uint> sample: return EncodeChannelData(sample, UInt32Code);
+                case FpgaSample sample: return EncodeFpgaSample(sample);
+                case SampleBlock<float> block: return EncodeSampleBlock(block, SingleCode);
+                case SampleBlock<double> block: return EncodeSampleBlock(block, DoubleCode);
+                default:
+                    throw new ArgumentException($"Cannot encode {message?.GetType().Name ?? "null"}.", nameof(message));
+            }
+        }
+
+        public object Decode(byte[] bytes)
+        {
+            var reader = new Reader(bytes);
+            var tag = reader.ReadByte();
+            var code = reader.ReadByte();
+            var schema = ReadSchema(ref reader);
+
+            if((tag == FpgaSampleTag ? schema.Groups : (object)schema.Channels) == null)
+            {
+                throw new ArgumentException($"Message tag {tag} does not match the kind of its schema.", nameof(bytes));
+            }
+
+            switch(tag)
+            {
+                case ChannelDataTag:
+                    switch(code)
+                    {
+                        case SingleCode: return DecodeChannelData<float>(ref reader, schema);
+                        case DoubleCode: return DecodeChannelData<double>(ref reader, schema);
+                        case Int16Code: return DecodeChannelData<short>(ref reader, schema);
+                        case Int32Code: return DecodeChannelData<int>(ref reader, schema);
+                        case Int64Code: return DecodeChannelData<long>(ref reader, schema);
+                        case UInt32Code: return DecodeChannelData<uint>(ref reader, schema);
+                    }
+                    break;
+
+                case FpgaSampleTag:
+                    return DecodeFpgaSample(ref reader, schema);
+
+                case SampleBlockTag:
+                    switch(code)
+                    {
+                        case SingleCode: return DecodeSampleBlock<float>(ref reader, schema);
+                        case DoubleCode: return DecodeSampleBlock<double>(ref reader, schema);
+                    }
+                    break;
+            }
+            throw new ArgumentException($"Unknown message tag {tag} with value code {code}.", nameof(bytes));
+        }
+
+        #region ChannelData
+
+        private byte[] EncodeChannelData<TData>(ChannelData<TData> sample, byte code)
+        {
+            var schema = _lastChannels;
+            if(schema == null || !schema.Describes(sample))
+            {
+                schema = Intern(WireSchema.FromChannels(ChannelSchema.FromSample(sample)));
+                _lastChannels = schema;
+            }
+
+            var analogs = sample.Analogs;
+            var digitals = sample.Digitals;
+            var announced = Announce(schema);
+            var writer = new Writer(new byte[HeaderSize + announced.Length + SyncSize + analogs.Count * Unsafe.SizeOf<TData>() + Bits(digitals.Count)]);
+
+            WriteHeader(ref writer, ChannelDataTag, code, schema, announced);
+            WriteSync(ref writer, sample);
+            for (int i = 0; i < analogs.Count; i++)
+            {
+                writer.Write(analogs[i].Value);
+            }
+
+            var bits = writer.Reserve(Bits(digitals.Count));
+            for (int i = 0; i < digitals.Count; i++)
+            {
+                writer.SetBit(bits, i, digitals[i].Value);
+            }
+            return writer.Bytes;
+        }
+
+        private static ChannelData<TData> DecodeChannelData<TData>(ref Reader reader, WireSchema schema)
+        {
+            var channels = schema.Channels;
+            var (timestamp, tacho, msi, mss, sampleIndex) = ReadSync(ref reader);
+
+            var analogs = new DataChannel<TData>[channels.AnalogCount];
+            for (int i = 0; i < analogs.Length; i++)
+            {
+                analogs[i] = new DataChannel<TData>(channels.AnalogNames[i], reader.Read<TData>(), channels.AnalogUnits[i]);
+            }
+
+            var digitals = new DataChannel<bool>[channels.DigitalCount];
+            var bits = reader.Position;
+            reader.Skip(Bits(digitals.Length));
+            for (int i = 0; i < digitals.Length; i++)
+            {
+                digitals[i] = new DataChannel<bool>(channels.DigitalNames[i], reader.Bit(bits, i));
+            }
+
+            return new ChannelData<TData>(analogs, digitals, timestamp, tacho, msi, mss, sampleIndex);
+        }
+
+        #endregion
+
+        #region FpgaSample
+
+        private byte[] EncodeFpgaSample(FpgaSample sample)
+        {
+            var schema = _lastFpga;
+            if(schema == null || !schema.Describes(sample))
+            {
+                schema = Intern(WireSchema.FromGroups(WireSchema.GroupsOf(sample)));
+                _lastFpga = schema;
+            }
+
+            var announced = Announce(schema);
+            var size = HeaderSize + announced.Length + SyncSize
+                       + sample.UInt32s.Count * 4
+                       + sample.Int16s.Count * 2
+                       + sample.Int24s.Count * 3
+                       + sample.Int32s.Count * 4
+                       + sample.Floats.Count * 4
+                       + sample.Doubles.Count * 8
+                       + Bits(sample.Bools.Count);
+            var writer = new Writer(new byte[size]);
+
+            WriteHeader(ref writer, FpgaSampleTag, 0, schema, announced);
+            WriteSync(ref writer, sample);
+            WriteGroup(ref writer, sample.UInt32s);
+            WriteGroup(ref writer, sample.Int16s);
+            for (int i = 0; i < sample.Int24s.Count; i++)
+            {
+                writer.WriteInt24(sample.Int24s[i].value);
+            }
+            WriteGroup(ref writer, sample.Int32s);
+            WriteGroup(ref writer, sample.Floats);
+            WriteGroup(ref writer, sample.Doubles);
+
+            var bits = writer.Reserve(Bits(sample.Bools.Count));
+            for (int i = 0; i < sample.Bools.Count; i++)
+            {
+                writer.SetBit(bits, i, sample.Bools[i].value);
+            }
+            return writer.Bytes;
+        }
+
+        private static FpgaSample DecodeFpgaSample(ref Reader reader, WireSchema schema)
+        {
+            var groups = schema.Groups;
+            var (timestamp, tacho, msi, mss, sampleIndex) = ReadSync(ref reader);
+
+            var uint32s = ReadGroup<uint>(ref reader, groups[0]);
+            var int16s = ReadGroup<short>(ref reader, groups[1]);
+
+            var int24s = new List<(string, Int24)>(groups[2].Length);
+            foreach (var name in groups[2])
+            {
+                int24s.Add((name, reader.ReadInt24()));
+            }
+
+            var int32s = ReadGroup<int>(ref reader, groups[3]);
+            var floats = ReadGroup<float>(ref reader, groups[4]);
+            var doubles = ReadGroup<double>(ref reader, groups[5]);
+
+            var bools = new List<(string, bool)>(groups[6].Length);
+            var bits = reader.Position;
+            reader.Skip(Bits(groups[6].Length));
+            for (int i = 0; i < groups[6].Length; i++)
+            {
+                bools.Add((groups[6][i], reader.Bit(bits, i)));
+            }
+
+            return new FpgaSample(timestamp, tacho, msi, mss, sampleIndex, uint32s, int16s, int24s, int32s, floats, doubles, bools);
+        }
+
+        private static void WriteGroup<T>(ref Writer writer, IReadOnlyList<(string name, T value)> values)
+        {
+            for (int i = 0; i < values.Count; i++)
+            {
+                writer.Write(values[i].value);
+            }
+        }
+
+        private static List<(string, T)> ReadGroup<T>(ref Reader reader, string[] names)
+        {
+            var values = new List<(string, T)>(names.Length);
+            foreach (var name in names)
+            {
+                values.Add((name, reader.Read<T>()));
+            }
+            return values;
+        }
+
+        #endregion
+
+        #region SampleBlock
+
+        private byte[] EncodeSampleBlock<TData>(SampleBlock<TData> block, byte code)
+        {
+            var schema = _blockSchemas.GetValue(block.Schema, _createBlockSchema);
+            var length = block.Length;
+            var announced = Announce(schema);
+
+            var size = HeaderSize + announced.Length + 4
+                       + length * (8 + 4 + 8 + 8)
+                       + Bits(length)
+                       + block.Analogs.Length * Unsafe.SizeOf<TData>()
+                       + Bits(block.Digitals.Length);
+            var writer = new Writer(new byte[size]);
+
+            WriteHeader(ref writer, SampleBlockTag, code, schema, announced);
+            writer.Write(length);
+            writer.WriteColumn(block.TimeStamps);
+            writer.WriteColumn(block.TachometerCounts);
+            writer.WriteColumn(block.MasterSyncIncrements);
+            writer.WriteBits(block.MasterSyncStates);
+            writer.WriteColumn(block.SampleIndices);
+            writer.WriteColumn(block.Analogs);
+            writer.WriteBits(block.Digitals);
+            return writer.Bytes;
+        }
+
+        private static SampleBlock<TData> DecodeSampleBlock<TData>(ref Reader reader, WireSchema schema)
+        {
+            var channels = schema.Channels;
+            var length = reader.Read<int>();
+
+            var timestamps = reader.ReadColumn<long>(length);
+            var tachos = reader.ReadColumn<uint>(length);
+            var increments = reader.ReadColumn<long>(length);
+            var states = reader.ReadBits(length);
+            var indices = reader.ReadColumn<long>(length);
+            var analogs = reader.ReadColumn<TData>(channels.AnalogCount * length);
+            var digitals = reader.ReadBits(channels.DigitalCount * length);
+
+            return new SampleBlock<TData>(channels, length, analogs, digitals, timestamps, tachos, increments, states, indices);
+        }
+
+        #endregion
+
+        #region Schemas
+
+        /// <summary>
+        /// The cached schema with the same bytes, caching this one if there is none
+        /// </summary>
+        private WireSchema Intern(WireSchema schema)
+        {
+            TrimCache();
+            var cached = _schemas.GetOrAdd(schema.Id, schema);
+            return SameBytes(cached.Bytes, schema.Bytes, 0) ? cached : schema;
+        }
+
+        /// <summary>
+        /// The schema bytes to send with the next message, empty unless the
+        /// schema is new or was last announced an interval ago
+        /// </summary>
+        private byte[] Announce(WireSchema schema)
+        {
+            var now = Stopwatch.GetTimestamp();
+            if(_announced.TryGetValue(schema.Id, out var last) && now - last < _announceTicks)
+            {
+                return Array.Empty<byte>();
+            }
+
+            _announced[schema.Id] = now;
+            return schema.Bytes;
+        }
+
+        private void TrimCache()
+        {
+            if(_schemas.Count >= MaxSchemas || _announced.Count >= MaxSchemas)
+            {
+                _schemas.Clear();
+                _announced.Clear();
+            }
+        }
+
+        private static void WriteHeader(ref Writer writer, byte tag, byte code, WireSchema schema, byte[] announced)
+        {
+            writer.Write(tag);
+            writer.Write(code);
+            writer.Write(schema.Id);
+            writer.Write(announced.Length);
+            writer.WriteColumn(announced);
+        }
+
+        private WireSchema ReadSchema(ref Reader reader)
+        {
+            var id = reader.Read<uint>();
+            var length = reader.Read<int>();
+            var offset = reader.Position;
+            reader.Skip(length);
+
+            var known = _schemas.TryGetValue(id, out var cached);
+            if(length == 0)
+            {
+                if(!known)
+                {
+                    throw new SerializationException($"Sample schema {id:X8} has not been announced.");
+                }
+                return cached;
+            }
+
+            if(known && cached.Bytes.Length == length && SameBytes(cached.Bytes, reader.Buffer, offset))
+            {
+                return cached;
+            }
+
+            var schema = WireSchema.Parse(reader.Buffer, offset, length);
+            TrimCache();
+            _schemas[id] = schema;
+            return schema;
+        }
+
+        private static bool SameBytes(byte[] schema, byte[] buffer, int offset)
+            => buffer.Length - offset >= schema.Length
+               && new ReadOnlySpan<byte>(schema).SequenceEqual(new ReadOnlySpan<byte>(buffer, offset, schema.Length));
+
+        #endregion
+
+        private static void WriteSync(ref Writer writer, SyncableBase sample)
+        {
+            writer.Write(sample.TimeStamp);
+            writer.Write(sample.TachometerCount);
+            writer.Write(sample.MasterSyncIncrement);
+            writer.Write(sample.MasterSyncState);
+            writer.Write(sample.SampleIndex);
+        }
+
+        private static (long, uint, long, bool, long) ReadSync(ref Reader reader)
+            => (reader.Read<long>(), reader.Read<uint>(), reader.Read<long>(), reader.Read<bool>(), reader.Read<long>());
+
+        private static int Bits(int count) => (count + 7) / 8;
+
+        /// <summary>
+        /// Writes values in host byte order, which the serializer checks is little-endian
+        /// </summary>
+        private struct Writer
+        {
+            public byte[] Bytes { get; }
+            private int _position;
+
+            public Writer(byte[] bytes)
+            {
+                Bytes = bytes;
+                _position = 0;
+            }
+
+            public void Write<T>(T value)
+            {
+                var size = Unsafe.SizeOf<T>();
+                if(_position + size > Bytes.Length)
+                {
+                    throw new IndexOutOfRangeException();
+                }
+                Unsafe.WriteUnaligned(ref Bytes[_position], value);
+                _position += size;
+            }
+
+            public void WriteInt24(int value)
+            {
+                Bytes[_position] = (byte)value;
+                Bytes[_position + 1] = (byte)(value >> 8);
+                Bytes[_position + 2] = (byte)(value >> 16);
+                _position += 3;
+            }
+
+            public void WriteColumn<T>(T[] values)
+            {
+                var size = values.Length * Unsafe.SizeOf<T>();
+                if(_position + size > Bytes.Length)
+                {
+                    throw new IndexOutOfRangeException();
+                }
+                if(size > 0)
+                {
+                    Unsafe.CopyBlockUnaligned(ref Bytes[_position], ref Unsafe.As<T, byte>(ref values[0]), (uint)size);
+                }
+                _position += size;
+            }
+
+            /// <summary>
+            /// Skips <paramref name="count"/> bytes to be filled in later, returning where they start
+            /// </summary>
+            public int Reserve(int count)
+            {
+                var start = _position;
+                _position += count;
+                return start;
+            }
+
+            public void SetBit(int start, int index, bool value)
+            {
+                if(value)
+                {
+                    Bytes[start + (index >> 3)] |= (byte)(1 << (index & 7));
+                }
+            }
+
+            public void WriteBits(bool[] values)
+            {
+                var start = Reserve(Bits(values.Length));
+                for (int i = 0; i < values.Length; i++)
+                {
+                    SetBit(start, i, values[i]);
+                }
+            }
+        }
+
+        private struct Reader
+        {
+            public byte[] Buffer { get; }
+            public int Position { get; private set; }
+
+            public Reader(byte[] buffer)
+            {
+                Buffer = buffer;
+                Position = 0;
+            }
+
+            public void Skip(int count)
+            {
+                if(count < 0 || Position + count > Buffer.Length)
+                {
+                    throw new ArgumentException("Message is truncated.");
+                }
+                Position += count;
+            }
+
+            public byte ReadByte() => Read<byte>();
+
+            public T Read<T>()
+            {
+                var position = Position;
+                Skip(Unsafe.SizeOf<T>());
+                return Unsafe.ReadUnaligned<T>(ref Buffer[position]);
+            }
+
+            public Int24 ReadInt24()
+            {
+                var position = Position;
+                Skip(3);
+                return new Int24(Buffer[position] | Buffer[position + 1] << 8 | (sbyte)Buffer[position + 2] << 16);
+            }
+
+            public T[] ReadColumn<T>(int count)
+            {
+                var values = new T[count];
+                var size = count * Unsafe.SizeOf<T>();
+                var position = Position;
+                Skip(size);
+                if(size > 0)
+                {
+                    Unsafe.CopyBlockUnaligned(ref Unsafe.As<T, byte>(ref values[0]), ref Buffer[position], (uint)size);
+                }
+                return values;
+            }
+
+            /// <summary>
+            /// Bit <paramref name="index"/> of the bits starting at <paramref name="start"/>
+            /// </summary>
+            public bool Bit(int start, int index) => (Buffer[start + (index >> 3)] & (1 << (index & 7))) != 0;
+
+            public bool[] ReadBits(int count)
+            {
+                var values = new bool[count];
+                var start = Position;
+                Skip(Bits(count));
+                for (int i = 0; i < count; i++)
+                {
+                    values[i] = Bit(start, i);
+                }
+                return values;
+            }
+        }
+    }
+}
@@ -0,0 +1,51 @@
+using System;
+using System.Linq;
+using Akka.Actor;
+using Akka.Configuration;
+using Akka.Serialization;
+
+namespace AkkaLibrary.Common.Serialization
+{
+    /// <summary>
+    /// Akka serializer for samples and sample blocks, using <see cref="SampleCodec"/>
+    ///
+    /// Add <see cref="Configuration"/> as a fallback to the system config to
+    /// bind it to every type in <see cref="SampleCodec.SupportedTypes"/>.
+    /// </summary>
+    public sealed class SampleSerializer : Serializer
+    {
+        private readonly SampleCodec _codec = new SampleCodec();
+
+        /// <summary>
+        /// Registers the serializer and binds the sample types to it
+        /// </summary>
+        public static Config Configuration { get; } = ConfigurationFactory.ParseString(
+            $@"akka.actor
+            {{
+                serializers
+                {{
+                    samples = ""{typeof(SampleSerializer).FullName}, {typeof(SampleSerializer).Assembly.GetName().Name}""
+                }}
+                serialization-bindings
+                {{
+                    {string.Join(Environment.NewLine, SampleCodec.SupportedTypes.Select(x => $@"""{x.AssemblyQualifiedName}"" = samples"))}
+                }}
+            }}");
+
+        public SampleSerializer(ExtendedActorSystem system) : base(system)
+        {
+            if(!BitConverter.IsLittleEndian)
+            {
+                throw new NotSupportedException("Samples are encoded in host byte order, which must be little-endian.");
+            }
+        }
+
+        public override int Identifier => 701;
+
+        public override bool IncludeManifest => false;
+
+        public override byte[] ToBinary(object obj) => _codec.Encode(obj);
+
+        public override object FromBinary(byte[] bytes, Type type) => _codec.Decode(bytes);
+    }
+}
@@ -0,0 +1,254 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using AkkaLibrary.Common.Objects;
+
+namespace AkkaLibrary.Common.Serialization
+{
+    /// <summary>
+    /// Channel names of a sample type, encoded once and shared by every
+    /// message with the same channels
+    ///
+    /// The id is the FNV-1a hash of the encoded bytes, so every node derives
+    /// the same id for the same channels without coordination.
+    /// </summary>
+    internal sealed class WireSchema
+    {
+        public const byte ChannelsKind = 1;
+        public const byte FpgaKind = 2;
+
+        /// <summary>
+        /// Number of name groups in an <see cref="FpgaSample"/>, in the order
+        /// UInt32s, Int16s, Int24s, Int32s, Floats, Doubles, Bools
+        /// </summary>
+        public const int FpgaGroups = 7;
+
+        public uint Id { get; }
+
+        public byte[] Bytes { get; }
+
+        /// <summary>
+        /// Analog and digital channels of a <see cref="ChannelData{TData}"/> or
+        /// <see cref="SampleBlock{TData}"/> schema
+        /// </summary>
+        public ChannelSchema Channels { get; }
+
+        /// <summary>
+        /// Name groups of an <see cref="FpgaSample"/> schema
+        /// </summary>
+        public string[][] Groups { get; }
+
+        private WireSchema(byte[] bytes, ChannelSchema channels, string[][] groups)
+        {
+            Id = Hash(bytes);
+            Bytes = bytes;
+            Channels = channels;
+            Groups = groups;
+        }
+
+        public static WireSchema FromChannels(ChannelSchema channels)
+        {
+            var bytes = new List<byte> { ChannelsKind };
+            WriteCount(bytes, channels.AnalogCount);
+            for (int i = 0; i < channels.AnalogCount; i++)
+            {
+                bytes.Add((byte)channels.AnalogUnits[i]);
+                WriteName(bytes, channels.AnalogNames[i]);
+            }
+            WriteCount(bytes, channels.DigitalCount);
+            foreach (var name in channels.DigitalNames)
+            {
+                WriteName(bytes, name);
+            }
+            return new WireSchema(bytes.ToArray(), channels, null);
+        }
+
+        public static WireSchema FromGroups(string[][] groups)
+        {
+            var bytes = new List<byte> { FpgaKind };
+            foreach (var group in groups)
+            {
+                WriteCount(bytes, group.Length);
+                foreach (var name in group)
+                {
+                    WriteName(bytes, name);
+                }
+            }
+            return new WireSchema(bytes.ToArray(), null, groups);
+        }
+
+        /// <summary>
+        /// Decodes a schema written by <see cref="FromChannels"/> or <see cref="FromGroups"/>
+        /// </summary>
+        /// <exception cref="ArgumentException">The schema is truncated or of an unknown kind</exception>
+        public static WireSchema Parse(byte[] buffer, int offset, int length)
+        {
+            var bytes = new byte[length];
+            Array.Copy(buffer, offset, bytes, 0, length);
+            var position = 0;
+            Need(bytes, position, 1);
+            position++;
+
+            switch(bytes[0])
+            {
+                case ChannelsKind:
+                {
+                    var analogs = ReadCount(bytes, ref position);
+                    var names = new string[analogs];
+                    var units = new Unit[analogs];
+                    for (int i = 0; i < analogs; i++)
+                    {
+                        Need(bytes, position, 1);
+                        units[i] = (Unit)bytes[position++];
+                        names[i] = ReadName(bytes, ref position);
+                    }
+                    var digitals = new string[ReadCount(bytes, ref position)];
+                    for (int i = 0; i < digitals.Length; i++)
+                    {
+                        digitals[i] = ReadName(bytes, ref position);
+                    }
+                    return new WireSchema(bytes, new ChannelSchema(names, units, digitals), null);
+                }
+
+                case FpgaKind:
+                {
+                    var groups = new string[FpgaGroups][];
+                    for (int g = 0; g < FpgaGroups; g++)
+                    {
+                        groups[g] = new string[ReadCount(bytes, ref position)];
+                        for (int i = 0; i < groups[g].Length; i++)
+                        {
+                            groups[g][i] = ReadName(bytes, ref position);
+                        }
+                    }
+                    return new WireSchema(bytes, null, groups);
+                }
+
+                default:
+                    throw new ArgumentException($"Unknown schema kind {bytes[0]}.");
+            }
+        }
+
+        /// <summary>
+        /// True when the analog names, units and digital names of the sample are those of this schema
+        /// </summary>
+        public bool Describes<TData>(ChannelData<TData> sample)
+        {
+            var channels = Channels;
+            if(channels == null || sample.Analogs.Count != channels.AnalogCount || sample.Digitals.Count != channels.DigitalCount)
+            {
+                return false;
+            }
+            for (int i = 0; i < channels.AnalogCount; i++)
+            {
+                var analog = sample.Analogs[i];
+                if(analog.Units != channels.AnalogUnits[i] || !string.Equals(analog.Name, channels.AnalogNames[i]))
+                {
+                    return false;
+                }
+            }
+            for (int i = 0; i < channels.DigitalCount; i++)
+            {
+                if(!string.Equals(sample.Digitals[i].Name, channels.DigitalNames[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// True when the names in each group of the sample are those of this schema
+        /// </summary>
+        public bool Describes(FpgaSample sample)
+            => Groups != null
+               && Matches(Groups[0], sample.UInt32s)
+               && Matches(Groups[1], sample.Int16s)
+               && Matches(Groups[2], sample.Int24s)
+               && Matches(Groups[3], sample.Int32s)
+               && Matches(Groups[4], sample.Floats)
+               && Matches(Groups[5], sample.Doubles)
+               && Matches(Groups[6], sample.Bools);
+
+        public static string[][] GroupsOf(FpgaSample sample)
+            => new[]
+            {
+                sample.UInt32s.Select(x => x.name).ToArray(),
+                sample.Int16s.Select(x => x.name).ToArray(),
+                sample.Int24s.Select(x => x.name).ToArray(),
+                sample.Int32s.Select(x => x.name).ToArray(),
+                sample.Floats.Select(x => x.name).ToArray(),
+                sample.Doubles.Select(x => x.name).ToArray(),
+                sample.Bools.Select(x => x.name).ToArray()
+            };
+
+        private static bool Matches<T>(string[] names, IReadOnlyList<(string name, T value)> values)
+        {
+            if(names.Length != values.Count)
+            {
+                return false;
+            }
+            for (int i = 0; i < names.Length; i++)
+            {
+                if(!string.Equals(names[i], values[i].name))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        private static void WriteCount(List<byte> bytes, int count)
+        {
+            if(count > ushort.MaxValue)
+            {
+                throw new ArgumentException($"{count} channels is more than a schema can hold.");
+            }
+            bytes.Add((byte)count);
+            bytes.Add((byte)(count >> 8));
+        }
+
+        private static int ReadCount(byte[] bytes, ref int position)
+        {
+            Need(bytes, position, 2);
+            var count = bytes[position] | bytes[position + 1] << 8;
+            position += 2;
+            return count;
+        }
+
+        private static void WriteName(List<byte> bytes, string name)
+        {
+            var encoded = Encoding.UTF8.GetBytes(name ?? string.Empty);
+            WriteCount(bytes, encoded.Length);
+            bytes.AddRange(encoded);
+        }
+
+        private static string ReadName(byte[] bytes, ref int position)
+        {
+            var length = ReadCount(bytes, ref position);
+            Need(bytes, position, length);
+            var name = Encoding.UTF8.GetString(bytes, position, length);
+            position += length;
+            return name;
+        }
+
+        private static void Need(byte[] bytes, int position, int count)
+        {
+            if(position + count > bytes.Length)
+            {
+                throw new ArgumentException("Message is truncated.");
+            }
+        }
+
+        private static uint Hash(byte[] bytes)
+        {
+            var hash = 2166136261;
+            foreach (var b in bytes)
+            {
+                hash = (hash ^ b) * 16777619;
+            }
+            return hash;
+        }
+    }
+}
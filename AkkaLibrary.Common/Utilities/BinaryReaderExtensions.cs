@@ -16,8 +16,11 @@ namespace AkkaLibrary.Common.Utilities
         /// <returns><see cref="Int24"/></returns>
         public static Int24 ReadInt24(this BinaryReader reader)
         {
-            var bytes = reader.ReadBytes(3);
-            return Int24.GetValue(bytes, 0);
+            // Little-endian low word followed by the signed high byte,
+            // read without allocating an intermediate array
+            var low = reader.ReadUInt16();
+            var high = reader.ReadSByte();
+            return new Int24(high << 16 | low);
         }
 
         /// <summary>
@@ -0,0 +1,101 @@
+using System;
+using System.Buffers.Binary;
+
+namespace AkkaLibrary.Common.Utilities
+{
+    /// <summary>
+    /// Bulk conversion of packed little-endian 24-bit integers
+    /// into sign-extended <see cref="int"/> or scaled <see cref="float"/> values
+    /// </summary>
+    /// <remarks>
+    /// This is the managed scalar path. Each value is read with a single unaligned
+    /// 32-bit load and sign-extended with a shift pair, avoiding the per-value
+    /// allocation and range checks of <see cref="Int24"/>.
+    /// </remarks>
+    public static class Int24Converter
+    {
+        /// <summary>
+        /// Size in bytes of a packed 24-bit value
+        /// </summary>
+        public const int BytesPerValue = 3;
+
+        /// <summary>
+        /// Converts packed 24-bit values into sign-extended 32-bit integers
+        /// </summary>
+        /// <param name="source">Packed little-endian 24-bit values</param>
+        /// <param name="destination">Destination for the converted values</param>
+        /// <returns>The number of values converted</returns>
+        public static int ToInt32(ReadOnlySpan<byte> source, Span<int> destination)
+        {
+            var count = CountOf(source, destination.Length);
+
+            // Every value except the last can be read with a 4 byte load without
+            // running past the end of the source
+            var i = 0;
+            for (; i < count - 1; i++)
+            {
+                destination[i] = BinaryPrimitives.ReadInt32LittleEndian(source.Slice(i * BytesPerValue)) << 8 >> 8;
+            }
+
+            if (i < count)
+            {
+                destination[i] = Read(source, i);
+            }
+
+            return count;
+        }
+
+        /// <summary>
+        /// Converts packed 24-bit values into scaled single precision floats
+        /// </summary>
+        /// <param name="source">Packed little-endian 24-bit values</param>
+        /// <param name="destination">Destination for the converted values</param>
+        /// <param name="scale">Multiplier applied to each value</param>
+        /// <returns>The number of values converted</returns>
+        public static int ToSingle(ReadOnlySpan<byte> source, Span<float> destination, float scale = 1f)
+        {
+            var count = CountOf(source, destination.Length);
+
+            var i = 0;
+            for (; i < count - 1; i++)
+            {
+                destination[i] = (BinaryPrimitives.ReadInt32LittleEndian(source.Slice(i * BytesPerValue)) << 8 >> 8) * scale;
+            }
+
+            if (i < count)
+            {
+                destination[i] = Read(source, i) * scale;
+            }
+
+            return count;
+        }
+
+        /// <summary>
+        /// Reads a single packed 24-bit value
+        /// </summary>
+        /// <param name="source">Packed little-endian 24-bit values</param>
+        /// <param name="index">Index of the value, not the byte offset</param>
+        /// <returns>The sign-extended value</returns>
+        public static int Read(ReadOnlySpan<byte> source, int index)
+        {
+            var offset = index * BytesPerValue;
+            return (source[offset] << 8 | source[offset + 1] << 16 | source[offset + 2] << 24) >> 8;
+        }
+
+        private static int CountOf(ReadOnlySpan<byte> source, int destinationLength)
+        {
+            if (source.Length % BytesPerValue != 0)
+            {
+                throw new ArgumentException($"Source length {source.Length} is not a multiple of {BytesPerValue}", nameof(source));
+            }
+
+            var count = source.Length / BytesPerValue;
+            if (destinationLength < count)
+            {
+                throw new ArgumentException($"Destination holds {destinationLength} values but {count} are required", "destination");
+            }
+
+            return count;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+using System;
+using Akka.Actor;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Logging;
+using AkkaLibrary.Hardware.Managers;
+using AkkaLibrary.Hardware.StaticWrappers;
+using FluentAssertions;
+using Moq;
+using Xunit;
+
+namespace AkkaLibrary.Hardware.Test
+{
+    public class BlinktManagerSpecs : TestKit
+    {
+        public BlinktManagerSpecs()
+        {
+            Serilog.Log.Logger = LoggerFactory.Logger;
+        }
+
+        [Fact]
+        public void ImmediateModePassesEachMessageThrough()
+        {
+            var controllerMock = new Mock<IBlinktController>();
+            controllerMock.Setup(x => x.Initialise()).Returns(true);
+
+            var manager = Sys.ActorOf(Props.Create(() => new BlinktManager(null, controllerMock.Object)));
+
+            manager.Tell(new BlinktManager.OnPixel(1, 255, 0, 0));
+            manager.Tell(new BlinktManager.OnPixel(2, 0, 255, 0));
+            manager.Tell(BlinktManager.GetStatistics.Instance, TestActor);
+
+            ExpectMsg<BlinktManager.Statistics>().MessagesApplied.Should().Be(2);
+
+            controllerMock.Verify(x => x.OnPixel(It.IsAny<short>(), It.IsAny<short>(), It.IsAny<short>(), It.IsAny<short>()), Times.Exactly(2));
+            controllerMock.Verify(x => x.SetFrame(It.IsAny<byte[]>()), Times.Never);
+        }
+
+        [Fact]
+        public void BurstIsCoalescedIntoSingleFrame()
+        {
+            var controllerMock = new Mock<IBlinktController>();
+            controllerMock.Setup(x => x.Initialise()).Returns(true);
+            controllerMock.Setup(x => x.SetFrame(It.IsAny<byte[]>())).Returns(true);
+
+            var manager = Sys.ActorOf(BlinktManager.GetProps(TimeSpan.FromMilliseconds(500), controllerMock.Object));
+
+            for (short i = 0; i < 100; i++)
+            {
+                manager.Tell(new BlinktManager.OnPixel((short)(i % 8), i, i, i));
+            }
+
+            AwaitAssert(() =>
+                controllerMock.Verify(x => x.SetFrame(It.IsAny<byte[]>()), Times.Once),
+                TimeSpan.FromSeconds(3));
+
+            manager.Tell(BlinktManager.GetStatistics.Instance, TestActor);
+
+            var stats = ExpectMsg<BlinktManager.Statistics>();
+            stats.MessagesApplied.Should().Be(100);
+            stats.FramesRendered.Should().Be(1);
+            stats.FramesCoalesced.Should().Be(99);
+            stats.PeakMessagesPerFrame.Should().Be(100);
+
+            controllerMock.Verify(x => x.OnPixel(It.IsAny<short>(), It.IsAny<short>(), It.IsAny<short>(), It.IsAny<short>()), Times.Never);
+        }
+
+        [Fact]
+        public void SetPixelWithoutUpdateDoesNotRender()
+        {
+            var controllerMock = new Mock<IBlinktController>();
+            controllerMock.Setup(x => x.Initialise()).Returns(true);
+
+            var manager = Sys.ActorOf(BlinktManager.GetProps(TimeSpan.FromMilliseconds(50), controllerMock.Object));
+
+            manager.Tell(new BlinktManager.SetPixel(0, 10, 20, 30));
+
+            ExpectNoMsg(TimeSpan.FromMilliseconds(300));
+
+            controllerMock.Verify(x => x.SetFrame(It.IsAny<byte[]>()), Times.Never);
+
+            manager.Tell(new BlinktManager.Update());
+
+            AwaitAssert(() =>
+                controllerMock.Verify(x => x.SetFrame(It.Is<byte[]>(f => f[0] == 10 && f[1] == 20 && f[2] == 30)), Times.Once),
+                TimeSpan.FromSeconds(3));
+        }
+    }
+}
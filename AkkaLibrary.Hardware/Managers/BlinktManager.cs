@@ -1,3 +1,4 @@
+using System;
 using Akka.Actor;
 using AkkaLibrary.Hardware.Exceptions;
 using AkkaLibrary.Hardware.StaticWrappers;
@@ -6,37 +7,221 @@ namespace AkkaLibrary.Hardware.Managers
 {
     /// <summary>
     /// Manager for a BlinktPhat
+    /// 
+    /// Without a render interval every message is passed straight through to
+    /// the controller. With a render interval, messages are applied to an
+    /// in-actor frame and the frame is rendered at most once per tick so that
+    /// bursts of messages cost a single hardware update
     /// </summary>
     public class BlinktManager : ReceiveActor
     {
-        private readonly BlinktPhat _manager;
+        private readonly IBlinktController _manager;
+        private readonly byte[] _frame;
+        private readonly ICancelable _renderSchedule;
+        private bool _renderRequested;
+        private long _messagesApplied;
+        private long _messagesSinceLastFrame;
+        private long _peakMessagesPerFrame;
+        private long _framesRendered;
+        private long _framesCoalesced;
 
-        public BlinktManager()
+        /// <summary>
+        /// Brightness used for all pixel updates
+        /// </summary>
+        private const byte Brightness = 3;
+
+        public BlinktManager() : this(null, null) { }
+
+        /// <summary>
+        /// Constructor
+        /// </summary>
+        /// <param name="renderInterval">
+        /// Minimum time between hardware updates. If null, each message
+        /// updates the hardware immediately
+        /// </param>
+        /// <param name="controller">Blinkt controller. Defaults to the singleton</param>
+        public BlinktManager(TimeSpan? renderInterval, IBlinktController controller = null)
         {
-            if(BlinktPhat.Instance.Initialise())
+            _manager = controller ?? BlinktPhat.Instance;
+            if(!_manager.Initialise())
             {
                 throw new HardwareInitialisationException();
             }
-            _manager = BlinktPhat.Instance;
 
-            Receive<On>(msg => _manager.OnAll(msg.Red, msg.Green, msg.Blue));
+            if(renderInterval.HasValue)
+            {
+                _frame = new byte[BlinktPhat.PixelCount * BlinktPhat.BytesPerPixel];
+                _renderSchedule = Context.System.Scheduler.ScheduleTellRepeatedlyCancelable(
+                                    renderInterval.Value, renderInterval.Value, Self, RenderTick.Instance, Self);
+                Coalescing();
+            }
+            else
+            {
+                Immediate();
+            }
+
+            Receive<GetStatistics>(msg => Sender.Tell(new Statistics(
+                                                        _messagesApplied,
+                                                        _messagesSinceLastFrame,
+                                                        _peakMessagesPerFrame,
+                                                        _framesRendered,
+                                                        _framesCoalesced)));
+        }
+
+        /// <summary>
+        /// Creates props for a manager that renders at most once per
+        /// <paramref name="renderInterval"/>
+        /// </summary>
+        public static Props GetProps(TimeSpan renderInterval, IBlinktController controller = null)
+            => Props.Create(() => new BlinktManager(renderInterval, controller));
+
+        /// <summary>
+        /// Each message is passed straight to the controller
+        /// </summary>
+        private void Immediate()
+        {
+            Receive<On>(msg =>
+            {
+                _manager.OnAll(msg.Red, msg.Green, msg.Blue);
+                Applied();
+            });
+
+            Receive<Off>(msg =>
+            {
+                _manager.OffAll();
+                Applied();
+            });
+
+            Receive<OnPixel>(msg =>
+            {
+                _manager.OnPixel(msg.Pixel, msg.Red, msg.Green, msg.Blue);
+                Applied();
+            });
+
+            Receive<OffPixel>(msg =>
+            {
+                _manager.OffPixel(msg.Pixel);
+                Applied();
+            });
+
+            Receive<SetPixel>(msg =>
+            {
+                _manager.SetPixel(msg.Pixel, msg.Red, msg.Green, msg.Blue);
+                Applied();
+            });
+
+            Receive<SetPixels>(msg =>
+            {
+                _manager.SetPixels(msg.Red, msg.Green, msg.Blue);
+                Applied();
+            });
+
+            Receive<Update>(msg =>
+            {
+                _manager.Update();
+                Applied();
+            });
+        }
+
+        /// <summary>
+        /// Messages are applied to the frame and rendered on the next tick
+        /// </summary>
+        private void Coalescing()
+        {
+            Receive<On>(msg =>
+            {
+                for (short pixel = 0; pixel < BlinktPhat.PixelCount; pixel++)
+                {
+                    WritePixel(pixel, msg.Red, msg.Green, msg.Blue);
+                }
+                RequestRender();
+            });
+
+            Receive<Off>(msg =>
+            {
+                Array.Clear(_frame, 0, _frame.Length);
+                RequestRender();
+            });
+
+            Receive<OnPixel>(msg =>
+            {
+                WritePixel(msg.Pixel, msg.Red, msg.Green, msg.Blue);
+                RequestRender();
+            });
+
+            Receive<OffPixel>(msg =>
+            {
+                WritePixel(msg.Pixel, 0, 0, 0);
+                RequestRender();
+            });
 
-            Receive<Off>(msg => _manager.OffAll());
+            Receive<SetPixel>(msg =>
+            {
+                WritePixel(msg.Pixel, msg.Red, msg.Green, msg.Blue);
+                Applied();
+            });
 
-            Receive<OnPixel>(msg => _manager.OnPixel(msg.Pixel, msg.Red, msg.Green, msg.Blue));
+            Receive<SetPixels>(msg =>
+            {
+                for (short pixel = 0; pixel < BlinktPhat.PixelCount; pixel++)
+                {
+                    WritePixel(pixel, msg.Red, msg.Green, msg.Blue);
+                }
+                Applied();
+            });
 
-            Receive<OffPixel>(msg => _manager.OffPixel(msg.Pixel));
+            Receive<Update>(msg => RequestRender());
 
-            Receive<SetPixel>(msg => _manager.SetPixel(msg.Pixel, msg.Red, msg.Green, msg.Blue));
+            Receive<RenderTick>(msg =>
+            {
+                if(!_renderRequested)
+                {
+                    return;
+                }
 
-            Receive<SetPixels>(msg => _manager.SetPixels(msg.Red, msg.Green, msg.Blue));
+                _manager.SetFrame(_frame);
+                _renderRequested = false;
+                ++_framesRendered;
+                _peakMessagesPerFrame = Math.Max(_peakMessagesPerFrame, _messagesSinceLastFrame);
+                _messagesSinceLastFrame = 0;
+            });
+        }
+
+        private void WritePixel(short pixel, short red, short green, short blue)
+        {
+            if(pixel < 0 || pixel >= BlinktPhat.PixelCount)
+            {
+                return;
+            }
 
-            Receive<Update>(msg => _manager.Update());
+            var offset = pixel * BlinktPhat.BytesPerPixel;
+            _frame[offset] = (byte)red;
+            _frame[offset + 1] = (byte)green;
+            _frame[offset + 2] = (byte)blue;
+            _frame[offset + 3] = Brightness;
+        }
+
+        private void RequestRender()
+        {
+            // A render already pending for this tick absorbs this request
+            if(_renderRequested)
+            {
+                ++_framesCoalesced;
+            }
+            _renderRequested = true;
+            Applied();
+        }
+
+        private void Applied()
+        {
+            ++_messagesApplied;
+            ++_messagesSinceLastFrame;
         }
 
         public override void AroundPostStop()
         {
-            BlinktPhat.Instance.Shutdown();
+            _renderSchedule?.Cancel();
+            _manager.Shutdown();
         }
 
         #region Messages
@@ -129,6 +314,65 @@ namespace AkkaLibrary.Hardware.Managers
         /// </summary>
         public sealed class Update { }
 
+        /// <summary>
+        /// Requests the manager counters. Replied to with <see cref="Statistics"/>
+        /// </summary>
+        public sealed class GetStatistics
+        {
+            public static GetStatistics Instance { get; } = new GetStatistics();
+            private GetStatistics() { }
+        }
+
+        /// <summary>
+        /// Snapshot of the manager counters
+        /// </summary>
+        public sealed class Statistics
+        {
+            /// <summary>
+            /// Total pixel messages applied
+            /// </summary>
+            public long MessagesApplied { get; }
+
+            /// <summary>
+            /// Messages applied since the last rendered frame. This is the
+            /// backlog drained from the mailbox during the current tick
+            /// </summary>
+            public long MessagesSinceLastFrame { get; }
+
+            /// <summary>
+            /// Largest number of messages applied between two rendered frames
+            /// </summary>
+            public long PeakMessagesPerFrame { get; }
+
+            /// <summary>
+            /// Frames sent to the hardware
+            /// </summary>
+            public long FramesRendered { get; }
+
+            /// <summary>
+            /// Render requests absorbed into an already pending frame
+            /// </summary>
+            public long FramesCoalesced { get; }
+
+            public Statistics(long messagesApplied, long messagesSinceLastFrame, long peakMessagesPerFrame, long framesRendered, long framesCoalesced)
+            {
+                MessagesApplied = messagesApplied;
+                MessagesSinceLastFrame = messagesSinceLastFrame;
+                PeakMessagesPerFrame = peakMessagesPerFrame;
+                FramesRendered = framesRendered;
+                FramesCoalesced = framesCoalesced;
+            }
+        }
+
+        /// <summary>
+        /// Scheduled to self once per render interval
+        /// </summary>
+        private sealed class RenderTick
+        {
+            public static RenderTick Instance { get; } = new RenderTick();
+            private RenderTick() { }
+        }
+
         /// <summary>
         /// Adds a Pixel property
         /// </summary>
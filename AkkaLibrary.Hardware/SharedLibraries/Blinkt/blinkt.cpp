@@ -115,6 +115,22 @@ int set_pixel(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b, uint8_t br)
 	return 0;
 }
 
+int set_frame(uint8_t values[])
+{
+	if(!initialised)
+	{
+		return 1;
+	}
+	// The frame is NUM_LEDS groups of r, g, b and brightness
+	for (int pixel = 0; pixel < NUM_LEDS; pixel++)
+	{
+		uint8_t *p = &values[pixel * 4];
+		pixels.setP(p[0], p[1], p[2], p[3], pixel);
+	}
+	pixels.show();
+	return 0;
+}
+
 int update()
 {
 	if(!initialised)
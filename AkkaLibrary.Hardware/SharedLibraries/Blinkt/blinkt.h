@@ -31,6 +31,9 @@ extern "C"
 	int set_pixel(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b, uint8_t br);
 	int update();
 
+	// Sets every pixel from a packed r,g,b,brightness frame and shows it
+	int set_frame(uint8_t values[]);
+
 	// void fade(int millisecs = 500);
 	// void rise(int millisecs = 500, int brightnesss = 3);   //! arbitrary number
 	// void crossfade(PixelList otherParent, int steps = 5);      //! more arbitrary numbers
@@ -1,5 +1,6 @@
 #include "low_level.h" // <bcm2835.h>, <stdint.h>
 #include "config.h"    // NUM_LEDs (and other goodies to pass onwards)
+#include "../Trace/trace.h"
 
 void writeByte(uint8_t byte){
 	int n;
@@ -22,6 +23,8 @@ void flushBuffer(int length)
      Default length is NUM_LEDS as defined in config.h
   ********************************************************************** **/
 
+  TRACE_SCOPE_BYTES(BitBangFlush, (length/2) + 1);
+
   for (int i =0; i < (length/2) + 1; i++)  // initial guess at length of buffer needed
     {
       writeByte(0);
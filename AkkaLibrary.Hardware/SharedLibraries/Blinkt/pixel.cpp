@@ -1,6 +1,7 @@
 #include <iostream>
 #include "pixel.h"
 #include <unistd.h> // usleep
+#include "../Trace/trace.h"
 
 uint8_t Pixel::defaultBrightness = 3;
 
@@ -182,18 +183,24 @@ Pixel temp = pVector[x];
 
 void PixelList::show()
 {
-  writeByte(0);
-  writeByte(0);
-  writeByte(0);
-  writeByte(0);  // ensure clear buffer
+  TRACE_SCOPE_BYTES(BlinktShow, 4 + NUM_LEDS * 4 + NUM_LEDS / 2 + 1);
 
-  for (int n = 0; n < NUM_LEDS; n++)
-    { 	   writeByte(APA_SOF | (pVector[n].getPixel() & 0b11111));
+  {
+    TRACE_SCOPE_BYTES(BitBangWrite, 4 + NUM_LEDS * 4);
+
+    writeByte(0);
+    writeByte(0);
+    writeByte(0);
+    writeByte(0);  // ensure clear buffer
+
+    for (int n = 0; n < NUM_LEDS; n++)
+      { 	   writeByte(APA_SOF | (pVector[n].getPixel() & 0b11111));
 	   writeByte(pVector[n].getPixel() >> 8 & 0xFF);
 	   writeByte(pVector[n].getPixel() >> 16 & 0xFF);
 	   writeByte(pVector[n].getPixel() >> 24 & 0xFF);
 
 	   // increment count
-    }
+      }
+  }
   flushBuffer();
 }
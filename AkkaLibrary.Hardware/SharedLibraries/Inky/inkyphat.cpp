@@ -8,6 +8,7 @@
 #include <stdlib.h>
 
 #include "inkyphat.h"
+#include "../Trace/trace.h"
 
 using namespace std;
 
@@ -90,6 +91,8 @@ InkyPhat::InkyPhat()
 // Display initialisation
 int InkyPhat::_display_init()
 {
+    TRACE_SCOPE(DisplayInit);
+
     reset();
 
     _send_command(0x74, 0x54); // Set analog control block
@@ -116,6 +119,8 @@ int InkyPhat::_display_init()
 // self._display_update = self._v2_update
 int InkyPhat::_display_update(vector<uint8_t> buf_black, vector<uint8_t> buf_red)
 {
+    TRACE_SCOPE_BYTES(DisplayUpdate, buf_black.size() + buf_red.size());
+
     vector<uint8_t> xRamData{0x00, 0x0c};
     _send_command(0x44, xRamData); // Set RAM X address
     vector<uint8_t> yRamData{0x00, 0x00, 0xD3, 0x00, 0x00};
@@ -194,10 +199,14 @@ int InkyPhat::_display_update(vector<uint8_t> buf_black, vector<uint8_t> buf_red
 
     _send_command(0x26, buf_red);
 
-    _send_command(0x22, 0xc7); // Display update setting
-    _send_command(0x20); // Display update activate
-    usleep(50);
-    _busy_wait();
+    {
+        TRACE_SCOPE(DisplayRefresh);
+
+        _send_command(0x22, 0xc7); // Display update setting
+        _send_command(0x20); // Display update activate
+        usleep(50);
+        _busy_wait();
+    }
 
     return 0;
 }
@@ -220,58 +229,64 @@ int InkyPhat::update(vector< vector< uint8_t > > pixels)
     vector<uint8_t> red_buffer;
     vector<uint8_t> black_buffer;
 
-    // For each row, create a single value
-    for(vector< vector<uint8_t> >::iterator col_it = pixels.begin(); col_it != pixels.end(); col_it++ )
     {
-        int count = 0;
+        TRACE_SCOPE(InkyPack);
+
+        // For each row, create a single value
+        for(vector< vector<uint8_t> >::iterator col_it = pixels.begin(); col_it != pixels.end(); col_it++ )
+        {
+            int count = 0;
         
-        // Start with empty value
-        uint8_t redValue = 0;
-        uint8_t blackValue = 0;
+            // Start with empty value
+            uint8_t redValue = 0;
+            uint8_t blackValue = 0;
         
-        for (vector<uint8_t>::iterator row_it = (*col_it).begin(); row_it != (*col_it).end(); row_it++)
-        {
-            uint8_t value = *row_it;
-            // If the value equals RED, it's considered TRUE otherwise FALSE
-            if(value == RED)
-            {
-                // If RED, add one and shift left
-                redValue <<= 1;
-                redValue += 1;
-            }
-            else
+            for (vector<uint8_t>::iterator row_it = (*col_it).begin(); row_it != (*col_it).end(); row_it++)
             {
-                // If not RED, just shift left
-                redValue <<= 1;
-            }
-            if(value == BLACK)
-            {
-                // If BLACK, just shift left
-                blackValue <<= 1;
-            }
-            else
-            {
-                // If not BLACK, shift left and add 1
-                blackValue <<= 1;
-                blackValue += 1;
-            }
-
-            if(++count == 8)
-            {
-                // Push the bytes into respective vectors
-                red_buffer.push_back(redValue);
-                black_buffer.push_back(blackValue);
-
-                // Reset the bytes
-                redValue = 0;
-                blackValue = 0;
-                count = 0;
+                uint8_t value = *row_it;
+                // If the value equals RED, it's considered TRUE otherwise FALSE
+                if(value == RED)
+                {
+                    // If RED, add one and shift left
+                    redValue <<= 1;
+                    redValue += 1;
+                }
+                else
+                {
+                    // If not RED, just shift left
+                    redValue <<= 1;
+                }
+                if(value == BLACK)
+                {
+                    // If BLACK, just shift left
+                    blackValue <<= 1;
+                }
+                else
+                {
+                    // If not BLACK, shift left and add 1
+                    blackValue <<= 1;
+                    blackValue += 1;
+                }
+
+                if(++count == 8)
+                {
+                    // Push the bytes into respective vectors
+                    red_buffer.push_back(redValue);
+                    black_buffer.push_back(blackValue);
+
+                    // Reset the bytes
+                    redValue = 0;
+                    blackValue = 0;
+                    count = 0;
+                }
             }
         }
     }
 
+    #ifdef DEBUG
     cout << "BlackBuffer Length:" << black_buffer.size() << endl;
     cout << "RedBuffer Length:" << red_buffer.size() << endl;
+    #endif
 
     _display_update(black_buffer, red_buffer);
 
@@ -282,6 +297,8 @@ int InkyPhat::update(vector< vector< uint8_t > > pixels)
 int InkyPhat::_busy_wait()
 {
     //Wait for the e-paper driver to be ready to receive commands/data.
+    TRACE_SCOPE(BusyWait);
+
     int wait_for = LOW;
     
     while( digitalRead(busy_pin) != wait_for )
@@ -294,6 +311,8 @@ int InkyPhat::_busy_wait()
 int InkyPhat::reset()
 {
     //Send a reset signal to the e-paper driver.
+    TRACE_SCOPE(DisplayReset);
+
     digitalWrite(reset_pin, LOW);
     usleep(100);
     digitalWrite(reset_pin, HIGH);
@@ -340,6 +359,8 @@ int InkyPhat::_send_data(vector<uint8_t> data)
 
 int InkyPhat::_spi_write(uint8_t level, vector<uint8_t> data)
 {
+    TRACE_SCOPE_BYTES(SpiWrite, data.size());
+
     digitalWrite(command_pin, level);
     uint8_t arr[data.size()];
     copy(data.begin(), data.end(), arr);
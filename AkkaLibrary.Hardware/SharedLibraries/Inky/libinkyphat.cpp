@@ -1,5 +1,6 @@
 // Local headers
 #include "libinkyphat.h"
+#include "../Trace/trace.h"
 #include<iostream>
 
 
@@ -64,7 +65,7 @@ extern "C"
             return 1;
         }
 
-        cout << "ValuesSize:" << valuesSize << endl;
+        TRACE_SCOPE_BYTES(InkyDraw, valuesSize);
 
         // // The data is expected as a single array that is 104x212 long
         // int length = sizeof(values) / sizeof(values[0]);
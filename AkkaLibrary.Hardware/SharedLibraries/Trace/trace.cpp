@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <limits>
+
+#include "trace.h"
+
+namespace trace
+{
+    std::atomic<bool> enabled(false);
+
+    namespace
+    {
+        const char* const names[EventCount] =
+        {
+            "show",
+            "bitbang_write",
+            "bitbang_flush",
+            "draw",
+            "pack",
+            "display_init",
+            "display_update",
+            "display_refresh",
+            "display_reset",
+            "busy_wait",
+            "spi_write"
+        };
+
+        const char* const categories[EventCount] =
+        {
+            "blinkt", "blinkt", "blinkt",
+            "inky", "inky", "inky", "inky", "inky", "inky", "inky", "inky"
+        };
+
+        // Events kept per thread. Must be a power of two.
+        const uint64_t RingSize = 4096;
+
+        const uint64_t NoMinimum = std::numeric_limits<uint64_t>::max();
+
+        // Fields are atomic so that a dump can read them while the owning thread
+        // writes. sequence is the ring index plus one once the entry is written
+        // and zero while it is being overwritten.
+        struct Entry
+        {
+            std::atomic<uint64_t> sequence;
+            std::atomic<uint64_t> start_ns;
+            std::atomic<uint64_t> duration_ns;
+            std::atomic<uint32_t> bytes;
+            std::atomic<uint16_t> event;
+        };
+
+        // Updated only by the owning thread, so a relaxed load then store is
+        // enough without a read-modify-write. Atomic so trace_stats can read
+        // them while the owner writes.
+        struct Stat
+        {
+            std::atomic<uint64_t> count;
+            std::atomic<uint64_t> total_ns;
+            std::atomic<uint64_t> min_ns;
+            std::atomic<uint64_t> max_ns;
+            std::atomic<uint64_t> bytes;
+        };
+
+        // Ring of one thread. Rings are never freed, so readers can walk the
+        // list without locks, and a thread that exits leaves its events behind.
+        struct Ring
+        {
+            long tid;
+            std::atomic<uint64_t> head;
+            Entry entries[RingSize];
+            Stat stats[EventCount];
+            Ring* next;
+        };
+
+        std::atomic<Ring*> rings(nullptr);
+        thread_local Ring* local = nullptr;
+
+        inline void bump(std::atomic<uint64_t>& value, uint64_t amount)
+        {
+            value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        void clear(Ring* ring)
+        {
+            for(int i = 0; i < EventCount; i++)
+            {
+                Stat& stat = ring->stats[i];
+                stat.count.store(0, std::memory_order_relaxed);
+                stat.total_ns.store(0, std::memory_order_relaxed);
+                stat.min_ns.store(NoMinimum, std::memory_order_relaxed);
+                stat.max_ns.store(0, std::memory_order_relaxed);
+                stat.bytes.store(0, std::memory_order_relaxed);
+            }
+            ring->head.store(0, std::memory_order_release);
+        }
+
+        Ring* local_ring()
+        {
+            if(!local)
+            {
+                Ring* ring = new Ring();
+                ring->tid = syscall(SYS_gettid);
+                clear(ring);
+
+                Ring* head = rings.load(std::memory_order_relaxed);
+                do
+                {
+                    ring->next = head;
+                } while(!rings.compare_exchange_weak(head, ring, std::memory_order_release, std::memory_order_relaxed));
+
+                local = ring;
+            }
+            return local;
+        }
+    }
+
+    void record(Event event, uint64_t start_ns, uint64_t end_ns, uint32_t bytes)
+    {
+        Ring* ring = local_ring();
+        uint64_t duration = end_ns - start_ns;
+
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        Entry& entry = ring->entries[head & (RingSize - 1)];
+        entry.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        entry.start_ns.store(start_ns, std::memory_order_relaxed);
+        entry.duration_ns.store(duration, std::memory_order_relaxed);
+        entry.bytes.store(bytes, std::memory_order_relaxed);
+        entry.event.store(event, std::memory_order_relaxed);
+        entry.sequence.store(head + 1, std::memory_order_release);
+        ring->head.store(head + 1, std::memory_order_release);
+
+        Stat& stat = ring->stats[event];
+        bump(stat.count, 1);
+        bump(stat.total_ns, duration);
+        bump(stat.bytes, bytes);
+        if(duration < stat.min_ns.load(std::memory_order_relaxed))
+        {
+            stat.min_ns.store(duration, std::memory_order_relaxed);
+        }
+        if(duration > stat.max_ns.load(std::memory_order_relaxed))
+        {
+            stat.max_ns.store(duration, std::memory_order_relaxed);
+        }
+    }
+}
+
+using namespace trace;
+
+extern "C"
+{
+    void trace_enable(int enable)
+    {
+        enabled.store(enable != 0, std::memory_order_relaxed);
+    }
+
+    void trace_reset()
+    {
+        for(Ring* ring = rings.load(std::memory_order_acquire); ring; ring = ring->next)
+        {
+            clear(ring);
+        }
+    }
+
+    const char* trace_event_name(int event)
+    {
+        return event >= 0 && event < EventCount ? names[event] : nullptr;
+    }
+
+    int trace_stats(TraceStat* stats, int capacity)
+    {
+        int written = 0;
+        for(int i = 0; i < EventCount && written < capacity; i++)
+        {
+            TraceStat total = { i, 0, 0, NoMinimum, 0, 0, 0 };
+            for(Ring* ring = rings.load(std::memory_order_acquire); ring; ring = ring->next)
+            {
+                Stat& stat = ring->stats[i];
+                total.count += stat.count.load(std::memory_order_relaxed);
+                total.total_ns += stat.total_ns.load(std::memory_order_relaxed);
+                total.bytes += stat.bytes.load(std::memory_order_relaxed);
+                uint64_t min = stat.min_ns.load(std::memory_order_relaxed);
+                uint64_t max = stat.max_ns.load(std::memory_order_relaxed);
+                total.min_ns = min < total.min_ns ? min : total.min_ns;
+                total.max_ns = max > total.max_ns ? max : total.max_ns;
+            }
+
+            if(total.count > 0)
+            {
+                total.mean_ns = total.total_ns / total.count;
+                stats[written++] = total;
+            }
+        }
+        return written;
+    }
+
+    int trace_dump(const char* path)
+    {
+        FILE* file = fopen(path, "w");
+        if(!file)
+        {
+            return -1;
+        }
+
+        int written = 0;
+        int pid = getpid();
+        fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+        for(Ring* ring = rings.load(std::memory_order_acquire); ring; ring = ring->next)
+        {
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            uint64_t first = head > RingSize ? head - RingSize : 0;
+
+            for(uint64_t i = first; i < head; i++)
+            {
+                Entry& entry = ring->entries[i & (RingSize - 1)];
+                if(entry.sequence.load(std::memory_order_acquire) != i + 1)
+                {
+                    continue;
+                }
+
+                uint64_t start = entry.start_ns.load(std::memory_order_relaxed);
+                uint64_t duration = entry.duration_ns.load(std::memory_order_relaxed);
+                uint32_t bytes = entry.bytes.load(std::memory_order_relaxed);
+                uint16_t event = entry.event.load(std::memory_order_relaxed);
+
+                // The owner may have wrapped round and overwritten this entry while it was copied
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(entry.sequence.load(std::memory_order_relaxed) != i + 1 || event >= EventCount)
+                {
+                    continue;
+                }
+
+                fprintf(file,
+                    "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%ld,\"args\":{\"bytes\":%u}}",
+                    written ? "," : "",
+                    names[event], categories[event],
+                    start / 1000.0, duration / 1000.0,
+                    pid, ring->tid, bytes);
+                written++;
+            }
+        }
+
+        fprintf(file, "]}\n");
+        if(fclose(file) != 0)
+        {
+            return -1;
+        }
+        return written;
+    }
+}
@@ -0,0 +1,121 @@
+// Include Guard
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+
+/*
+    Low overhead tracing of the hardware libraries.
+
+    Every traced operation records its start, duration and bytes into a ring
+    buffer owned by the calling thread, so recording takes no locks. Tracing
+    is off until trace_enable(1) is called and costs a single relaxed load
+    while off. Building with -DNO_TRACE removes it altogether.
+
+    Each library links its own copy, so the internals are hidden to keep the
+    copies in libblinkt and libinkyphat apart when both are loaded.
+ */
+
+#define TRACE_HIDDEN __attribute__((visibility("hidden")))
+
+namespace trace
+{
+    // Traced operations. Keep in step with the names in trace.cpp.
+    enum Event : uint16_t
+    {
+        BlinktShow,
+        BitBangWrite,
+        BitBangFlush,
+        InkyDraw,
+        InkyPack,
+        DisplayInit,
+        DisplayUpdate,
+        DisplayRefresh,
+        DisplayReset,
+        BusyWait,
+        SpiWrite,
+        EventCount
+    };
+
+    TRACE_HIDDEN extern std::atomic<bool> enabled;
+
+    TRACE_HIDDEN void record(Event event, uint64_t start_ns, uint64_t end_ns, uint32_t bytes);
+
+    inline uint64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Records the lifetime of the scope as one event
+    class Scope
+    {
+      private:
+        Event event;
+        uint32_t bytes;
+        uint64_t start;
+
+      public:
+        Scope(Event event, uint32_t bytes = 0)
+            : event(event), bytes(bytes), start(enabled.load(std::memory_order_relaxed) ? now_ns() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if(start)
+            {
+                record(event, start, now_ns(), bytes);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef NO_TRACE
+    #define TRACE_SCOPE(event)
+    #define TRACE_SCOPE_BYTES(event, bytes)
+#else
+    #define TRACE_SCOPE(event) trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(trace::event)
+    #define TRACE_SCOPE_BYTES(event, bytes) trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(trace::event, (bytes))
+#endif
+
+// Aggregate statistics of one event since the last reset
+struct TraceStat
+{
+    int32_t event;
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t mean_ns;
+    uint64_t max_ns;
+    uint64_t bytes;
+};
+
+extern "C"
+{
+    // Turns tracing on (non-zero) or off
+    void trace_enable(int enable);
+
+    // Clears statistics and buffered events. Only call while no traced call is running.
+    void trace_reset();
+
+    // Name of an event, or null if out of range
+    const char* trace_event_name(int event);
+
+    // Copies the statistics of every event that occurred, returning how many were copied
+    int trace_stats(TraceStat* stats, int capacity);
+
+    // Writes the buffered events to a Chrome/Perfetto trace file, returning
+    // the number written or -1 if the file could not be written
+    int trace_dump(const char* path);
+}
+
+#endif // TRACE_H
@@ -7,8 +7,18 @@ namespace AkkaLibrary.Hardware.StaticWrappers
     /// Singleton around the BlinktPhat wrapper that provides logging and
     /// thread-safety
     /// </summary>
-    public class BlinktPhat
+    public class BlinktPhat : IBlinktController
     {
+        /// <summary>
+        /// Number of pixels on the Blinkt Phat
+        /// </summary>
+        public static readonly int PixelCount = 8;
+
+        /// <summary>
+        /// Number of bytes per pixel in a frame passed to <see cref="SetFrame"/>
+        /// </summary>
+        public static readonly int BytesPerPixel = 4;
+
         // The singleton instance
         private static BlinktPhat _instance;
 
@@ -35,7 +45,7 @@ namespace AkkaLibrary.Hardware.StaticWrappers
         {
             lock(_lock)
             {
-                if (_running)
+                if (!_running)
                 {
                     if (BlinktPhatWrapper.Initialise() == 0 ? _running = true: _running = false)
                     {
@@ -260,5 +270,71 @@ namespace AkkaLibrary.Hardware.StaticWrappers
                 return false;
             }
         }
+
+        /// <summary>
+        /// Sets every pixel from a packed frame of (r,g,b,brightness) bytes and
+        /// shows it, taking the lock once for the whole frame
+        /// </summary>
+        /// <returns>true if called correctly, false otherwise</returns>
+        public bool SetFrame(byte[] frame)
+        {
+            lock(_lock)
+            {
+                if (_running)
+                {
+                    if(frame.Length != PixelCount * BytesPerPixel)
+                    {
+                        _logger.Error("SetFrame called with {Length} bytes. Expected {Expected}", frame.Length, PixelCount * BytesPerPixel);
+                        return false;
+                    }
+
+                    if(BlinktPhatWrapper.SetFrame(frame) == 0)
+                    {
+                        _logger.Debug("SetFrame called");
+                        return true;
+                    }
+                    else
+                    {
+                        _logger.Error("SetFrame exited incorrectly");
+                        return false;
+                    }
+                }
+                _logger.Warning("SetFrame called while not running");
+                return false;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Controller interface for BlinktPhat
+    /// </summary>
+    public interface IBlinktController
+    {
+        /// <summary>
+        /// Initialises the Blinkt controller
+        /// </summary>
+        /// <returns>True if initialised</returns>
+        bool Initialise();
+
+        /// <summary>
+        /// Uninitialises and frees resources associated with Blinkt
+        /// </summary>
+        /// <returns>True if shutdown successfully</returns>
+        bool Shutdown();
+
+        bool OnAll(short r, short g, short b);
+        bool OnPixel(short pixel, short r, short g, short b);
+        bool OffAll();
+        bool OffPixel(short pixel);
+        bool SetPixels(short r, short g, short b);
+        bool SetPixel(short pixel, short r, short g, short b);
+        bool Update();
+
+        /// <summary>
+        /// Sets and shows every pixel from a packed frame of
+        /// (r,g,b,brightness) bytes
+        /// </summary>
+        /// <returns>True if the frame was shown</returns>
+        bool SetFrame(byte[] frame);
     }
-}
\ No newline at end of file
+}
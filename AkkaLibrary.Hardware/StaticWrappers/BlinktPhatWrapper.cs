@@ -37,5 +37,39 @@ namespace AkkaLibrary.Hardware.StaticWrappers
 
         [DllImport("SharedLibraries/build/libblinkt.so", EntryPoint = "update")]
         public static extern int Update();
+
+        /// <summary>
+        /// Sets every pixel from a packed frame of (r,g,b,brightness) bytes
+        /// and shows it in a single call
+        /// </summary>
+        /// <returns>0 for success, otherwise a fault code</returns>
+        [DllImport("SharedLibraries/build/libblinkt.so", EntryPoint = "set_frame")]
+        public static extern int SetFrame(byte[] frame);
+
+        /// <summary>
+        /// Turns native tracing on (non-zero) or off
+        /// </summary>
+        [DllImport("SharedLibraries/build/libblinkt.so", EntryPoint = "trace_enable")]
+        public static extern void TraceEnable(int enable);
+
+        /// <summary>
+        /// Clears native trace statistics and events. Only call while no other call is running.
+        /// </summary>
+        [DllImport("SharedLibraries/build/libblinkt.so", EntryPoint = "trace_reset")]
+        public static extern void TraceReset();
+
+        /// <summary>
+        /// Copies the statistics of every traced operation
+        /// </summary>
+        /// <returns>Number of statistics copied</returns>
+        [DllImport("SharedLibraries/build/libblinkt.so", EntryPoint = "trace_stats")]
+        public static extern int TraceStats([Out] TraceStatistic[] stats, int capacity);
+
+        /// <summary>
+        /// Writes the buffered trace events to a Chrome/Perfetto trace file
+        /// </summary>
+        /// <returns>Number of events written, or -1 on failure</returns>
+        [DllImport("SharedLibraries/build/libblinkt.so", EntryPoint = "trace_dump")]
+        public static extern int TraceDump(string path);
     }
 }
\ No newline at end of file
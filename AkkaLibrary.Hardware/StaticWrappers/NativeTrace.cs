@@ -0,0 +1,96 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace AkkaLibrary.Hardware.StaticWrappers
+{
+    /// <summary>
+    /// Operations traced by the native libraries, in the order of
+    /// trace::Event in SharedLibraries/Trace/trace.h
+    /// </summary>
+    public enum TraceEvent
+    {
+        BlinktShow,
+        BitBangWrite,
+        BitBangFlush,
+        InkyDraw,
+        InkyPack,
+        DisplayInit,
+        DisplayUpdate,
+        DisplayRefresh,
+        DisplayReset,
+        BusyWait,
+        SpiWrite
+    }
+
+    /// <summary>
+    /// Aggregate statistics of one traced operation. Matches TraceStat in trace.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TraceStatistic
+    {
+        public TraceEvent Event;
+        public ulong Count;
+        public ulong TotalNanoseconds;
+        public ulong MinNanoseconds;
+        public ulong MeanNanoseconds;
+        public ulong MaxNanoseconds;
+        public ulong Bytes;
+
+        public override string ToString()
+            => $"{Event}: {Count} calls, min/mean/max {MinNanoseconds}/{MeanNanoseconds}/{MaxNanoseconds}ns, {Bytes} bytes";
+    }
+
+    /// <summary>
+    /// Tracing built into a native hardware library
+    ///
+    /// Tracing is off until enabled and costs almost nothing while off. Each
+    /// library keeps its own statistics and events.
+    /// </summary>
+    public sealed class NativeTrace
+    {
+        public static NativeTrace Blinkt { get; } = new NativeTrace(
+            BlinktPhatWrapper.TraceEnable, BlinktPhatWrapper.TraceReset, BlinktPhatWrapper.TraceStats, BlinktPhatWrapper.TraceDump);
+
+        public static NativeTrace InkyPhat { get; } = new NativeTrace(
+            InkyPhatWrapper.TraceEnable, InkyPhatWrapper.TraceReset, InkyPhatWrapper.TraceStats, InkyPhatWrapper.TraceDump);
+
+        private readonly Action<int> _enable;
+        private readonly Action _reset;
+        private readonly Func<TraceStatistic[], int, int> _stats;
+        private readonly Func<string, int> _dump;
+
+        private NativeTrace(Action<int> enable, Action reset, Func<TraceStatistic[], int, int> stats, Func<string, int> dump)
+        {
+            _enable = enable;
+            _reset = reset;
+            _stats = stats;
+            _dump = dump;
+        }
+
+        public void Enable() => _enable(1);
+
+        public void Disable() => _enable(0);
+
+        /// <summary>
+        /// Clears the statistics and events. Must not run alongside calls into the library.
+        /// </summary>
+        public void Reset() => _reset();
+
+        /// <summary>
+        /// Statistics of every operation traced since the last reset
+        /// </summary>
+        public TraceStatistic[] Statistics()
+        {
+            var stats = new TraceStatistic[Enum.GetValues(typeof(TraceEvent)).Length];
+            var count = _stats(stats, stats.Length);
+            Array.Resize(ref stats, count);
+            return stats;
+        }
+
+        /// <summary>
+        /// Writes the buffered events to a trace file that chrome://tracing and Perfetto open
+        /// </summary>
+        /// <returns>Number of events written, or -1 if the file could not be written</returns>
+        public int Dump(string path) => _dump(path);
+    }
+}
@@ -0,0 +1,267 @@
+using System;
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using Akka.Streams;
+using Akka.Streams.Dsl;
+using Akka.Streams.TestKit;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Interfaces;
+using AkkaLibrary.Streams.GraphStages;
+using FluentAssertions;
+using Moq;
+using Xunit;
+
+namespace AkkaLibrary.Streams.Test
+{
+    public class BatchedStageSpecs : TestKit
+    {
+        /// <summary>
+        /// Copies a batch out of pooled memory and returns it to the pool
+        /// </summary>
+        private static T[] Copy<T>(ElementBatch<T> batch)
+        {
+            using (batch)
+            {
+                return batch.ToArray();
+            }
+        }
+
+        [Fact]
+        public void BatcherEmitsFullBatches()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var batches = Source.From(Enumerable.Range(0, 100))
+                                    .Via(new Batcher<int>(10, TimeSpan.FromSeconds(10)))
+                                    .Select(x => Copy(x))
+                                    .RunWith(Sink.Seq<int[]>(), mat)
+                                    .Result;
+
+                batches.Should().HaveCount(10);
+                batches.Should().OnlyContain(x => x.Length == 10);
+                batches.SelectMany(x => x).Should().Equal(Enumerable.Range(0, 100));
+            }
+        }
+
+        [Fact]
+        public void BatcherFlushesAPartialBatchAfterTheTimeout()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var (source, sink) = this.SourceProbe<int>()
+                                         .Via(new Batcher<int>(100, TimeSpan.FromMilliseconds(200)))
+                                         .Select(x => Copy(x))
+                                         .ToMaterialized(this.SinkProbe<int[]>(), Keep.Both)
+                                         .Run(mat);
+
+                sink.Request(1);
+                source.SendNext(1);
+                source.SendNext(2);
+                source.SendNext(3);
+
+                sink.ExpectNoMsg(TimeSpan.FromMilliseconds(100));
+                sink.ExpectNext(TimeSpan.FromSeconds(1)).Should().Equal(1, 2, 3);
+            }
+        }
+
+        [Fact]
+        public void BatcherEmitsThePartialBatchOnCompletion()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var batches = Source.From(Enumerable.Range(0, 25))
+                                    .Via(new Batcher<int>(10, TimeSpan.FromSeconds(10)))
+                                    .Select(x => Copy(x))
+                                    .RunWith(Sink.Seq<int[]>(), mat)
+                                    .Result;
+
+                batches.Select(x => x.Length).Should().Equal(10, 10, 5);
+            }
+        }
+
+        [Fact]
+        public void UnbatcherRestoresTheElements()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var result = Source.From(Enumerable.Range(0, 1000))
+                                   .Via(new Batcher<int>(7, TimeSpan.FromMilliseconds(50)))
+                                   .Via(new Unbatcher<int>())
+                                   .RunWith(Sink.Seq<int>(), mat)
+                                   .Result;
+
+                result.Should().Equal(Enumerable.Range(0, 1000));
+            }
+        }
+
+        [Fact]
+        public void BatchesKeepTheirOrderThroughTheRoundRobinFans()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var probe = CreateTestProbe();
+
+                var graph = RunnableGraph.FromGraph(GraphDsl.Create(builder =>
+                {
+                    var source = Source.From(Enumerable.Range(0, 1000))
+                                       .Via(new Batcher<int>(16, TimeSpan.FromMilliseconds(50)));
+
+                    var fanOut = builder.Add(new RoundRobinFanOut<ElementBatch<int>>(4));
+                    var fanIn = builder.Add(new RoundRobinFanIn<ElementBatch<int>>(4));
+
+                    var sink = Flow.Create<ElementBatch<int>>()
+                                   .Via(new Unbatcher<int>())
+                                   .Grouped(1000)
+                                   .To(Sink.ActorRef<IEnumerable<int>>(probe, "completed"));
+
+                    builder.From(source).To(fanOut.In);
+                    for (int i = 0; i < 4; i++)
+                    {
+                        builder.From(fanOut.Out(i)).Via(Flow.Create<ElementBatch<int>>().Async()).To(fanIn.In(i));
+                    }
+                    builder.From(fanIn.Out).To(sink);
+
+                    return ClosedShape.Instance;
+                }));
+
+                graph.Run(mat);
+
+                probe.ExpectMsg<IEnumerable<int>>(TimeSpan.FromSeconds(3)).Should().Equal(Enumerable.Range(0, 1000));
+            }
+        }
+
+        [Fact]
+        public void BatchedUnzipSplitsEachBatchIntoColumns()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var probes = Enumerable.Range(0, 3).Select(_ => CreateTestProbe()).ToArray();
+
+                var graph = RunnableGraph.FromGraph(GraphDsl.Create(builder =>
+                {
+                    var source = Source.From(Enumerable.Range(0, 100).Select(x => new[] { x, 10 * x, 100 * x }))
+                                       .Via(new Batcher<int[]>(8, TimeSpan.FromMilliseconds(50)));
+
+                    var unzip = builder.Add(new BatchedUnzip<int[], int>((row, k) => row[k], 3));
+
+                    builder.From(source).To(unzip.In);
+                    for (int i = 0; i < 3; i++)
+                    {
+                        builder.From(unzip.Out(i))
+                               .To(Flow.Create<ElementBatch<int>>()
+                                       .Via(new Unbatcher<int>())
+                                       .Grouped(100)
+                                       .To(Sink.ActorRef<IEnumerable<int>>(probes[i], "completed")));
+                    }
+
+                    return ClosedShape.Instance;
+                }));
+
+                graph.Run(mat);
+
+                var scale = 1;
+                foreach (var probe in probes)
+                {
+                    probe.ExpectMsg<IEnumerable<int>>(TimeSpan.FromSeconds(3)).Should().Equal(Enumerable.Range(0, 100).Select(x => scale * x));
+                    scale *= 10;
+                }
+            }
+        }
+
+        [Fact]
+        public void BatchedMergeMatchesTheElementMerge()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var probe = CreateTestProbe();
+
+                var graph = RunnableGraph.FromGraph(GraphDsl.Create(builder =>
+                {
+                    var primary = Source.From(
+                        Enumerable.Range(0, 200)
+                        .Select(y => Mock.Of<ISyncData>(x => x.TimeStamp == 50 * y && x.SampleIndex == y)))
+                        .Via(new Batcher<ISyncData>(7, TimeSpan.FromMilliseconds(50)));
+
+                    var secondary = Source.From(
+                        Enumerable.Range(0, 100)
+                        .Select(y => Mock.Of<ISyncData>(x => x.TimeStamp == 100 * y && x.SampleIndex == y)))
+                        .Via(new Batcher<ISyncData>(5, TimeSpan.FromMilliseconds(50)));
+
+                    var merger = builder.Add(new BatchedMergeClosestN<ISyncData>(2, 16, TimeSpan.FromMilliseconds(50)));
+
+                    var sink = Flow.Create<ElementBatch<IImmutableList<ISyncData>>>()
+                                   .Via(new Unbatcher<IImmutableList<ISyncData>>())
+                                   .Grouped(1000)
+                                   .To(Sink.ActorRef<IEnumerable<IImmutableList<ISyncData>>>(probe, "completed"));
+
+                    builder.From(primary).To(merger.In(0));
+                    builder.From(secondary).To(merger.In(1));
+                    builder.From(merger.Out).To(sink);
+
+                    return ClosedShape.Instance;
+                }));
+
+                graph.Run(mat);
+
+                var merged = probe.ExpectMsg<IEnumerable<IImmutableList<ISyncData>>>(TimeSpan.FromSeconds(3)).Take(97).ToList();
+
+                merged.Select(x => x.Select(y => y.TimeStamp).ToArray())
+                      .Should().BeEquivalentTo(Enumerable.Range(0, 97).Select(x => new long[] { 100 * x, 100 * x }));
+
+                merged.Select(x => x.Select(y => y.SampleIndex).ToArray())
+                      .Should().BeEquivalentTo(Enumerable.Range(0, 97).Select(x => new long[] { 2 * x, x }));
+            }
+        }
+
+        [Fact]
+        public void BatchedMergeFlushesAPartialBatchAfterTheTimeout()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                ISyncData Sample(long timeStamp) => Mock.Of<ISyncData>(x => x.TimeStamp == timeStamp && x.SampleIndex == timeStamp);
+
+                var primary = this.CreatePublisherProbe<ElementBatch<ISyncData>>();
+                var secondary = this.CreatePublisherProbe<ElementBatch<ISyncData>>();
+                var sink = this.CreateSubscriberProbe<IImmutableList<ISyncData>[]>();
+
+                RunnableGraph.FromGraph(GraphDsl.Create(builder =>
+                {
+                    var merger = builder.Add(new BatchedMergeClosestN<ISyncData>(2, 16, TimeSpan.FromMilliseconds(200)));
+
+                    builder.From(Source.FromPublisher(primary)).To(merger.In(0));
+                    builder.From(Source.FromPublisher(secondary)).To(merger.In(1));
+                    builder.From(merger.Out)
+                           .To(Flow.Create<ElementBatch<IImmutableList<ISyncData>>>()
+                                   .Select(x => Copy(x))
+                                   .To(Sink.FromSubscriber(sink)));
+
+                    return ClosedShape.Instance;
+                })).Run(mat);
+
+                sink.Request(1);
+                primary.ExpectRequest();
+                secondary.ExpectRequest();
+                primary.SendNext(ElementBatch<ISyncData>.From(new[] { Sample(0), Sample(100), Sample(200) }));
+                secondary.SendNext(ElementBatch<ISyncData>.From(new[] { Sample(0), Sample(100), Sample(200) }));
+
+                // Two outputs are merged, then the last primary waits for the one after it
+                sink.ExpectNoMsg(TimeSpan.FromMilliseconds(100));
+                sink.ExpectNext(TimeSpan.FromSeconds(1)).Select(x => x[0].TimeStamp).Should().Equal(0, 100);
+            }
+        }
+
+        [Fact]
+        public void ElementsAreOnlyValidUntilTheBatchIsDisposed()
+        {
+            var batch = ElementBatch<string>.From(new[] { "a", "b" });
+            batch.Should().Equal("a", "b");
+
+            batch.Dispose();
+
+            batch.Count.Should().Be(0);
+            Action read = () => { var _ = batch.Memory; };
+            read.Should().Throw<ObjectDisposedException>();
+        }
+    }
+}
@@ -0,0 +1,85 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using Akka.Streams;
+using Akka.Streams.Dsl;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Objects;
+using FluentAssertions;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace AkkaLibrary.Streams.Test
+{
+    /// <summary>
+    /// Compares the per-sample adjuster graph with the fused block adjuster
+    /// over the same configuration and data. Timings are written to the test
+    /// output; only the results are asserted.
+    /// </summary>
+    [Trait("Category", "Benchmark")]
+    public class ChannelAdjusterBenchmarks : TestKit
+    {
+        private const int Samples = 5000;
+        private const int BlockLength = 32;
+
+        private readonly ITestOutputHelper _output;
+
+        public ChannelAdjusterBenchmarks(ITestOutputHelper output) : base(output: output)
+        {
+            _output = output;
+        }
+
+        private static List<ChannelAdjusterConfig> CreateConfigs(int channels)
+            => Enumerable.Range(0, channels)
+                         .Select(c => new ChannelAdjusterConfig($"Channel{c}", 0.5f, c, c % 3 - 1, c % 2 == 0 ? FilterOption.Filter : FilterOption.PassThrough))
+                         .ToList();
+
+        [Theory]
+        [InlineData(4)]
+        [InlineData(16)]
+        public void FusedAdjusterMatchesSampleGraph(int channels)
+        {
+            var configs = CreateConfigs(channels);
+            var schema = new ChannelSchema(configs.Select(x => x.Name), new string[0]);
+            var blocks = FusedChannelAdjusterSpecs.CreateBlocks(schema, Samples, BlockLength).ToList();
+            var samples = blocks.SelectMany(b => b.ToChannelData()).ToList();
+
+            using (var materializer = Sys.Materializer())
+            {
+                // Per-sample graph
+                var probe = CreateTestProbe();
+                var stopwatch = Stopwatch.StartNew();
+
+                var queue = DataAdjusterFactory.CreateGraph(probe.Ref, configs, samples[0]).Run(materializer);
+                foreach (var sample in samples)
+                {
+                    queue.OfferAsync(sample).Wait();
+                }
+
+                var expected = Enumerable.Range(0, Samples - 2)
+                                         .Select(_ => probe.ExpectMsg<ChannelData<float>>(TimeSpan.FromSeconds(10)))
+                                         .ToList();
+                var sampleGraphTime = stopwatch.Elapsed;
+
+                // Fused block stage
+                stopwatch.Restart();
+                var actual = Source.From(blocks)
+                                   .Via(DataAdjusterFactory.CreateFlow(configs))
+                                   .RunWith(Sink.Seq<SampleBlock<float>>(), materializer)
+                                   .Result;
+                var fusedTime = stopwatch.Elapsed;
+
+                _output.WriteLine($"{channels} channels, {Samples} samples");
+                _output.WriteLine($"  Per-sample graph: {sampleGraphTime.TotalMilliseconds:F1} ms ({Samples / sampleGraphTime.TotalSeconds:F0} samples/s)");
+                _output.WriteLine($"  Fused stage:      {fusedTime.TotalMilliseconds:F1} ms ({Samples / fusedTime.TotalSeconds:F0} samples/s)");
+
+                var fused = actual.SelectMany(b => b.ToChannelData()).ToList();
+                fused.Should().HaveCount(expected.Count);
+                fused.Select(x => x.SampleIndex).Should().Equal(expected.Select(x => x.SampleIndex));
+                fused.SelectMany(x => x.Analogs.Select(a => a.Value))
+                     .Should().Equal(expected.SelectMany(x => x.Analogs.Select(a => a.Value)));
+            }
+        }
+    }
+}
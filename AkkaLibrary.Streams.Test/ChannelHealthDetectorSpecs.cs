@@ -0,0 +1,71 @@
+using System;
+using System.Linq;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Streams.Test
+{
+    public class ChannelHealthDetectorSpecs
+    {
+        private static bool[] Run(ChannelHealthDetector detector, Func<ChannelHealthDetector, bool> flag, params float[] values)
+            => values.Select(x =>
+            {
+                detector.Update(x);
+                return flag(detector);
+            }).ToArray();
+
+        [Fact]
+        public void PositiveFullScaleLatchesWithHysteresis()
+        {
+            var detector = new ChannelHealthDetector(new ChannelDetectorConfig(10, -10, 2, 0, 0));
+
+            Run(detector, x => x.PositiveFullScale, 9, 10, 9, 8, 7.9f, 9, 11)
+                .Should().Equal(false, true, true, true, false, false, true);
+        }
+
+        [Fact]
+        public void NegativeFullScaleLatchesWithHysteresis()
+        {
+            var detector = new ChannelHealthDetector(new ChannelDetectorConfig(10, -10, 2, 0, 0));
+
+            Run(detector, x => x.NegativeFullScale, -9, -10, -9, -8, -7.9f, -9, -11)
+                .Should().Equal(false, true, true, true, false, false, true);
+        }
+
+        [Fact]
+        public void FlatlineNeedsAFullWindowWithinTolerance()
+        {
+            var detector = new ChannelHealthDetector(new ChannelDetectorConfig(100, -100, 0, 3, 0.5f));
+
+            Run(detector, x => x.Flatlining, 1, 1.2f, 1.4f, 1.6f, 5, 5, 5.6f, 4.9f, 5, 5)
+                .Should().Equal(false, false, true, true, false, false, false, false, false, true);
+        }
+
+        [Fact]
+        public void FlatlineWindowSlidesPastOldExtremes()
+        {
+            var detector = new ChannelHealthDetector(new ChannelDetectorConfig(100, -100, 0, 4, 0));
+            var values = new float[] { 9, 1, 8, 2, 2, 2, 2, 3 };
+
+            Run(detector, x => x.Flatlining, values)
+                .Should().Equal(false, false, false, false, false, false, true, false);
+        }
+
+        [Fact]
+        public void DisabledDetectorNeverRaises()
+        {
+            var detector = new ChannelHealthDetector(null);
+
+            Run(detector, x => x.PositiveFullScale || x.NegativeFullScale || x.Flatlining,
+                float.MaxValue, float.MinValue, 0, 0, 0, 0)
+                .Should().OnlyContain(x => !x);
+        }
+
+        [Fact]
+        public void NegativeWindowIsRejected()
+        {
+            Action create = () => new ChannelDetectorConfig(1, -1, 0, -1, 0);
+            create.Should().Throw<ArgumentException>();
+        }
+    }
+}
@@ -0,0 +1,146 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Akka.Streams;
+using Akka.Streams.Dsl;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Objects;
+using FluentAssertions;
+using FsCheck;
+using FsCheck.Xunit;
+using Xunit;
+
+namespace AkkaLibrary.Streams.Test
+{
+    public class FusedChannelAdjusterSpecs : TestKit
+    {
+        private static readonly ChannelSchema Schema = new ChannelSchema(new[] { "One", "Two", "Three" }, new[] { "D1" });
+
+        /// <summary>
+        /// Creates consecutive blocks where channel c of sample n holds 100 * c + n
+        /// </summary>
+        internal static IEnumerable<SampleBlock<float>> CreateBlocks(ChannelSchema schema, int samples, int blockLength)
+        {
+            for (int first = 0; first < samples; first += blockLength)
+            {
+                var length = Math.Min(blockLength, samples - first);
+                var block = new SampleBlock<float>(schema, length);
+                for (int s = 0; s < length; s++)
+                {
+                    var n = first + s;
+                    for (int c = 0; c < schema.AnalogCount; c++)
+                    {
+                        block.Analogs[c * length + s] = 100 * c + n;
+                    }
+                    for (int d = 0; d < schema.DigitalCount; d++)
+                    {
+                        block.Digitals[d * length + s] = n % 2 == 0;
+                    }
+                    block.SampleIndices[s] = n;
+                    block.TachometerCounts[s] = (uint)n;
+                }
+                yield return block;
+            }
+        }
+
+        private List<SampleBlock<float>> Run(IEnumerable<ChannelAdjusterConfig> configs, IEnumerable<SampleBlock<float>> blocks)
+        {
+            using (var materializer = Sys.Materializer())
+            {
+                return Source.From(blocks)
+                             .Via(DataAdjusterFactory.CreateFlow(configs))
+                             .RunWith(Sink.Seq<SampleBlock<float>>(), materializer)
+                             .Result
+                             .ToList();
+            }
+        }
+
+        [Fact]
+        public void ScalesOffsetsAndReordersWholeBlocks()
+        {
+            var configs = new[]
+            {
+                new ChannelAdjusterConfig("Three", 2, 1, 0, FilterOption.Filter),
+                new ChannelAdjusterConfig("One", 5, 5, 0, FilterOption.PassThrough),
+            };
+
+            var result = Run(configs, CreateBlocks(Schema, 37, 37)).Single();
+
+            result.Schema.AnalogNames.Should().Equal("Three", "One");
+            result.Schema.DigitalNames.Should().Equal("D1");
+            result.Analogs.Take(37).Should().Equal(Enumerable.Range(0, 37).Select(n => (200f + n) * 2 + 1));
+            result.Analogs.Skip(37).Should().Equal(Enumerable.Range(0, 37).Select(n => (float)n));
+        }
+
+        [Property(MaxTest = 20)]
+        public Property TemporalOffsetsAreIndependentOfBlockLength(PositiveInt blockLength)
+        {
+            var configs = new[]
+            {
+                new ChannelAdjusterConfig("One", 1, 0, 3, FilterOption.PassThrough),
+                new ChannelAdjusterConfig("Two", 1, 0, -2, FilterOption.PassThrough),
+                new ChannelAdjusterConfig("Three", 1, 0, 0, FilterOption.Filter),
+            };
+            var offsets = new[] { 3, -2, 0 };
+            var columns = new[] { 0, 1, 2 };
+
+            var blocks = Run(configs, CreateBlocks(Schema, 40, Math.Min(blockLength.Get, 50)));
+            var samples = blocks.SelectMany(b => b.ToChannelData()).ToList();
+
+            // Channel c at sync index j holds the input of sample j - offset
+            var aligned = samples.All(sample => sample.Analogs
+                                    .Select((channel, i) => channel.Value == 100 * columns[i] + sample.SampleIndex - offsets[i])
+                                    .All(x => x));
+
+            var digitalsFollowSync = samples.All(sample => sample.Digitals.Single().Value == (sample.SampleIndex % 2 == 0));
+
+            // The largest offset spread (3 - -2) of samples is held back
+            return (aligned && digitalsFollowSync && samples.Count == 35 && blocks.All(b => b.Length > 0)).ToProperty();
+        }
+
+        [Fact]
+        public void CreateDigitalsAppendsGeneratedChannels()
+        {
+            var configs = new[]
+            {
+                new ChannelAdjusterConfig("Two", 1, 0, 0, FilterOption.CreateDigitals),
+            };
+
+            var result = Run(configs, CreateBlocks(Schema, 4, 4)).Single();
+
+            result.Schema.DigitalNames.Should().Equal("D1", "Two_+FullScale", "Two_-FullScale", "Two_Flatlining");
+            result.Digitals.Should().HaveCount(16);
+        }
+
+        [Fact]
+        public void CreateDigitalsAreComputedAcrossBlocks()
+        {
+            // Adjusted values of Two are 100 + n, so sample 5 onwards is at full scale
+            var detectors = new ChannelDetectorConfig(105, -1, 0, 3, 10);
+            var configs = new[]
+            {
+                new ChannelAdjusterConfig("Two", 1, 0, 0, FilterOption.CreateDigitals, detectors),
+            };
+
+            var samples = Run(configs, CreateBlocks(Schema, 8, 3))
+                            .SelectMany(b => b.ToChannelData())
+                            .ToList();
+
+            samples.Select(x => x.Digitals[1].Value).Should().Equal(false, false, false, false, false, true, true, true);
+            samples.Select(x => x.Digitals[2].Value).Should().OnlyContain(x => !x);
+            samples.Select(x => x.Digitals[3].Value).Should().Equal(false, false, true, true, true, true, true, true);
+        }
+
+        [Fact]
+        public void MissingChannelFailsTheStream()
+        {
+            var configs = new[]
+            {
+                new ChannelAdjusterConfig("Four", 1, 0, 0, FilterOption.Filter),
+            };
+
+            Action run = () => Run(configs, CreateBlocks(Schema, 4, 4));
+            run.Should().Throw<AggregateException>().WithInnerException<ArgumentException>();
+        }
+    }
+}
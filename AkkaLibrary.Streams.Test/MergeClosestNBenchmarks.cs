@@ -0,0 +1,88 @@
+using System;
+using System.Collections.Immutable;
+using System.Diagnostics;
+using System.Linq;
+using Akka.Streams;
+using Akka.Streams.Dsl;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Interfaces;
+using AkkaLibrary.Streams.GraphStages;
+using FluentAssertions;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace AkkaLibrary.Streams.Test
+{
+    /// <summary>
+    /// Merges jittered streams of increasing width. Time per output and per
+    /// output per input are written to the test output; the second should stay
+    /// roughly flat as inputs are added. Only the output count is asserted.
+    /// </summary>
+    [Trait("Category", "Benchmark")]
+    public class MergeClosestNBenchmarks : TestKit
+    {
+        private const int Samples = 20000;
+
+        private readonly ITestOutputHelper _output;
+
+        public MergeClosestNBenchmarks(ITestOutputHelper output) : base(output: output)
+        {
+            _output = output;
+        }
+
+        private sealed class Sample : ISyncData
+        {
+            public long TimeStamp { get; set; }
+            public uint TachometerCount { get; set; }
+            public bool MasterSyncState { get; set; }
+            public long MasterSyncIncrement { get; set; }
+            public long SampleIndex { get; set; }
+        }
+
+        [Theory]
+        [InlineData(2)]
+        [InlineData(8)]
+        [InlineData(32)]
+        [InlineData(128)]
+        public void MergeCostIsLinearInInputs(int inputs)
+        {
+            var random = new Random(inputs);
+            var streams = Enumerable.Range(0, inputs)
+                                    .Select(s => Enumerable.Range(0, Samples)
+                                                           .Select(y => new Sample
+                                                           {
+                                                               TimeStamp = 1000L * y + (s == 0 ? 0 : random.Next(-300, 301)),
+                                                               SampleIndex = y
+                                                           })
+                                                           .ToArray())
+                                    .ToArray();
+
+            using (var materializer = Sys.Materializer())
+            {
+                var graph = RunnableGraph.FromGraph(
+                    GraphDsl.Create(Sink.Aggregate<IImmutableList<Sample>, int>(0, (count, _) => count + 1), (builder, sink) =>
+                    {
+                        var merger = builder.Add(new MergeClosestN<Sample>(inputs));
+
+                        for (int i = 0; i < inputs; i++)
+                        {
+                            builder.From(Source.From(streams[i])).To(merger.In(i));
+                        }
+                        builder.From(merger.Out).To(sink);
+
+                        return ClosedShape.Instance;
+                    }));
+
+                var stopwatch = Stopwatch.StartNew();
+                var outputs = graph.Run(materializer).Result;
+                var elapsed = stopwatch.Elapsed;
+
+                var perOutput = elapsed.TotalMilliseconds * 1000 / outputs;
+                _output.WriteLine($"{inputs} inputs, {Samples} samples");
+                _output.WriteLine($"  {elapsed.TotalMilliseconds:F1} ms, {perOutput:F2} us per output, {perOutput * 1000 / inputs:F0} ns per output per input");
+
+                outputs.Should().BeGreaterOrEqualTo(Samples - 1);
+            }
+        }
+    }
+}
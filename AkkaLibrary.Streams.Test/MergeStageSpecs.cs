@@ -211,5 +211,58 @@ namespace AkkaLibrary.Streams.Test
                     Enumerable.Range(0,5).Select(y => x).ToArray()));
             }
         }
+
+        [Fact]
+        public void JitteredSourcesMergeBySample()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var probe = CreateTestProbe();
+                var random = new Random(3);
+
+                var graph = RunnableGraph.FromGraph(
+                    GraphDsl.Create(builder =>
+                    {
+                        // Secondaries wander up to 30 either side of the primary's 100 step
+                        var sources = Enumerable.Range(0, 32).Select(s =>
+                            Source.From(
+                                Enumerable.Range(0, 200)
+                                .Select(y => (y, jitter: s == 0 ? 0 : random.Next(-30, 31)))
+                                .ToList()
+                                .Select(v => Mock.Of<ISyncData>(m =>
+                                m.TimeStamp == 100 * v.y + v.jitter
+                                && m.SampleIndex == v.y
+                                )))).ToArray();
+
+                        var merger = builder.Add(new MergeClosestN<ISyncData>(32, bufferSize: 4));
+
+                        var sink = Sink.ActorRef<IImmutableList<ISyncData>>(probe, "completed");
+
+                        for (int i = 0; i < 32; i++)
+                        {
+                            builder.From(sources[i]).To(merger.In(i));
+                        }
+                        builder.From(merger.Out).To(sink);
+
+                        return ClosedShape.Instance;
+                    }));
+
+                graph.Run(mat);
+
+                var msgs = probe.ReceiveN(199, TimeSpan.FromSeconds(Debugger.IsAttached ? 300 : 10));
+
+                var sampleIndices = msgs.Cast<IImmutableList<ISyncData>>().Select(x => x.Select(y => y.SampleIndex).ToArray()).ToList();
+                sampleIndices.Should().BeEquivalentTo(
+                    Enumerable.Range(0,199).Select(x =>
+                    Enumerable.Range(0,32).Select(y => x).ToArray()));
+            }
+        }
+
+        [Fact]
+        public void BufferMustHoldTwoElements()
+        {
+            Action create = () => new MergeClosestN<ISyncData>(2, bufferSize: 1);
+            create.Should().Throw<ArgumentException>();
+        }
     }
 }
\ No newline at end of file
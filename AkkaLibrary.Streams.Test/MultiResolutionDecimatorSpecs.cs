@@ -0,0 +1,142 @@
+using System;
+using System.Linq;
+using Akka.Streams;
+using Akka.Streams.Dsl;
+using Akka.Streams.TestKit;
+using Akka.TestKit;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Objects;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Streams.Test
+{
+    public class MultiResolutionDecimatorSpecs : TestKit
+    {
+        private ActorMaterializer Materializer { get; }
+
+        public MultiResolutionDecimatorSpecs()
+        {
+            Materializer = Sys.Materializer();
+        }
+
+        private static ChannelData<float> Sample(int tacho, float value)
+            => new ChannelData<float>(new[] { new DataChannel<float>("Channel", value) }, new DataChannel<bool>[0], tacho, (uint)tacho, 0, false, tacho);
+
+        /// <summary>
+        /// Runs samples one tacho apart through 1, 10 and 100 tacho levels
+        /// </summary>
+        private TestProbe[] Run(params float[] values)
+        {
+            var probes = Enumerable.Range(0, 3).Select(_ => CreateTestProbe()).ToArray();
+
+            RunnableGraph.FromGraph(
+                GraphDsl.Create(builder =>
+                {
+                    var source = Source.From(values.Select((x, i) => Sample(i, x)));
+                    var decimator = builder.Add(MultiResolutionDecimator.ForChannelData(10, new[] { 0.1, 1, 10 }, 1));
+
+                    builder.From(source).To(decimator.In);
+                    for (int i = 0; i < 3; i++)
+                    {
+                        builder.From(decimator.Out(i)).To(Sink.ActorRef<SpatialAggregate<ChannelData<float>>>(probes[i], "completed"));
+                    }
+
+                    return ClosedShape.Instance;
+                })).Run(Materializer);
+
+            return probes;
+        }
+
+        [Fact]
+        public void EachLevelAggregatesItsSpacing()
+        {
+            var probes = Run(Enumerable.Range(0, 1000).Select(x => (float)x).ToArray());
+
+            var fine = probes[0].ReceiveN(1000).Cast<SpatialAggregate<ChannelData<float>>>().ToList();
+            var medium = probes[1].ReceiveN(100).Cast<SpatialAggregate<ChannelData<float>>>().ToList();
+            var coarse = probes[2].ReceiveN(10).Cast<SpatialAggregate<ChannelData<float>>>().ToList();
+
+            fine.Select(x => x.Count).Should().OnlyContain(x => x == 1);
+            medium.Select(x => x.StartTacho).Should().Equal(Enumerable.Range(0, 100).Select(x => (uint)x * 10));
+            medium.Select(x => x.Mean[0]).Should().Equal(Enumerable.Range(0, 100).Select(x => x * 10 + 4.5f));
+            coarse.Select(x => x.Count).Should().OnlyContain(x => x == 100);
+            coarse.Select(x => x.Min[0]).Should().Equal(Enumerable.Range(0, 10).Select(x => x * 100f));
+            coarse.Select(x => x.Max[0]).Should().Equal(Enumerable.Range(0, 10).Select(x => x * 100f + 99));
+
+            foreach (var probe in probes)
+            {
+                probe.ExpectMsg("completed");
+            }
+        }
+
+        [Fact]
+        public void CoarseLevelsKeepPeaks()
+        {
+            var values = new float[300];
+            values[155] = 1000;
+            values[156] = -1000;
+
+            var probes = Run(values);
+            var coarse = probes[2].ReceiveN(3).Cast<SpatialAggregate<ChannelData<float>>>().ToList();
+
+            coarse.Select(x => x.Max[0]).Should().Equal(0, 1000, 0);
+            coarse.Select(x => x.Min[0]).Should().Equal(0, -1000, 0);
+            coarse[1].First.TachometerCount.Should().Be(100);
+        }
+
+        [Fact]
+        public void PartialIntervalsAreEmittedOnCompletion()
+        {
+            var probes = Run(Enumerable.Range(0, 25).Select(x => (float)x).ToArray());
+
+            var medium = probes[1].ReceiveN(3).Cast<SpatialAggregate<ChannelData<float>>>().ToList();
+            medium.Select(x => x.Count).Should().Equal(10, 10, 5);
+
+            var coarse = probes[2].ExpectMsg<SpatialAggregate<ChannelData<float>>>();
+            coarse.Count.Should().Be(25);
+            coarse.EndTacho.Should().Be(24);
+        }
+
+        [Fact]
+        public void CancellingALevelReleasesTheOthers()
+        {
+            var fine = TestSubscriber.CreateManualProbe<SpatialAggregate<ChannelData<float>>>(this);
+            var medium = TestSubscriber.CreateManualProbe<SpatialAggregate<ChannelData<float>>>(this);
+
+            RunnableGraph.FromGraph(
+                GraphDsl.Create(builder =>
+                {
+                    var source = Source.From(Enumerable.Range(0, 1000).Select(x => Sample(x, x)));
+                    var decimator = builder.Add(MultiResolutionDecimator.ForChannelData(10, new[] { 0.1, 1 }, 1));
+
+                    builder.From(source).To(decimator.In);
+                    builder.From(decimator.Out(0)).To(Sink.FromSubscriber(fine));
+                    builder.From(decimator.Out(1)).To(Sink.FromSubscriber(medium));
+
+                    return ClosedShape.Instance;
+                })).Run(Materializer);
+
+            var fineSubscription = fine.ExpectSubscription();
+            var mediumSubscription = medium.ExpectSubscription();
+            fineSubscription.Request(1000);
+
+            // The first medium interval closes with the eleventh fine one and
+            // waits for demand, holding back upstream
+            fine.ExpectNextN(11);
+            fine.ExpectNoMsg(TimeSpan.FromMilliseconds(200));
+
+            mediumSubscription.Cancel();
+
+            fine.ExpectNextN(989);
+            fine.ExpectComplete();
+        }
+
+        [Fact]
+        public void SpacingsMustBeAscending()
+        {
+            Action create = () => MultiResolutionDecimator.ForChannelData(10, new[] { 1.0, 0.1 }, 1);
+            create.Should().Throw<ArgumentException>();
+        }
+    }
+}
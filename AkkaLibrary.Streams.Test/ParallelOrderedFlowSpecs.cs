@@ -0,0 +1,105 @@
+using System;
+using System.Linq;
+using System.Threading;
+using Akka.Streams;
+using Akka.Streams.Dsl;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Metrics;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Streams.Test
+{
+    public class ParallelOrderedFlowSpecs : TestKit
+    {
+        [Theory]
+        [InlineData(1, 1)]
+        [InlineData(2, 8)]
+        [InlineData(4, 32)]
+        [InlineData(7, 5)]
+        public void OrderIsPreservedWithUnevenWork(int parallelism, int batchSize)
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var result = Source.From(Enumerable.Range(0, 2000))
+                                   .Via(ParallelOrderedFlow.Create<int, int>(x =>
+                                   {
+                                       // Some elements take far longer than their neighbours
+                                       if(x % 97 == 0)
+                                       {
+                                           Thread.Sleep(2);
+                                       }
+                                       return x * 2;
+                                   }, parallelism, batchSize))
+                                   .RunWith(Sink.Seq<int>(), mat)
+                                   .Result;
+
+                result.Should().Equal(Enumerable.Range(0, 2000).Select(x => x * 2));
+            }
+        }
+
+        [Fact]
+        public void FansAreMeteredUnderTheFlowName()
+        {
+            var name = MetricsRegistry.InstanceName("ParallelOrderedFlowSpecs");
+
+            using (var mat = Sys.Materializer())
+            {
+                Source.From(Enumerable.Range(0, 100))
+                      .Via(ParallelOrderedFlow.Create<int, int>(x => x, 2, 8, name: name))
+                      .RunWith(Sink.Seq<int>(), mat)
+                      .Wait(TimeSpan.FromSeconds(3)).Should().BeTrue();
+            }
+
+            var counters = MetricsRegistry.Default.Snapshot().Counters;
+            counters[$"{name}.FanOut.Elements"].Should().BeGreaterThan(0);
+            (counters[$"{name}.FanIn0.Elements"] + counters[$"{name}.FanIn1.Elements"]).Should().Be(counters[$"{name}.FanOut.Elements"]);
+        }
+
+        [Fact]
+        public void MoreWorkersThanElementsCompletes()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var result = Source.From(Enumerable.Range(0, 3))
+                                   .Via(ParallelOrderedFlow.Create<int, string>(x => x.ToString(), 8))
+                                   .RunWith(Sink.Seq<string>(), mat)
+                                   .Result;
+
+                result.Should().Equal("0", "1", "2");
+            }
+        }
+
+        [Fact]
+        public void WorkRunsOnSeveralThreads()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var threads = Source.From(Enumerable.Range(0, 400))
+                                    .Via(ParallelOrderedFlow.Create<int, int>(x =>
+                                    {
+                                        Thread.Sleep(1);
+                                        return Thread.CurrentThread.ManagedThreadId;
+                                    }, 4, 4))
+                                    .RunWith(Sink.Seq<int>(), mat)
+                                    .Result;
+
+                threads.Distinct().Count().Should().BeGreaterThan(1);
+            }
+        }
+
+        [Fact]
+        public void FailuresInWorkFailTheStream()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var task = Source.From(Enumerable.Range(0, 100))
+                                 .Via(ParallelOrderedFlow.Create<int, int>(x => x == 50 ? throw new InvalidOperationException("bad element") : x, 4))
+                                 .RunWith(Sink.Seq<int>(), mat);
+
+                Action wait = () => task.Wait(TimeSpan.FromSeconds(3));
+                wait.Should().Throw<AggregateException>().WithInnerException<InvalidOperationException>();
+            }
+        }
+    }
+}
@@ -0,0 +1,164 @@
+using System;
+using System.Linq;
+using System.Threading;
+using Akka.Streams;
+using Akka.Streams.Dsl;
+using Akka.Streams.TestKit;
+using Akka.TestKit.Xunit2;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Streams.Test
+{
+    public class TimedBufferFlowSpecs : TestKit
+    {
+        private static readonly TimeSpan Timeout = TimeSpan.FromMilliseconds(300);
+
+        [Fact]
+        public void ElementsPassThroughInOrder()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var result = Source.From(Enumerable.Range(0, 1000))
+                                   .Via(new TimedBufferFlow<int>(TimeSpan.FromSeconds(10)))
+                                   .RunWith(Sink.Seq<int>(), mat)
+                                   .Result;
+
+                result.Should().Equal(Enumerable.Range(0, 1000));
+            }
+        }
+
+        [Fact]
+        public void UpstreamIsBackpressuredAtCapacity()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var pulled = 0;
+                var probe = Source.From(Enumerable.Range(0, 100))
+                                  .Select(x =>
+                                  {
+                                      Interlocked.Increment(ref pulled);
+                                      return x;
+                                  })
+                                  .Via(new TimedBufferFlow<int>(TimeSpan.FromSeconds(10), capacity: 4))
+                                  .RunWith(this.SinkProbe<int>(), mat);
+
+                probe.EnsureSubscription();
+                probe.ExpectNoMsg(TimeSpan.FromMilliseconds(200));
+                Volatile.Read(ref pulled).Should().Be(4);
+
+                probe.Request(2);
+                probe.ExpectNext(0, 1);
+                AwaitCondition(() => Volatile.Read(ref pulled) == 6);
+            }
+        }
+
+        [Fact]
+        public void ExpiredElementsAreDropped()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var (upstream, downstream) = this.SourceProbe<int>()
+                                                 .Via(new TimedBufferFlow<int>(Timeout))
+                                                 .ToMaterialized(this.SinkProbe<int>(), Keep.Both)
+                                                 .Run(mat);
+
+                upstream.SendNext(1);
+                upstream.SendNext(2);
+                downstream.EnsureSubscription();
+                Thread.Sleep(Timeout + Timeout);
+
+                upstream.SendNext(3);
+                downstream.Request(3);
+                downstream.ExpectNext(3);
+                downstream.ExpectNoMsg(TimeSpan.FromMilliseconds(100));
+            }
+        }
+
+        [Fact]
+        public void ElementsAreKeptForTheWholeTimeout()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                // A resolution as coarse as the timeout would otherwise drop an
+                // element that arrived at the end of a tick on the next one
+                var (upstream, downstream) = this.SourceProbe<int>()
+                                                 .Via(new TimedBufferFlow<int>(Timeout, resolution: Timeout))
+                                                 .ToMaterialized(this.SinkProbe<int>(), Keep.Both)
+                                                 .Run(mat);
+
+                downstream.EnsureSubscription();
+                upstream.SendNext(1);
+                Thread.Sleep(Timeout - TimeSpan.FromMilliseconds(50));
+
+                downstream.Request(1);
+                downstream.ExpectNext(1);
+            }
+        }
+
+        [Fact]
+        public void BufferedElementsAreDeliveredAfterUpstreamCompletes()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var (upstream, downstream) = this.SourceProbe<int>()
+                                                 .Via(new TimedBufferFlow<int>(TimeSpan.FromSeconds(10)))
+                                                 .ToMaterialized(this.SinkProbe<int>(), Keep.Both)
+                                                 .Run(mat);
+
+                upstream.SendNext(1);
+                upstream.SendNext(2);
+                upstream.SendComplete();
+
+                downstream.Request(3);
+                downstream.ExpectNext(1, 2);
+                downstream.ExpectComplete();
+            }
+        }
+
+        [Fact]
+        public void StageCompletesOnceRemainingElementsExpire()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var (upstream, downstream) = this.SourceProbe<int>()
+                                                 .Via(new TimedBufferFlow<int>(Timeout))
+                                                 .ToMaterialized(this.SinkProbe<int>(), Keep.Both)
+                                                 .Run(mat);
+
+                downstream.EnsureSubscription();
+                upstream.SendNext(1);
+                upstream.SendComplete();
+
+                downstream.ExpectComplete();
+            }
+        }
+
+        [Fact]
+        public void HundredsOfThousandsOfElementsCanBeHeld()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                const int count = 300000;
+                var probe = Source.From(Enumerable.Range(0, count))
+                                  .Via(new TimedBufferFlow<int>(TimeSpan.FromSeconds(30)))
+                                  .RunWith(this.SinkProbe<int>(), mat);
+
+                // Let the buffer fill before taking anything
+                probe.EnsureSubscription();
+                Thread.Sleep(500);
+
+                probe.Request(count);
+                probe.ExpectNextN(count).Should().Equal(Enumerable.Range(0, count));
+                probe.ExpectComplete();
+            }
+        }
+
+        [Fact]
+        public void ResolutionMustNotExceedTimeout()
+        {
+            Action create = () => new TimedBufferFlow<int>(TimeSpan.FromMilliseconds(10), resolution: TimeSpan.FromSeconds(1));
+            create.Should().Throw<ArgumentException>();
+        }
+    }
+}
@@ -0,0 +1,168 @@
+using System;
+
+namespace AkkaLibrary.Streams
+{
+    /// <summary>
+    /// Limits for the channel health digitals created by <see cref="FilterOption.CreateDigitals"/>
+    ///
+    /// Thresholds are in adjusted units, after scale and offset. The defaults
+    /// disable every detector.
+    /// </summary>
+    public class ChannelDetectorConfig
+    {
+        /// <summary>
+        /// Value at or above which _+FullScale is raised
+        /// </summary>
+        public float PositiveFullScale { get; }
+
+        /// <summary>
+        /// Value at or below which _-FullScale is raised
+        /// </summary>
+        public float NegativeFullScale { get; }
+
+        /// <summary>
+        /// Distance back inside a full-scale threshold before the digital clears
+        /// </summary>
+        public float Hysteresis { get; }
+
+        /// <summary>
+        /// Number of samples in the flatline window. Zero disables the detector.
+        /// </summary>
+        public int FlatlineWindow { get; }
+
+        /// <summary>
+        /// Largest peak to peak change over a full window still considered flat
+        /// </summary>
+        public float FlatlineTolerance { get; }
+
+        public ChannelDetectorConfig(float positiveFullScale, float negativeFullScale, float hysteresis, int flatlineWindow, float flatlineTolerance)
+        {
+            if(hysteresis < 0)
+            {
+                throw new ArgumentException("Hysteresis cannot be negative.", nameof(hysteresis));
+            }
+            if(flatlineWindow < 0)
+            {
+                throw new ArgumentException("Flatline window cannot be negative.", nameof(flatlineWindow));
+            }
+
+            PositiveFullScale = positiveFullScale;
+            NegativeFullScale = negativeFullScale;
+            Hysteresis = hysteresis;
+            FlatlineWindow = flatlineWindow;
+            FlatlineTolerance = flatlineTolerance;
+        }
+
+        public static ChannelDetectorConfig Disabled { get; } = new ChannelDetectorConfig(float.PositiveInfinity, float.NegativeInfinity, 0, 0, 0);
+    }
+
+    /// <summary>
+    /// Streaming full-scale and flatline detection for a single channel
+    ///
+    /// Full-scale digitals latch on crossing their threshold and clear once the
+    /// value is back inside by the hysteresis. The flatline digital is raised
+    /// while the peak to peak range of the last <see cref="ChannelDetectorConfig.FlatlineWindow"/>
+    /// samples is within tolerance, tracked with monotonic min and max deques so
+    /// each sample costs O(1) amortised.
+    /// </summary>
+    public sealed class ChannelHealthDetector
+    {
+        private readonly ChannelDetectorConfig _config;
+        private readonly MonotonicDeque _minimums;
+        private readonly MonotonicDeque _maximums;
+        private long _index;
+
+        public bool PositiveFullScale { get; private set; }
+        public bool NegativeFullScale { get; private set; }
+        public bool Flatlining { get; private set; }
+
+        public ChannelHealthDetector(ChannelDetectorConfig config)
+        {
+            _config = config ?? ChannelDetectorConfig.Disabled;
+
+            if(_config.FlatlineWindow > 0)
+            {
+                _minimums = new MonotonicDeque(_config.FlatlineWindow, keepMinimum: true);
+                _maximums = new MonotonicDeque(_config.FlatlineWindow, keepMinimum: false);
+            }
+        }
+
+        /// <summary>
+        /// Updates the detectors with the next sample
+        /// </summary>
+        public void Update(float value)
+        {
+            var cfg = _config;
+
+            PositiveFullScale = PositiveFullScale
+                                ? value >= cfg.PositiveFullScale - cfg.Hysteresis
+                                : value >= cfg.PositiveFullScale;
+
+            NegativeFullScale = NegativeFullScale
+                                ? value <= cfg.NegativeFullScale + cfg.Hysteresis
+                                : value <= cfg.NegativeFullScale;
+
+            if(_minimums != null)
+            {
+                _minimums.Add(_index, value);
+                _maximums.Add(_index, value);
+
+                Flatlining = _index >= cfg.FlatlineWindow - 1
+                             && _maximums.Front - _minimums.Front <= cfg.FlatlineTolerance;
+            }
+
+            _index++;
+        }
+
+        /// <summary>
+        /// Sliding window extreme as a ring of (index, value) pairs whose values
+        /// are monotonic from front to back
+        /// </summary>
+        private sealed class MonotonicDeque
+        {
+            private readonly long[] _indices;
+            private readonly float[] _values;
+            private readonly int _window;
+            private readonly bool _keepMinimum;
+            private int _head;
+            private int _count;
+
+            public MonotonicDeque(int window, bool keepMinimum)
+            {
+                _window = window;
+                _keepMinimum = keepMinimum;
+                _indices = new long[window];
+                _values = new float[window];
+            }
+
+            public float Front => _values[_head];
+
+            public void Add(long index, float value)
+            {
+                // Expire the front once it leaves the window
+                if(_count > 0 && _indices[_head] <= index - _window)
+                {
+                    _head = (_head + 1) % _window;
+                    _count--;
+                }
+
+                // Drop values from the back that can never be the extreme again
+                while(_count > 0)
+                {
+                    var back = (_head + _count - 1) % _window;
+                    var dominated = _keepMinimum ? _values[back] >= value : _values[back] <= value;
+                    if(!dominated)
+                    {
+                        break;
+                    }
+                    _count--;
+                }
+
+                var tail = (_head + _count) % _window;
+                _indices[tail] = index;
+                _values[tail] = value;
+                _count++;
+            }
+        }
+    }
+}
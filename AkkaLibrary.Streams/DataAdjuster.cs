@@ -2,13 +2,18 @@ using System;
 using System.Collections.Generic;
 using System.Collections.Immutable;
 using System.Linq;
+using System.Runtime.CompilerServices;
+using Akka;
 using Akka.Actor;
 using Akka.Streams;
 using Akka.Streams.Dsl;
 using AkkaLibrary.Common.Interfaces;
+using AkkaLibrary.Common.Metrics;
 using AkkaLibrary.Common.Objects;
 using AkkaLibrary.Streams.GraphStages;
 
+[assembly: InternalsVisibleTo("AkkaLibrary.Streams.Test")]
+
 namespace AkkaLibrary.Streams
 {
     public class ChannelAdjusterConfig
@@ -23,13 +28,24 @@ namespace AkkaLibrary.Streams
 
         public int TemporalOffset { get; }
 
+        /// <summary>
+        /// Limits for the digitals created with <see cref="FilterOption.CreateDigitals"/>
+        /// </summary>
+        public ChannelDetectorConfig Detectors { get; }
+
         public ChannelAdjusterConfig(string name, float scale, float offset, int temporalOffset, FilterOption option)
+            : this(name, scale, offset, temporalOffset, option, ChannelDetectorConfig.Disabled)
+        {
+        }
+
+        public ChannelAdjusterConfig(string name, float scale, float offset, int temporalOffset, FilterOption option, ChannelDetectorConfig detectors)
         {
             Name = name;
             Scale = scale;
             Offset = offset;
             Option = option;
             TemporalOffset = temporalOffset;
+            Detectors = detectors ?? ChannelDetectorConfig.Disabled;
         }
     }
 
@@ -43,12 +59,23 @@ namespace AkkaLibrary.Streams
 
     public static class DataAdjusterFactory
     {
+        /// <summary>
+        /// Creates a flow that adjusts whole sample blocks in a single fused stage
+        /// </summary>
+        /// <param name="configs">Channels to keep, in output order</param>
+        public static Flow<SampleBlock<float>, SampleBlock<float>, NotUsed> CreateFlow(IEnumerable<ChannelAdjusterConfig> configs)
+            => Flow.FromGraph(new FusedChannelAdjuster(configs));
+
         private static IEnumerable<int> GetIndices(ChannelData<float> sample, IEnumerable<ChannelAdjusterConfig> configs)
         {
             return configs.Select(cfg => sample.Analogs.Select((x, i) => (index: i, data: x)).First(pair => pair.data.Name == cfg.Name).index);
         }
 
-        private static RunnableGraph<ISourceQueueWithComplete<ChannelData<float>>> CreateGraph(IActorRef target, List<ChannelAdjusterConfig> configs, ChannelData<float> sample)
+        /// <summary>
+        /// Creates the per-sample adjuster graph, one set of flows per channel.
+        /// Superseded by <see cref="CreateFlow"/> and kept for comparison.
+        /// </summary>
+        internal static RunnableGraph<ISourceQueueWithComplete<ChannelData<float>>> CreateGraph(IActorRef target, List<ChannelAdjusterConfig> configs, ChannelData<float> sample)
         {
             /*
                 Digital Merger is only necessary when there are additional digitals created and the same goes for the
@@ -83,6 +110,9 @@ namespace AkkaLibrary.Streams
             var bufferSize = temp.Max() + 1;
             var skipFlowsNeeded = skipIndices.Any(x => x != 0);
 
+            // Shows how the analog splitter keeps up with the per-channel flows
+            var splitterMeter = new Meter<IReadOnlyList<DataChannel<float>>>($"{MetricsRegistry.InstanceName("ChannelAdjusterGraph")}.AnalogSplitter");
+
             var graph = GraphDsl.Create(Source.Queue<ChannelData<float>>(10000, OverflowStrategy.Backpressure), (builder, source) =>
             {
                 //Split channel data into sync data, analogs and digitals
@@ -243,6 +273,7 @@ namespace AkkaLibrary.Streams
                     //Splitter analogs to analog splitter.
                     builder.From(channelDataSplitterShape.Out1)
                             .Via(builder.Add(Flow.Create<IReadOnlyList<DataChannel<float>>>().Buffer(bufferSize, OverflowStrategy.Backpressure)))
+                            .Via(splitterMeter)
                             .To(analogSplitterShape.In);
 
                     //=====AdditionalDigitalFlows=====
@@ -297,7 +328,7 @@ namespace AkkaLibrary.Streams
                     //Splitter sync data to merger.
                     builder.From(channelDataSplitterShape.Out0).To(channelDataMergerShape.In0);
                     //Splitter analogs to analog splitter.
-                    builder.From(channelDataSplitterShape.Out1).To(analogSplitterShape.In);
+                    builder.From(channelDataSplitterShape.Out1).Via(splitterMeter).To(analogSplitterShape.In);
 
                     //=====AdditionalDigitalFlows=====
                     if (additionalDigitalFlows.Count > 0)
@@ -0,0 +1,298 @@
+using System;
+using System.Collections.Immutable;
+using System.Linq;
+using Akka.Streams;
+using Akka.Streams.Stage;
+using AkkaLibrary.Common.Interfaces;
+
+namespace AkkaLibrary.Streams.GraphStages
+{
+    /// <summary>
+    /// Batched counterpart of <see cref="MergeClosestN{TIn}"/>
+    ///
+    /// Inputs arrive as batches and merged outputs leave in batches of up to
+    /// maxBatchSize, with the same pairing as the per-element stage. Like
+    /// <see cref="Batcher{T}"/>, a batch is pushed once it is full or flushAfter
+    /// after its first output was merged, whichever is sooner. Input batches
+    /// are disposed once every element has been taken into the merge buffers.
+    /// </summary>
+    public class BatchedMergeClosestN<TIn> : GraphStage<UniformFanInShape<ElementBatch<TIn>, ElementBatch<IImmutableList<TIn>>>>
+        where TIn : class, ISyncData
+    {
+        private readonly int _n;
+        private readonly int _maxBatchSize;
+        private readonly int _bufferSize;
+        private readonly TimeSpan _flushAfter;
+
+        /// <param name="n">Number of inputs including the primary</param>
+        /// <param name="maxBatchSize">Merged outputs in a full batch</param>
+        /// <param name="flushAfter">Longest time a merged output waits for its batch to fill</param>
+        /// <param name="bufferSize">Elements buffered per input besides its current batch</param>
+        public BatchedMergeClosestN(int n, int maxBatchSize, TimeSpan flushAfter, int bufferSize = 16)
+        {
+            if(n < 2)
+            {
+                throw new ArgumentException("Requires at least two streams. One primary and at least one secondary.");
+            }
+            if(maxBatchSize < 1)
+            {
+                throw new ArgumentException("A batch must hold at least one element.", nameof(maxBatchSize));
+            }
+            if(flushAfter <= TimeSpan.Zero)
+            {
+                throw new ArgumentException("Flush timeout must be positive.", nameof(flushAfter));
+            }
+            if(bufferSize < 2)
+            {
+                throw new ArgumentException("Each input must buffer at least two elements.", nameof(bufferSize));
+            }
+            _n = n;
+            _maxBatchSize = maxBatchSize;
+            _bufferSize = bufferSize;
+            _flushAfter = flushAfter;
+            Shape = new UniformFanInShape<ElementBatch<TIn>, ElementBatch<IImmutableList<TIn>>>(n);
+
+            PrimaryInlet = Shape.Ins[0];
+            SecondaryInlets = Shape.Ins.Skip(1).ToImmutableList();
+            Out = Shape.Out;
+        }
+
+        public override UniformFanInShape<ElementBatch<TIn>, ElementBatch<IImmutableList<TIn>>> Shape { get; }
+
+        #region Ports
+
+        public Outlet<ElementBatch<IImmutableList<TIn>>> Out { get; }
+        public Inlet<ElementBatch<TIn>> PrimaryInlet { get; }
+        public Inlet<ElementBatch<TIn>> SecondaryInlet(int n) => SecondaryInlets[n];
+        public IImmutableList<Inlet<ElementBatch<TIn>>> SecondaryInlets { get; }
+
+        #endregion
+
+        protected override GraphStageLogic CreateLogic(Attributes inheritedAttributes) => new Logic(this);
+
+        public override string ToString() => "BatchedMergeN";
+
+        protected override Attributes InitialAttributes => Attributes.CreateName(ToString());
+
+        #region Logic
+
+        private sealed class Logic : TimerGraphStageLogic, IOutHandler
+        {
+            private const string FlushTimer = "Flush";
+
+            private readonly BatchedMergeClosestN<TIn> _source;
+            private readonly int _n;
+            private readonly Inlet<ElementBatch<TIn>>[] _inlets;
+            private readonly ClosestMergeState<TIn> _state;
+            private readonly ImmutableArray<TIn>.Builder _row;
+
+            // Batch each input is being read from and the next element to take from it
+            private readonly ElementBatch<TIn>[] _batches;
+            private readonly int[] _cursors;
+
+            // Merged outputs not yet pushed, and whether their flush timeout has passed
+            private ElementBatch<IImmutableList<TIn>> _output;
+            private bool _due;
+
+            public Logic(BatchedMergeClosestN<TIn> source) : base(source.Shape)
+            {
+                _source = source;
+                _n = source._n;
+                _inlets = source.Shape.Ins.ToArray();
+                _state = new ClosestMergeState<TIn>(_n, source._bufferSize);
+                _row = ImmutableArray.CreateBuilder<TIn>(_n);
+                _batches = new ElementBatch<TIn>[_n];
+                _cursors = new int[_n];
+
+                SetHandler(source.Out, this);
+
+                for (int i = 0; i < _n; i++)
+                {
+                    var index = i;
+                    SetHandler(
+                        _inlets[index],
+                        onPush: () =>
+                        {
+                            _batches[index] = Grab(_inlets[index]);
+                            _cursors[index] = 0;
+                            Feed(index);
+                            TryMerge();
+                        },
+                        onUpstreamFinish: () =>
+                        {
+                            Feed(index);
+                            if(_state.IsExhausted(index))
+                            {
+                                Finish();
+                                return;
+                            }
+                            TryMerge();
+                        });
+                }
+            }
+
+            public override void PreStart()
+            {
+                for (int i = 0; i < _n; i++)
+                {
+                    Pull(_inlets[i]);
+                }
+            }
+
+            public void OnPull()
+            {
+                if(IsOutputReady)
+                {
+                    PushOutput();
+                }
+                TryMerge();
+            }
+
+            public void OnDownstreamFinish() => CompleteStage();
+
+            protected override void OnTimer(object timerKey)
+            {
+                _due = true;
+                if(IsOutputReady && IsAvailable(_source.Out))
+                {
+                    PushOutput();
+                    TryMerge();
+                }
+            }
+
+            public override void PostStop()
+            {
+                foreach (var batch in _batches)
+                {
+                    batch?.Dispose();
+                }
+                _output?.Dispose();
+            }
+
+            /// <summary>
+            /// Moves elements from an input's batch into its merge buffer and
+            /// pulls the next batch once the current one is used up. Returns
+            /// true if any elements were moved.
+            /// </summary>
+            private bool Feed(int index)
+            {
+                var batch = _batches[index];
+                if(batch == null)
+                {
+                    PullOrFinish(index);
+                    return false;
+                }
+
+                var start = _cursors[index];
+                var items = batch.Memory.Span;
+                while(_cursors[index] < items.Length && _state.HasSpace(index))
+                {
+                    _state.Add(index, items[_cursors[index]++]);
+                }
+
+                if(_cursors[index] == batch.Count)
+                {
+                    batch.Dispose();
+                    _batches[index] = null;
+                    PullOrFinish(index);
+                }
+                return _cursors[index] > start;
+            }
+
+            private void PullOrFinish(int index)
+            {
+                var inlet = _inlets[index];
+                if(IsClosed(inlet))
+                {
+                    _state.Finish(index);
+                }
+                else if(!HasBeenPulled(inlet))
+                {
+                    Pull(inlet);
+                }
+            }
+
+            private void TryMerge()
+            {
+                while(_output == null || !_output.IsFull)
+                {
+                    var step = _state.Resolve();
+
+                    if(step == MergeStep.Ready)
+                    {
+                        for (int i = 0; i < _n; i++)
+                        {
+                            _row.Add(_state.Head(i));
+                        }
+                        _state.Take();
+
+                        if(_output == null)
+                        {
+                            _output = ElementBatch<IImmutableList<TIn>>.Rent(_source._maxBatchSize);
+                            ScheduleOnce(FlushTimer, _source._flushAfter);
+                        }
+                        _output.Add(_row.MoveToImmutable());
+                        _row.Capacity = _n;
+                    }
+                    else if(step == MergeStep.Completed)
+                    {
+                        Finish();
+                        return;
+                    }
+
+                    // Skipped elements free buffer space as well as merged ones
+                    var fed = false;
+                    for (int i = 0; i < _n; i++)
+                    {
+                        fed |= Feed(i);
+                    }
+
+                    if(step == MergeStep.Waiting && !fed)
+                    {
+                        // Waiting on upstream
+                        break;
+                    }
+                }
+
+                if(IsOutputReady && IsAvailable(_source.Out))
+                {
+                    PushOutput();
+                }
+            }
+
+            private bool IsOutputReady => _output != null && (_output.IsFull || _due);
+
+            private void PushOutput()
+            {
+                CancelTimer(FlushTimer);
+                Push(_source.Out, _output);
+                _output = null;
+                _due = false;
+            }
+
+            /// <summary>
+            /// Nothing more can be merged without an exhausted input
+            /// </summary>
+            private void Finish()
+            {
+                for (int i = 0; i < _n; i++)
+                {
+                    Cancel(_inlets[i]);
+                }
+
+                CancelTimer(FlushTimer);
+                if(_output != null)
+                {
+                    Emit(_source.Out, _output, CompleteStage);
+                    _output = null;
+                }
+                else
+                {
+                    CompleteStage();
+                }
+            }
+        }
+
+        #endregion
+    }
+}
@@ -0,0 +1,138 @@
+using System;
+using System.Collections.Immutable;
+using Akka.Streams;
+using Akka.Streams.Stage;
+
+namespace AkkaLibrary.Streams.GraphStages
+{
+    /// <summary>
+    /// Batched counterpart of <see cref="UnzipEnumerable{TIn, TOut}"/>
+    ///
+    /// Each input batch is split into one batch per outlet, where outlet k
+    /// receives select(element, k) for every element in order. Nothing is
+    /// allocated per element. The input batch is disposed once split.
+    /// </summary>
+    public class BatchedUnzip<TIn, TOut> : GraphStage<UniformFanOutShape<ElementBatch<TIn>, ElementBatch<TOut>>>
+    {
+        private readonly Func<TIn, int, TOut> _select;
+        private readonly int _n;
+
+        /// <param name="select">Value of an element for the outlet at the given index</param>
+        /// <param name="n">Number of outlets</param>
+        public BatchedUnzip(Func<TIn, int, TOut> select, int n)
+        {
+            _select = select;
+            _n = n;
+
+            Shape = new UniformFanOutShape<ElementBatch<TIn>, ElementBatch<TOut>>(n);
+
+            Outlets = Shape.Outs;
+            In = Shape.In;
+        }
+
+        public IImmutableList<Outlet<ElementBatch<TOut>>> Outlets { get; }
+
+        public Outlet<ElementBatch<TOut>> Out(int i) => Outlets[i];
+
+        public Inlet<ElementBatch<TIn>> In { get; }
+
+        public override string ToString() => "BatchedUnzip";
+
+        public override UniformFanOutShape<ElementBatch<TIn>, ElementBatch<TOut>> Shape { get; }
+
+        protected override GraphStageLogic CreateLogic(Attributes inheritedAttributes) => new Logic(this);
+
+        protected override Attributes InitialAttributes => Attributes.CreateName(ToString());
+
+        #region Logic
+
+        private sealed class Logic : InGraphStageLogic
+        {
+            private readonly BatchedUnzip<TIn, TOut> _stage;
+            private readonly bool[] _pending;
+            private int _pendingCount;
+            private int _downstreamRunning;
+
+            public Logic(BatchedUnzip<TIn, TOut> stage) : base(stage.Shape)
+            {
+                _stage = stage;
+                _pending = new bool[stage._n];
+                _pendingCount = stage._n;
+                _downstreamRunning = stage._n;
+
+                for (int i = 0; i < _pending.Length; i++)
+                {
+                    _pending[i] = true;
+                }
+
+                SetHandler(stage.In, this);
+
+                for (int i = 0; i < stage._n; i++)
+                {
+                    var index = i;
+                    SetHandler(stage.Outlets[index], onPull: () =>
+                    {
+                        _pending[index] = false;
+                        if(--_pendingCount == 0)
+                        {
+                            Pull(_stage.In);
+                        }
+                    },
+                    onDownstreamFinish: () =>
+                    {
+                        if(--_downstreamRunning == 0)
+                        {
+                            CompleteStage();
+                            return;
+                        }
+
+                        if(_pending[index])
+                        {
+                            _pending[index] = false;
+                            _pendingCount--;
+                        }
+                        if(_pendingCount == 0 && !HasBeenPulled(_stage.In))
+                        {
+                            Pull(_stage.In);
+                        }
+                    });
+                }
+            }
+
+            public override void OnPush()
+            {
+                using (var batch = Grab(_stage.In))
+                {
+                    if(batch.Count == 0)
+                    {
+                        Pull(_stage.In);
+                        return;
+                    }
+
+                    for (int k = 0; k < _stage._n; k++)
+                    {
+                        var outlet = _stage.Outlets[k];
+                        if(IsClosed(outlet))
+                        {
+                            continue;
+                        }
+
+                        var column = ElementBatch<TOut>.Rent(batch.Count);
+                        var rows = batch.Memory.Span;
+                        for (int i = 0; i < rows.Length; i++)
+                        {
+                            column.Add(_stage._select(rows[i], k));
+                        }
+
+                        Push(outlet, column);
+                        _pending[k] = true;
+                    }
+                }
+
+                _pendingCount = _downstreamRunning;
+            }
+        }
+
+        #endregion
+    }
+}
@@ -0,0 +1,259 @@
+using System;
+using Akka.Streams;
+using Akka.Streams.Stage;
+
+namespace AkkaLibrary.Streams.GraphStages
+{
+    /// <summary>
+    /// Groups a stream of elements into <see cref="ElementBatch{T}"/>s
+    ///
+    /// A batch is emitted once it holds maxSize elements, or flushAfter after
+    /// its first element arrived, whichever is sooner. While a batch waits for
+    /// downstream the next one is not started and upstream is backpressured.
+    /// A partial batch is emitted when upstream finishes.
+    /// </summary>
+    public class Batcher<T> : GraphStage<FlowShape<T, ElementBatch<T>>>
+    {
+        private readonly int _maxSize;
+        private readonly TimeSpan _flushAfter;
+
+        /// <param name="maxSize">Elements in a full batch</param>
+        /// <param name="flushAfter">Longest time an element waits for its batch to fill</param>
+        public Batcher(int maxSize, TimeSpan flushAfter)
+        {
+            if(maxSize < 1)
+            {
+                throw new ArgumentException("A batch must hold at least one element.", nameof(maxSize));
+            }
+            if(flushAfter <= TimeSpan.Zero)
+            {
+                throw new ArgumentException("Flush timeout must be positive.", nameof(flushAfter));
+            }
+            _maxSize = maxSize;
+            _flushAfter = flushAfter;
+        }
+
+        public override FlowShape<T, ElementBatch<T>> Shape => new FlowShape<T, ElementBatch<T>>(In, Out);
+
+        public Inlet<T> In { get; } = new Inlet<T>("Batcher.In");
+
+        public Outlet<ElementBatch<T>> Out { get; } = new Outlet<ElementBatch<T>>("Batcher.Out");
+
+        public override string ToString() => "Batcher";
+
+        protected override Attributes InitialAttributes => Attributes.CreateName(ToString());
+
+        protected override GraphStageLogic CreateLogic(Attributes inheritedAttributes) => new Logic(this);
+
+        private sealed class Logic : TimerGraphStageLogic, IInHandler, IOutHandler
+        {
+            private const string FlushTimer = "Flush";
+
+            private readonly Batcher<T> _source;
+
+            // Batch being filled, and a closed batch waiting for downstream
+            private ElementBatch<T> _current;
+            private ElementBatch<T> _ready;
+
+            public Logic(Batcher<T> source) : base(source.Shape)
+            {
+                _source = source;
+
+                SetHandler(source.In, this);
+                SetHandler(source.Out, this);
+            }
+
+            public override void PreStart() => Pull(_source.In);
+
+            public void OnPush()
+            {
+                if(_current == null)
+                {
+                    _current = ElementBatch<T>.Rent(_source._maxSize);
+                    ScheduleOnce(FlushTimer, _source._flushAfter);
+                }
+
+                _current.Add(Grab(_source.In));
+
+                if(_current.IsFull)
+                {
+                    Close();
+                }
+                PullIfReady();
+            }
+
+            protected override void OnTimer(object timerKey)
+            {
+                if(_current != null && _ready == null)
+                {
+                    Close();
+                    PullIfReady();
+                }
+            }
+
+            public void OnPull()
+            {
+                if(_ready != null)
+                {
+                    Push(_source.Out, _ready);
+                    _ready = null;
+
+                    // A batch that timed out while the last one waited is due now
+                    if(_current != null && !IsTimerActive(FlushTimer))
+                    {
+                        Close();
+                    }
+                    PullIfReady();
+                }
+            }
+
+            public void OnUpstreamFinish()
+            {
+                CancelTimer(FlushTimer);
+
+                if(_ready != null)
+                {
+                    Emit(_source.Out, _ready);
+                    _ready = null;
+                }
+                if(_current != null)
+                {
+                    Emit(_source.Out, _current);
+                    _current = null;
+                }
+
+                // Completes once the batches above have been emitted
+                Complete(_source.Out);
+            }
+
+            public void OnUpstreamFailure(Exception e) => FailStage(e);
+
+            public void OnDownstreamFinish() => CompleteStage();
+
+            public override void PostStop()
+            {
+                _current?.Dispose();
+                _ready?.Dispose();
+            }
+
+            /// <summary>
+            /// Ends the current batch, pushing it straight away if downstream is waiting
+            /// </summary>
+            private void Close()
+            {
+                CancelTimer(FlushTimer);
+
+                if(IsAvailable(_source.Out))
+                {
+                    Push(_source.Out, _current);
+                }
+                else
+                {
+                    _ready = _current;
+                }
+                _current = null;
+            }
+
+            private void PullIfReady()
+            {
+                if(_ready == null && !HasBeenPulled(_source.In) && !IsClosed(_source.In))
+                {
+                    Pull(_source.In);
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Emits the elements of each <see cref="ElementBatch{T}"/> in order and
+    /// disposes the batch once its last element has been pushed
+    /// </summary>
+    public class Unbatcher<T> : GraphStage<FlowShape<ElementBatch<T>, T>>
+    {
+        public override FlowShape<ElementBatch<T>, T> Shape => new FlowShape<ElementBatch<T>, T>(In, Out);
+
+        public Inlet<ElementBatch<T>> In { get; } = new Inlet<ElementBatch<T>>("Unbatcher.In");
+
+        public Outlet<T> Out { get; } = new Outlet<T>("Unbatcher.Out");
+
+        public override string ToString() => "Unbatcher";
+
+        protected override Attributes InitialAttributes => Attributes.CreateName(ToString());
+
+        protected override GraphStageLogic CreateLogic(Attributes inheritedAttributes) => new Logic(this);
+
+        private sealed class Logic : InAndOutGraphStageLogic
+        {
+            private readonly Unbatcher<T> _source;
+            private ElementBatch<T> _batch;
+            private int _next;
+
+            public Logic(Unbatcher<T> source) : base(source.Shape)
+            {
+                _source = source;
+
+                SetHandler(source.In, this);
+                SetHandler(source.Out, this);
+            }
+
+            public override void OnPush()
+            {
+                _batch = Grab(_source.In);
+                _next = 0;
+
+                if(IsAvailable(_source.Out))
+                {
+                    PushNext();
+                }
+            }
+
+            public override void OnPull()
+            {
+                if(_batch != null)
+                {
+                    PushNext();
+                }
+                else if(!HasBeenPulled(_source.In))
+                {
+                    Pull(_source.In);
+                }
+            }
+
+            public override void OnUpstreamFinish()
+            {
+                if(_batch == null)
+                {
+                    CompleteStage();
+                }
+            }
+
+            public override void PostStop() => _batch?.Dispose();
+
+            private void PushNext()
+            {
+                if(_next < _batch.Count)
+                {
+                    Push(_source.Out, _batch.Memory.Span[_next++]);
+                }
+
+                if(_next < _batch.Count)
+                {
+                    return;
+                }
+
+                _batch.Dispose();
+                _batch = null;
+
+                if(IsClosed(_source.In))
+                {
+                    CompleteStage();
+                }
+                else
+                {
+                    // Fetch the next batch while the last element is consumed
+                    Pull(_source.In);
+                }
+            }
+        }
+    }
+}
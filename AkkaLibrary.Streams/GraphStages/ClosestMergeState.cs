@@ -0,0 +1,190 @@
+using System;
+using AkkaLibrary.Common.Interfaces;
+
+namespace AkkaLibrary.Streams.GraphStages
+{
+    internal enum MergeStep
+    {
+        /// <summary>
+        /// The head of every input forms the next output
+        /// </summary>
+        Ready,
+
+        /// <summary>
+        /// An input needs more elements before the next output is known
+        /// </summary>
+        Waiting,
+
+        /// <summary>
+        /// An input has finished and nothing more can be merged
+        /// </summary>
+        Completed
+    }
+
+    /// <summary>
+    /// Buffers and pairing rules shared by <see cref="MergeClosestN{TIn}"/>
+    /// and <see cref="BatchedMergeClosestN{TIn}"/>
+    ///
+    /// Each element of the primary input (index 0) is paired with the element
+    /// of every secondary input nearest to it in time, and each element is
+    /// used at most once. A primary is skipped when some secondary's nearest
+    /// element is strictly closer to the next primary. Secondary buffers are
+    /// searched with a single forward pointer and inputs already resolved for
+    /// the current primary are not revisited, so each output costs O(n).
+    /// </summary>
+    internal sealed class ClosestMergeState<TIn> where TIn : class, ISyncData
+    {
+        private readonly Ring[] _rings;
+        private readonly bool[] _finished;
+
+        // Secondaries below this index hold their nearest element to the primary head
+        private int _resolved = 1;
+
+        public int Inputs { get; }
+
+        public ClosestMergeState(int inputs, int bufferSize)
+        {
+            Inputs = inputs;
+            _rings = new Ring[inputs];
+            for (int i = 0; i < inputs; i++)
+            {
+                _rings[i] = new Ring(bufferSize);
+            }
+            _finished = new bool[inputs];
+        }
+
+        /// <summary>
+        /// True if the input can take another element now
+        /// </summary>
+        public bool HasSpace(int input) => !_finished[input] && _rings[input].Count < _rings[input].Capacity;
+
+        public void Add(int input, TIn element) => _rings[input].Enqueue(element);
+
+        /// <summary>
+        /// Marks an input as having no more elements
+        /// </summary>
+        public void Finish(int input) => _finished[input] = true;
+
+        /// <summary>
+        /// True once an input has finished and all of its elements are used
+        /// </summary>
+        public bool IsExhausted(int input) => _finished[input] && _rings[input].Count == 0;
+
+        /// <summary>
+        /// Head of an input, valid after <see cref="MergeStep.Ready"/>
+        /// </summary>
+        public TIn Head(int input) => _rings[input].Head;
+
+        /// <summary>
+        /// Drops elements that cannot be merged until every head forms an output
+        /// </summary>
+        public MergeStep Resolve()
+        {
+            while(true)
+            {
+                var primary = _rings[0];
+                if(primary.Count == 0)
+                {
+                    return _finished[0] ? MergeStep.Completed : MergeStep.Waiting;
+                }
+
+                // The next primary decides whether a secondary is closer to it instead
+                var hasNext = primary.Count > 1;
+                if(!hasNext && !_finished[0])
+                {
+                    return MergeStep.Waiting;
+                }
+
+                var ph = primary.Head.TimeStamp;
+                var pn = hasNext ? primary.Second.TimeStamp : 0;
+
+                var skipPrimary = false;
+                while(_resolved < Inputs)
+                {
+                    var ring = _rings[_resolved];
+                    if(ring.Count == 0)
+                    {
+                        return _finished[_resolved] ? MergeStep.Completed : MergeStep.Waiting;
+                    }
+
+                    // Advance to the element nearest the primary head
+                    while(ring.Count > 1 && Math.Abs(ring.Second.TimeStamp - ph) <= Math.Abs(ring.Head.TimeStamp - ph))
+                    {
+                        ring.Dequeue();
+                    }
+
+                    // An earlier element is only known to be nearest once a later one has arrived
+                    var sh = ring.Head.TimeStamp;
+                    if(ring.Count == 1 && sh < ph && !_finished[_resolved])
+                    {
+                        return MergeStep.Waiting;
+                    }
+
+                    if(hasNext && Math.Abs(sh - pn) < Math.Abs(sh - ph))
+                    {
+                        skipPrimary = true;
+                        break;
+                    }
+
+                    _resolved++;
+                }
+
+                if(!skipPrimary)
+                {
+                    return MergeStep.Ready;
+                }
+
+                primary.Dequeue();
+                _resolved = 1;
+            }
+        }
+
+        /// <summary>
+        /// Removes the heads that formed the last output
+        /// </summary>
+        public void Take()
+        {
+            for (int i = 0; i < Inputs; i++)
+            {
+                _rings[i].Dequeue();
+            }
+            _resolved = 1;
+        }
+
+        /// <summary>
+        /// Fixed capacity FIFO with access to its first two elements
+        /// </summary>
+        private sealed class Ring
+        {
+            private readonly TIn[] _items;
+            private int _head;
+
+            public int Count { get; private set; }
+
+            public int Capacity => _items.Length;
+
+            public TIn Head => _items[_head];
+
+            public TIn Second => _items[_head + 1 == _items.Length ? 0 : _head + 1];
+
+            public Ring(int capacity)
+            {
+                _items = new TIn[capacity];
+            }
+
+            public void Enqueue(TIn item)
+            {
+                var tail = _head + Count;
+                _items[tail >= _items.Length ? tail - _items.Length : tail] = item;
+                Count++;
+            }
+
+            public void Dequeue()
+            {
+                _items[_head] = null;
+                _head = _head + 1 == _items.Length ? 0 : _head + 1;
+                Count--;
+            }
+        }
+    }
+}
@@ -0,0 +1,116 @@
+using System;
+using System.Buffers;
+using System.Collections;
+using System.Collections.Generic;
+
+namespace AkkaLibrary.Streams.GraphStages
+{
+    /// <summary>
+    /// Up to <see cref="Capacity"/> elements held in an array rented from
+    /// <see cref="ArrayPool{T}.Shared"/>
+    ///
+    /// Batches are passed between the batched graph stages so that each push
+    /// carries many elements. A batch is owned by whichever stage last
+    /// received it: stages that consume a batch dispose it, and a sink that
+    /// receives batches should dispose them once read. Elements are only valid
+    /// until the batch is disposed, so readers take them through
+    /// <see cref="Memory"/> rather than keeping the array.
+    /// </summary>
+    public sealed class ElementBatch<T> : IReadOnlyList<T>, IDisposable
+    {
+        private T[] _items;
+
+        public int Count { get; private set; }
+
+        public int Capacity { get; }
+
+        public bool IsFull => Count == Capacity;
+
+        /// <summary>
+        /// The elements held, over the pooled array
+        /// </summary>
+        public ReadOnlyMemory<T> Memory => new ReadOnlyMemory<T>(Items, 0, Count);
+
+        private T[] Items => _items ?? throw new ObjectDisposedException(nameof(ElementBatch<T>));
+
+        private ElementBatch(int capacity)
+        {
+            Capacity = capacity;
+            _items = ArrayPool<T>.Shared.Rent(capacity);
+        }
+
+        /// <summary>
+        /// Creates an empty batch with room for <paramref name="capacity"/> elements
+        /// </summary>
+        public static ElementBatch<T> Rent(int capacity)
+        {
+            if(capacity < 1)
+            {
+                throw new ArgumentException("A batch must hold at least one element.", nameof(capacity));
+            }
+            return new ElementBatch<T>(capacity);
+        }
+
+        /// <summary>
+        /// Creates a full batch holding a copy of <paramref name="elements"/>
+        /// </summary>
+        public static ElementBatch<T> From(IReadOnlyList<T> elements)
+        {
+            var batch = Rent(Math.Max(1, elements.Count));
+            for (int i = 0; i < elements.Count; i++)
+            {
+                batch.Add(elements[i]);
+            }
+            return batch;
+        }
+
+        public void Add(T item)
+        {
+            if(IsFull)
+            {
+                throw new InvalidOperationException("Batch is full.");
+            }
+            Items[Count++] = item;
+        }
+
+        public T this[int index]
+        {
+            get
+            {
+                if((uint)index >= (uint)Count)
+                {
+                    throw new ArgumentOutOfRangeException(nameof(index));
+                }
+                return Items[index];
+            }
+        }
+
+        public IEnumerator<T> GetEnumerator()
+        {
+            for (int i = 0; i < Count; i++)
+            {
+                yield return Items[i];
+            }
+        }
+
+        IEnumerator IEnumerable.GetEnumerator() => GetEnumerator();
+
+        /// <summary>
+        /// Returns the array to the pool
+        /// </summary>
+        public void Dispose()
+        {
+            var items = _items;
+            if(items == null)
+            {
+                return;
+            }
+            _items = null;
+
+            // Only the used part can hold references
+            Array.Clear(items, 0, Count);
+            Count = 0;
+            ArrayPool<T>.Shared.Return(items);
+        }
+    }
+}
@@ -0,0 +1,354 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Numerics;
+using Akka.Streams;
+using Akka.Streams.Stage;
+using AkkaLibrary.Common.Metrics;
+using AkkaLibrary.Common.Objects;
+
+namespace AkkaLibrary.Streams.GraphStages
+{
+    /// <summary>
+    /// Single stage channel adjuster operating on whole <see cref="SampleBlock{TData}"/>s.
+    ///
+    /// Selects, reorders, scales and offsets the configured analog channels and
+    /// applies each channel's <see cref="ChannelAdjusterConfig.TemporalOffset"/>,
+    /// replacing the per-channel Unzip/Buffer/Skip/Zip graph built by
+    /// <see cref="DataAdjusterFactory"/>. A channel with a temporal offset of t
+    /// is delayed by t samples relative to the sync data, so an output block is
+    /// only complete once the largest offset worth of samples has arrived and
+    /// early blocks may be shorter than their input.
+    ///
+    /// Channels set to <see cref="FilterOption.CreateDigitals"/> get full-scale
+    /// and flatline digitals computed by a <see cref="ChannelHealthDetector"/>
+    /// in the same pass as their scaling.
+    /// </summary>
+    public class FusedChannelAdjuster : GraphStage<FlowShape<SampleBlock<float>, SampleBlock<float>>>
+    {
+        #region Logic
+
+        private sealed class Logic : InAndOutGraphStageLogic
+        {
+            private readonly FusedChannelAdjuster _stage;
+
+            private ChannelSchema _inputSchema;
+            private ChannelSchema _outputSchema;
+            private int[] _columns;
+
+            // Health detectors and the first generated digital column of each CreateDigitals channel
+            private ChannelHealthDetector[] _detectors;
+            private int[] _detectorColumns;
+
+            // Delay lines are only used when some channel is offset
+            private DelayLine<float>[] _analogLines;
+            private DelayLine<bool>[] _digitalLines;
+            private DelayLine<long> _timestamps;
+            private DelayLine<uint> _tachometerCounts;
+            private DelayLine<long> _masterSyncIncrements;
+            private DelayLine<bool> _masterSyncStates;
+            private DelayLine<long> _sampleIndices;
+            private int _held;
+
+            public Logic(FusedChannelAdjuster stage) : base(stage.Shape)
+            {
+                _stage = stage;
+                SetHandler(stage.In, this);
+                SetHandler(stage.Out, this);
+            }
+
+            public override void OnPush()
+            {
+                var block = Grab(_stage.In);
+
+                if(!ReferenceEquals(block.Schema, _inputSchema))
+                {
+                    Configure(block.Schema);
+                }
+
+                var started = Stopwatch.GetTimestamp();
+                var adjusted = Adjust(block);
+                _stage._adjustTime.RecordSince(started);
+                _stage._samples.Add(block.Length);
+
+                if(adjusted.Length > 0)
+                {
+                    Push(_stage.Out, adjusted);
+                }
+                else
+                {
+                    Pull(_stage.In);
+                }
+            }
+
+            public override void OnPull() => Pull(_stage.In);
+
+            /// <summary>
+            /// Resolves the configured channels against a new input schema.
+            /// Any samples held for temporal alignment are discarded.
+            /// </summary>
+            private void Configure(ChannelSchema schema)
+            {
+                var configs = _stage._configs;
+
+                _columns = configs.Select(cfg =>
+                {
+                    var column = schema.IndexOfAnalog(cfg.Name);
+                    if(column < 0)
+                    {
+                        throw new ArgumentException($"Channel {cfg.Name} is not present in the input.");
+                    }
+                    return column;
+                }).ToArray();
+
+                var generated = configs
+                                .Where(cfg => cfg.Option == FilterOption.CreateDigitals)
+                                .SelectMany(cfg => new[] { $"{cfg.Name}_+FullScale", $"{cfg.Name}_-FullScale", $"{cfg.Name}_Flatlining" });
+
+                _outputSchema = new ChannelSchema(
+                                    configs.Select(cfg => cfg.Name),
+                                    _columns.Select(c => schema.AnalogUnits[c]),
+                                    schema.DigitalNames.Concat(generated));
+                _inputSchema = schema;
+
+                _detectors = new ChannelHealthDetector[configs.Count];
+                _detectorColumns = new int[configs.Count];
+                var digitalColumn = schema.DigitalCount;
+                for (int i = 0; i < configs.Count; i++)
+                {
+                    if(configs[i].Option == FilterOption.CreateDigitals)
+                    {
+                        _detectors[i] = new ChannelHealthDetector(configs[i].Detectors);
+                        _detectorColumns[i] = digitalColumn;
+                        digitalColumn += 3;
+                    }
+                }
+
+                var delay = _stage._delay;
+                _analogLines = configs.Select(_ => new DelayLine<float>(delay)).ToArray();
+                _digitalLines = schema.DigitalNames.Select(_ => new DelayLine<bool>(delay)).ToArray();
+                _timestamps = new DelayLine<long>(delay);
+                _tachometerCounts = new DelayLine<uint>(delay);
+                _masterSyncIncrements = new DelayLine<long>(delay);
+                _masterSyncStates = new DelayLine<bool>(delay);
+                _sampleIndices = new DelayLine<long>(delay);
+                _held = 0;
+            }
+
+            private SampleBlock<float> Adjust(SampleBlock<float> block)
+            {
+                var configs = _stage._configs;
+                var length = block.Length;
+                var window = _held + length;
+                var count = Math.Max(0, window - _stage._delay);
+
+                var output = new SampleBlock<float>(_outputSchema, count);
+
+                // Analogs
+                for (int i = 0; i < configs.Count; i++)
+                {
+                    var (source, start) = Window(_analogLines[i], block.Analogs, _columns[i] * length, length);
+                    var sourceIndex = start + _stage._skips[i];
+
+                    if(configs[i].Option == FilterOption.PassThrough)
+                    {
+                        Array.Copy(source, sourceIndex, output.Analogs, i * count, count);
+                    }
+                    else if(configs[i].Option == FilterOption.CreateDigitals)
+                    {
+                        ScaleOffsetDetect(source, sourceIndex, output, i, count, configs[i], _detectors[i], _detectorColumns[i]);
+                    }
+                    else
+                    {
+                        ScaleOffset(source, sourceIndex, output.Analogs, i * count, count, configs[i].Scale, configs[i].Offset);
+                    }
+                }
+
+                // Input digitals follow the sync data
+                var zeroth = _stage._zeroth;
+                for (int d = 0; d < _digitalLines.Length; d++)
+                {
+                    var (source, start) = Window(_digitalLines[d], block.Digitals, d * length, length);
+                    Array.Copy(source, start + zeroth, output.Digitals, d * count, count);
+                }
+
+                CopySync(_timestamps, block.TimeStamps, output.TimeStamps, length, count);
+                CopySync(_tachometerCounts, block.TachometerCounts, output.TachometerCounts, length, count);
+                CopySync(_masterSyncIncrements, block.MasterSyncIncrements, output.MasterSyncIncrements, length, count);
+                CopySync(_masterSyncStates, block.MasterSyncStates, output.MasterSyncStates, length, count);
+                CopySync(_sampleIndices, block.SampleIndices, output.SampleIndices, length, count);
+
+                if(_stage._delay > 0)
+                {
+                    foreach (var line in _analogLines) line.Retain(window);
+                    foreach (var line in _digitalLines) line.Retain(window);
+                    _timestamps.Retain(window);
+                    _tachometerCounts.Retain(window);
+                    _masterSyncIncrements.Retain(window);
+                    _masterSyncStates.Retain(window);
+                    _sampleIndices.Retain(window);
+                    _held = Math.Min(_stage._delay, window);
+                }
+
+                return output;
+            }
+
+            /// <summary>
+            /// Scales one channel and updates its health digitals in the same pass
+            /// </summary>
+            private static void ScaleOffsetDetect(float[] source, int sourceIndex, SampleBlock<float> output, int channel, int count,
+                                                  ChannelAdjusterConfig config, ChannelHealthDetector detector, int digitalColumn)
+            {
+                var analogs = output.Analogs;
+                var digitals = output.Digitals;
+                var analogIndex = channel * count;
+                var positive = digitalColumn * count;
+                var negative = positive + count;
+                var flat = negative + count;
+                var scale = config.Scale;
+                var offset = config.Offset;
+
+                for (int s = 0; s < count; s++)
+                {
+                    var value = source[sourceIndex + s] * scale + offset;
+                    analogs[analogIndex + s] = value;
+
+                    detector.Update(value);
+                    digitals[positive + s] = detector.PositiveFullScale;
+                    digitals[negative + s] = detector.NegativeFullScale;
+                    digitals[flat + s] = detector.Flatlining;
+                }
+            }
+
+            private void CopySync<T>(DelayLine<T> line, T[] column, T[] destination, int length, int count)
+            {
+                var (source, start) = Window(line, column, 0, length);
+                Array.Copy(source, start + _stage._zeroth, destination, 0, count);
+            }
+
+            /// <summary>
+            /// The held samples followed by the new column. Without any offsets
+            /// the column is read in place.
+            /// </summary>
+            private (T[] source, int start) Window<T>(DelayLine<T> line, T[] column, int offset, int length)
+            {
+                if(_stage._delay == 0)
+                {
+                    return (column, offset);
+                }
+
+                line.Append(column, offset, length);
+                return (line.Values, 0);
+            }
+        }
+
+        /// <summary>
+        /// Holds the last few samples of one column ahead of the next block
+        /// so each block is processed as a contiguous window
+        /// </summary>
+        private sealed class DelayLine<T>
+        {
+            private readonly int _delay;
+            private int _held;
+
+            public T[] Values { get; private set; }
+
+            public DelayLine(int delay)
+            {
+                _delay = delay;
+                Values = new T[delay];
+            }
+
+            public void Append(T[] source, int offset, int length)
+            {
+                if(Values.Length < _held + length)
+                {
+                    var values = new T[_held + length];
+                    Array.Copy(Values, values, _held);
+                    Values = values;
+                }
+                Array.Copy(source, offset, Values, _held, length);
+            }
+
+            public void Retain(int window)
+            {
+                var keep = Math.Min(_delay, window);
+                Array.Copy(Values, window - keep, Values, 0, keep);
+                _held = keep;
+            }
+        }
+
+        #endregion
+
+        private readonly IReadOnlyList<ChannelAdjusterConfig> _configs;
+        private readonly int[] _skips;
+        private readonly int _zeroth;
+        private readonly int _delay;
+
+        private readonly Counter _samples;
+        private readonly LatencyHistogram _adjustTime;
+
+        /// <param name="configs">Channels to keep, in output order</param>
+        /// <param name="name">Prefix of the published metric names. Defaults to one unique to this stage.</param>
+        /// <param name="registry">Registry to publish to. Defaults to <see cref="MetricsRegistry.Default"/>.</param>
+        public FusedChannelAdjuster(IEnumerable<ChannelAdjusterConfig> configs, string name = null, MetricsRegistry registry = null)
+        {
+            registry = registry ?? MetricsRegistry.Default;
+            name = name ?? MetricsRegistry.InstanceName("FusedChannelAdjuster");
+
+            _configs = configs.ToArray();
+            _samples = registry.Counter($"{name}.Samples");
+            _adjustTime = registry.Histogram($"{name}.Adjust");
+
+            if(_configs.Any(cfg => cfg.Option == FilterOption.NotSet))
+            {
+                throw new ArgumentException("Filter Option Not Set is not allowed.");
+            }
+
+            // Window offsets of each channel and of the sync data, as in the
+            // Buffer+Skip graph: the most delayed stream starts at zero
+            var shifts = _configs.Select(cfg => -cfg.TemporalOffset).Append(0).ToArray();
+            var min = shifts.Min();
+            _skips = _configs.Select(cfg => -cfg.TemporalOffset - min).ToArray();
+            _zeroth = -min;
+            _delay = shifts.Max() - min;
+        }
+
+        /// <summary>
+        /// Applies y = x * scale + offset over a contiguous run of values
+        /// </summary>
+        internal static void ScaleOffset(float[] source, int sourceIndex, float[] destination, int destinationIndex, int count, float scale, float offset)
+        {
+            var i = 0;
+            if(Vector.IsHardwareAccelerated)
+            {
+                var width = Vector<float>.Count;
+                var scales = new Vector<float>(scale);
+                var offsets = new Vector<float>(offset);
+                for (; i <= count - width; i += width)
+                {
+                    var values = new Vector<float>(source, sourceIndex + i);
+                    (values * scales + offsets).CopyTo(destination, destinationIndex + i);
+                }
+            }
+
+            for (; i < count; i++)
+            {
+                destination[destinationIndex + i] = source[sourceIndex + i] * scale + offset;
+            }
+        }
+
+        public Inlet<SampleBlock<float>> In { get; } = new Inlet<SampleBlock<float>>("FusedChannelAdjuster.In");
+
+        public Outlet<SampleBlock<float>> Out { get; } = new Outlet<SampleBlock<float>>("FusedChannelAdjuster.Out");
+
+        public override FlowShape<SampleBlock<float>, SampleBlock<float>> Shape => new FlowShape<SampleBlock<float>, SampleBlock<float>>(In, Out);
+
+        public override string ToString() => "FusedChannelAdjuster";
+
+        protected override GraphStageLogic CreateLogic(Attributes inheritedAttributes) => new Logic(this);
+
+        protected override Attributes InitialAttributes => Attributes.CreateName("FusedChannelAdjuster");
+    }
+}
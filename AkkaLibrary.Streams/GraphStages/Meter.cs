@@ -0,0 +1,80 @@
+using System.Diagnostics;
+using Akka.Streams;
+using Akka.Streams.Stage;
+using AkkaLibrary.Common.Metrics;
+
+namespace AkkaLibrary.Streams.GraphStages
+{
+    /// <summary>
+    /// Pass-through stage that publishes how a point in a graph is flowing
+    ///
+    /// Counts elements in "{name}.Elements" and records how long downstream
+    /// takes to pull again after each element in "{name}.Backpressure", so a
+    /// slow stage shows as high backpressure on the meter in front of it.
+    /// Adds one interlocked increment and one histogram record per element.
+    /// </summary>
+    public class Meter<T> : GraphStage<FlowShape<T, T>>
+    {
+        #region Logic
+
+        private sealed class Logic : InAndOutGraphStageLogic
+        {
+            private readonly Meter<T> _stage;
+            private long _pushed;
+
+            public Logic(Meter<T> stage) : base(stage.Shape)
+            {
+                _stage = stage;
+                SetHandler(stage.In, this);
+                SetHandler(stage.Out, this);
+            }
+
+            public override void OnPush()
+            {
+                _stage._elements.Increment();
+                _pushed = Stopwatch.GetTimestamp();
+                Push(_stage.Out, Grab(_stage.In));
+            }
+
+            public override void OnPull()
+            {
+                if(_pushed != 0)
+                {
+                    _stage._backpressure.RecordSince(_pushed);
+                }
+                Pull(_stage.In);
+            }
+        }
+
+        #endregion
+
+        private readonly string _name;
+        private readonly Counter _elements;
+        private readonly LatencyHistogram _backpressure;
+
+        /// <param name="name">Prefix of the published metric names</param>
+        /// <param name="registry">Registry to publish to. Defaults to <see cref="MetricsRegistry.Default"/>.</param>
+        public Meter(string name, MetricsRegistry registry = null)
+        {
+            registry = registry ?? MetricsRegistry.Default;
+
+            _name = name;
+            _elements = registry.Counter($"{name}.Elements");
+            _backpressure = registry.Histogram($"{name}.Backpressure");
+
+            Shape = new FlowShape<T, T>(In, Out);
+        }
+
+        public Inlet<T> In { get; } = new Inlet<T>("Meter.In");
+
+        public Outlet<T> Out { get; } = new Outlet<T>("Meter.Out");
+
+        public override FlowShape<T, T> Shape { get; }
+
+        public override string ToString() => $"Meter({_name})";
+
+        protected override GraphStageLogic CreateLogic(Attributes inheritedAttributes) => new Logic(this);
+
+        protected override Attributes InitialAttributes => Attributes.CreateName("Meter");
+    }
+}
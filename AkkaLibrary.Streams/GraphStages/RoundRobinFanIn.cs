@@ -49,70 +49,94 @@ namespace AkkaLibrary.Streams.GraphStages
                     SetHandler(inlet,
                     onPush:() =>
                     {
-                        // Inlet has a new element.
-
-                        // If the inlet is the current inlet and the outlet is
-                        // available to be pushed, grab the element and push it.
-                        if(inlet == _currentInlet && IsAvailable(_source.Out))
+                        // Inlet has a new element. Only the current inlet may
+                        // deliver; the others hold theirs until it is their turn.
+                        if(inlet == _currentInlet)
                         {
-                            var element = Grab(inlet);
-                            Push(_source.Out, element);
-
-                            // move the iterator to the next
-                            NextInlet();
+                            TryDeliver();
                         }
                     },
                     onUpstreamFinish:() =>
                     {
                         --_upstreamRunning;
-                        if(_upstreamRunning == 0)
+
+                        // A finished inlet may still hold an element that has
+                        // not been grabbed, so only finish once all are taken
+                        if(IsDrained())
                         {
                             CompleteStage();
                         }
-                        else
+                        else if(inlet == _currentInlet)
                         {
-                            if (inlet == _currentInlet)
-                            {
-                                NextInlet();
-                            }
+                            TryDeliver();
                         }
                     });
                 }
             }
 
             // Request from the outlet that an item can be transmitted.
-            public override void OnPull()
+            public override void OnPull() => TryDeliver();
+
+            /// <summary>
+            /// Pushes the current inlet's element if downstream is ready,
+            /// skipping inlets that have finished and hold nothing
+            /// </summary>
+            private void TryDeliver()
             {
-                // If there are no inlets open then complete the stage
-                if(_upstreamRunning == 0)
+                if(!IsAvailable(_source.Out))
                 {
-                    CompleteStage();
+                    return;
                 }
-                
-                // If the current inlet is closed then move to the next
-                while(IsClosed(_currentInlet))
+
+                // If the current inlet is closed and empty then move to the next
+                for (int i = 0; i < _source._n && IsClosed(_currentInlet) && !IsAvailable(_currentInlet); i++)
                 {
                     NextInlet();
                 }
 
-                // If the current inlet has an element to push then grab it
-                
                 // If there is an element to grab then do so.
                 if(IsAvailable(_currentInlet))
                 {
-                    var element = Grab(_currentInlet);
-
                     // then push it to the outlet.
-                    Push(_source.Out, element);
+                    Push(_source.Out, Grab(_currentInlet));
 
                     NextInlet();
+
+                    if(IsDrained())
+                    {
+                        CompleteStage();
+                    }
                 }
                 // Otherwise, pull on the current inlet if it has not been done already
-                else if(!HasBeenPulled(_currentInlet))
+                else if(!IsClosed(_currentInlet) && !HasBeenPulled(_currentInlet))
                 {
                     // Create demand on the inlet
                     Pull(_currentInlet);
                 }
+                else if(IsDrained())
+                {
+                    CompleteStage();
+                }
+            }
+
+            /// <summary>
+            /// True once every inlet has finished and every element has been taken
+            /// </summary>
+            private bool IsDrained()
+            {
+                if(_upstreamRunning > 0)
+                {
+                    return false;
+                }
+
+                foreach (var inlet in _source.Inlets)
+                {
+                    if(IsAvailable(inlet))
+                    {
+                        return false;
+                    }
+                }
+                return true;
             }
         }
 
@@ -0,0 +1,240 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Akka.Streams;
+using Akka.Streams.Stage;
+using AkkaLibrary.Common.Interfaces;
+using AkkaLibrary.Common.Objects;
+
+namespace AkkaLibrary.Streams
+{
+    /// <summary>
+    /// Spatial decimator producing several spacings from one pass over the stream
+    ///
+    /// Outlet i emits a <see cref="SpatialAggregate{T}"/> with the min, max and
+    /// mean of every channel for each interval of spacingsMetres[i] of tacho
+    /// travel, so coarse levels keep the peaks that a first-sample decimator
+    /// would skip. Only the finest level looks at every sample; each coarser
+    /// level folds in the closed intervals of the level below, so intervals
+    /// close on the first finer boundary at or past their spacing. Spacings
+    /// must be ascending and are exact when each divides the next.
+    ///
+    /// Upstream is only pulled once every outlet has taken its pending
+    /// aggregates, so the slowest consumer sets the rate.
+    /// </summary>
+    /// <typeparam name="T"></typeparam>
+    public class MultiResolutionDecimator<T> : GraphStage<UniformFanOutShape<T, SpatialAggregate<T>>> where T : ISyncData
+    {
+        private readonly double _tachosPerMetre;
+        private readonly double[] _spacingsMetres;
+        private readonly int _channels;
+        private readonly Action<T, float[]> _readValues;
+
+        /// <param name="tachosPerMetre">Tachos per metre</param>
+        /// <param name="spacingsMetres">Ascending interval of each level in metres</param>
+        /// <param name="channels">Number of values aggregated per sample</param>
+        /// <param name="readValues">Copies a sample's values into the given array</param>
+        public MultiResolutionDecimator(double tachosPerMetre, IEnumerable<double> spacingsMetres, int channels, Action<T, float[]> readValues)
+        {
+            _spacingsMetres = spacingsMetres.ToArray();
+            if(_spacingsMetres.Length == 0)
+            {
+                throw new ArgumentException("At least one spacing is required.", nameof(spacingsMetres));
+            }
+            for (int i = 1; i < _spacingsMetres.Length; i++)
+            {
+                if(_spacingsMetres[i] <= _spacingsMetres[i - 1])
+                {
+                    throw new ArgumentException("Spacings must be ascending.", nameof(spacingsMetres));
+                }
+            }
+
+            _tachosPerMetre = tachosPerMetre;
+            _channels = channels;
+            _readValues = readValues;
+
+            Shape = new UniformFanOutShape<T, SpatialAggregate<T>>(_spacingsMetres.Length);
+        }
+
+        public override UniformFanOutShape<T, SpatialAggregate<T>> Shape { get; }
+
+        public Inlet<T> In => Shape.In;
+
+        /// <summary>
+        /// Outlet of the level with spacing spacingsMetres[level]
+        /// </summary>
+        public Outlet<SpatialAggregate<T>> Out(int level) => Shape.Out(level);
+
+        protected override GraphStageLogic CreateLogic(Attributes inheritedAttributes) => new Logic(this);
+
+        public override string ToString() => "MultiResolutionDecimator";
+
+        protected override Attributes InitialAttributes => Attributes.CreateName(ToString());
+
+        /// <summary>
+        /// Implementation of stream stage logic
+        /// </summary>
+        private sealed class Logic : GraphStageLogic
+        {
+            private readonly MultiResolutionDecimator<T> _source;
+            private readonly int _levels;
+            private readonly long[] _requiredTachos;
+            private readonly SpatialAccumulator<T>[] _accumulators;
+            private readonly Queue<SpatialAggregate<T>>[] _pending;
+            private readonly float[] _values;
+            private int _pendingCount;
+
+            public Logic(MultiResolutionDecimator<T> source) : base(source.Shape)
+            {
+                _source = source;
+                _levels = source._spacingsMetres.Length;
+                _requiredTachos = source._spacingsMetres.Select(x => (long)Math.Max(x * source._tachosPerMetre, 1)).ToArray();
+                _accumulators = Enumerable.Range(0, _levels).Select(_ => new SpatialAccumulator<T>(source._channels)).ToArray();
+                _pending = Enumerable.Range(0, _levels).Select(_ => new Queue<SpatialAggregate<T>>()).ToArray();
+                _values = new float[source._channels];
+
+                SetHandler(source.In, onPush: OnPush, onUpstreamFinish: OnUpstreamFinish);
+
+                for (int i = 0; i < _levels; i++)
+                {
+                    var level = i;
+                    SetHandler(source.Out(i), onPull: OnPull, onDownstreamFinish: () => OnDownstreamFinish(level));
+                }
+            }
+
+            private void OnPush()
+            {
+                var element = Grab(_source.In);
+
+                var finest = _accumulators[0];
+                if(finest.IsOpen && element.TachometerCount - (long)finest.StartTacho >= _requiredTachos[0])
+                {
+                    Close(0);
+                }
+
+                _source._readValues(element, _values);
+                finest.Add(element, _values);
+
+                Flush();
+                PullIfDrained();
+            }
+
+            private void OnPull()
+            {
+                Flush();
+                PullIfDrained();
+            }
+
+            /// <summary>
+            /// The partly filled interval of every level is emitted before completing
+            /// </summary>
+            private void OnUpstreamFinish()
+            {
+                for (int level = 0; level < _levels; level++)
+                {
+                    if(_accumulators[level].IsOpen)
+                    {
+                        Close(level);
+                    }
+                }
+                Flush();
+            }
+
+            /// <summary>
+            /// Drops what was queued for the cancelled level so the other
+            /// levels are not held back waiting for it to drain
+            /// </summary>
+            private void OnDownstreamFinish(int level)
+            {
+                if(Enumerable.Range(0, _levels).All(i => IsClosed(_source.Out(i))))
+                {
+                    CompleteStage();
+                    return;
+                }
+                _pendingCount -= _pending[level].Count;
+                _pending[level].Clear();
+                Flush();
+                PullIfDrained();
+            }
+
+            /// <summary>
+            /// Emits a level's interval and folds it into the next level,
+            /// closing that level first if the interval starts past its spacing
+            /// </summary>
+            private void Close(int level)
+            {
+                var accumulator = _accumulators[level];
+                Enqueue(level, accumulator.ToAggregate(level, _source._spacingsMetres[level]));
+
+                var coarser = level + 1;
+                if(coarser < _levels)
+                {
+                    var next = _accumulators[coarser];
+                    if(next.IsOpen && accumulator.StartTacho - (long)next.StartTacho >= _requiredTachos[coarser])
+                    {
+                        Close(coarser);
+                    }
+                    next.Merge(accumulator);
+                }
+
+                accumulator.Reset();
+            }
+
+            private void Enqueue(int level, SpatialAggregate<T> aggregate)
+            {
+                // Nobody is listening at this level any more
+                if(IsClosed(_source.Out(level)))
+                {
+                    return;
+                }
+                _pending[level].Enqueue(aggregate);
+                _pendingCount++;
+            }
+
+            private void Flush()
+            {
+                for (int level = 0; level < _levels && _pendingCount > 0; level++)
+                {
+                    var outlet = _source.Out(level);
+                    if(_pending[level].Count > 0 && IsAvailable(outlet))
+                    {
+                        Push(outlet, _pending[level].Dequeue());
+                        _pendingCount--;
+                    }
+                }
+
+                if(_pendingCount == 0 && IsClosed(_source.In))
+                {
+                    CompleteStage();
+                }
+            }
+
+            private void PullIfDrained()
+            {
+                if(_pendingCount == 0 && !HasBeenPulled(_source.In) && !IsClosed(_source.In))
+                {
+                    Pull(_source.In);
+                }
+            }
+        }
+    }
+
+    public static class MultiResolutionDecimator
+    {
+        /// <summary>
+        /// Decimator aggregating the first <paramref name="channels"/> analogs of each sample
+        /// </summary>
+        public static MultiResolutionDecimator<ChannelData<float>> ForChannelData(double tachosPerMetre, IEnumerable<double> spacingsMetres, int channels)
+            => new MultiResolutionDecimator<ChannelData<float>>(
+                    tachosPerMetre,
+                    spacingsMetres,
+                    channels,
+                    (sample, values) =>
+                    {
+                        for (int c = 0; c < values.Length; c++)
+                        {
+                            values[c] = sample.Analogs[c].Value;
+                        }
+                    });
+    }
+}
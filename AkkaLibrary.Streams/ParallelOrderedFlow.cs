@@ -0,0 +1,108 @@
+using System;
+using System.Collections.Generic;
+using Akka;
+using Akka.Streams;
+using Akka.Streams.Dsl;
+using AkkaLibrary.Common.Metrics;
+using AkkaLibrary.Streams.GraphStages;
+
+namespace AkkaLibrary.Streams
+{
+    /// <summary>
+    /// Applies a CPU-bound function across several workers without reordering
+    ///
+    /// Elements are gathered into micro-batches of up to batchSize while the
+    /// workers are busy, dealt to the workers by a <see cref="RoundRobinFanOut{T}"/>
+    /// and collected by a <see cref="RoundRobinFanIn{T}"/>. Each worker is its own
+    /// asynchronous island on the given dispatcher and maps a whole batch in
+    /// one go, so there is no task or message per element. Both fans take the
+    /// workers in the same fixed rotation, which returns batches in the order
+    /// they were dealt. A <see cref="Meter{T}"/> in front of each fan shows
+    /// when one is held back by a slow worker.
+    /// </summary>
+    public static class ParallelOrderedFlow
+    {
+        /// <summary>
+        /// Thread pool dispatcher that Akka.Streams configures for blocking work,
+        /// keeping workers off the default dispatcher
+        /// </summary>
+        public const string DefaultDispatcher = "akka.stream.default-blocking-io-dispatcher";
+
+        /// <param name="work">Function applied to every element</param>
+        /// <param name="parallelism">Number of workers</param>
+        /// <param name="batchSize">Most elements handed to a worker at once</param>
+        /// <param name="dispatcher">Dispatcher the workers run on</param>
+        /// <param name="name">Prefix of the published metric names. Defaults to one unique to this flow.</param>
+        public static Flow<TIn, TOut, NotUsed> Create<TIn, TOut>(
+                                                    Func<TIn, TOut> work,
+                                                    int parallelism,
+                                                    int batchSize = 32,
+                                                    string dispatcher = DefaultDispatcher,
+                                                    string name = null)
+        {
+            if(parallelism < 1)
+            {
+                throw new ArgumentException("At least one worker is required.", nameof(parallelism));
+            }
+            if(batchSize < 1)
+            {
+                throw new ArgumentException("Batch size must be positive.", nameof(batchSize));
+            }
+
+            var batching = Flow.Create<TIn>()
+                               .Batch(batchSize, x => new List<TIn>(batchSize) { x }, (batch, x) =>
+                               {
+                                   batch.Add(x);
+                                   return batch;
+                               });
+
+            if(parallelism == 1)
+            {
+                return batching.Via(CreateWorker(work, dispatcher)).SelectMany(x => x);
+            }
+
+            name = name ?? MetricsRegistry.InstanceName("ParallelOrderedFlow");
+
+            return Flow.FromGraph(GraphDsl.Create(builder =>
+            {
+                var batcher = builder.Add(batching);
+                var distributer = builder.Add(new RoundRobinFanOut<List<TIn>>(parallelism));
+                var merger = builder.Add(new RoundRobinFanIn<TOut[]>(parallelism));
+                var flatten = builder.Add(Flow.Create<TOut[]>().SelectMany(x => x));
+
+                builder.From(batcher).Via(new Meter<List<TIn>>($"{name}.FanOut")).To(distributer.In);
+
+                for (int i = 0; i < parallelism; i++)
+                {
+                    builder.From(distributer.Out(i))
+                           .Via(CreateWorker(work, dispatcher))
+                           .Via(new Meter<TOut[]>($"{name}.FanIn{i}"))
+                           .To(merger.In(i));
+                }
+
+                builder.From(merger.Out).To(flatten);
+
+                return new FlowShape<TIn, TOut>(batcher.Inlet, flatten.Outlet);
+            }));
+        }
+
+        /// <summary>
+        /// Maps whole batches on its own island. The single element input
+        /// buffer makes a busy worker backpressure at once, so batches grow
+        /// instead of queueing.
+        /// </summary>
+        private static Flow<List<TIn>, TOut[], NotUsed> CreateWorker<TIn, TOut>(Func<TIn, TOut> work, string dispatcher)
+            => Flow.Create<List<TIn>>()
+                   .Select(batch =>
+                   {
+                       var output = new TOut[batch.Count];
+                       for (int i = 0; i < output.Length; i++)
+                       {
+                           output[i] = work(batch[i]);
+                       }
+                       return output;
+                   })
+                   .WithAttributes(ActorAttributes.CreateDispatcher(dispatcher).And(Attributes.CreateInputBuffer(1, 1)))
+                   .Async();
+    }
+}
@@ -0,0 +1,147 @@
+using System;
+using System.Collections.Generic;
+using AkkaLibrary.Common.Interfaces;
+
+namespace AkkaLibrary.Streams
+{
+    /// <summary>
+    /// Summary of the samples covering one spacing interval of tacho travel
+    /// </summary>
+    /// <typeparam name="T">Sample type</typeparam>
+    public sealed class SpatialAggregate<T> where T : ISyncData
+    {
+        /// <summary>
+        /// Index of the spacing level that produced the aggregate
+        /// </summary>
+        public int Level { get; }
+
+        public double SpacingMetres { get; }
+
+        /// <summary>
+        /// First sample of the interval, for its sync data
+        /// </summary>
+        public T First { get; }
+
+        public uint StartTacho { get; }
+
+        /// <summary>
+        /// Tacho count of the last sample in the interval
+        /// </summary>
+        public uint EndTacho { get; }
+
+        /// <summary>
+        /// Number of samples in the interval
+        /// </summary>
+        public int Count { get; }
+
+        public IReadOnlyList<float> Min { get; }
+        public IReadOnlyList<float> Max { get; }
+        public IReadOnlyList<float> Mean { get; }
+
+        public SpatialAggregate(int level, double spacingMetres, T first, uint startTacho, uint endTacho, int count, float[] min, float[] max, float[] mean)
+        {
+            Level = level;
+            SpacingMetres = spacingMetres;
+            First = first;
+            StartTacho = startTacho;
+            EndTacho = endTacho;
+            Count = count;
+            Min = min;
+            Max = max;
+            Mean = mean;
+        }
+    }
+
+    /// <summary>
+    /// Running min, max and sum of every channel over an interval
+    /// </summary>
+    internal sealed class SpatialAccumulator<T> where T : ISyncData
+    {
+        private readonly float[] _min;
+        private readonly float[] _max;
+        private readonly double[] _sum;
+
+        public bool IsOpen => Count > 0;
+        public T First { get; private set; }
+        public uint StartTacho { get; private set; }
+        public uint EndTacho { get; private set; }
+        public int Count { get; private set; }
+
+        public SpatialAccumulator(int channels)
+        {
+            _min = new float[channels];
+            _max = new float[channels];
+            _sum = new double[channels];
+        }
+
+        public void Add(T sample, float[] values)
+        {
+            if(Count == 0)
+            {
+                First = sample;
+                StartTacho = sample.TachometerCount;
+                Array.Copy(values, _min, values.Length);
+                Array.Copy(values, _max, values.Length);
+                Array.Clear(_sum, 0, _sum.Length);
+            }
+            else
+            {
+                for (int c = 0; c < values.Length; c++)
+                {
+                    var value = values[c];
+                    if(value < _min[c]) _min[c] = value;
+                    if(value > _max[c]) _max[c] = value;
+                }
+            }
+
+            for (int c = 0; c < values.Length; c++)
+            {
+                _sum[c] += values[c];
+            }
+            EndTacho = sample.TachometerCount;
+            Count++;
+        }
+
+        /// <summary>
+        /// Folds a finer closed interval into this one
+        /// </summary>
+        public void Merge(SpatialAccumulator<T> other)
+        {
+            if(Count == 0)
+            {
+                First = other.First;
+                StartTacho = other.StartTacho;
+                Array.Copy(other._min, _min, _min.Length);
+                Array.Copy(other._max, _max, _max.Length);
+                Array.Copy(other._sum, _sum, _sum.Length);
+            }
+            else
+            {
+                for (int c = 0; c < _min.Length; c++)
+                {
+                    if(other._min[c] < _min[c]) _min[c] = other._min[c];
+                    if(other._max[c] > _max[c]) _max[c] = other._max[c];
+                    _sum[c] += other._sum[c];
+                }
+            }
+            EndTacho = other.EndTacho;
+            Count += other.Count;
+        }
+
+        public SpatialAggregate<T> ToAggregate(int level, double spacingMetres)
+        {
+            var mean = new float[_sum.Length];
+            for (int c = 0; c < mean.Length; c++)
+            {
+                mean[c] = (float)(_sum[c] / Count);
+            }
+            return new SpatialAggregate<T>(level, spacingMetres, First, StartTacho, EndTacho, Count, (float[])_min.Clone(), (float[])_max.Clone(), mean);
+        }
+
+        public void Reset()
+        {
+            Count = 0;
+            First = default(T);
+        }
+    }
+}
@@ -1,18 +1,49 @@
 using System;
-using System.Collections.Generic;
 using Akka.Streams;
 using Akka.Streams.Stage;
 
 namespace AkkaLibrary.Streams
 {
+    /// <summary>
+    /// Buffer that drops elements which have waited longer than a timeout
+    ///
+    /// Elements are pulled from upstream until <paramref name="capacity"/> are
+    /// held, after which upstream is backpressured. Downstream receives the
+    /// oldest element that has not expired. Expiry is tracked by a hashed
+    /// timing wheel advanced by a single repeating timer: each slot counts the
+    /// elements that arrived during one tick of the resolution, so a whole
+    /// tick's worth of elements is released from the buffer at once and there
+    /// is no per-element timer. Elements expire no sooner than the timeout and
+    /// at most two resolutions after it.
+    /// </summary>
     public class TimedBufferFlow<T> : GraphStage<FlowShape<T, T>>
     {
         private readonly TimeSpan _timeout;
+        private readonly TimeSpan _resolution;
+        private readonly int _capacity;
 
-        public TimedBufferFlow(TimeSpan timeout)
+        /// <param name="timeout">Time an element may wait before it is dropped</param>
+        /// <param name="capacity">Elements held before upstream is backpressured</param>
+        /// <param name="resolution">Timer tick. Defaults to a sixteenth of the timeout.</param>
+        public TimedBufferFlow(TimeSpan timeout, int capacity = 1 << 20, TimeSpan? resolution = null)
         {
-            
+            if(timeout <= TimeSpan.Zero)
+            {
+                throw new ArgumentException("Timeout must be positive.", nameof(timeout));
+            }
+            if(capacity < 1)
+            {
+                throw new ArgumentException("Capacity must be positive.", nameof(capacity));
+            }
+
             _timeout = timeout;
+            _capacity = capacity;
+            _resolution = resolution ?? TimeSpan.FromTicks(Math.Max(TimeSpan.TicksPerMillisecond, timeout.Ticks / 16));
+
+            if(_resolution <= TimeSpan.Zero || _resolution > timeout)
+            {
+                throw new ArgumentException("Resolution must be positive and no longer than the timeout.", nameof(resolution));
+            }
         }
 
         public override FlowShape<T, T> Shape => new FlowShape<T, T>(In, Out);
@@ -28,25 +59,58 @@ namespace AkkaLibrary.Streams
         /// </summary>
         private sealed class Logic : TimerGraphStageLogic, IInHandler, IOutHandler
         {
-            private Queue<T> _buffer;
-            private readonly TimeSpan _timeout;
+            private readonly TimedBufferFlow<T> _source;
             private readonly object _timerKey;
 
+            // Elements in arrival order. Grows by doubling up to the capacity.
+            private T[] _buffer;
+            private int _head;
+            private int _count;
+
+            // Elements that arrived during tick t are counted in slot t % slots and
+            // expire when the wheel reaches t + _timeoutTicks. One tick is added to
+            // the rounded-up timeout as an element may arrive at the end of its tick.
+            private readonly int[] _wheel;
+            private readonly long _timeoutTicks;
+            private long _tick;
+            private long _oldestTick;
+
             public Logic(TimedBufferFlow<T> source) : base(source.Shape)
             {
-                _buffer = new Queue<T>(100);
-                _timeout = source._timeout;
+                _source = source;
+                _buffer = new T[Math.Min(source._capacity, 64)];
+                _timeoutTicks = (source._timeout.Ticks + source._resolution.Ticks - 1) / source._resolution.Ticks + 1;
+                _wheel = new int[_timeoutTicks + 1];
                 _timerKey = new object();
+
+                SetHandler(source.In, this);
+                SetHandler(source.Out, this);
+            }
+
+            public override void PreStart()
+            {
+                ScheduleRepeatedly(_timerKey, _source._resolution);
+                Pull(_source.In);
             }
 
             public void OnPull()
             {
-                throw new NotImplementedException();
+                if(_count > 0)
+                {
+                    Push(_source.Out, Dequeue());
+                    PullIfSpace();
+                }
             }
 
             public void OnPush()
             {
-                throw new NotImplementedException();
+                Enqueue(Grab(_source.In));
+
+                if(IsAvailable(_source.Out))
+                {
+                    Push(_source.Out, Dequeue());
+                }
+                PullIfSpace();
             }
 
             /// <summary>
@@ -55,7 +119,23 @@ namespace AkkaLibrary.Streams
             /// <param name="timerKey"></param>
             protected override void OnTimer(object timerKey)
             {
-                throw new NotImplementedException();
+                _tick++;
+
+                var expiring = _tick - _timeoutTicks;
+                if(expiring >= _oldestTick)
+                {
+                    var slot = (int)(expiring % _wheel.Length);
+                    Release(_wheel[slot]);
+                    _wheel[slot] = 0;
+                    _oldestTick = expiring + 1;
+                }
+
+                if(_count == 0 && IsClosed(_source.In))
+                {
+                    CompleteStage();
+                    return;
+                }
+                PullIfSpace();
             }
 
             /// <summary>
@@ -63,26 +143,85 @@ namespace AkkaLibrary.Streams
             /// </summary>
             public void OnUpstreamFinish()
             {
-                throw new NotImplementedException();
+                // Buffered elements are still delivered until they expire
+                if(_count == 0)
+                {
+                    CompleteStage();
+                }
             }
 
             /// <summary>
             /// Called when the upstream stage has failed
             /// </summary>
             /// <param name="e"></param>
-            public void OnUpstreamFailure(Exception e)
-            {
-                throw new NotImplementedException();
-            }
+            public void OnUpstreamFailure(Exception e) => FailStage(e);
 
             /// <summary>
             /// Called when the downstream stage has finished
             /// No more requests will come
             /// </summary>
-            public void OnDownstreamFinish()
+            public void OnDownstreamFinish() => CompleteStage();
+
+            private void PullIfSpace()
+            {
+                if(_count < _source._capacity && !HasBeenPulled(_source.In) && !IsClosed(_source.In))
+                {
+                    Pull(_source.In);
+                }
+            }
+
+            private void Enqueue(T element)
+            {
+                if(_count == _buffer.Length)
+                {
+                    Grow();
+                }
+
+                var tail = _head + _count;
+                _buffer[tail >= _buffer.Length ? tail - _buffer.Length : tail] = element;
+                _count++;
+                _wheel[_tick % _wheel.Length]++;
+            }
+
+            private T Dequeue()
             {
-                throw new NotImplementedException();
+                // The head belongs to the oldest slot still holding elements
+                var slot = (int)(_oldestTick % _wheel.Length);
+                while(_wheel[slot] == 0)
+                {
+                    _oldestTick++;
+                    slot = (int)(_oldestTick % _wheel.Length);
+                }
+                _wheel[slot]--;
+
+                var element = _buffer[_head];
+                Release(1);
+                return element;
+            }
+
+            /// <summary>
+            /// Removes elements from the head of the buffer, clearing them in at most two runs
+            /// </summary>
+            private void Release(int count)
+            {
+                var first = Math.Min(count, _buffer.Length - _head);
+                Array.Clear(_buffer, _head, first);
+                Array.Clear(_buffer, 0, count - first);
+
+                _head = (_head + count) % _buffer.Length;
+                _count -= count;
+            }
+
+            private void Grow()
+            {
+                var grown = new T[Math.Min(_source._capacity, _buffer.Length * 2)];
+                var first = Math.Min(_count, _buffer.Length - _head);
+                Array.Copy(_buffer, _head, grown, 0, first);
+                Array.Copy(_buffer, 0, grown, first, _count - first);
+
+                _buffer = grown;
+                _head = 0;
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,230 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using Akka.Actor;
+using Akka.TestKit;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Cluster.Actors;
+using AkkaLibrary.Cluster.Configuration;
+using AkkaLibrary.Common.Interfaces;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class ConfigurationDistributorTests : TestKit
+    {
+        private Address LocalAddress => ((ExtendedActorSystem)Sys).Provider.DefaultAddress;
+
+        private IActorRef CreateDistributor(int retryBudget)
+            => Sys.ActorOf(Props.Create(() => new ConfigurationDistributor(TestActor, retryBudget, TimeSpan.FromMilliseconds(200), 64)));
+
+        private TestProbe CreateConfigurator(bool replies)
+        {
+            var probe = CreateTestProbe();
+            Sys.ActorOf(Props.Create(() => new ConfiguratorStub(probe.Ref, replies)), "configurator");
+            return probe;
+        }
+
+        [Fact]
+        public void PackagesAreAddressedByContent()
+        {
+            var configuration = new SystemConfiguration();
+
+            var small = ConfigurationPackage.Create(configuration, Sys.Serialization, 1, int.MaxValue);
+            var compressed = ConfigurationPackage.Create(configuration, Sys.Serialization, 2, 0);
+
+            small.Compressed.Should().BeFalse();
+            compressed.Compressed.Should().BeTrue();
+            compressed.Hash.Should().Be(small.Hash);
+            compressed.Unpack(Sys.Serialization).Should().BeOfType<SystemConfiguration>();
+        }
+
+        [Fact]
+        public void EqualContentHasAnEqualHash()
+        {
+            var first = ConfigurationPackage.Create(new SystemConfiguration(), Sys.Serialization, 1, int.MaxValue);
+            var second = ConfigurationPackage.Create(new SystemConfiguration(), Sys.Serialization, 2, int.MaxValue);
+            var different = ConfigurationPackage.Create(new SystemConfiguration(new IPluginConfiguration[0]), Sys.Serialization, 3, int.MaxValue);
+
+            second.Hash.Should().Be(first.Hash);
+            second.Checksum.Should().NotBe(first.Checksum);
+            different.Hash.Should().NotBe(first.Hash);
+        }
+
+        [Fact]
+        public void NestedIdsDoNotChangeTheHash()
+        {
+            var first = new SystemConfiguration(new IPluginConfiguration[] { new TaggedConfiguration { Inner = new TaggedConfiguration() } });
+            var second = new SystemConfiguration(new IPluginConfiguration[] { new TaggedConfiguration { Inner = new TaggedConfiguration() } });
+
+            ConfigurationPackage.Create(second, Sys.Serialization, 2, int.MaxValue).Hash
+                .Should().Be(ConfigurationPackage.Create(first, Sys.Serialization, 1, int.MaxValue).Hash);
+        }
+
+        [Fact]
+        public void ContentEqualToAnIdIsHashed()
+        {
+            var tagged = new TaggedConfiguration();
+            tagged.Tag = tagged.Id;
+            var blank = new TaggedConfiguration { Tag = Guid.Empty };
+
+            var first = ConfigurationPackage.Create(new SystemConfiguration(new IPluginConfiguration[] { tagged }), Sys.Serialization, 1, int.MaxValue);
+            var second = ConfigurationPackage.Create(new SystemConfiguration(new IPluginConfiguration[] { blank }), Sys.Serialization, 2, int.MaxValue);
+
+            second.Hash.Should().NotBe(first.Hash);
+        }
+
+        [Fact]
+        public void CorruptPayloadIsRejected()
+        {
+            var package = ConfigurationPackage.Create(new SystemConfiguration(), Sys.Serialization, 1, int.MaxValue);
+            package.Payload[package.Payload.Length / 2] ^= 0xFF;
+
+            package.Invoking(x => x.Unpack(Sys.Serialization)).Should().Throw<InvalidDataException>();
+        }
+
+        [Fact]
+        public void PayloadIsOnlySentToNodesWithoutTheConfiguration()
+        {
+            var configurator = CreateConfigurator(true);
+            var distributor = CreateDistributor(2);
+            var configuration = new SystemConfiguration();
+
+            distributor.Tell(new ConfigurationDistributor.RegisterNode(LocalAddress, "worker"));
+            distributor.Tell(new ConfigurationDistributor.ConfigureRole("worker", configuration));
+
+            configurator.ExpectMsg<ConfigurationDistributor.OfferConfiguration>();
+            var payload = configurator.ExpectMsg<ConfigurationDistributor.ConfigurationPayload>();
+            ExpectMsg<ConfigurationDistributor.NodeConfigured>().Hash.Should().Be(payload.Package.Hash);
+
+            // The node reported holding it, so the same configuration costs nothing
+            distributor.Tell(new ConfigurationDistributor.ConfigureRole("worker", configuration));
+            ExpectMsg<ConfigurationDistributor.NodeConfigured>().ConfigurationId.Should().Be(configuration.Id);
+            configurator.ExpectNoMsg(TimeSpan.FromMilliseconds(500));
+
+            // Reissued under a new message id, it is still the same content
+            var reissued = new SystemConfiguration();
+            distributor.Tell(new ConfigurationDistributor.ConfigureRole("worker", reissued));
+            var configured = ExpectMsg<ConfigurationDistributor.NodeConfigured>();
+            configured.ConfigurationId.Should().Be(reissued.Id);
+            configured.Hash.Should().Be(payload.Package.Hash);
+            configurator.ExpectNoMsg(TimeSpan.FromMilliseconds(500));
+
+            distributor.Tell(new ConfigurationDistributor.ConfigureRole("worker", new SystemConfiguration(new IPluginConfiguration[0])));
+            configurator.ExpectMsg<ConfigurationDistributor.OfferConfiguration>().Version.Should().Be(2);
+        }
+
+        [Fact]
+        public void ConfigurationIsSentAgainWhenARoleReturnsToIt()
+        {
+            var configurator = CreateConfigurator(true);
+            var distributor = CreateDistributor(2);
+            var first = new SystemConfiguration();
+            var second = new SystemConfiguration(new IPluginConfiguration[0]);
+
+            distributor.Tell(new ConfigurationDistributor.RegisterNode(LocalAddress, "worker"));
+            foreach (var configuration in new[] { first, second, first })
+            {
+                distributor.Tell(new ConfigurationDistributor.ConfigureRole("worker", configuration));
+                configurator.ExpectMsg<ConfigurationDistributor.OfferConfiguration>();
+                configurator.ExpectMsg<ConfigurationDistributor.ConfigurationPayload>();
+                ExpectMsg<ConfigurationDistributor.NodeConfigured>();
+            }
+        }
+
+        [Fact]
+        public void NodeCanBeConfiguredOnItsOwn()
+        {
+            var configurator = CreateConfigurator(true);
+            var distributor = CreateDistributor(2);
+            var other = new Address("akka.tcp", "other", "host", 1);
+
+            distributor.Tell(new ConfigurationDistributor.ConfigureNode(LocalAddress, new SystemConfiguration()));
+            configurator.ExpectNoMsg(TimeSpan.FromMilliseconds(200));
+
+            distributor.Tell(new ConfigurationDistributor.RegisterNode(LocalAddress, "worker"));
+            distributor.Tell(new ConfigurationDistributor.RegisterNode(other, "worker"));
+            var configuration = new SystemConfiguration();
+            distributor.Tell(new ConfigurationDistributor.ConfigureNode(LocalAddress, configuration));
+
+            configurator.ExpectMsg<ConfigurationDistributor.OfferConfiguration>();
+            var payload = configurator.ExpectMsg<ConfigurationDistributor.ConfigurationPayload>();
+            var configured = ExpectMsg<ConfigurationDistributor.NodeConfigured>();
+            configured.Hash.Should().Be(payload.Package.Hash);
+            configured.ConfigurationId.Should().Be(configuration.Id);
+
+            // The node already holds the same content, so it is reported configured at once
+            var reissued = new SystemConfiguration();
+            distributor.Tell(new ConfigurationDistributor.ConfigureNode(LocalAddress, reissued));
+            ExpectMsg<ConfigurationDistributor.NodeConfigured>().ConfigurationId.Should().Be(reissued.Id);
+            configurator.ExpectNoMsg(TimeSpan.FromMilliseconds(200));
+        }
+
+        [Fact]
+        public void UnresponsiveNodeIsGivenUpOnAfterItsRetryBudget()
+        {
+            var configurator = CreateConfigurator(false);
+            var distributor = CreateDistributor(2);
+
+            distributor.Tell(new ConfigurationDistributor.RegisterNode(LocalAddress, "worker"));
+            distributor.Tell(new ConfigurationDistributor.ConfigureRole("worker", new SystemConfiguration()));
+
+            configurator.ReceiveN(3);
+            ExpectMsg<ConfigurationDistributor.NodeConfigurationFailed>().Address.Should().Be(LocalAddress);
+            configurator.ExpectNoMsg(TimeSpan.FromMilliseconds(500));
+        }
+
+        /// <summary>
+        /// Plugin configuration with a Guid in its content and a nested configuration
+        /// </summary>
+        private class TaggedConfiguration : IPluginConfiguration
+        {
+            public Guid Id { get; } = Guid.NewGuid();
+
+            public string Name { get; set; } = "Tagged";
+
+            public Guid Tag { get; set; }
+
+            public TaggedConfiguration Inner { get; set; }
+
+            public Props ActorProps => null;
+
+            public string[] SubcribeTopics { get; set; } = new string[0];
+
+            public string[] PublishTopics { get; set; } = new string[0];
+
+            public IConfirmation<IPluginConfiguration> GetConfirmation() => null;
+
+            IConfirmation IConfirmable.GetConfirmation() => GetConfirmation();
+        }
+
+        /// <summary>
+        /// Answers offers and payloads like a node configurator and forwards them to a probe
+        /// </summary>
+        private class ConfiguratorStub : ReceiveActor
+        {
+            private readonly Dictionary<string, string> _applied = new Dictionary<string, string>();
+
+            public ConfiguratorStub(IActorRef probe, bool replies)
+            {
+                Receive<ConfigurationDistributor.OfferConfiguration>(msg =>
+                {
+                    probe.Forward(msg);
+                    if (replies)
+                    {
+                        Sender.Tell(new ConfigurationDistributor.ConfigurationReport(msg.Key, msg.Hash, _applied));
+                    }
+                });
+
+                Receive<ConfigurationDistributor.ConfigurationPayload>(msg =>
+                {
+                    probe.Forward(msg);
+                    msg.Package.Unpack(Context.System.Serialization);
+                    _applied[msg.Key] = msg.Package.Hash;
+                    Sender.Tell(new ConfigurationDistributor.ConfigurationReport(msg.Key, msg.Package.Hash, _applied));
+                });
+            }
+        }
+    }
+}
@@ -0,0 +1,172 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using AkkaLibrary.Common.Objects;
+using AkkaLibrary.Exceedances;
+using FluentAssertions;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace AkkaLibrary.Test
+{
+    /// <summary>
+    /// Evaluates thousands of limits over blocks of smoothed noise with an
+    /// <see cref="ExceedancePlan"/> and with a per-sample, per-limit loop.
+    /// Timings per block are written to the test output; only matching
+    /// events are asserted.
+    /// </summary>
+    [Trait("Category", "Benchmark")]
+    public class ExceedanceBenchmarks
+    {
+        private const int Blocks = 100;
+        private const int BlockLength = 256;
+
+        private readonly ITestOutputHelper _output;
+
+        public ExceedanceBenchmarks(ITestOutputHelper output)
+        {
+            _output = output;
+        }
+
+        private static List<SampleBlock<float>> CreateBlocks(ChannelSchema schema)
+        {
+            var random = new Random(1);
+            var values = new float[schema.AnalogCount];
+            var blocks = new List<SampleBlock<float>>();
+
+            for (int b = 0; b < Blocks; b++)
+            {
+                var channels = new float[schema.AnalogCount][];
+                for (int c = 0; c < channels.Length; c++)
+                {
+                    channels[c] = new float[BlockLength];
+                    for (int s = 0; s < BlockLength; s++)
+                    {
+                        values[c] = (values[c] + (float)(random.NextDouble() - 0.5)) * 0.98f;
+                        channels[c][s] = values[c];
+                    }
+                }
+                blocks.Add(ExceedanceTests.CreateBlock(schema, (long)b * BlockLength, channels));
+            }
+            return blocks;
+        }
+
+        /// <summary>
+        /// Limits spread over every channel, alternating above and below.
+        /// Thresholds further out are crossed less often.
+        /// </summary>
+        private static ExceedanceConfiguration CreateConfiguration(int limits, int channels, float threshold)
+            => new ExceedanceConfiguration(
+                Enumerable.Range(0, limits)
+                          .Select(i => new LimitConfiguration(
+                              $"Limit{i}",
+                              $"Channel{i % channels}",
+                              i % 2 == 0 ? LimitDirection.Above : LimitDirection.Below,
+                              (i % 2 == 0 ? 1 : -1) * (threshold + i % 7 * 0.25f),
+                              0.2f,
+                              i % 3 == 0 ? PersistenceKind.Distance : PersistenceKind.Duration,
+                              100)));
+
+        [Theory]
+        [InlineData(1000, 100, 4f)]
+        [InlineData(5000, 500, 4f)]
+        [InlineData(5000, 500, 1.5f)]
+        public void PlanMatchesPerSampleEvaluation(int limitCount, int channelCount, float threshold)
+        {
+            var schema = new ChannelSchema(Enumerable.Range(0, channelCount).Select(c => $"Channel{c}"), new string[0]);
+            var config = CreateConfiguration(limitCount, channelCount, threshold);
+            var blocks = CreateBlocks(schema);
+
+            // Warm up on a plan of its own so the timed one starts from idle
+            Evaluate(new ExceedancePlan(config), blocks);
+
+            var stopwatch = Stopwatch.StartNew();
+            var actual = Evaluate(new ExceedancePlan(config), blocks);
+            var planTime = stopwatch.Elapsed;
+
+            stopwatch.Restart();
+            var expected = EvaluatePerSample(config, blocks);
+            var perSampleTime = stopwatch.Elapsed;
+
+            _output.WriteLine($"{limitCount} limits over {channelCount} channels, {Blocks} blocks of {BlockLength} samples, {actual.Count} events");
+            _output.WriteLine($"  Plan:       {planTime.TotalMilliseconds * 1000 / Blocks:F1} us/block");
+            _output.WriteLine($"  Per-sample: {perSampleTime.TotalMilliseconds * 1000 / Blocks:F1} us/block");
+
+            actual.Select(Describe).OrderBy(x => x).Should().Equal(expected.OrderBy(x => x));
+        }
+
+        private static List<ExceedanceEvent> Evaluate(ExceedancePlan plan, List<SampleBlock<float>> blocks)
+        {
+            var events = new List<ExceedanceEvent>();
+            foreach (var block in blocks)
+            {
+                plan.Evaluate(block, events);
+            }
+            return events;
+        }
+
+        private static string Describe(ExceedanceEvent e) => $"{e.Limit} {e.Kind} {e.SampleIndex} {e.Peak}";
+
+        /// <summary>
+        /// Straightforward state machine stepping every limit through every sample
+        /// </summary>
+        private static List<string> EvaluatePerSample(ExceedanceConfiguration config, List<SampleBlock<float>> blocks)
+        {
+            var events = new List<string>();
+            var limits = config.Limits;
+            var states = new int[limits.Count];
+            var peaks = new float[limits.Count];
+            var onsets = new long[limits.Count, 3];
+
+            foreach (var block in blocks)
+            {
+                var columns = limits.Select(x => block.Schema.IndexOfAnalog(x.Channel)).ToArray();
+                for (int s = 0; s < block.Length; s++)
+                {
+                    for (int i = 0; i < limits.Count; i++)
+                    {
+                        var limit = limits[i];
+                        var sign = limit.Direction == LimitDirection.Above ? 1 : -1;
+                        var value = sign * block.Analogs[columns[i] * block.Length + s];
+                        var threshold = sign * limit.Threshold;
+                        var distance = limit.Persistence == PersistenceKind.Distance;
+                        var persistence = Math.Ceiling(distance ? limit.PersistenceLength * config.TachosPerMetre : limit.PersistenceLength);
+
+                        if(states[i] == 2 && value < threshold - limit.Hysteresis)
+                        {
+                            events.Add($"{limit.Name} {ExceedanceEventKind.End} {block.SampleIndices[s]} {sign * peaks[i]}");
+                            states[i] = 0;
+                        }
+                        if(states[i] == 1 && value <= threshold)
+                        {
+                            states[i] = 0;
+                        }
+                        if(states[i] == 0 && value > threshold)
+                        {
+                            states[i] = 1;
+                            peaks[i] = float.NegativeInfinity;
+                            onsets[i, 0] = block.SampleIndices[s];
+                            onsets[i, 1] = block.TimeStamps[s];
+                            onsets[i, 2] = block.TachometerCounts[s];
+                        }
+                        if(states[i] != 0)
+                        {
+                            peaks[i] = Math.Max(peaks[i], value);
+                        }
+                        if(states[i] == 1)
+                        {
+                            var elapsed = distance ? block.TachometerCounts[s] - onsets[i, 2] : block.TimeStamps[s] - onsets[i, 1];
+                            if(elapsed >= persistence)
+                            {
+                                events.Add($"{limit.Name} {ExceedanceEventKind.Start} {onsets[i, 0]} {sign * peaks[i]}");
+                                states[i] = 2;
+                            }
+                        }
+                    }
+                }
+            }
+            return events;
+        }
+    }
+}
@@ -0,0 +1,208 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Akka.Streams;
+using Akka.Streams.Dsl;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Objects;
+using AkkaLibrary.Exceedances;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class ExceedanceTests : TestKit
+    {
+        private static readonly ChannelSchema Schema = new ChannelSchema(new[] { "Speed", "Pressure" }, new string[0]);
+
+        /// <summary>
+        /// Block of the given speeds and pressures. Samples are 10 timestamp
+        /// units and 2 tachos apart.
+        /// </summary>
+        internal static SampleBlock<float> CreateBlock(ChannelSchema schema, long firstIndex, params float[][] channels)
+        {
+            var length = channels[0].Length;
+            var block = new SampleBlock<float>(schema, length);
+            for (int c = 0; c < channels.Length; c++)
+            {
+                Array.Copy(channels[c], 0, block.Analogs, c * length, length);
+            }
+            for (int s = 0; s < length; s++)
+            {
+                var index = firstIndex + s;
+                block.SampleIndices[s] = index;
+                block.TimeStamps[s] = index * 10;
+                block.TachometerCounts[s] = (uint)(index * 2);
+            }
+            return block;
+        }
+
+        private static SampleBlock<float> Speeds(long firstIndex, params float[] speeds)
+            => CreateBlock(Schema, firstIndex, speeds, new float[speeds.Length]);
+
+        private static List<ExceedanceEvent> Evaluate(ExceedancePlan plan, params SampleBlock<float>[] blocks)
+        {
+            var events = new List<ExceedanceEvent>();
+            foreach (var block in blocks)
+            {
+                plan.Evaluate(block, events);
+            }
+            return events;
+        }
+
+        private static ExceedancePlan CreatePlan(params LimitConfiguration[] limits)
+            => new ExceedancePlan(new ExceedanceConfiguration(limits, tachosPerMetre: 2));
+
+        [Fact]
+        public void ExceedanceStartsAndEndsAtTheCrossings()
+        {
+            var plan = CreatePlan(new LimitConfiguration("Overspeed", "Speed", LimitDirection.Above, 10));
+
+            var events = Evaluate(plan, Speeds(0, 5, 9, 11, 14, 12, 8, 7));
+
+            events.Select(x => (x.Kind, x.SampleIndex)).Should().Equal((ExceedanceEventKind.Start, 2L), (ExceedanceEventKind.End, 5L));
+            events[0].Channel.Should().Be("Speed");
+            events[0].TimeStamp.Should().Be(20);
+            events[1].Peak.Should().Be(14);
+        }
+
+        [Fact]
+        public void BelowLimitsReportTheirLowestValue()
+        {
+            var plan = CreatePlan(new LimitConfiguration("LowPressure", "Pressure", LimitDirection.Below, -1));
+
+            var events = Evaluate(plan, CreateBlock(Schema, 0, new float[6], new[] { 0f, -2, -5, -3, 0, 0 }));
+
+            events.Select(x => (x.Kind, x.SampleIndex)).Should().Equal((ExceedanceEventKind.Start, 1L), (ExceedanceEventKind.End, 4L));
+            events[1].Peak.Should().Be(-5);
+        }
+
+        [Fact]
+        public void HysteresisHoldsTheExceedanceOpen()
+        {
+            var plan = CreatePlan(new LimitConfiguration("Overspeed", "Speed", LimitDirection.Above, 10, 2, PersistenceKind.Duration, 0));
+
+            var events = Evaluate(plan, Speeds(0, 11, 9, 11, 8.5f, 7.5f, 11));
+
+            events.Select(x => (x.Kind, x.SampleIndex)).Should().Equal(
+                (ExceedanceEventKind.Start, 0L),
+                (ExceedanceEventKind.End, 4L),
+                (ExceedanceEventKind.Start, 5L));
+        }
+
+        [Fact]
+        public void ShortExcursionsDoNotPersist()
+        {
+            // 30 units is four samples past the threshold
+            var plan = CreatePlan(new LimitConfiguration("Overspeed", "Speed", LimitDirection.Above, 10, 0, PersistenceKind.Duration, 30));
+
+            var events = Evaluate(plan, Speeds(0, 11, 11, 11, 5, 11, 11, 11, 11, 5));
+
+            events.Select(x => (x.Kind, x.SampleIndex)).Should().Equal((ExceedanceEventKind.Start, 4L), (ExceedanceEventKind.End, 8L));
+        }
+
+        [Fact]
+        public void PersistenceCarriesAcrossBlocks()
+        {
+            // 3 metres is 6 tachos, three samples after the onset
+            var plan = CreatePlan(new LimitConfiguration("Overspeed", "Speed", LimitDirection.Above, 10, 0, PersistenceKind.Distance, 3));
+
+            Evaluate(plan, Speeds(0, 5, 12), Speeds(2, 12)).Should().BeEmpty();
+            plan.IsExceeding(0).Should().BeFalse();
+
+            var events = Evaluate(plan, Speeds(3, 15, 12), Speeds(5, 12, 12, 0));
+
+            events.Select(x => (x.Kind, x.SampleIndex, x.Peak)).Should().Equal(
+                (ExceedanceEventKind.Start, 1L, 15f),
+                (ExceedanceEventKind.End, 7L, 15f));
+        }
+
+        [Fact]
+        public void ExceedanceOpenAcrossManyBlocksEndsOnce()
+        {
+            var plan = CreatePlan(new LimitConfiguration("Overspeed", "Speed", LimitDirection.Above, 10));
+            var blocks = Enumerable.Range(0, 20).Select(b => Speeds(b * 32, Enumerable.Repeat(11f + b, 32).ToArray())).ToList();
+            blocks.Add(Speeds(640, 0));
+
+            var events = Evaluate(plan, blocks.ToArray());
+
+            events.Select(x => (x.Kind, x.SampleIndex, x.Peak)).Should().Equal(
+                (ExceedanceEventKind.Start, 0L, 11f),
+                (ExceedanceEventKind.End, 640L, 30f));
+        }
+
+        [Fact]
+        public void LimitsOnTheSameChannelAreIndependent()
+        {
+            var plan = CreatePlan(
+                new LimitConfiguration("Warning", "Speed", LimitDirection.Above, 10),
+                new LimitConfiguration("Alarm", "Speed", LimitDirection.Above, 20),
+                new LimitConfiguration("Stalled", "Speed", LimitDirection.Below, 1));
+
+            var events = Evaluate(plan, Speeds(0, 5, 15, 25, 15, 5, 0));
+
+            events.Select(x => (x.Limit, x.Kind, x.SampleIndex)).Should().BeEquivalentTo(new[]
+            {
+                ("Warning", ExceedanceEventKind.Start, 1L),
+                ("Warning", ExceedanceEventKind.End, 4L),
+                ("Alarm", ExceedanceEventKind.Start, 2L),
+                ("Alarm", ExceedanceEventKind.End, 3L),
+                ("Stalled", ExceedanceEventKind.Start, 5L)
+            });
+        }
+
+        [Fact]
+        public void StateIsKeptWhenTheSchemaChanges()
+        {
+            var plan = CreatePlan(new LimitConfiguration("Overspeed", "Speed", LimitDirection.Above, 10));
+            var reordered = new ChannelSchema(new[] { "Pressure", "Speed" }, new string[0]);
+
+            var events = Evaluate(plan,
+                                  Speeds(0, 5, 12),
+                                  CreateBlock(reordered, 2, new[] { 50f, 50f }, new[] { 12f, 5f }));
+
+            events.Select(x => (x.Kind, x.SampleIndex)).Should().Equal((ExceedanceEventKind.Start, 1L), (ExceedanceEventKind.End, 3L));
+        }
+
+        [Fact]
+        public void MissingChannelIsRejected()
+        {
+            var plan = CreatePlan(new LimitConfiguration("Overheat", "Temperature", LimitDirection.Above, 10));
+
+            plan.Invoking(x => x.Evaluate(Speeds(0, 1), new List<ExceedanceEvent>())).Should().Throw<ArgumentException>();
+        }
+
+        [Fact]
+        public void DuplicateLimitNamesAreRejected()
+        {
+            Action create = () => new ExceedanceConfiguration(new[]
+            {
+                new LimitConfiguration("Overspeed", "Speed", LimitDirection.Above, 10),
+                new LimitConfiguration("Overspeed", "Pressure", LimitDirection.Above, 10)
+            });
+
+            create.Should().Throw<ArgumentException>();
+        }
+
+        [Fact]
+        public void DetectorEmitsTheEventsOfEachBlock()
+        {
+            var config = new ExceedanceConfiguration(new[] { new LimitConfiguration("Overspeed", "Speed", LimitDirection.Above, 10) });
+
+            using (var materializer = Sys.Materializer())
+            {
+                var events = Source.From(new[] { Speeds(0, 5, 12, 5, 12), Speeds(4, 5, 5), Speeds(6, 12, 12) })
+                                   .Via(new ExceedanceDetector(config))
+                                   .RunWith(Sink.Seq<ExceedanceEvent>(), materializer)
+                                   .Result;
+
+                events.Select(x => (x.Kind, x.SampleIndex)).Should().Equal(
+                    (ExceedanceEventKind.Start, 1L),
+                    (ExceedanceEventKind.End, 2L),
+                    (ExceedanceEventKind.Start, 3L),
+                    (ExceedanceEventKind.End, 4L),
+                    (ExceedanceEventKind.Start, 6L));
+            }
+        }
+    }
+}
@@ -0,0 +1,175 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using AkkaLibrary.Common.Objects;
+using AkkaLibrary.DataSynchronisation;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class ExtractionPlanTests
+    {
+        private static readonly DataStream Stream = new DataStream
+        {
+            Name = "Fpga",
+            DataType = typeof(ChannelData<float>),
+            Transforms = new List<Transform>
+            {
+                new Transform { Assignment = "Speed", Extractions = new List<string> { "Analogs[Name|Speed].Value" } },
+                new Transform { Assignment = "Gate", Extractions = new List<string> { "Digitals[Gate].Value" } },
+                new Transform { Assignment = "SampleIndex", Extractions = new List<string> { "SampleIndex" } },
+                new Transform { Assignment = "Position.First", Extractions = new List<string> { "Analogs[0].Value" } },
+                new Transform { Assignment = "Values", Extractions = new List<string> { "Analogs[Load].Value", "Analogs[Speed].Value" } },
+            }
+        };
+
+        /// <summary>
+        /// Analog k of sample i holds 10 * i + k and the gate is set on even samples
+        /// </summary>
+        private static ChannelData<float> Sample(long index, params string[] analogs)
+            => new ChannelData<float>(
+                analogs.Select((name, k) => new DataChannel<float>(name, index * 10 + k)),
+                new[] { new DataChannel<bool>("Gate", index % 2 == 0) },
+                0, 0, 0, false, index);
+
+        [Fact]
+        public void TransformsAreWrittenIntoTheOutputRecord()
+        {
+            var plan = new ExtractionPlan<SyncRecord>(Stream);
+            var record = new SyncRecord();
+
+            plan.Apply(Sample(4, "Torque", "Speed", "Load"), record);
+
+            record.Speed.Should().Be(41);
+            record.Gate.Should().BeTrue();
+            record.SampleIndex.Should().Be(4);
+            record.Position.First.Should().Be(40);
+            record.Values.Should().Equal(42, 41);
+        }
+
+        [Fact]
+        public void PlanIsCompiledOnceForAnUnchangedSchema()
+        {
+            var plan = new ExtractionPlan<SyncRecord>(Stream);
+            var record = new SyncRecord();
+
+            for (int i = 0; i < 10; i++)
+            {
+                plan.Apply(Sample(i, "Torque", "Speed", "Load"), record);
+            }
+
+            plan.Compilations.Should().Be(1);
+            record.Speed.Should().Be(91);
+        }
+
+        [Fact]
+        public void PlanIsRecompiledWhenChannelsMove()
+        {
+            var plan = new ExtractionPlan<SyncRecord>(Stream);
+            var record = new SyncRecord();
+
+            plan.Apply(Sample(1, "Torque", "Speed", "Load"), record);
+            plan.Apply(Sample(2, "Load", "Torque", "Speed"), record);
+            plan.Apply(Sample(3, "Load", "Torque", "Speed"), record);
+
+            plan.Compilations.Should().Be(2);
+            record.Speed.Should().Be(32);
+            record.Values.Should().Equal(30, 32);
+        }
+
+        [Fact]
+        public void MissingChannelIsRejected()
+        {
+            var plan = new ExtractionPlan<SyncRecord>(Stream);
+            var record = new SyncRecord();
+
+            plan.Apply(Sample(1, "Torque", "Speed", "Load"), record);
+
+            plan.Invoking(x => x.Apply(Sample(2, "Torque", "Load"), record))
+                .Should().Throw<ArgumentException>();
+        }
+
+        [Fact]
+        public void MissingDictionaryKeyIsRejected()
+        {
+            var plan = new ExtractionPlan<SyncRecord>(ReadingStream);
+            var record = new SyncRecord();
+
+            plan.Apply(new ReadingSample("Speed", 3), record);
+            plan.Apply(new ReadingSample("Speed", 4), record);
+            record.Speed.Should().Be(4);
+
+            plan.Invoking(x => x.Apply(new ReadingSample("Load", 5), record))
+                .Should().Throw<ArgumentException>();
+            plan.Compilations.Should().Be(1);
+        }
+
+        [Fact]
+        public void NullValueOnAnExtractionPathIsRejected()
+        {
+            var plan = new ExtractionPlan<SyncRecord>(ReadingStream);
+            var record = new SyncRecord();
+
+            plan.Apply(new ReadingSample("Speed", 3), record);
+
+            plan.Invoking(x => x.Apply(new ReadingSample("Speed", 4) { Latest = null }, record))
+                .Should().Throw<ArgumentException>();
+            plan.Compilations.Should().Be(1);
+        }
+
+        [Fact]
+        public void ConfigurationCreatesAPlanPerStream()
+        {
+            var config = new DataSyncConfiguration { Streams = new List<DataStream> { Stream, new DataStream { Name = "Other" } } };
+
+            var plans = ExtractionPlanCompiler.CreatePlans<SyncRecord>(config);
+
+            plans.Keys.Should().BeEquivalentTo("Fpga", "Other");
+            plans["Fpga"].IsCompiled.Should().BeFalse();
+        }
+
+        private static readonly DataStream ReadingStream = new DataStream
+        {
+            Name = "Readings",
+            DataType = typeof(ReadingSample),
+            Transforms = new List<Transform>
+            {
+                new Transform { Assignment = "Speed", Extractions = new List<string> { "Readings[Speed].Value" } },
+                new Transform { Assignment = "SampleIndex", Extractions = new List<string> { "Latest.Index" } },
+            }
+        };
+
+        public class ReadingSample
+        {
+            public Dictionary<string, Reading> Readings { get; }
+            public Reading Latest { get; set; }
+
+            public ReadingSample(string name, double value)
+            {
+                Readings = new Dictionary<string, Reading> { [name] = new Reading { Value = value } };
+                Latest = new Reading { Index = (long)value };
+            }
+        }
+
+        public class Reading
+        {
+            public double Value { get; set; }
+            public long Index { get; set; }
+        }
+
+        public class SyncRecord
+        {
+            public double Speed { get; set; }
+            public bool Gate { get; set; }
+            public long SampleIndex { get; set; }
+            public PositionRecord Position { get; } = new PositionRecord();
+            public float[] Values { get; } = new float[2];
+        }
+
+        public class PositionRecord
+        {
+            public float First { get; set; }
+        }
+    }
+}
@@ -0,0 +1,140 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class FpgaPacketDecoderTests
+    {
+        private static readonly List<FpgaChannel> Channels = new List<FpgaChannel>
+        {
+            new FpgaChannel("Analog1", ChannelType.Int16),
+            new FpgaChannel("D1", ChannelType.Bool),
+            new FpgaChannel("Analog2", ChannelType.Int24),
+            new FpgaChannel("D2", ChannelType.Bool),
+            new FpgaChannel("Analog3", ChannelType.Double),
+            new FpgaChannel("D3", ChannelType.Bool),
+        };
+
+        private static byte[] CreatePacket()
+        {
+            // Int16 + Int24 + Double + one byte of digitals per sample
+            var packet = new byte[28];
+            BitConverter.GetBytes((short)-5).CopyTo(packet, 0);
+            packet[2] = 0xFE; packet[3] = 0xFF; packet[4] = 0xFF;
+            BitConverter.GetBytes(3.5).CopyTo(packet, 5);
+            packet[13] = 0b101;
+
+            BitConverter.GetBytes((short)7).CopyTo(packet, 14);
+            packet[16] = 0x01; packet[17] = 0x00; packet[18] = 0x00;
+            BitConverter.GetBytes(-1.0).CopyTo(packet, 19);
+            packet[27] = 0b010;
+            return packet;
+        }
+
+        [Fact]
+        public void SampleLengthRoundsDigitalsUpToWholeBytes()
+        {
+            using (var decoder = new FpgaPacketDecoder(Channels, 2, false))
+            {
+                decoder.SampleLength.Should().Be(14);
+                decoder.PacketLength.Should().Be(28);
+            }
+
+            FpgaPacketDecoder.GetPacketLength(Channels, 2).Should().Be(28);
+        }
+
+        [Fact]
+        public void DecodesPacketIntoColumns()
+        {
+            using (var decoder = new FpgaPacketDecoder(Channels, 2, false))
+            {
+                decoder.Decode(CreatePacket(), 0);
+
+                decoder.Int16s.Should().Equal((short)-5, (short)7);
+                decoder.Int24s.Should().Equal(-2, 1);
+                decoder.Doubles.Should().Equal(3.5, -1.0);
+
+                // Columns are per channel: D1, D2, D3 each for samples 0 and 1
+                decoder.Bools.Should().Equal(new byte[] { 1, 0, 0, 1, 1, 0 });
+                decoder.BoolNames.Should().Equal("D1", "D2", "D3");
+            }
+        }
+
+        [Fact]
+        public void DecodesFromOffset()
+        {
+            var packet = new byte[3].Concat(CreatePacket()).ToArray();
+
+            using (var decoder = new FpgaPacketDecoder(Channels, 2, false))
+            {
+                decoder.Decode(packet, 3);
+
+                decoder.Int16s.Should().Equal((short)-5, (short)7);
+            }
+        }
+
+        /// <summary>
+        /// Skipped unless libfpgadecode has been built with make in SharedLibraries
+        /// </summary>
+        private sealed class NativeFactAttribute : FactAttribute
+        {
+            public NativeFactAttribute()
+            {
+                if(!File.Exists(Path.Combine(AppContext.BaseDirectory, "SharedLibraries", "build", "libfpgadecode.so")))
+                {
+                    Skip = "libfpgadecode is not built.";
+                }
+            }
+        }
+
+        [NativeFact]
+        public void NativeDecoderMatchesTheManagedDecoder()
+        {
+            var mixed = new[] { ChannelType.UInt32, ChannelType.Int16, ChannelType.Int24, ChannelType.Int32, ChannelType.Float, ChannelType.Double }
+                .SelectMany((type, i) => new[] { new FpgaChannel($"A{i}", type), new FpgaChannel($"B{i}", type) })
+                .Concat(Enumerable.Range(0, 11).Select(i => new FpgaChannel($"D{i}", ChannelType.Bool)))
+                .ToList();
+            var int24s = Enumerable.Range(0, 5).Select(i => new FpgaChannel($"C{i}", ChannelType.Int24)).ToList();
+            var random = new Random(27);
+
+            foreach (var channels in new[] { mixed, int24s })
+            {
+                using (var native = new FpgaPacketDecoder(channels, 16))
+                using (var managed = new FpgaPacketDecoder(channels, 16, false))
+                {
+                    native.IsNative.Should().BeTrue();
+
+                    for (int i = 0; i < 10; i++)
+                    {
+                        var packet = new byte[native.PacketLength + 1];
+                        random.NextBytes(packet);
+                        native.Decode(packet, 1);
+                        managed.Decode(packet, 1);
+
+                        native.UInt32s.Should().Equal(managed.UInt32s);
+                        native.Int16s.Should().Equal(managed.Int16s);
+                        native.Int24s.Should().Equal(managed.Int24s);
+                        native.Int32s.Should().Equal(managed.Int32s);
+                        native.Floats.Should().Equal(managed.Floats);
+                        native.Doubles.Should().Equal(managed.Doubles);
+                        native.Bools.Should().Equal(managed.Bools);
+                    }
+                }
+            }
+        }
+
+        [Fact]
+        public void ShortPacketThrows()
+        {
+            using (var decoder = new FpgaPacketDecoder(Channels, 2, false))
+            {
+                Action decode = () => decoder.Decode(new byte[27], 0);
+                decode.Should().Throw<ArgumentException>();
+            }
+        }
+    }
+}
@@ -0,0 +1,210 @@
+using System;
+using System.Buffers;
+using System.Collections.Generic;
+using System.Linq;
+using Akka.IO;
+using Akka.TestKit.Xunit2;
+using FluentAssertions;
+using FsCheck;
+using FsCheck.Xunit;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class FpgaPacketFramerTests : TestKit
+    {
+        private static readonly ByteString Delimiter = ByteString.FromBytes(new byte[] { 0x00, 0x55, 0xAA, 0xFF });
+        private const int PacketLength = 6;
+
+        /// <summary>
+        /// Delimited packets where byte i of packet p is p * 10 + i
+        /// </summary>
+        private static byte[] CreateStream(int packets)
+            => Enumerable.Range(0, packets)
+                         .SelectMany(p => Delimiter.ToArray().Concat(Enumerable.Range(0, PacketLength).Select(i => (byte)(p * 10 + i))))
+                         .ToArray();
+
+        private static byte[] Payload(PooledPacket packet) => packet.Array.Skip(packet.Offset).Take(packet.Count).ToArray();
+
+        private static List<byte[]> ReadAll(FpgaPacketFramer framer)
+        {
+            var packets = new List<byte[]>();
+            while(framer.TryRead(out var packet))
+            {
+                using (packet)
+                {
+                    packets.Add(Payload(packet));
+                }
+            }
+            return packets;
+        }
+
+        [Property(MaxTest = 50)]
+        public Property PacketsAreReassembledAcrossAnySegmentation(PositiveInt segmentLength)
+        {
+            var stream = CreateStream(20);
+            var packets = new List<byte[]>();
+
+            using (var framer = new FpgaPacketFramer(Delimiter, PacketLength, 2))
+            {
+                for (int offset = 0; offset < stream.Length; offset += segmentLength.Get)
+                {
+                    var count = Math.Min(segmentLength.Get, stream.Length - offset);
+                    framer.Write(ByteString.CopyFrom(stream, offset, count));
+                    packets.AddRange(ReadAll(framer));
+                }
+
+                var expected = Enumerable.Range(0, 20)
+                                         .Select(p => Enumerable.Range(0, PacketLength).Select(i => (byte)(p * 10 + i)));
+
+                return (packets.Count == 20
+                        && packets.Zip(expected, (a, b) => a.SequenceEqual(b)).All(x => x)
+                        && framer.BufferedBytes == 0
+                        && framer.DiscardedBytes == 0).ToProperty();
+            }
+        }
+
+        [Fact]
+        public void GarbageIsSkippedToTheNextDelimiter()
+        {
+            using (var framer = new FpgaPacketFramer(Delimiter, PacketLength))
+            {
+                framer.Write(ByteString.FromBytes(new byte[] { 1, 2, 3 }.Concat(CreateStream(2)).ToArray()));
+
+                ReadAll(framer).Should().HaveCount(2);
+                framer.DiscardedBytes.Should().Be(3);
+            }
+        }
+
+        [Fact]
+        public void IncompletePacketsAreHeldBack()
+        {
+            using (var framer = new FpgaPacketFramer(Delimiter, PacketLength))
+            {
+                var stream = CreateStream(1);
+                framer.Write(ByteString.CopyFrom(stream, 0, stream.Length - 1));
+
+                framer.TryRead(out _).Should().BeFalse();
+                framer.BufferedBytes.Should().Be(stream.Length - 1);
+            }
+        }
+
+        [Fact]
+        public void ChunksReturnToThePoolOnceEveryPacketIsDisposed()
+        {
+            var pool = new CountingPool();
+            var stream = CreateStream(6);
+            var packets = new List<PooledPacket>();
+
+            using (var framer = new FpgaPacketFramer(Delimiter, PacketLength, 2, pool))
+            {
+                foreach (var b in stream)
+                {
+                    framer.Write(ByteString.FromBytes(new[] { b }));
+                    if(framer.TryRead(out var packet))
+                    {
+                        packets.Add(packet);
+                    }
+                }
+
+                packets.Should().HaveCount(6);
+                pool.Rented.Should().BeGreaterThan(1);
+
+                // Packets still reference their chunks
+                pool.Returned.Should().Be(0);
+
+                packets.ForEach(x => x.Dispose());
+                pool.Returned.Should().Be(pool.Rented - 1);
+            }
+
+            pool.Returned.Should().Be(pool.Rented);
+        }
+
+        [Fact]
+        public void LargeSegmentsAreCopiedIntoASingleChunk()
+        {
+            var pool = new CountingPool();
+
+            using (var framer = new FpgaPacketFramer(Delimiter, PacketLength, 2, pool))
+            {
+                framer.Write(ByteString.FromBytes(CreateStream(100)));
+
+                pool.Rented.Should().Be(2);
+                ReadAll(framer).Should().HaveCount(100);
+            }
+        }
+
+        [Fact]
+        public void ResetDropsAPartialPacket()
+        {
+            using (var framer = new FpgaPacketFramer(Delimiter, PacketLength))
+            {
+                var stream = CreateStream(1);
+                framer.Write(ByteString.CopyFrom(stream, 0, stream.Length - 1));
+
+                framer.Reset();
+                framer.Write(ByteString.FromBytes(CreateStream(1)));
+
+                ReadAll(framer).Should().ContainSingle().Which.Should().Equal(0, 1, 2, 3, 4, 5);
+                framer.DiscardedBytes.Should().Be(stream.Length - 1);
+            }
+        }
+
+        [Fact]
+        public void FramingActorDropsAPartialPacketWhenReconnected()
+        {
+            var assembler = CreateTestProbe();
+            var reader = CreateTestProbe();
+            var framing = Sys.ActorOf(FpgaFramingActor.GetProps(Delimiter, PacketLength, 1, assembler.Ref));
+            var stream = CreateStream(2);
+
+            framing.Tell(ByteString.CopyFrom(stream, 0, stream.Length - 1), reader.Ref);
+            var packets = assembler.ExpectMsg<FpgaPluginMessages.Packets>();
+            packets.Items.Should().ContainSingle();
+
+            framing.Tell(FpgaPluginMessages.Connected.Instance);
+            framing.Tell(ByteString.FromBytes(CreateStream(1)), reader.Ref);
+
+            var next = assembler.ExpectMsg<FpgaPluginMessages.Packets>();
+            Payload(next.Items.Single()).Should().Equal(0, 1, 2, 3, 4, 5);
+        }
+
+        [Fact]
+        public void FramingActorOnlyRequestsReadsWithinItsBudget()
+        {
+            var assembler = CreateTestProbe();
+            var reader = CreateTestProbe();
+            var framing = Sys.ActorOf(FpgaFramingActor.GetProps(Delimiter, PacketLength, 2, assembler.Ref));
+
+            framing.Tell(ByteString.FromBytes(CreateStream(2)), reader.Ref);
+
+            var packets = assembler.ExpectMsg<FpgaPluginMessages.Packets>();
+            packets.Items.Should().HaveCount(2);
+
+            // Two packets are waiting to be decoded so the socket is held back
+            reader.ExpectNoMsg(TimeSpan.FromMilliseconds(100));
+
+            foreach (var packet in packets.Items)
+            {
+                packet.Dispose();
+            }
+            framing.Tell(new FpgaPluginMessages.PacketsDecoded(2), assembler.Ref);
+
+            reader.ExpectMsg<FpgaPluginMessages.ReadMore>();
+        }
+
+        internal sealed class CountingPool : ArrayPool<byte>
+        {
+            public int Rented { get; private set; }
+            public int Returned { get; private set; }
+
+            public override byte[] Rent(int minimumLength)
+            {
+                Rented++;
+                return new byte[minimumLength];
+            }
+
+            public override void Return(byte[] array, bool clearArray = false) => Returned++;
+        }
+    }
+}
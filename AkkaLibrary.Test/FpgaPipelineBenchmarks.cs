@@ -0,0 +1,158 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+using Akka.Actor;
+using Akka.IO;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Metrics;
+using AkkaLibrary.Common.Objects;
+using FluentAssertions;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace AkkaLibrary.Test
+{
+    /// <summary>
+    /// Drives the acquisition chain from a local <see cref="FpgaSimulator"/>
+    /// through the connection, framing, assembler, converter and channel
+    /// adjuster actors. Throughput, drops and latency percentiles are written
+    /// to the test output; only delivery of every sample is asserted.
+    /// </summary>
+    [Trait("Category", "Benchmark")]
+    public class FpgaPipelineBenchmarks : TestKit
+    {
+        private const int Packets = 20000;
+        private static readonly ByteString Delimiter = ByteString.FromBytes(new byte[] { 0x00, 0x55, 0xAA, 0xFF });
+
+        private static readonly ChannelType[] Mixed =
+        {
+            ChannelType.Int16, ChannelType.Int24, ChannelType.Int32, ChannelType.Float, ChannelType.Double, ChannelType.Bool
+        };
+
+        private readonly ITestOutputHelper _output;
+
+        public FpgaPipelineBenchmarks(ITestOutputHelper output) : base(output: output)
+        {
+            _output = output;
+        }
+
+        private static List<FpgaChannel> CreateChannels(string mix, int count)
+            => Enumerable.Range(0, count)
+                         .Select(c =>
+                         {
+                             var type = mix == nameof(Mixed) ? Mixed[c % Mixed.Length] : (ChannelType)Enum.Parse(typeof(ChannelType), mix);
+                             return new FpgaChannel($"{type}{c}", type);
+                         })
+                         .ToList();
+
+        [Theory]
+        [InlineData("Int16", 8, 32)]
+        [InlineData("Int24", 8, 32)]
+        [InlineData("Mixed", 16, 64)]
+        public void AcquisitionChainDeliversEverySample(string mix, int channelCount, int samplesPerPacket)
+        {
+            var channels = CreateChannels(mix, channelCount);
+            var expected = (long)Packets * samplesPerPacket;
+
+            using (var simulator = new FpgaSimulator(channels, samplesPerPacket, Delimiter, packetLimit: Packets))
+            {
+                var configs = channels.Where(x => x.DataType != ChannelType.Bool)
+                                      .Select(x => new ChannelAdjusterConfig(x.ChannelName, 0.5f, 1, 0, FilterOption.Filter))
+                                      .ToList();
+
+                var arrivals = new SampleArrivals();
+                var probe = Sys.ActorOf(Props.Create(() => new LatencyProbe(simulator, samplesPerPacket)));
+                var adjuster = Sys.ActorOf(ChannelAdjuster.GetProps(configs, probe, arrivals));
+                var conversion = Sys.ActorOf(FpgaConversionPluginActor.GetProps(adjuster, arrivals));
+                var acquisition = Sys.ActorOf(FpgaAcquisitionPluginActor.GetProps());
+
+                acquisition.Tell(new FpgaPluginMessages.Configure(new FpgaAcquisitionConfiguration
+                {
+                    IpAddress = "127.0.0.1",
+                    Port = simulator.Port,
+                    ChannelList = channels,
+                    SamplesPerPacket = samplesPerPacket,
+                    Delimiter = Delimiter,
+                    MaxFrameLength = simulator.PacketLength,
+                    OutputTarget = conversion,
+                    Arrivals = arrivals,
+                    RetryConnectionTimeout = TimeSpan.FromSeconds(1)
+                }));
+
+                // Wait for every sample or for delivery to stall
+                var deadline = Stopwatch.StartNew();
+                var result = probe.Ask<LatencyProbe.Result>(LatencyProbe.Report.Instance).Result;
+                while(result.Samples < expected && deadline.Elapsed < TimeSpan.FromSeconds(60))
+                {
+                    Thread.Sleep(100);
+                    result = probe.Ask<LatencyProbe.Result>(LatencyProbe.Report.Instance).Result;
+                }
+
+                var latencies = result.LatenciesMs.OrderBy(x => x).ToArray();
+                double Percentile(double p) => latencies.Length == 0 ? double.NaN : latencies[(int)Math.Min(latencies.Length - 1, p * latencies.Length)];
+
+                _output.WriteLine($"{mix}: {channelCount} channels, {samplesPerPacket} samples per packet, {simulator.PacketLength} byte packets");
+                _output.WriteLine($"  Sent {simulator.PacketsSent} packets, received {result.Samples} of {expected} samples, {expected - result.Samples} dropped, {result.Gaps} missing in gaps");
+                _output.WriteLine($"  Throughput: {result.Samples / result.Elapsed.TotalSeconds:F0} samples/s over {result.Elapsed.TotalMilliseconds:F0} ms");
+                _output.WriteLine($"  Latency p50 {Percentile(0.5):F2} ms, p95 {Percentile(0.95):F2} ms, p99 {Percentile(0.99):F2} ms, max {Percentile(1):F2} ms");
+
+                result.Samples.Should().Be(expected);
+                result.Gaps.Should().Be(0);
+            }
+        }
+
+        /// <summary>
+        /// Timestamps adjusted blocks on arrival against the simulator's send times
+        /// </summary>
+        private sealed class LatencyProbe : ReceiveActor
+        {
+            private readonly List<double> _latencies = new List<double>();
+            private readonly Stopwatch _elapsed = new Stopwatch();
+            private long _samples;
+            private long _gaps;
+            private long _lastSampleIndex;
+
+            public LatencyProbe(FpgaSimulator simulator, int samplesPerPacket)
+            {
+                Receive<SampleBlock<float>>(block =>
+                {
+                    var now = Stopwatch.GetTimestamp();
+                    _elapsed.Start();
+
+                    var first = block.SampleIndices[0];
+                    var packet = (first - 1) / samplesPerPacket;
+                    _latencies.Add((now - simulator.SendTimeOf(packet)) * 1000.0 / Stopwatch.Frequency);
+
+                    _gaps += first - _lastSampleIndex - 1;
+                    _lastSampleIndex = block.SampleIndices[block.Length - 1];
+                    _samples += block.Length;
+                });
+
+                Receive<Report>(msg => Sender.Tell(new Result(_samples, _gaps, _elapsed.Elapsed, _latencies.ToArray())));
+            }
+
+            public sealed class Report
+            {
+                public static Report Instance { get; } = new Report();
+            }
+
+            public sealed class Result
+            {
+                public long Samples { get; }
+                public long Gaps { get; }
+                public TimeSpan Elapsed { get; }
+                public IReadOnlyList<double> LatenciesMs { get; }
+
+                public Result(long samples, long gaps, TimeSpan elapsed, IReadOnlyList<double> latenciesMs)
+                {
+                    Samples = samples;
+                    Gaps = gaps;
+                    Elapsed = elapsed;
+                    LatenciesMs = latenciesMs;
+                }
+            }
+        }
+    }
+}
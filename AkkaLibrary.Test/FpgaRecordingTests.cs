@@ -0,0 +1,149 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using Akka.TestKit.Xunit2;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class FpgaRecordingTests : TestKit
+    {
+        private static readonly List<FpgaChannel> Channels = new List<FpgaChannel>
+        {
+            new FpgaChannel("Analog1", ChannelType.Int16),
+            new FpgaChannel("D1", ChannelType.Bool),
+        };
+
+        // Int16 plus one byte of digitals for each of two samples
+        private const int PacketLength = 6;
+
+        private readonly string _directory = Path.Combine(Path.GetTempPath(), Guid.NewGuid().ToString());
+        private readonly string _path;
+
+        public FpgaRecordingTests()
+        {
+            Directory.CreateDirectory(_directory);
+            _path = Path.Combine(_directory, "recording");
+        }
+
+        /// <summary>
+        /// Records packets whose Int16 values are 10 * packet + sample, starting at sample index 101
+        /// </summary>
+        private void Record(int packets, long ticksPerPacket = TimeSpan.TicksPerMillisecond)
+        {
+            using (var writer = new FpgaRecordingWriter(_path, Channels, 2, packetsPerSegment: 4, indexInterval: 3))
+            {
+                for (int p = 0; p < packets; p++)
+                {
+                    var packet = new byte[PacketLength];
+                    BitConverter.GetBytes((short)(10 * p)).CopyTo(packet, 0);
+                    BitConverter.GetBytes((short)(10 * p + 1)).CopyTo(packet, 3);
+                    writer.Append(packet, 0, 101 + 2 * p, 1000 + p * ticksPerPacket);
+                }
+            }
+        }
+
+        [Fact]
+        public void PacketsAreReadBackAcrossSegments()
+        {
+            Record(10);
+
+            using (var reader = new FpgaRecordingReader(_path))
+            {
+                reader.PacketCount.Should().Be(10);
+                reader.Header.PacketLength.Should().Be(PacketLength);
+                reader.Header.Channels.Select(x => x.ChannelName).Should().Equal("Analog1", "D1");
+
+                var buffer = new byte[PacketLength];
+                reader.ReadPacket(9, buffer, 0);
+                BitConverter.ToInt16(buffer, 0).Should().Be(90);
+                BitConverter.ToInt16(buffer, 3).Should().Be(91);
+            }
+        }
+
+        [Fact]
+        public void SampleIndicesAndTimesComeFromTheSparseIndex()
+        {
+            Record(10, 30);
+
+            using (var reader = new FpgaRecordingReader(_path))
+            {
+                reader.SampleIndexOf(0).Should().Be(101);
+                reader.SampleIndexOf(7).Should().Be(115);
+                reader.PacketOf(116).Should().Be(7);
+                reader.PacketOf(10000).Should().Be(9);
+
+                // Packet 4 lies between index entries for packets 3 and 6
+                reader.TimestampOf(4).Should().Be(1000 + 4 * 30);
+            }
+        }
+
+        [Fact]
+        public void TimesAfterTheLastIndexEntryKeepItsPace()
+        {
+            Record(11, 30);
+
+            using (var reader = new FpgaRecordingReader(_path))
+            {
+                // The last entry is for packet 9
+                reader.TimestampOf(10).Should().Be(1000 + 10 * 30);
+            }
+        }
+
+        [Fact]
+        public void IndexEntriesAreOnDiskAsTheyAreWritten()
+        {
+            using (var writer = new FpgaRecordingWriter(_path, Channels, 2, packetsPerSegment: 4, indexInterval: 3))
+            {
+                for (int p = 0; p < 4; p++)
+                {
+                    writer.Append(new byte[PacketLength], 0, 101 + 2 * p, 1000 + p);
+                }
+
+                new FileInfo(FpgaRecordingFormat.IndexPath(_path)).Length.Should().Be(2 * FpgaRecordingFormat.IndexEntryLength);
+            }
+        }
+
+        [Fact]
+        public void ReplayFeedsTheAssemblerWithRecordedSampleIndices()
+        {
+            Record(10);
+
+            var output = CreateTestProbe();
+            var assembler = Sys.ActorOf(FpgaSampleAssemblerActor.GetProps(Channels, 2, output.Ref));
+            Sys.ActorOf(FpgaReplayActor.GetProps(_path, 0, assembler, batchPackets: 3, maxBufferedPackets: 4));
+
+            var blocks = Enumerable.Range(0, 10).Select(_ => output.ExpectMsg<FpgaSampleBlock>()).ToList();
+            output.ExpectMsg<FpgaPluginMessages.StreamComplete>();
+
+            blocks.Select(x => x.FirstSampleIndex).Should().Equal(Enumerable.Range(0, 10).Select(p => 101L + 2 * p));
+            blocks.SelectMany(x => x.Int16s).Should().Equal(Enumerable.Range(0, 10).SelectMany(p => new[] { (short)(10 * p), (short)(10 * p + 1) }));
+        }
+
+        [Fact]
+        public void SeekRestartsReplayAtTheSample()
+        {
+            Record(10);
+
+            var output = CreateTestProbe();
+            var assembler = Sys.ActorOf(FpgaSampleAssemblerActor.GetProps(Channels, 2, output.Ref));
+            var replay = Sys.ActorOf(FpgaReplayActor.GetProps(_path, 0, assembler));
+
+            output.ReceiveN(10);
+            output.ExpectMsg<FpgaPluginMessages.StreamComplete>();
+
+            replay.Tell(new FpgaPluginMessages.Seek(115));
+
+            output.ExpectMsg<FpgaSampleBlock>().FirstSampleIndex.Should().Be(115);
+            output.ExpectMsg<FpgaSampleBlock>().FirstSampleIndex.Should().Be(117);
+        }
+
+        protected override void AfterAll()
+        {
+            base.AfterAll();
+            Directory.Delete(_directory, true);
+        }
+    }
+}
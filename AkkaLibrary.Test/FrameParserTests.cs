@@ -0,0 +1,218 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.IO;
+using System.Text;
+using Akka.Actor;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.IOReceiveHandlers;
+using AkkaLibrary.Serial;
+using FluentAssertions;
+using FsCheck;
+using FsCheck.Xunit;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class FrameParserTests : TestKit
+    {
+        private static readonly List<string> Frames = Enumerable.Range(0, 200)
+                                                                .Select(i => new string('a', i % 37) + i)
+                                                                .ToList();
+
+        private static string Text(PooledPacket frame) => Encoding.ASCII.GetString(frame.Array, frame.Offset, frame.Count);
+
+        /// <summary>
+        /// Writes <paramref name="data"/> in segments of <paramref name="segmentLength"/>
+        /// bytes and reads every frame after each one
+        /// </summary>
+        private static List<string> Parse(FrameParser parser, byte[] data, int segmentLength)
+        {
+            var frames = new List<string>();
+            for (int offset = 0; offset < data.Length; offset += segmentLength)
+            {
+                parser.Write(new ReadOnlySpan<byte>(data, offset, Math.Min(segmentLength, data.Length - offset)));
+                while(parser.TryRead(out var frame))
+                {
+                    using (frame)
+                    {
+                        frames.Add(Text(frame));
+                    }
+                }
+            }
+            return frames;
+        }
+
+        [Property(MaxTest = 50)]
+        public Property DelimitedFramesAreFoundAcrossAnySegmentation(PositiveInt segmentLength)
+        {
+            var result = new[] { "!", "\r\n", "<END>" }.All(delimiter =>
+            {
+                var data = Encoding.ASCII.GetBytes(string.Concat(Frames.Select(x => x + delimiter)));
+                using (var parser = FrameParser.Delimited(Encoding.ASCII.GetBytes(delimiter), 100, chunkLength: 256))
+                {
+                    return Parse(parser, data, segmentLength.Get).SequenceEqual(Frames) && parser.BufferedBytes == 0;
+                }
+            });
+            return result.ToProperty();
+        }
+
+        [Property(MaxTest = 50)]
+        public Property LengthPrefixedFramesAreFoundAcrossAnySegmentation(PositiveInt segmentLength)
+        {
+            var result = new[] { (1, false), (2, false), (2, true), (4, true) }.All(format =>
+            {
+                var (prefixLength, bigEndian) = format;
+                var data = Frames.SelectMany(x =>
+                {
+                    var prefix = BitConverter.GetBytes(x.Length).Take(prefixLength).ToArray();
+                    if(bigEndian)
+                    {
+                        Array.Reverse(prefix);
+                    }
+                    return prefix.Concat(Encoding.ASCII.GetBytes(x));
+                }).ToArray();
+
+                using (var parser = FrameParser.LengthPrefixed(prefixLength, 100, bigEndian, chunkLength: 256))
+                {
+                    return Parse(parser, data, segmentLength.Get).SequenceEqual(Frames);
+                }
+            });
+            return result.ToProperty();
+        }
+
+        [Fact]
+        public void FixedLengthFramesHoldBackThePartialTail()
+        {
+            using (var parser = FrameParser.FixedLength(3, chunkLength: 8))
+            {
+                Parse(parser, Encoding.ASCII.GetBytes("abcdefghijk"), 2).Should().Equal("abc", "def", "ghi");
+                parser.BufferedBytes.Should().Be(2);
+            }
+        }
+
+        [Fact]
+        public void OversizedDelimitedFramesAreSkipped()
+        {
+            var data = Encoding.ASCII.GetBytes($"ok1\r\n{new string('x', 300)}\r\nok2\r\n{new string('y', 150)}\r\nok3\r\n");
+
+            using (var parser = FrameParser.Delimited(Encoding.ASCII.GetBytes("\r\n"), 100, chunkLength: 128))
+            {
+                Parse(parser, data, 7).Should().Equal("ok1", "ok2", "ok3");
+                parser.OversizedFrames.Should().Be(2);
+                parser.DiscardedBytes.Should().Be(300 + 2 + 150 + 2);
+            }
+        }
+
+        [Fact]
+        public void DelimiterIsKeptWhenRequested()
+        {
+            using (var parser = FrameParser.Delimited(new[] { (byte)'!' }, 10, includeDelimiter: true))
+            {
+                Parse(parser, Encoding.ASCII.GetBytes("ab!c!"), 1).Should().Equal("ab!", "c!");
+            }
+        }
+
+        [Fact]
+        public void OverlongLengthPrefixThrows()
+        {
+            using (var parser = FrameParser.LengthPrefixed(1, 10))
+            {
+                parser.Write(new byte[] { 20, 1, 2 });
+                Action read = () => parser.TryRead(out _);
+                read.Should().Throw<InvalidDataException>();
+            }
+        }
+
+        [Theory]
+        [InlineData(new byte[] { 1, 2, 1, 2, 3 }, new byte[] { 1, 2, 3 }, 2)]
+        [InlineData(new byte[] { 1, 2 }, new byte[] { 1, 2, 3 }, -1)]
+        [InlineData(new byte[] { 5, 1, 2 }, new byte[] { 1, 2 }, 1)]
+        [InlineData(new byte[] { 5, 1, 1 }, new byte[] { 1, 2 }, -1)]
+        public void IndexOfVerifiesEachFirstByteCandidate(byte[] data, byte[] delimiter, int expected)
+        {
+            FrameParser.IndexOf(data, delimiter).Should().Be(expected);
+        }
+
+        [Fact]
+        public void ReceiveUntilActorSendsEachFrameToTheReader()
+        {
+            var receiver = Sys.ActorOf(ReceiveUntilActor.GetProps("port", "!"));
+
+            receiver.Tell(new ReceiveUntilActor.IOReadResult(Encoding.ASCII.GetBytes("first!sec")));
+            receiver.Tell(new ReceiveUntilActor.IOReadResult(Encoding.ASCII.GetBytes("ond!")));
+
+            foreach (var expected in new[] { "first", "second" })
+            {
+                using (var msg = ExpectMsg<ReceiveUntilActor.FrameReceived>())
+                {
+                    msg.Name.Should().Be("port");
+                    Text(msg.Frame).Should().Be(expected);
+                }
+            }
+        }
+
+        [Fact]
+        public void SharedPooledReadsReturnToThePoolOnceEveryReceiverHasParsedThem()
+        {
+            var pool = new FpgaPacketFramerTests.CountingPool();
+            PooledPacket read;
+            using (var port = FrameParser.FixedLength(6, pool: pool))
+            {
+                port.Write(Encoding.ASCII.GetBytes("first!"));
+                port.TryRead(out read).Should().BeTrue();
+            }
+            var first = Sys.ActorOf(ReceiveUntilActor.GetProps("first", "!"));
+            var second = Sys.ActorOf(ReceiveUntilActor.GetProps("second", "!"));
+
+            first.Tell(new ReceiveUntilActor.IOReadResult(read.Share()));
+            second.Tell(new ReceiveUntilActor.IOReadResult(read));
+
+            for (int i = 0; i < 2; i++)
+            {
+                using (var msg = ExpectMsg<ReceiveUntilActor.FrameReceived>())
+                {
+                    Text(msg.Frame).Should().Be("first");
+                }
+            }
+            AwaitAssert(() => pool.Returned.Should().Be(pool.Rented));
+        }
+
+        [Fact]
+        public void ReceiveUntilActorConfirmsAParsedRead()
+        {
+            var receiver = Sys.ActorOf(ReceiveUntilActor.GetProps("port", "!"));
+
+            receiver.Tell(new ReceiveUntilActor.IOReadResult(Read("first!"), "parsed"));
+
+            ExpectMsg<ReceiveUntilActor.FrameReceived>().Dispose();
+            ExpectMsg("parsed");
+        }
+
+        [Fact]
+        public void SerialPortSupervisorAcksAReadOnceItsReceiversHaveParsedIt()
+        {
+            var supervisor = Sys.ActorOf(Props.Create(() => new SerialPortSupervisor("supervisor")));
+
+            // Nothing to wait for without receivers
+            supervisor.Tell(new SerialPortReadActor.PortReadResult("COM1", Read("first!")));
+            ExpectMsg<SerialPortReadActor.Ack>();
+
+            supervisor.Tell(new SerialPortSupervisor.ReceiveUntilOnPort("COM1"));
+            supervisor.Tell(new SerialPortSupervisor.ReceiveUntilOnPort("COM1"));
+            supervisor.Tell(new SerialPortReadActor.PortReadResult("COM1", Read("second!")));
+            ExpectMsg<SerialPortReadActor.Ack>();
+            ExpectNoMsg(TimeSpan.FromMilliseconds(200));
+        }
+
+        private static PooledPacket Read(string text)
+        {
+            using (var port = FrameParser.FixedLength(text.Length))
+            {
+                port.Write(Encoding.ASCII.GetBytes(text));
+                port.TryRead(out var read).Should().BeTrue();
+                return read;
+            }
+        }
+    }
+}
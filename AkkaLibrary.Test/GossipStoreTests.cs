@@ -0,0 +1,132 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using AkkaLibrary.Cluster.Gossip;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class GossipStoreTests
+    {
+        private static readonly Func<HashSet<int>, HashSet<int>, HashSet<int>> Union = (x, y) => x.Union(y).ToHashSet();
+
+        private static GossipStore<string, HashSet<int>> CreateStore(string node) => new GossipStore<string, HashSet<int>>(node, Union);
+
+        /// <summary>
+        /// One exchange between replicas as run by the gossip actor, returning the entries sent
+        /// </summary>
+        private static int Exchange(GossipStore<string, HashSet<int>> opener, GossipStore<string, HashSet<int>> peer)
+        {
+            if(opener.Summary == peer.Summary)
+            {
+                return 0;
+            }
+
+            opener.Compare(peer.Digests(), out var send, out var request);
+            peer.Merge(opener.Entries(send));
+            var reply = peer.Entries(request);
+            opener.Merge(reply);
+            return send.Count + reply.Count;
+        }
+
+        [Fact]
+        public void VersionVectorsAreOrdered()
+        {
+            var a = VersionVector.Empty.With("a", 1);
+            var ab = a.With("b", 1);
+            var ac = a.With("c", 1);
+
+            a.Compare(ab).Should().Be(VersionOrder.Before);
+            ab.Compare(a).Should().Be(VersionOrder.After);
+            ab.Compare(ac).Should().Be(VersionOrder.Concurrent);
+            ab.Merge(ac).Compare(ab.Merge(ac)).Should().Be(VersionOrder.Same);
+            a.Digest().Should().Be(VersionVector.Empty.With("a", 1).Digest());
+        }
+
+        [Fact]
+        public void OnlyDifferingKeysAreExchanged()
+        {
+            var first = CreateStore("first");
+            var second = CreateStore("second");
+
+            first.Set("shared", new HashSet<int> { 1 });
+            Exchange(first, second).Should().Be(1);
+
+            first.Set("new", new HashSet<int> { 2 });
+            Exchange(second, first).Should().Be(1);
+
+            second.Summary.Should().Be(first.Summary);
+            Exchange(first, second).Should().Be(0);
+        }
+
+        [Fact]
+        public void NewerVersionReplacesOlder()
+        {
+            var first = CreateStore("first");
+            var second = CreateStore("second");
+
+            first.Set("key", new HashSet<int> { 1 });
+            Exchange(first, second);
+            second.Set("key", new HashSet<int> { 2 });
+            Exchange(first, second);
+
+            first.TryGetValue("key", out var value).Should().BeTrue();
+            value.Should().BeEquivalentTo(2);
+        }
+
+        [Fact]
+        public void ConcurrentWritesAreMergedIdenticallyEverywhere()
+        {
+            var first = CreateStore("first");
+            var second = CreateStore("second");
+            var third = CreateStore("third");
+
+            first.Set("key", new HashSet<int> { 1 });
+            second.Set("key", new HashSet<int> { 2 });
+            third.Set("key", new HashSet<int> { 3 });
+
+            Exchange(first, second);
+            Exchange(third, second);
+            Exchange(first, third);
+
+            foreach (var store in new[] { first, second, third })
+            {
+                store.TryGetValue("key", out var value);
+                value.Should().BeEquivalentTo(1, 2, 3);
+                store.Summary.Should().Be(first.Summary);
+            }
+        }
+
+        [Fact]
+        public void RandomGossipConverges()
+        {
+            var random = new Random(7);
+            var stores = Enumerable.Range(0, 16).Select(x => CreateStore($"node{x}")).ToList();
+            for (int i = 0; i < stores.Count; i++)
+            {
+                stores[i].Set($"own{i}", new HashSet<int> { i });
+                stores[i].Set("shared", new HashSet<int> { i });
+            }
+
+            var rounds = 0;
+            while(stores.Select(x => x.Summary).Distinct().Count() > 1)
+            {
+                rounds.Should().BeLessThan(20);
+                rounds++;
+
+                foreach (var store in stores)
+                {
+                    foreach (var peer in stores.Where(x => x != store).OrderBy(x => random.Next()).Take(3).ToList())
+                    {
+                        Exchange(store, peer);
+                    }
+                }
+            }
+
+            stores.Should().OnlyContain(x => x.Count == 17);
+            stores[5].TryGetValue("shared", out var shared);
+            shared.Should().BeEquivalentTo(Enumerable.Range(0, 16));
+        }
+    }
+}
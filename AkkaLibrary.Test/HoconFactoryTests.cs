@@ -2,6 +2,7 @@ using System.Collections.Generic;
 using Xunit;
 using FluentAssertions;
 using AkkaLibrary.Common.Configuration;
+using AkkaLibrary.Common.Serialization;
 using Moq;
 using AkkaLibrary.Cluster.Interfaces;
 using AkkaLibrary.Cluster.Configuration;
@@ -17,6 +18,7 @@ namespace AkkaLibrary.Test
             var cfg = CommonConfigs.BasicConfig();
 
             cfg.GetBoolean("akka.suppress-json-serializer-warning").Should().Be(true);
+            cfg.GetString("akka.actor.serializers.samples").Should().StartWith(typeof(SampleSerializer).FullName);
         }
 
         [Fact]
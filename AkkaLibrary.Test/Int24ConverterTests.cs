@@ -0,0 +1,88 @@
+using System;
+using System.Linq;
+using AkkaLibrary.Common.Utilities;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class Int24ConverterTests
+    {
+        private static byte[] Pack(params int[] values)
+        {
+            var packed = new byte[values.Length * 3];
+            for (int i = 0; i < values.Length; i++)
+            {
+                packed[i * 3] = (byte)values[i];
+                packed[i * 3 + 1] = (byte)(values[i] >> 8);
+                packed[i * 3 + 2] = (byte)(values[i] >> 16);
+            }
+            return packed;
+        }
+
+        [Fact]
+        public void ConvertsWithSignExtension()
+        {
+            var values = new[] { 0, 1, -1, 8388607, -8388608, 0x123456, -0x123456 };
+            var result = new int[values.Length];
+
+            Int24Converter.ToInt32(Pack(values), result).Should().Be(values.Length);
+
+            result.Should().Equal(values);
+        }
+
+        [Fact]
+        public void ConvertsToScaledFloats()
+        {
+            var result = new float[3];
+
+            Int24Converter.ToSingle(Pack(2, -4, 0), result, 0.5f);
+
+            result.Should().Equal(1f, -2f, 0f);
+        }
+
+        [Fact]
+        public void SourceNotMultipleOfThreeThrows()
+        {
+            Action convert = () => Int24Converter.ToInt32(new byte[4], new int[2]);
+            convert.Should().Throw<ArgumentException>();
+        }
+
+        [Fact]
+        public void KernelsMatchConverterForAllLengths()
+        {
+            // Covers the vector bodies and every tail length of the native kernels
+            var random = new Random(24);
+            for (int count = 0; count < 40; count++)
+            {
+                var values = Enumerable.Range(0, count).Select(_ => random.Next(-8388608, 8388608)).ToArray();
+                var packed = Pack(values);
+                var ints = new int[count];
+                var floats = new float[count];
+
+                Int24Kernels.ToInt32(packed, ints).Should().Be(count);
+                Int24Kernels.ToSingle(packed, floats, 2f);
+
+                ints.Should().Equal(values);
+                floats.Should().Equal(values.Select(x => x * 2f));
+            }
+        }
+
+        [Fact]
+        public void AllInt24PacketDecodesIntoColumns()
+        {
+            var channels = new[]
+            {
+                new FpgaChannel("A", ChannelType.Int24),
+                new FpgaChannel("B", ChannelType.Int24),
+            };
+
+            using (var decoder = new FpgaPacketDecoder(channels, 3, false))
+            {
+                decoder.Decode(Pack(1, -1, 2, -2, 3, -3), 0);
+
+                decoder.Int24s.Should().Equal(1, 2, 3, -1, -2, -3);
+            }
+        }
+    }
+}
@@ -0,0 +1,145 @@
+using System;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Metrics;
+using AkkaLibrary.Exceedances;
+using AkkaLibrary.Streams.GraphStages;
+using FluentAssertions;
+using FsCheck;
+using FsCheck.Xunit;
+using Newtonsoft.Json.Linq;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class MetricsTests : TestKit
+    {
+        [Property(MaxTest = 200)]
+        public Property HistogramReportsValuesWithinOneSubBucket(PositiveInt value)
+        {
+            var histogram = new LatencyHistogram("Test");
+            histogram.Record(value.Get);
+
+            var snapshot = histogram.Snapshot();
+            return (snapshot.Count == 1
+                    && snapshot.P50 >= value.Get
+                    && snapshot.P50 <= value.Get + value.Get / LatencyHistogram.SubBuckets
+                    && snapshot.Max == value.Get).ToProperty();
+        }
+
+        [Fact]
+        public void HistogramPercentilesFollowTheRecordedDistribution()
+        {
+            var histogram = new LatencyHistogram("Test");
+            for (int i = 1; i <= 10000; i++)
+            {
+                histogram.Record(i);
+            }
+
+            var snapshot = histogram.Snapshot();
+            snapshot.Count.Should().Be(10000);
+            snapshot.P50.Should().BeInRange(5000, 5000 + 5000 / LatencyHistogram.SubBuckets);
+            snapshot.P99.Should().BeInRange(9900, 9900 + 9900 / LatencyHistogram.SubBuckets);
+            snapshot.Max.Should().Be(10000);
+        }
+
+        [Fact]
+        public void RegistryReturnsTheSameMetricForAName()
+        {
+            var registry = new MetricsRegistry();
+            registry.Counter("Stage.Count").Add(3);
+            registry.Counter("Stage.Count").Increment();
+            registry.Gauge("Stage.Depth").Set(7);
+            registry.Gauge("Stage.Depth").Decrement();
+            registry.Histogram("Stage.Latency").Record(12);
+
+            var snapshot = registry.Snapshot();
+            snapshot.Counters["Stage.Count"].Should().Be(4);
+            snapshot.Gauges["Stage.Depth"].Should().Be(6);
+            snapshot.Histograms.Single().Name.Should().Be("Stage.Latency");
+        }
+
+        [Fact]
+        public void StagesWithoutANamePublishSeparately()
+        {
+            var registry = new MetricsRegistry();
+            var configs = new Streams.ChannelAdjusterConfig[0];
+
+            new FusedChannelAdjuster(configs, registry: registry);
+            new FusedChannelAdjuster(configs, registry: registry);
+            new FusedChannelAdjuster(configs, "Adjuster", registry);
+
+            var counters = registry.Snapshot().Counters.Keys;
+            counters.Should().HaveCount(3).And.Contain("Adjuster.Samples");
+        }
+
+        [Fact]
+        public void ExceedanceDetectorsWithoutANamePublishSeparately()
+        {
+            var registry = new MetricsRegistry();
+            var config = new ExceedanceConfiguration(new[] { new LimitConfiguration("Overspeed", "Speed", LimitDirection.Above, 10) });
+
+            new ExceedanceDetector(config, registry: registry);
+            new ExceedanceDetector(config, registry: registry);
+            new ExceedanceDetector(config, "Detector", registry);
+
+            var counters = registry.Snapshot().Counters.Keys;
+            counters.Should().HaveCount(6).And.Contain("Detector.Samples", "Detector.Events");
+        }
+
+        [Fact]
+        public void ArrivalsAreOnlyFoundForTheMarkedSample()
+        {
+            var arrivals = new SampleArrivals();
+            arrivals.Mark(5, 1234);
+
+            arrivals.TryGet(5, out var timestamp).Should().BeTrue();
+            timestamp.Should().Be(1234);
+            arrivals.TryGet(6, out _).Should().BeFalse();
+
+            // Overwritten by a sample sharing its slot
+            arrivals.Mark(5 + SampleArrivals.Capacity, 99);
+            arrivals.TryGet(5, out _).Should().BeFalse();
+        }
+
+        [Fact]
+        public void LatencyIsRecordedSinceArrival()
+        {
+            var arrivals = new SampleArrivals();
+            var histogram = new LatencyHistogram("Test");
+            arrivals.Mark(1, Stopwatch.GetTimestamp() - Stopwatch.Frequency / 100);
+
+            arrivals.RecordLatency(1, histogram);
+            arrivals.RecordLatency(2, histogram);
+
+            var snapshot = histogram.Snapshot();
+            snapshot.Count.Should().Be(1);
+            snapshot.Max.Should().BeGreaterOrEqualTo(10000);
+        }
+
+        [Fact]
+        public void ReporterAppendsSnapshotsAsJsonLines()
+        {
+            var path = Path.GetTempFileName();
+            try
+            {
+                var registry = new MetricsRegistry();
+                registry.Counter("Stage.Count").Add(2);
+
+                var reporter = Sys.ActorOf(MetricsReporterActor.GetProps(TimeSpan.FromHours(1), path, registry: registry));
+                reporter.Tell(MetricsReporterActor.Report.Requested);
+                var json = ExpectMsg<string>();
+                Sys.Stop(reporter);
+
+                JObject.Parse(json)["Counters"]["Stage.Count"].Value<long>().Should().Be(2);
+                AwaitAssert(() => File.ReadAllLines(path).Should().Equal(json));
+            }
+            finally
+            {
+                File.Delete(path);
+            }
+        }
+    }
+}
@@ -0,0 +1,227 @@
+using System;
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using Akka.Actor;
+using Akka.Cluster.Tools.PublishSubscribe;
+using Akka.Event;
+using Akka.TestKit;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Cluster.Actors;
+using AkkaLibrary.Cluster.Actors.Helpers;
+using AkkaLibrary.Cluster.Placement;
+using AkkaLibrary.Common.Metrics;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    /// <summary>
+    /// Runs a load reporter in each of several actor systems in this process,
+    /// all publishing to the placement manager of the test system
+    /// </summary>
+    public class PlacementManagerTests : TestKit
+    {
+        private readonly List<ActorSystem> _nodes = new List<ActorSystem>();
+        private readonly List<MetricsRegistry> _registries = new List<MetricsRegistry>();
+        private readonly IActorRef _mediator;
+        private readonly TestProbe _loads;
+
+        public PlacementManagerTests()
+        {
+            _mediator = Sys.ActorOf(Props.Create(() => new MediatorStub()));
+            _loads = CreateTestProbe();
+        }
+
+        private Address StartNode(long queueDepth)
+        {
+            var node = ActorSystem.Create($"node-{_nodes.Count + 1}");
+            var registry = new MetricsRegistry();
+            registry.Gauge("Stage.QueueDepth").Set(queueDepth);
+
+            var mediator = _mediator;
+            node.ActorOf(Props.Create(() => new NodeLoadReporter(mediator, registry, TimeSpan.FromMilliseconds(100))), "load-reporter");
+
+            _nodes.Add(node);
+            _registries.Add(registry);
+            return ((ExtendedActorSystem)node).Provider.DefaultAddress;
+        }
+
+        private IActorRef CreateManager(TestProbe distributor, PlacementSettings settings, params Address[] nodes)
+        {
+            var mediator = _mediator;
+            var manager = Sys.ActorOf(Props.Create(() => new PlacementManager(distributor.Ref, mediator, settings)));
+
+            // The manager subscribes before it answers, so it is sent every load the probe is
+            manager.Tell(new Identify(null));
+            ExpectMsg<ActorIdentity>();
+
+            foreach (var node in nodes)
+            {
+                manager.Tell(new NodeUp(node, ImmutableHashSet.Create("worker")));
+            }
+
+            _mediator.Tell(new Subscribe(NodeLoadReporter.Topic, _loads.Ref), _loads.Ref);
+            _loads.ExpectMsg<SubscribeAck>();
+
+            var reported = new HashSet<Address>();
+            while (reported.Count < nodes.Length)
+            {
+                reported.Add(_loads.ExpectMsg<NodeLoad>().Address);
+            }
+            return manager;
+        }
+
+        private static RandomLoggerActorConfiguration Plugin(string name)
+            => new RandomLoggerActorConfiguration(name, TimeSpan.FromSeconds(1), TimeSpan.FromSeconds(2), "Logs");
+
+        [Fact]
+        public void ReportersPublishTheirQueueDepth()
+        {
+            var node = StartNode(1234);
+            _mediator.Tell(new Subscribe(NodeLoadReporter.Topic, _loads.Ref), _loads.Ref);
+            _loads.ExpectMsg<SubscribeAck>();
+
+            var load = _loads.ExpectMsg<NodeLoad>();
+            load.Address.Should().Be(node);
+            load.MailboxDepth.Should().Be(1234);
+            load.MemoryBytes.Should().BePositive();
+        }
+
+        [Fact]
+        public void ThroughputCountsOnlyTheSourceStage()
+        {
+            StartNode(0);
+            var registry = _registries.Last();
+            _mediator.Tell(new Subscribe(NodeLoadReporter.Topic, _loads.Ref), _loads.Ref);
+            _loads.ExpectMsg<SubscribeAck>();
+            _loads.ExpectMsg<NodeLoad>();
+
+            // Later stages of the same pipeline count the same samples again
+            registry.Counter("FpgaSampleAssembler-1.Samples").Add(1000);
+            registry.Counter("ExceedanceDetector-1.Samples").Add(1000000);
+            registry.Counter("ChannelAdjuster-1.Samples").Add(1000000);
+
+            var load = _loads.FishForMessage(x => x is NodeLoad reported && reported.Throughput > 0);
+            ((NodeLoad)load).Throughput.Should().BeLessThan(100000);
+        }
+
+        [Fact]
+        public void PluginsArePlacedOnTheLeastLoadedNode()
+        {
+            var busy = StartNode(8000);
+            var idle = StartNode(0);
+            var middle = StartNode(4000);
+            var distributor = CreateTestProbe();
+            var manager = CreateManager(distributor, PlacementSettings.Default, busy, idle, middle);
+
+            manager.Tell(new PlacePlugins("worker", Plugin("LoggerOne")));
+
+            var configure = distributor.ExpectMsg<ConfigurationDistributor.ConfigureNode>();
+            configure.Address.Should().Be(idle);
+            configure.Configuration.Configs.Select(x => x.Name).Should().Equal("LoggerOne");
+        }
+
+        [Fact]
+        public void PluginsOfARemovedNodeArePlacedAgain()
+        {
+            var first = StartNode(0);
+            var second = StartNode(4000);
+            var distributor = CreateTestProbe();
+            var manager = CreateManager(distributor, PlacementSettings.Default, first, second);
+
+            manager.Tell(new PlacePlugins("worker", Plugin("LoggerOne"), Plugin("LoggerTwo")));
+            distributor.ExpectMsg<ConfigurationDistributor.ConfigureNode>().Address.Should().Be(first);
+
+            manager.Tell(new NodeRemoved(first));
+
+            var configure = distributor.ExpectMsg<ConfigurationDistributor.ConfigureNode>();
+            configure.Address.Should().Be(second);
+            configure.Configuration.Configs.Select(x => x.Name).Should().BeEquivalentTo("LoggerOne", "LoggerTwo");
+        }
+
+        [Fact]
+        public void PluginsMoveOffANodeThatBecomesBusy()
+        {
+            var first = StartNode(0);
+            var second = StartNode(8000);
+            var distributor = CreateTestProbe();
+            var settings = new PlacementSettings(minimumDwell: TimeSpan.Zero, rebalanceInterval: TimeSpan.FromMilliseconds(200));
+            var manager = CreateManager(distributor, settings, first, second);
+
+            manager.Tell(new PlacePlugins("worker", Plugin("LoggerOne"), Plugin("LoggerTwo"), Plugin("LoggerThree")));
+            distributor.ExpectMsg<ConfigurationDistributor.ConfigureNode>().Configuration.Configs.Should().HaveCount(3);
+
+            _registries[0].Gauge("Stage.QueueDepth").Set(8000);
+            _registries[1].Gauge("Stage.QueueDepth").Set(0);
+
+            var moved = (ConfigurationDistributor.ConfigureNode)distributor.FishForMessage(x => x is ConfigurationDistributor.ConfigureNode configure && configure.Address.Equals(second), TimeSpan.FromSeconds(5));
+            moved.Configuration.Configs.Should().HaveCount(1);
+            distributor.ExpectMsg<ConfigurationDistributor.ConfigureNode>().Address.Should().Be(first);
+        }
+
+        [Fact]
+        public void MovedPluginsAreStoppedOnceTheirNewNodeHoldsThem()
+        {
+            // The nodes are not reachable from the test system, so stops end up as dead letters
+            var stops = CreateTestProbe();
+            Sys.EventStream.Subscribe(stops.Ref, typeof(DeadLetter));
+            bool IsStop(object x) => x is DeadLetter letter
+                                     && (letter.Message is NodeConfigurator.StopPlugin
+                                         || (letter.Message is ActorSelectionMessage selection && selection.Message is NodeConfigurator.StopPlugin));
+
+            var first = StartNode(0);
+            var second = StartNode(8000);
+            var distributor = CreateTestProbe();
+            var settings = new PlacementSettings(minimumDwell: TimeSpan.Zero, rebalanceInterval: TimeSpan.FromMilliseconds(200));
+            var manager = CreateManager(distributor, settings, first, second);
+
+            manager.Tell(new PlacePlugins("worker", Plugin("LoggerOne"), Plugin("LoggerTwo"), Plugin("LoggerThree")));
+            distributor.ExpectMsg<ConfigurationDistributor.ConfigureNode>();
+
+            _registries[0].Gauge("Stage.QueueDepth").Set(8000);
+            _registries[1].Gauge("Stage.QueueDepth").Set(0);
+
+            var moved = (ConfigurationDistributor.ConfigureNode)distributor.FishForMessage(x => x is ConfigurationDistributor.ConfigureNode configure && configure.Address.Equals(second), TimeSpan.FromSeconds(5));
+            stops.ReceiveWhile(TimeSpan.FromMilliseconds(500), x => x).Should().NotContain(x => IsStop(x));
+
+            manager.Tell(new ConfigurationDistributor.NodeConfigured(second, "hash", 2, moved.Configuration.Id));
+
+            stops.FishForMessage(IsStop, TimeSpan.FromSeconds(3));
+        }
+
+        protected override void AfterAll()
+        {
+            base.AfterAll();
+            foreach (var node in _nodes)
+            {
+                node.Terminate().Wait(TimeSpan.FromSeconds(5));
+            }
+        }
+
+        /// <summary>
+        /// Stands in for the distributed pub-sub mediator of a single node
+        /// </summary>
+        private class MediatorStub : ReceiveActor
+        {
+            private readonly List<IActorRef> _subscribers = new List<IActorRef>();
+
+            public MediatorStub()
+            {
+                Receive<Subscribe>(msg =>
+                {
+                    _subscribers.Add(msg.Ref);
+                    Sender.Tell(new SubscribeAck(msg));
+                });
+
+                Receive<Publish>(msg =>
+                {
+                    foreach (var subscriber in _subscribers)
+                    {
+                        subscriber.Tell(msg.Message);
+                    }
+                });
+            }
+        }
+    }
+}
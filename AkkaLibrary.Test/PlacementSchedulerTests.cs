@@ -0,0 +1,154 @@
+using System;
+using Akka.Actor;
+using AkkaLibrary.Cluster.Placement;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class PlacementSchedulerTests
+    {
+        private static readonly DateTime Start = new DateTime(2018, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+        private static readonly Address A = new Address("akka.tcp", "sys", "host", 1);
+        private static readonly Address B = new Address("akka.tcp", "sys", "host", 2);
+        private static readonly Address C = new Address("akka.tcp", "sys", "host", 3);
+
+        private static NodeLoad Load(Address address, double cpu, long memory = 0)
+            => new NodeLoad(address, Start, cpu, memory, 0, 0);
+
+        private static PlacementScheduler CreateScheduler(long memoryLimit = long.MaxValue)
+        {
+            var scheduler = new PlacementScheduler(new PlacementSettings(hysteresis: 0.25, minimumDwell: TimeSpan.FromMinutes(1), memoryLimitBytes: memoryLimit, movesPerRound: 10));
+            scheduler.AddNode(A, new[] { "worker" });
+            scheduler.AddNode(B, new[] { "worker" });
+            scheduler.AddNode(C, new[] { "listener" });
+            return scheduler;
+        }
+
+        [Fact]
+        public void PluginsArePlacedOnTheLeastLoadedNodeWithTheirRole()
+        {
+            var scheduler = CreateScheduler();
+            scheduler.Report(Load(A, 0.8), Start);
+            scheduler.Report(Load(B, 0.3), Start);
+            scheduler.Report(Load(C, 0.0), Start);
+
+            scheduler.Place("Logger", "worker", Start.AddSeconds(1)).Should().Be(B);
+            scheduler.Place("Listener", "listener", Start.AddSeconds(1)).Should().Be(C);
+            scheduler.Place("Orphan", "recorder", Start.AddSeconds(1)).Should().BeNull();
+            scheduler.Unplaced.Should().Equal("Orphan");
+        }
+
+        [Fact]
+        public void BurstOfPlacementsIsSpreadBeforeTheNextReport()
+        {
+            var scheduler = CreateScheduler();
+
+            for (int i = 0; i < 6; i++)
+            {
+                scheduler.Place($"Logger{i}", "worker", Start);
+            }
+
+            scheduler.PluginsOn(A).Should().HaveCount(3);
+            scheduler.PluginsOn(B).Should().HaveCount(3);
+        }
+
+        [Fact]
+        public void NodesOverTheMemoryLimitAreNotGivenPlugins()
+        {
+            var scheduler = CreateScheduler(memoryLimit: 1000);
+            scheduler.Report(Load(A, 0.0, 2000), Start);
+            scheduler.Report(Load(B, 0.9, 500), Start);
+
+            scheduler.Place("Logger", "worker", Start.AddSeconds(1)).Should().Be(B);
+        }
+
+        [Fact]
+        public void SmallDifferencesDoNotMovePlugins()
+        {
+            var scheduler = CreateScheduler();
+            scheduler.Place("Logger", "worker", Start);
+            scheduler.Report(Load(A, 0.5), Start.AddSeconds(1));
+            scheduler.Report(Load(B, 0.3), Start.AddSeconds(1));
+
+            scheduler.Rebalance(Start.AddMinutes(5)).Should().BeEmpty();
+        }
+
+        [Fact]
+        public void PluginsStayPutForTheMinimumDwell()
+        {
+            var scheduler = CreateScheduler();
+            scheduler.Report(Load(B, 0.9), Start);
+            for (int i = 0; i < 4; i++)
+            {
+                scheduler.Place($"Logger{i}", "worker", Start.AddSeconds(1));
+            }
+            scheduler.PluginsOn(A).Should().HaveCount(4);
+
+            scheduler.Report(Load(A, 0.8), Start.AddSeconds(2));
+            scheduler.Report(Load(B, 0.0), Start.AddSeconds(2));
+
+            scheduler.Rebalance(Start.AddSeconds(30)).Should().BeEmpty();
+            scheduler.Rebalance(Start.AddSeconds(62)).Should().NotBeEmpty();
+        }
+
+        [Fact]
+        public void RebalancingStopsOnceTheGapIsNarrowed()
+        {
+            var scheduler = CreateScheduler();
+            scheduler.Report(Load(B, 0.9), Start);
+            for (int i = 0; i < 4; i++)
+            {
+                scheduler.Place($"Logger{i}", "worker", Start.AddSeconds(1));
+            }
+
+            scheduler.Report(Load(A, 0.8), Start.AddSeconds(2));
+            scheduler.Report(Load(B, 0.0), Start.AddSeconds(2));
+
+            var moves = scheduler.Rebalance(Start.AddMinutes(2));
+
+            // The first plugin is estimated at a quarter of 0.8. The next is a
+            // third of 0.8, and moving it would leave B busier than A.
+            moves.Should().HaveCount(1);
+            moves.Should().OnlyContain(x => x.From.Equals(A) && x.To.Equals(B));
+            scheduler.Rebalance(Start.AddMinutes(2)).Should().BeEmpty();
+        }
+
+        [Fact]
+        public void LonePluginIsNotMovedWhenThatWouldReverseTheGap()
+        {
+            var scheduler = CreateScheduler();
+            scheduler.Place("Logger", "worker", Start);
+            scheduler.Report(Load(A, 0.9), Start.AddSeconds(1));
+            scheduler.Report(Load(B, 0.0), Start.AddSeconds(1));
+
+            scheduler.Rebalance(Start.AddMinutes(5)).Should().BeEmpty();
+        }
+
+        [Fact]
+        public void PluginIsNotMovedWhenThatWouldReverseTheGap()
+        {
+            var scheduler = CreateScheduler();
+            scheduler.Report(Load(B, 0.9), Start);
+            scheduler.Place("Logger1", "worker", Start.AddSeconds(1));
+            scheduler.Place("Logger2", "worker", Start.AddSeconds(1));
+
+            scheduler.Report(Load(A, 0.8), Start.AddSeconds(2));
+            scheduler.Report(Load(B, 0.3), Start.AddSeconds(2));
+
+            // Moving a plugin estimated at 0.4 across a gap of 0.5 would leave B at 0.7 and A at 0.4
+            scheduler.Rebalance(Start.AddMinutes(2)).Should().BeEmpty();
+        }
+
+        [Fact]
+        public void PluginsOfRemovedNodesArePlacedAgain()
+        {
+            var scheduler = CreateScheduler();
+            scheduler.Place("Logger", "worker", Start).Should().Be(A);
+
+            scheduler.RemoveNode(A).Should().Equal("Logger");
+            scheduler.Unplaced.Should().Equal("Logger");
+            scheduler.Place("Logger", scheduler.RoleOf("Logger"), Start).Should().Be(B);
+        }
+    }
+}
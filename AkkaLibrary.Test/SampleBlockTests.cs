@@ -0,0 +1,100 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Akka.Actor;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Objects;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class SampleBlockTests : TestKit
+    {
+        private static SampleBlock<float> CreateBlock()
+        {
+            var schema = new ChannelSchema(new[] { "ChannelOne", "ChannelTwo" }, new[] { "D1" });
+            var block = new SampleBlock<float>(schema, 3);
+
+            new float[] { 1, 2, 3 }.CopyTo(block.Analog(0));
+            new float[] { -1, -2, -3 }.CopyTo(block.Analog(1));
+            new[] { true, false, true }.CopyTo(block.Digital(0));
+            new long[] { 10, 11, 12 }.CopyTo(block.SampleIndices, 0);
+            return block;
+        }
+
+        [Fact]
+        public void ColumnsAreContiguousPerChannel()
+        {
+            var block = CreateBlock();
+
+            block.Analogs.Should().Equal(1, 2, 3, -1, -2, -3);
+            block.Schema.IndexOfAnalog("ChannelTwo").Should().Be(1);
+            block.Schema.IndexOfAnalog("Missing").Should().Be(-1);
+        }
+
+        [Fact]
+        public void GetSampleMaterialisesChannelData()
+        {
+            var sample = CreateBlock().GetSample(1);
+
+            sample.Analogs.Select(x => x.Name).Should().Equal("ChannelOne", "ChannelTwo");
+            sample.Analogs.Select(x => x.Value).Should().Equal(2, -2);
+            sample.Digitals.Single().Value.Should().BeFalse();
+            sample.SampleIndex.Should().Be(11);
+        }
+
+        [Fact]
+        public void MismatchedColumnsThrow()
+        {
+            var schema = new ChannelSchema(new[] { "ChannelOne" }, new string[0]);
+
+            Action create = () => new SampleBlock<float>(schema, 2, new float[3], new bool[0],
+                                    new long[2], new uint[2], new long[2], new bool[2], new long[2]);
+            create.Should().Throw<ArgumentException>();
+        }
+
+        [Fact]
+        public void FpgaBlockConvertsToFloatColumns()
+        {
+            var channels = new List<FpgaChannel>
+            {
+                new FpgaChannel("Analog1", ChannelType.Int24),
+                new FpgaChannel("D1", ChannelType.Bool),
+                new FpgaChannel("Analog2", ChannelType.Int16),
+            };
+
+            using (var decoder = new FpgaPacketDecoder(channels, 2, false))
+            {
+                // Int24 + Int16 + one byte of digitals per sample
+                decoder.Decode(new byte[] { 0xFE, 0xFF, 0xFF, 0x05, 0x00, 0x01, 0x01, 0x00, 0x00, 0xFF, 0xFF, 0x00 }, 0);
+
+                var block = new FpgaSampleBlock(FpgaSampleBlock.CreateSchema(decoder), decoder, 1).ToFloats();
+
+                block.Schema.AnalogNames.Should().Equal("Analog2", "Analog1");
+                block.Analog(0).ToArray().Should().Equal(5f, -1f);
+                block.Analog(1).ToArray().Should().Equal(-2f, 1f);
+                block.Digitals.Should().Equal(true, false);
+                block.SampleIndices.Should().Equal(1L, 2L);
+            }
+        }
+
+        [Fact]
+        public void ChannelAdjusterAcceptsBlocks()
+        {
+            var configs = new List<ChannelAdjusterConfig>
+            {
+                new ChannelAdjusterConfig("ChannelTwo",2,1,0,FilterOption.Filter),
+            };
+
+            var ca = Sys.ActorOf(Props.Create(() => new ChannelAdjuster(configs,TestActor)));
+
+            ca.Tell(CreateBlock());
+
+            var result = ExpectMsg<SampleBlock<float>>(TimeSpan.FromSeconds(3));
+            result.Schema.AnalogNames.Should().Equal("ChannelTwo");
+            result.Analogs.Should().Equal(-1, -3, -5);
+            result.SampleIndices.Should().Equal(10L, 11L, 12L);
+        }
+    }
+}
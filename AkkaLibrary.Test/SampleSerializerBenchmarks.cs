@@ -0,0 +1,113 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using Akka.Actor;
+using Akka.Serialization;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Objects;
+using AkkaLibrary.Common.Serialization;
+using FluentAssertions;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace AkkaLibrary.Test
+{
+    /// <summary>
+    /// Serializes streams of samples with the <see cref="SampleSerializer"/>,
+    /// the default JSON serializer and Hyperion. Bytes per sample, the schema
+    /// bytes among them and throughput are written to the test output; only
+    /// that the sample serializer is the most compact is asserted.
+    /// </summary>
+    [Trait("Category", "Benchmark")]
+    public class SampleSerializerBenchmarks : TestKit
+    {
+        private const int Samples = 10000;
+        private const int BlockLength = 256;
+
+        private readonly ITestOutputHelper _output;
+
+        public SampleSerializerBenchmarks(ITestOutputHelper output) : base(output: output)
+        {
+            _output = output;
+        }
+
+        private static IEnumerable<object> CreateMessages(string kind, int channelCount)
+        {
+            switch(kind)
+            {
+                case nameof(ChannelData<float>):
+                    return Enumerable.Range(0, Samples).Select(i => SampleSerializerTests.CreateChannelData(i, channelCount, channelCount / 2)).ToList();
+
+                case nameof(FpgaSample):
+                    return Enumerable.Range(0, Samples).Select(i => SampleSerializerTests.CreateFpgaSample(i)).ToList();
+
+                default:
+                    var schema = new ChannelSchema(Enumerable.Range(0, channelCount).Select(c => $"Analog{c}"), new string[0]);
+                    var random = new Random(1);
+                    return Enumerable.Range(0, Samples / BlockLength)
+                                     .Select(b => ExceedanceTests.CreateBlock(
+                                         schema,
+                                         (long)b * BlockLength,
+                                         Enumerable.Range(0, channelCount).Select(c => Enumerable.Range(0, BlockLength).Select(s => (float)random.NextDouble()).ToArray()).ToArray()))
+                                     .ToList();
+            }
+        }
+
+        [Theory]
+        [InlineData(nameof(ChannelData<float>), 8)]
+        [InlineData(nameof(ChannelData<float>), 64)]
+        [InlineData(nameof(FpgaSample), 0)]
+        [InlineData(nameof(SampleBlock<float>), 64)]
+        public void SampleSerializerIsTheMostCompact(string kind, int channelCount)
+        {
+            var messages = CreateMessages(kind, channelCount).ToList();
+            var samples = kind == nameof(SampleBlock<float>) ? messages.Count * BlockLength : messages.Count;
+            var system = (ExtendedActorSystem)Sys;
+
+            _output.WriteLine($"{messages.Count} x {kind} with {channelCount} channels");
+            var sampleBytes = Measure("Samples", new SampleSerializer(system), messages, samples);
+            var jsonBytes = Measure("JSON", new NewtonSoftJsonSerializer(system), messages, samples);
+            var hyperionBytes = Measure("Hyperion", new HyperionSerializer(system), messages, samples);
+
+            sampleBytes.Should().BeLessThan(jsonBytes);
+            sampleBytes.Should().BeLessThan(hyperionBytes);
+        }
+
+        /// <summary>
+        /// Writes bytes per sample and encode and decode rates, returning the total bytes
+        /// </summary>
+        private long Measure(string name, Serializer serializer, List<object> messages, int samples)
+        {
+            // Warm up, and let the sample serializer cache its schema
+            var first = serializer.ToBinary(messages[0]);
+
+            var stopwatch = Stopwatch.StartNew();
+            var encoded = messages.Select(serializer.ToBinary).ToList();
+            var encodeTime = stopwatch.Elapsed;
+            var bytes = encoded.Sum(x => (long)x.Length);
+            var schema = serializer is SampleSerializer
+                ? $", schema {(double)encoded.Sum(x => (long)SampleCodec.SchemaLength(x)) / samples:F2} bytes/sample"
+                : string.Empty;
+
+            string decodeRate;
+            try
+            {
+                serializer.FromBinary(first, messages[0].GetType());
+                stopwatch.Restart();
+                for (int i = 0; i < encoded.Count; i++)
+                {
+                    serializer.FromBinary(encoded[i], messages[i].GetType());
+                }
+                decodeRate = $"{samples / stopwatch.Elapsed.TotalSeconds:F0} samples/s";
+            }
+            catch(Exception e)
+            {
+                decodeRate = $"failed with {e.GetType().Name}";
+            }
+
+            _output.WriteLine($"  {name,-9} {(double)bytes / samples,8:F1} bytes/sample{schema}, encode {samples / encodeTime.TotalSeconds:F0} samples/s, decode {decodeRate}");
+            return bytes;
+        }
+    }
+}
@@ -0,0 +1,255 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.Serialization;
+using Akka.Actor;
+using Akka.Configuration;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Objects;
+using AkkaLibrary.Common.Utilities;
+using AkkaLibrary.Common.Serialization;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class SampleSerializerTests : TestKit
+    {
+        private static readonly Config RemoteConfig = ConfigurationFactory.ParseString(
+            @"akka.actor.provider = ""Akka.Remote.RemoteActorRefProvider, Akka.Remote""
+            akka.remote.dot-netty.tcp.hostname = 127.0.0.1
+            akka.remote.dot-netty.tcp.port = 0")
+            .WithFallback(SampleSerializer.Configuration);
+
+        public SampleSerializerTests() : base(RemoteConfig)
+        {
+        }
+
+        private class Echo : ReceiveActor
+        {
+            public Echo() => ReceiveAny(x => Sender.Tell(x));
+        }
+
+        internal static ChannelData<float> CreateChannelData(long sampleIndex, int analogs = 2, int digitals = 11)
+            => new ChannelData<float>(
+                Enumerable.Range(0, analogs).Select(i => new DataChannel<float>($"Analog{i}", sampleIndex + i * 0.5f, Unit.Metres)).ToList(),
+                Enumerable.Range(0, digitals).Select(i => new DataChannel<bool>($"Digital{i}", (sampleIndex + i) % 3 == 0)).ToList(),
+                sampleIndex * 10, (uint)sampleIndex * 2, 1, sampleIndex % 2 == 0, sampleIndex);
+
+        internal static FpgaSample CreateFpgaSample(long sampleIndex)
+            => new FpgaSample(
+                sampleIndex * 10, (uint)sampleIndex * 2, 1, true, sampleIndex,
+                new List<(string, uint)> { ("Status", uint.MaxValue) },
+                new List<(string, short)> { ("Counter", -5) },
+                new List<(string, Int24)> { ("Low", new Int24(-8388608)), ("High", new Int24(8388607)) },
+                new List<(string, int)> { ("Position", -7) },
+                new List<(string, float)> { ("Speed", 2.5f) },
+                new List<(string, double)> { ("Distance", 1e300) },
+                new List<(string, bool)> { ("Running", true), ("Fault", false), ("Ready", true) });
+
+        private T RoundTrip<T>(T message)
+        {
+            var serializer = Sys.Serialization.FindSerializerFor(message);
+            serializer.Should().BeOfType<SampleSerializer>();
+            return (T)serializer.FromBinary(serializer.ToBinary(message), typeof(T));
+        }
+
+        [Fact]
+        public void ChannelDataRoundTrips()
+        {
+            var sample = CreateChannelData(7);
+
+            var decoded = RoundTrip(sample);
+
+            decoded.Analogs.Select(x => (x.Name, x.Value, x.Units)).Should().Equal(sample.Analogs.Select(x => (x.Name, x.Value, x.Units)));
+            decoded.Digitals.Select(x => (x.Name, x.Value)).Should().Equal(sample.Digitals.Select(x => (x.Name, x.Value)));
+            (decoded.TimeStamp, decoded.TachometerCount, decoded.MasterSyncIncrement, decoded.MasterSyncState, decoded.SampleIndex)
+                .Should().Be((70L, 14u, 1L, false, 7L));
+        }
+
+        [Fact]
+        public void IntegerChannelDataRoundTrips()
+        {
+            var sample = new ChannelData<long>(new[] { new DataChannel<long>("Count", long.MinValue) }, new DataChannel<bool>[0], 1, 2, 3, true, 4);
+
+            RoundTrip(sample).Analogs.Single().Value.Should().Be(long.MinValue);
+        }
+
+        [Fact]
+        public void FpgaSampleRoundTrips()
+        {
+            var decoded = RoundTrip(CreateFpgaSample(3));
+
+            decoded.UInt32s.Should().Equal(("Status", uint.MaxValue));
+            decoded.Int16s.Should().Equal(("Counter", (short)-5));
+            decoded.Int24s.Select(x => (x.name, (int)x.value)).Should().Equal(("Low", -8388608), ("High", 8388607));
+            decoded.Int32s.Should().Equal(("Position", -7));
+            decoded.Floats.Should().Equal(("Speed", 2.5f));
+            decoded.Doubles.Should().Equal(("Distance", 1e300));
+            decoded.Bools.Should().Equal(("Running", true), ("Fault", false), ("Ready", true));
+            decoded.SampleIndex.Should().Be(3);
+        }
+
+        [Fact]
+        public void SampleBlockRoundTrips()
+        {
+            var schema = new ChannelSchema(new[] { "Speed", "Pressure" }, new[] { "Running" });
+            var block = ExceedanceTests.CreateBlock(schema, 100, new[] { 1f, 2, 3 }, new[] { -1f, -2, -3 });
+            block.Digitals[1] = true;
+            block.MasterSyncStates[2] = true;
+
+            var decoded = RoundTrip(block);
+
+            decoded.Schema.AnalogNames.Should().Equal(schema.AnalogNames);
+            decoded.Schema.DigitalNames.Should().Equal(schema.DigitalNames);
+            decoded.Analogs.Should().Equal(block.Analogs);
+            decoded.Digitals.Should().Equal(block.Digitals);
+            decoded.TimeStamps.Should().Equal(block.TimeStamps);
+            decoded.TachometerCounts.Should().Equal(block.TachometerCounts);
+            decoded.MasterSyncStates.Should().Equal(block.MasterSyncStates);
+            decoded.SampleIndices.Should().Equal(block.SampleIndices);
+        }
+
+        [Fact]
+        public void SamplesRoundTripBetweenRemoteSystems()
+        {
+            var remote = ActorSystem.Create("remote", RemoteConfig);
+            try
+            {
+                remote.ActorOf(Props.Create(() => new Echo()), "echo");
+                var address = ((ExtendedActorSystem)remote).Provider.DefaultAddress;
+                var echo = Sys.ActorSelection(new RootActorPath(address) / "user" / "echo");
+
+                var sample = CreateChannelData(5);
+                echo.Tell(sample);
+                var channelData = ExpectMsg<ChannelData<float>>(TimeSpan.FromSeconds(10));
+
+                echo.Tell(CreateFpgaSample(6));
+                var fpgaSample = ExpectMsg<FpgaSample>();
+
+                var block = ExceedanceTests.CreateBlock(new ChannelSchema(new[] { "Speed" }, new string[0]), 7, new[] { 1f, 2 });
+                echo.Tell(block);
+                var sampleBlock = ExpectMsg<SampleBlock<float>>();
+
+                channelData.Should().NotBeSameAs(sample);
+                channelData.Analogs.Select(x => x.Value).Should().Equal(sample.Analogs.Select(x => x.Value));
+                fpgaSample.Doubles.Should().Equal(("Distance", 1e300));
+                sampleBlock.Analogs.Should().Equal(block.Analogs);
+                sampleBlock.SampleIndices.Should().Equal(block.SampleIndices);
+            }
+            finally
+            {
+                Shutdown(remote);
+            }
+        }
+
+        [Fact]
+        public void DecodedSamplesShareTheirSchema()
+        {
+            var codec = new SampleCodec();
+            var schema = new ChannelSchema(new[] { "Speed" }, new string[0]);
+
+            var first = (SampleBlock<float>)codec.Decode(codec.Encode(ExceedanceTests.CreateBlock(schema, 0, new[] { 1f })));
+            var second = (SampleBlock<float>)codec.Decode(codec.Encode(ExceedanceTests.CreateBlock(schema, 1, new[] { 2f })));
+            var third = (ChannelData<float>)codec.Decode(codec.Encode(CreateChannelData(0)));
+            var fourth = (ChannelData<float>)codec.Decode(codec.Encode(CreateChannelData(1)));
+
+            second.Schema.Should().BeSameAs(first.Schema);
+            fourth.Analogs[0].Name.Should().BeSameAs(third.Analogs[0].Name);
+        }
+
+        [Fact]
+        public void ChangedChannelsAreDecodedWithTheirOwnSchema()
+        {
+            var codec = new SampleCodec();
+
+            codec.Decode(codec.Encode(CreateChannelData(0, analogs: 2)));
+            var decoded = (ChannelData<float>)codec.Decode(codec.Encode(CreateChannelData(1, analogs: 3)));
+
+            decoded.Analogs.Select(x => x.Name).Should().Equal("Analog0", "Analog1", "Analog2");
+        }
+
+        [Fact]
+        public void TruncatedMessagesAreRejected()
+        {
+            var codec = new SampleCodec();
+            var bytes = codec.Encode(CreateChannelData(0));
+
+            codec.Invoking(x => x.Decode(bytes.Take(bytes.Length - 3).ToArray())).Should().Throw<ArgumentException>();
+        }
+
+        [Fact]
+        public void OnlyAnnouncementsCarryTheSchema()
+        {
+            var encoder = new SampleCodec(TimeSpan.FromHours(1));
+            var decoder = new SampleCodec();
+
+            var first = encoder.Encode(CreateChannelData(0));
+            var second = encoder.Encode(CreateChannelData(1));
+
+            SampleCodec.SchemaLength(first).Should().BeGreaterThan(0);
+            SampleCodec.SchemaLength(second).Should().Be(0);
+            decoder.Invoking(x => x.Decode(second)).Should().Throw<SerializationException>();
+
+            decoder.Decode(first);
+            ((ChannelData<float>)decoder.Decode(second)).Analogs.Select(x => x.Name).Should().Equal("Analog0", "Analog1");
+        }
+
+        [Fact]
+        public void SchemasAreAnnouncedAgainAfterTheInterval()
+        {
+            var encoder = new SampleCodec(TimeSpan.Zero);
+
+            encoder.Encode(CreateFpgaSample(0));
+
+            SampleCodec.SchemaLength(encoder.Encode(CreateFpgaSample(1))).Should().BeGreaterThan(0);
+        }
+
+        [Fact]
+        public void SchemaCacheIsBounded()
+        {
+            var encoder = new SampleCodec(TimeSpan.FromHours(1));
+            var decoder = new SampleCodec();
+
+            decoder.Decode(encoder.Encode(CreateChannelData(0, analogs: 0)));
+            var unannounced = encoder.Encode(CreateChannelData(1, analogs: 0));
+            for (int i = 1; i <= SampleCodec.MaxSchemas; i++)
+            {
+                decoder.Decode(encoder.Encode(CreateChannelData(0, analogs: i)));
+            }
+
+            decoder.Invoking(x => x.Decode(unannounced)).Should().Throw<SerializationException>();
+        }
+
+        [Fact]
+        public void TruncatedSchemasAreRejected()
+        {
+            var bytes = new SampleCodec().Encode(CreateChannelData(0));
+            // Shorten the schema so its channel names run past its end
+            bytes[6] = 5;
+            bytes[7] = bytes[8] = bytes[9] = 0;
+
+            new SampleCodec().Invoking(x => x.Decode(bytes)).Should().Throw<ArgumentException>().WithMessage("Message is truncated.");
+        }
+
+        [Fact]
+        public void TagsPairedWithTheWrongKindOfSchemaAreRejected()
+        {
+            var codec = new SampleCodec();
+            var fpga = codec.Encode(CreateFpgaSample(0));
+            var channels = codec.Encode(CreateChannelData(0));
+            // Swap the ChannelData and FpgaSample tags
+            fpga[0] = 1;
+            channels[0] = 2;
+
+            codec.Invoking(x => x.Decode(fpga)).Should().Throw<ArgumentException>();
+            codec.Invoking(x => x.Decode(channels)).Should().Throw<ArgumentException>();
+        }
+
+        [Fact]
+        public void UnsupportedMessagesAreRejected()
+        {
+            new SampleCodec().Invoking(x => x.Encode("sample")).Should().Throw<ArgumentException>();
+        }
+    }
+}
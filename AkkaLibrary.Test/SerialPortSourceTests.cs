@@ -0,0 +1,123 @@
+using System;
+using System.IO.Pipes;
+using System.Linq;
+using Akka.Streams;
+using Akka.Streams.Dsl;
+using Akka.Streams.TestKit;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Metrics;
+using AkkaLibrary.Serial;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class SerialPortSourceTests : TestKit
+    {
+        private readonly AnonymousPipeServerStream _port = new AnonymousPipeServerStream(PipeDirection.Out);
+        private readonly MetricsRegistry _registry = new MetricsRegistry();
+
+        /// <summary>
+        /// Source reading what the test writes to <see cref="_port"/>
+        /// </summary>
+        private Source<PooledPacket, Akka.NotUsed> CreateSource(SerialReadPolicy policy = null)
+            => SerialPortSource.Create("Test", () => new AnonymousPipeClientStream(PipeDirection.In, _port.ClientSafePipeHandle), policy, _registry);
+
+        private static byte[] Copy(PooledPacket packet)
+        {
+            using (packet)
+            {
+                return packet.Span.ToArray();
+            }
+        }
+
+        private void Write(int from, int count) => _port.Write(Enumerable.Range(from, count).Select(x => (byte)x).ToArray(), 0, count);
+
+        [Fact]
+        public void BytesArriveInOrderUntilTheEndOfTheStream()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var result = CreateSource().Select(Copy).RunWith(Sink.Seq<byte[]>(), mat);
+
+                for (int i = 0; i < 10; i++)
+                {
+                    Write(i * 100, 100);
+                }
+                _port.Dispose();
+
+                result.Result.SelectMany(x => x).Should().Equal(Enumerable.Range(0, 1000).Select(x => (byte)x));
+                _registry.Counter("Test.Bytes").Value.Should().Be(1000);
+            }
+        }
+
+        [Fact]
+        public void ReadsAreCoalescedUpToTheMinimum()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var probe = CreateSource(new SerialReadPolicy(100, TimeSpan.FromSeconds(10)))
+                            .Select(Copy)
+                            .RunWith(this.SinkProbe<byte[]>(), mat);
+
+                probe.Request(1);
+                for (int i = 0; i < 10; i++)
+                {
+                    Write(i * 10, 10);
+                    if(i < 9)
+                    {
+                        probe.ExpectNoMsg(TimeSpan.FromMilliseconds(20));
+                    }
+                }
+
+                probe.ExpectNext(TimeSpan.FromSeconds(3)).Should().HaveCount(100);
+            }
+        }
+
+        [Fact]
+        public void LatencyFlushesBytesBelowTheMinimum()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var probe = CreateSource(new SerialReadPolicy(100, TimeSpan.FromMilliseconds(100)))
+                            .Select(Copy)
+                            .RunWith(this.SinkProbe<byte[]>(), mat);
+
+                probe.Request(1);
+                Write(0, 5);
+
+                probe.ExpectNext(TimeSpan.FromSeconds(3)).Should().Equal(0, 1, 2, 3, 4);
+            }
+        }
+
+        [Fact]
+        public void ReadsPauseWhileDownstreamIsBusy()
+        {
+            using (var mat = Sys.Materializer())
+            {
+                var probe = CreateSource(new SerialReadPolicy(1, TimeSpan.FromMilliseconds(10), bufferLength: 64))
+                            .Select(Copy)
+                            .RunWith(this.SinkProbe<byte[]>(), mat);
+
+                probe.EnsureSubscription();
+                Write(0, 200);
+
+                // A whole buffer waits for downstream and the rest stays in the port
+                AwaitCondition(() => _registry.Counter("Test.Pauses").Value == 1);
+                _registry.Counter("Test.Bytes").Value.Should().BeLessThan(200);
+
+                probe.Request(100);
+                _port.Dispose();
+
+                probe.ToStrict(TimeSpan.FromSeconds(3)).SelectMany(x => x)
+                     .Should().Equal(Enumerable.Range(0, 200).Select(x => (byte)x));
+            }
+        }
+
+        protected override void AfterAll()
+        {
+            base.AfterAll();
+            _port.Dispose();
+        }
+    }
+}
@@ -0,0 +1,182 @@
+using System;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using Akka.IO;
+using Akka.TestKit.Xunit2;
+using AkkaLibrary.Common.Metrics;
+using AkkaLibrary.TcpActors;
+using FluentAssertions;
+using Xunit;
+
+namespace AkkaLibrary.Test
+{
+    public class SubscriberHubTests : TestKit
+    {
+        private readonly MetricsRegistry _registry = new MetricsRegistry();
+
+        private SubscriberHub<int> CreateHub() => new SubscriberHub<int>("Hub", TestActor, _registry);
+
+        [Fact]
+        public void SlowSubscriberDoesNotHoldUpTheOthers()
+        {
+            var hub = CreateHub();
+            var fast = CreateTestProbe();
+            var slow = CreateTestProbe();
+            hub.Add("fast", fast.Ref, 4, OverflowPolicy.DropOldest);
+            hub.Add("slow", slow.Ref, 4, OverflowPolicy.DropOldest);
+
+            for (int i = 0; i < 100; i++)
+            {
+                hub.Publish(i);
+                fast.ExpectMsg(i);
+                hub.Acknowledge(fast.Ref);
+            }
+
+            slow.ExpectMsg(0);
+            slow.ExpectNoMsg(TimeSpan.FromMilliseconds(50));
+            hub.Lags()["slow"].Should().Be(4);
+            _registry.Gauge("Hub.slow.Lag").Value.Should().Be(4);
+            _registry.Counter("Hub.slow.Dropped").Value.Should().Be(95);
+            _registry.Counter("Hub.fast.Dropped").Value.Should().Be(0);
+
+            // The newest elements were kept
+            foreach (var expected in Enumerable.Range(96, 4))
+            {
+                hub.Acknowledge(slow.Ref);
+                slow.ExpectMsg(expected);
+            }
+            hub.Acknowledge(slow.Ref);
+            hub.Lags()["slow"].Should().Be(0);
+        }
+
+        [Fact]
+        public void DropNewestKeepsTheOldestElements()
+        {
+            var hub = CreateHub();
+            var slow = CreateTestProbe();
+            hub.Add("slow", slow.Ref, 4, OverflowPolicy.DropNewest);
+
+            for (int i = 0; i < 10; i++)
+            {
+                hub.Publish(i);
+            }
+
+            slow.ExpectMsg(0);
+            foreach (var expected in Enumerable.Range(1, 4))
+            {
+                hub.Acknowledge(slow.Ref);
+                slow.ExpectMsg(expected);
+            }
+            _registry.Counter("Hub.slow.Dropped").Value.Should().Be(5);
+        }
+
+        [Fact]
+        public void FullSubscriberIsDisconnected()
+        {
+            var hub = CreateHub();
+            var slow = CreateTestProbe();
+            string disconnected = null;
+            hub.Disconnected += (name, actor) => disconnected = name;
+            hub.Add("slow", slow.Ref, 2, OverflowPolicy.Disconnect);
+
+            for (int i = 0; i < 4; i++)
+            {
+                hub.Publish(i);
+            }
+
+            disconnected.Should().Be("slow");
+            hub.Count.Should().Be(0);
+            hub.Contains("slow").Should().BeFalse();
+        }
+
+        [Fact]
+        public void BackpressureHoldsUntilTheSubscriberDrainsToHalf()
+        {
+            var hub = CreateHub();
+            var slow = CreateTestProbe();
+            hub.Add("slow", slow.Ref, 4, OverflowPolicy.Backpressure);
+
+            // One in flight and four buffered
+            for (int i = 0; i < 5; i++)
+            {
+                hub.Publish(i);
+            }
+            hub.IsBackpressured.Should().BeTrue();
+
+            // Elements published after the pause are still kept
+            hub.Publish(5);
+            hub.Lags()["slow"].Should().Be(5);
+
+            for (int acked = 0; acked < 2; acked++)
+            {
+                hub.Acknowledge(slow.Ref);
+                hub.IsBackpressured.Should().BeTrue();
+            }
+            hub.Acknowledge(slow.Ref);
+            hub.IsBackpressured.Should().BeFalse();
+
+            slow.ReceiveN(4).Should().Equal(0, 1, 2, 3);
+        }
+
+        [Fact]
+        public void EverySubscriberReceivesTheSamePayload()
+        {
+            var hub = new SubscriberHub<ByteString>("Hub", TestActor, _registry);
+            var probes = Enumerable.Range(0, 24).Select(_ => CreateTestProbe()).ToList();
+            for (int i = 0; i < probes.Count; i++)
+            {
+                hub.Add($"s{i}", probes[i].Ref, 8, OverflowPolicy.DropOldest);
+            }
+
+            var payload = ByteString.FromString("payload");
+            hub.Publish(payload);
+
+            foreach (var probe in probes)
+            {
+                probe.ExpectMsg<ByteString>().Should().BeSameAs(payload);
+                probe.LastSender.Should().Be(TestActor);
+            }
+        }
+
+        [Fact]
+        public void SubscriberNamesAndActorsAreUnique()
+        {
+            var hub = CreateHub();
+            var probe = CreateTestProbe();
+
+            hub.Add("a", probe.Ref, 4, OverflowPolicy.DropOldest).Should().BeTrue();
+            hub.Add("a", CreateTestProbe().Ref, 4, OverflowPolicy.DropOldest).Should().BeFalse();
+            hub.Add("b", probe.Ref, 4, OverflowPolicy.DropOldest).Should().BeFalse();
+
+            hub.Remove(probe.Ref).Should().BeTrue();
+            hub.Remove("a").Should().BeFalse();
+        }
+
+        [Fact]
+        public void ReadingSuspendedBeforeTheConnectionOpensStaysSuspended()
+        {
+            var listener = new TcpListener(IPAddress.Loopback, 0);
+            listener.Start();
+            try
+            {
+                var port = ((IPEndPoint)listener.LocalEndpoint).Port;
+                var connection = Sys.ActorOf(TcpConnectionActor.GetProps("tcp", new DnsEndPoint("127.0.0.1", port), TestActor));
+                connection.Tell(TcpConnectionActor.SuspendReading.Instance);
+
+                using (var client = listener.AcceptTcpClient())
+                {
+                    client.GetStream().Write(new byte[] { 1, 2, 3 }, 0, 3);
+                    ExpectNoMsg(TimeSpan.FromMilliseconds(500));
+
+                    connection.Tell(TcpConnectionActor.ResumeReading.Instance);
+                    ExpectMsg<TcpConnectionActor.TcpDataReceived>().Data.Count.Should().Be(3);
+                }
+            }
+            finally
+            {
+                listener.Stop();
+            }
+        }
+    }
+}
@@ -0,0 +1,141 @@
+using System;
+using System.IO;
+using System.Net;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using Akka.Actor;
+using AkkaLibrary.Common.Metrics;
+using Newtonsoft.Json;
+using Serilog;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// Publishes periodic snapshots of a <see cref="MetricsRegistry"/>
+    ///
+    /// Each snapshot is appended to a file as one line of JSON and, when an
+    /// HTTP prefix such as "http://localhost:9100/metrics/" is given, the most
+    /// recent snapshot is served there. Metrics are only read when a snapshot
+    /// is taken, so reporting adds nothing to the pipeline's own cost.
+    /// </summary>
+    public class MetricsReporterActor : ReceiveActor
+    {
+        /// <param name="interval">Time between snapshots</param>
+        /// <param name="path">File to append snapshots to. Null disables the file.</param>
+        /// <param name="httpPrefix">Prefix to serve the latest snapshot on. Null disables the endpoint.</param>
+        /// <param name="registry">Registry to report. Defaults to <see cref="MetricsRegistry.Default"/>.</param>
+        public MetricsReporterActor(TimeSpan interval, string path, string httpPrefix = null, MetricsRegistry registry = null)
+        {
+            _interval = interval;
+            _registry = registry ?? MetricsRegistry.Default;
+
+            if(path != null)
+            {
+                _writer = new StreamWriter(new FileStream(path, FileMode.Append, FileAccess.Write, FileShare.Read));
+            }
+
+            if(httpPrefix != null)
+            {
+                _listener = new HttpListener();
+                _listener.Prefixes.Add(httpPrefix);
+            }
+
+            Receive<Report>(msg =>
+            {
+                var json = JsonConvert.SerializeObject(_registry.Snapshot());
+                Volatile.Write(ref _latest, json);
+
+                if(_writer != null)
+                {
+                    _writer.WriteLine(json);
+                    _writer.Flush();
+                }
+
+                if(msg.ReplyTo)
+                {
+                    Sender.Tell(json);
+                }
+            });
+        }
+
+        protected override void PreStart()
+        {
+            _schedule = Context.System.Scheduler.ScheduleTellRepeatedlyCancelable(
+                            _interval, _interval, Self, Report.Scheduled, Self);
+
+            if(_listener != null)
+            {
+                _listener.Start();
+                Task.Run(Serve);
+            }
+        }
+
+        private async Task Serve()
+        {
+            while(_listener.IsListening)
+            {
+                HttpListenerContext context;
+                try
+                {
+                    context = await _listener.GetContextAsync();
+                }
+                catch (Exception) when (!_listener.IsListening)
+                {
+                    return;
+                }
+
+                try
+                {
+                    var body = Encoding.UTF8.GetBytes(Volatile.Read(ref _latest) ?? "{}");
+                    context.Response.ContentType = "application/json";
+                    context.Response.ContentLength64 = body.Length;
+                    await context.Response.OutputStream.WriteAsync(body, 0, body.Length);
+                    context.Response.Close();
+                }
+                catch (Exception e)
+                {
+                    Log.Warning("Metrics endpoint failed to respond: {0}", e.Message);
+                }
+            }
+        }
+
+        protected override void PostStop()
+        {
+            _schedule?.Cancel();
+            _listener?.Close();
+            _writer?.Dispose();
+            base.PostStop();
+        }
+
+        public static Props GetProps(TimeSpan interval, string path, string httpPrefix = null, MetricsRegistry registry = null)
+                                => Props.Create(() => new MetricsReporterActor(interval, path, httpPrefix, registry));
+
+        #region Messages
+
+        /// <summary>
+        /// Takes a snapshot now. The requested form replies with the JSON.
+        /// </summary>
+        public sealed class Report
+        {
+            public static Report Scheduled { get; } = new Report(false);
+            public static Report Requested { get; } = new Report(true);
+
+            public bool ReplyTo { get; }
+
+            private Report(bool replyTo)
+            {
+                ReplyTo = replyTo;
+            }
+        }
+
+        #endregion
+
+        private readonly TimeSpan _interval;
+        private readonly MetricsRegistry _registry;
+        private readonly StreamWriter _writer;
+        private readonly HttpListener _listener;
+        private ICancelable _schedule;
+        private string _latest;
+    }
+}
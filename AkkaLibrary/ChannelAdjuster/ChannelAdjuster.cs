@@ -1,13 +1,10 @@
 using System;
 using System.Collections.Generic;
-using System.Collections.Immutable;
 using System.Linq;
-using Akka;
 using Akka.Actor;
 using Akka.Streams;
 using Akka.Streams.Dsl;
-using Akka.Util.Internal;
-using AkkaLibrary.Common.Interfaces;
+using AkkaLibrary.Common.Metrics;
 using AkkaLibrary.Common.Objects;
 using AkkaLibrary.Streams.GraphStages;
 using Serilog;
@@ -16,50 +13,88 @@ namespace AkkaLibrary
 {
     public class ChannelAdjuster : ReceiveActor, IWithUnboundedStash
     {
-        private ISourceQueueWithComplete<ChannelData<float>> _queue;
-        private int _samplesEnqueued;
-        private int _samplesDropped;
+        private ISourceQueueWithComplete<SampleBlock<float>> _queue;
+        private readonly string _name;
+        private readonly Gauge _queueDepth;
+        private readonly Counter _enqueued;
+        private readonly Counter _dropped;
+        private readonly LatencyHistogram _latency;
+        private readonly SampleArrivals _arrivals;
         private IEnumerable<ChannelAdjusterConfig> _configs;
+        private ChannelSchema _sampleSchema;
 
         public IStash Stash { get ; set; }
 
-        public ChannelAdjuster(IEnumerable<ChannelAdjusterConfig> configs, IActorRef target)
+        /// <param name="arrivals">Arrival times marked by the acquisition of this pipeline, to measure latency against</param>
+        public ChannelAdjuster(IEnumerable<ChannelAdjusterConfig> configs, IActorRef target, SampleArrivals arrivals = null)
         {
             _configs = configs;
-            
-            /* Receives the first sample and creates the graph. Starts the graph and
-               transitions to running state and passes the sample back in as the
-               first message.
+            _arrivals = arrivals;
+
+            _name = $"ChannelAdjuster[{Self.Path.ToStringWithoutAddress()}]";
+            _queueDepth = MetricsRegistry.Default.Gauge($"{_name}.QueueDepth");
+            _enqueued = MetricsRegistry.Default.Counter($"{_name}.Enqueued");
+            _dropped = MetricsRegistry.Default.Counter($"{_name}.Dropped");
+            _latency = MetricsRegistry.Default.Histogram($"{_name}.Latency");
+
+            /* Receives the first message and creates the graph. Output matches the
+               input: single samples are emitted as samples and blocks as blocks.
+               Starts the graph and transitions to running state and passes the
+               message back in as the first message.
              */
             Receive<ChannelData<float>>(sample =>
             {
-                //Create the graph from the first sample and then become working.
                 Stash.Stash();
-                var runnableGraph = CreateGraph(target, _configs.ToList(), sample);
-                _queue = runnableGraph.Run(Context.Materializer());
+                _queue = CreateGraph(target, emitSamples: true).Run(Context.Materializer());
+                Become(Working);
+            });
+
+            Receive<SampleBlock<float>>(block =>
+            {
+                Stash.Stash();
+                _queue = CreateGraph(target, emitSamples: false).Run(Context.Materializer());
                 Become(Working);
             });
         }
 
         public static Props GetProps(
                         IEnumerable<ChannelAdjusterConfig> adjustedChannels,
-                        IActorRef target)
+                        IActorRef target,
+                        SampleArrivals arrivals = null)
                         => Props.Create(
-                            () => new ChannelAdjuster(adjustedChannels, target)
+                            () => new ChannelAdjuster(adjustedChannels, target, arrivals)
                             );
 
         private void Working()
         {
             Receive<ChannelData<float>>(msg =>
             {
-                _queue.OfferAsync(msg).PipeTo(Self);
+                // Reuse the schema while the channels are unchanged
+                if(_sampleSchema == null || !_sampleSchema.Describes(msg))
+                {
+                    _sampleSchema = ChannelSchema.FromSample(msg);
+                }
+
+                _queueDepth.Increment();
+                _queue.OfferAsync(SampleBlock<float>.FromSample(msg, _sampleSchema)).PipeTo(Self);
+            });
+
+            Receive<SampleBlock<float>>(block =>
+            {
+                _queueDepth.Increment();
+                _queue.OfferAsync(block).PipeTo(Self);
             });
 
             Receive<IQueueOfferResult>(enqueueTask =>
             {
                 enqueueTask.Match()
-                        .With<QueueOfferResult.Enqueued>(msg => ++_samplesEnqueued)
-                        .With<QueueOfferResult.Dropped>(msg => Log.Warning("Signal Adjuster dropped a sample. Total dropped:{0}", ++_samplesDropped))
+                        .With<QueueOfferResult.Enqueued>(msg => _enqueued.Increment())
+                        .With<QueueOfferResult.Dropped>(msg =>
+                        {
+                            _queueDepth.Decrement();
+                            _dropped.Increment();
+                            Log.Warning("Signal Adjuster dropped a sample. Total dropped:{0}", _dropped.Value);
+                        })
                         .With<QueueOfferResult.Failure>(msg => throw msg.Cause)
                         .With<QueueOfferResult.QueueClosed>(msg => throw new Exception("The stream queue was closed."));
             });
@@ -67,307 +102,34 @@ namespace AkkaLibrary
             Stash.UnstashAll();
         }
 
-        private IEnumerable<int> GetIndices(ChannelData<float> sample, IEnumerable<ChannelAdjusterConfig> configs)
+        private RunnableGraph<ISourceQueueWithComplete<SampleBlock<float>>> CreateGraph(IActorRef target, bool emitSamples)
         {
-            return configs.Select(cfg => sample.Analogs.Select((x, i) => (index: i, data: x)).First(pair => pair.data.Name == cfg.Name).index);
-        }
-
-        private RunnableGraph<ISourceQueueWithComplete<ChannelData<float>>> CreateGraph(IActorRef target, List<ChannelAdjusterConfig> configs, ChannelData<float> sample)
-        {
-            /*
-            Digital Merger is only necessary when there are additional digitals created and the same goes for the
-            Broadcast following the Analog Splitter. A broadcast is only required when the analog channel is produces
-            the additional digitals. Otherwise the analog is pushed straight to the merger
-            +---------------+--------------+-----------------------------------------------------------------------+
-            |               |              |                     SyncData                           |              |
-            |               |              +-------------+----------------+-------------------------+              |
-            |  QueueSource  | Channel Data |             |    FilterFlow           |                | Channel Data |
-            |               |    Splitter  |    Analog   |  ================       |     Analog     |              |
-            |               |              |   Splitter  |  Broadcast => Filter    |     Merger     |              |
-            |               |              |             |         ----------------+----------------+              |
-            |               |              |             |         \=> -FullScale  |                |              |
-            |               |              |             |         \=> +FullScale  |    Digital     |              |
-            |               |              |             |         \=> FlatLining  |     Merger     |              |
-            |               |              +-------------+-------------------------+                |              |
-            |               |              |    Digitals                           |                |              |
-            +---------------+--------------+-----------------------------------------------------------------------+
-            */
-
-            var indices = GetIndices(sample, configs);
-            var number = indices.Count();
-
-            var temporalOffsets = configs.Select(x => -x.TemporalOffset).Append(0);
-
-            var temp = temporalOffsets.Select(x => x - temporalOffsets.Min()).ToList();
-            var skipIndices = temp.Take(temp.Count - 1).ToList();
-            var zerothIndex = temp.Last();
-            
-
-
-            var bufferSize = temp.Max() + 1;
-            var skipFlowsNeeded = skipIndices.Any(x => x != 0);
-
-            var graph = GraphDsl.Create(Source.Queue<ChannelData<float>>(10000, OverflowStrategy.Backpressure), (builder, source) =>
-            {
-                //Split channel data into sync data, analogs and digitals
-                var channelDataSplitter = new UnzipWith<
-                                    ChannelData<float>,
-                                    ISyncData,
-                                    IReadOnlyList<DataChannel<float>>,
-                                    IReadOnlyList<DataChannel<bool>>
-                                    >(cd => Tuple.Create(cd as ISyncData, cd.Analogs, cd.Digitals));
-                var channelDataSplitterShape = builder.Add(channelDataSplitter);
-
-                //Split, filter and reorder the analog channels into the required data channels
-                var analogSplitter = new UnzipEnumerable<
-                                        IReadOnlyList<DataChannel<float>>,
-                                        DataChannel<float>
-                                        >(list => indices.Select(i => list[i]).ToImmutableList(), number
-                                        );
-                var analogSplitterShape = builder.Add(analogSplitter);
-
-                //Re-combine the filtered analog channels
-                var analogMerger = new ZipN<DataChannel<float>>(number);
-                var analogMergerShape = builder.Add(analogMerger);
-
-                //Digital additional flows
-                var additionalDigitalFlows = new List<FlowShape<DataChannel<float>, DataChannel<bool>>>();
-
-                //Create the appropriate analog filtering flows.
-                for (int i = 0; i < configs.Count(); i++)
-                {
-                    var skipValue = skipIndices[i];
-                    //Create new flows for the analogs
-                    switch (configs[i].Option)
-                    {
-                        // 1a) Each cfg generates one analog flow...
-                        case FilterOption.PassThrough:
-                            if(skipFlowsNeeded)
-                            {
-                                builder.From(analogSplitterShape.Out(i))
-                                       .Via(
-                                           builder.Add(
-                                               Flow.Create<DataChannel<float>>()
-                                                   .Buffer(bufferSize, OverflowStrategy.Backpressure)
-                                                   .Skip(skipValue)
-                                                   .Log("AnalogLog")
-                                               )
-                                            )
-                                       .To(analogMergerShape.In(i));
-                            }
-                            else
-                            {
-                                // Pass through channels can be connected straight from the splitter to the merger.
-                                builder.From(analogSplitterShape.Out(i)).To(analogMergerShape.In(i));
-                            }
-                            break;
-                        case FilterOption.Filter:
-                            // Filtered channels create a single flow and connected from the splitter to the merger.
-                            var scale = configs[i].Scale;
-                            var offset = configs[i].Offset;
-
-                            var filterFlow = skipFlowsNeeded?
-                                                Flow.Create<DataChannel<float>>()
-                                                    .Buffer(bufferSize, OverflowStrategy.Backpressure)
-                                                    .Skip(skipValue)
-                                                    .Select(x => new DataChannel<float>(x.Name, x.Value * scale + offset, x.Units))
-                                                    :
-                                                Flow.Create<DataChannel<float>>()
-                                                    .Select(x => new DataChannel<float>(x.Name, x.Value * scale + offset, x.Units));
-
-                            builder.From(analogSplitterShape.Out(i)).Via(builder.Add(filterFlow)).To(analogMergerShape.In(i));
-                            break;
-                        // 1b) OR One analog flow and 3 additional digital flows.
-                        case FilterOption.CreateDigitals:
-                            // Filtered channels that create digitals creates a broadcaster for the analog channel first...
-                            var analogBroadcaster = new Broadcast<DataChannel<float>>(4);
-
-                            // ...then three flows for the digitals
-                            var d1Flow = builder.Add(Flow.Create<DataChannel<float>>().Select(x => new DataChannel<bool>($"{x.Name}_+FullScale", false)));
-                            var d2Flow = builder.Add(Flow.Create<DataChannel<float>>().Select(x => new DataChannel<bool>($"{x.Name}_-FullScale", false)));
-                            var d3Flow = builder.Add(Flow.Create<DataChannel<float>>().Select(x => new DataChannel<bool>($"{x.Name}_Flatlining", false)));
-
-                            // ...add the digital flow shapes to be connected later
-                            additionalDigitalFlows.Add(d1Flow);
-                            additionalDigitalFlows.Add(d2Flow);
-                            additionalDigitalFlows.Add(d3Flow);
-
-                            // ...create the broadcaster shape
-                            var analogBroadcasterShape = builder.Add(analogBroadcaster);
-
-                            // ...create the filter flow and connect the broadcaster to the merger via the filter
-                            var scaler = configs[i].Scale;
-                            var offsetter = configs[i].Offset;
-                            var filter = skipFlowsNeeded ?
-                                            Flow.Create<DataChannel<float>>()
-                                                .Buffer(bufferSize, OverflowStrategy.Backpressure)
-                                                .Skip(skipValue)
-                                                .Select(x => new DataChannel<float>(x.Name, x.Value * scaler + offsetter, x.Units))
-                                                :
-                                            Flow.Create<DataChannel<float>>()
-                                                .Select(x => new DataChannel<float>(x.Name, x.Value * scaler + offsetter, x.Units));
-
-
-                            // ...link the analog splitter output to the broadcaster
-                            builder.From(analogSplitterShape.Out(i))
-                                    .Via(filter)
-                                    .To(analogBroadcasterShape);
-
-                            builder.From(analogBroadcasterShape.Out(0)).To(analogMergerShape.In(i));
-                            // ...link the broadcaster channels to the additional digital flows
-                            builder.From(analogBroadcasterShape.Out(1)).Via(d1Flow);
-                            builder.From(analogBroadcasterShape.Out(2)).Via(d2Flow);
-                            builder.From(analogBroadcasterShape.Out(3)).Via(d3Flow);
-                            break;
-                        case FilterOption.NotSet:
-                            throw new ArgumentException("Filter Option Not Set is not allowed.");
-                    }
-                }
-
-                //Merge everything back together
-                var channelDataMerger = ZipWith.Apply<
-                                    ISyncData,
-                                    IImmutableList<DataChannel<float>>,
-                                    IReadOnlyList<DataChannel<bool>>,
-                                    ChannelData<float>
-                                    >(
-                                        (sync, analogs, digitals) => new ChannelData<float>
-                                        (
-                                            analogs,
-                                            digitals,
-                                            sync.TimeStamp,
-                                            sync.TachometerCount,
-                                            sync.MasterSyncIncrement,
-                                            sync.MasterSyncState,
-                                            sync.SampleIndex
-                                        )
-                                    );
-                var channelDataMergerShape = builder.Add(channelDataMerger);
-
-                //Sink
-                var sink = Sink.ActorRef<ChannelData<float>>(target, false);
-                var sinkShape = builder.Add(sink);
-
-                //_________Link stages_________
-
-                //=====Source=====
-                //Source to the channel data splitter
-                if(skipFlowsNeeded)
-                {
-                    builder.From(source)
-                           .Via(builder.Add(Flow.Create<ChannelData<float>>().Buffer(bufferSize, OverflowStrategy.Backpressure)))
-                           .To(channelDataSplitterShape.In);
-
-                    //=====Splitter=====
-                    //Splitter sync data to merger.
-                    builder.From(channelDataSplitterShape.Out0)
-                            .Via(builder.Add(Flow.Create<ISyncData>().Buffer(bufferSize, OverflowStrategy.Backpressure).Skip(zerothIndex)))
-                            .To(channelDataMergerShape.In0);
-
-                    //Splitter analogs to analog splitter.
-                    builder.From(channelDataSplitterShape.Out1)
-                            .Via(builder.Add(Flow.Create<IReadOnlyList<DataChannel<float>>>().Buffer(bufferSize, OverflowStrategy.Backpressure)))
-                            .To(analogSplitterShape.In);
-
-                    //=====AdditionalDigitalFlows=====
-                    if (additionalDigitalFlows.Count > 0)
-                    {
-                        // Additonal Digital Merger
-                        var additionalDigitalMerger = new ZipWithN<DataChannel<bool>, IImmutableList<DataChannel<bool>>>(channel => channel, additionalDigitalFlows.Count);
-                        var additionalDigitalMergerShape = builder.Add(additionalDigitalMerger);
-
-                        //Combine the input digitals with the generated additional digitals
-                        var digitalMerger = ZipWith.Apply<List<DataChannel<bool>>, ImmutableList<DataChannel<bool>>, IReadOnlyList<DataChannel<bool>>>((channel1, channel2) => channel1.Concat(channel2).ToList());
-                        var digitalMergerShape = builder.Add(digitalMerger);
-
-                        //Splitter digitals to digital merger.
-                        builder.From(channelDataSplitterShape.Out2)
-                                .Via(builder.Add(Flow.Create<IReadOnlyList<DataChannel<bool>>>().Buffer(bufferSize, OverflowStrategy.Backpressure)))
-                                .To(digitalMergerShape.In0);
-
-                        // Merge all additional flows together.
-                        for (int i = 0; i < additionalDigitalFlows.Count; i++)
-                        {
-                            builder.From(additionalDigitalFlows[i]).To(additionalDigitalMergerShape.In(i));
-                        }
-                        //Additional digitals to digital merger
-                        builder.From(additionalDigitalMergerShape.Out).To(digitalMergerShape.In1);
-
-                        //=====DigitalMerger=====
-                        //Digital merger to channel data merger
-                        builder.From(digitalMergerShape.Out).To(channelDataMergerShape.In2);
-                    }
-                    else
-                    {
-                        // Splitter digitals to final merger.
-                        builder.From(channelDataSplitterShape.Out2)
-                                .Via(builder.Add(Flow.Create<IReadOnlyList<DataChannel<bool>>>().Buffer(bufferSize, OverflowStrategy.Backpressure)))
-                                .To(channelDataMergerShape.In2);
-                    }
-
-                    // Analog merger to final merger.
-                    builder.From(analogMergerShape.Out).To(channelDataMergerShape.In1);
-
-
-                    //=====Merger=====
-                    //Channel Data Merger to sink
-                    builder.From(channelDataMergerShape.Out).To(sinkShape);
-                }
-                else
-                {
-                    builder.From(source).To(channelDataSplitterShape.In);
-
-                    //=====Splitter=====
-                    //Splitter sync data to merger.
-                    builder.From(channelDataSplitterShape.Out0).To(channelDataMergerShape.In0);
-                    //Splitter analogs to analog splitter.
-                    builder.From(channelDataSplitterShape.Out1).To(analogSplitterShape.In);
-
-                    //=====AdditionalDigitalFlows=====
-                    if (additionalDigitalFlows.Count > 0)
-                    {
-                        // Additonal Digital Merger
-                        var additionalDigitalMerger = new ZipWithN<DataChannel<bool>, IImmutableList<DataChannel<bool>>>(channel => channel, additionalDigitalFlows.Count);
-                        var additionalDigitalMergerShape = builder.Add(additionalDigitalMerger);
-
-                        //Combine the input digitals with the generated additional digitals
-                        var digitalMerger = ZipWith.Apply<List<DataChannel<bool>>, ImmutableList<DataChannel<bool>>, IReadOnlyList<DataChannel<bool>>>((channel1, channel2) => channel1.Concat(channel2).ToList());
-                        var digitalMergerShape = builder.Add(digitalMerger);
-
-                        //Splitter digitals to digital merger.
-                        builder.From(channelDataSplitterShape.Out2).To(digitalMergerShape.In0);
-
-                        // Merge all additional flows together.
-                        for (int i = 0; i < additionalDigitalFlows.Count; i++)
-                        {
-                            builder.From(additionalDigitalFlows[i]).To(additionalDigitalMergerShape.In(i));
-                        }
-                        //Additional digitals to digital merger
-                        builder.From(additionalDigitalMergerShape.Out).To(digitalMergerShape.In1);
-
-                        //=====DigitalMerger=====
-                        //Digital merger to channel data merger
-                        builder.From(digitalMergerShape.Out).To(channelDataMergerShape.In2);
-                    }
-                    else
-                    {
-                        // Splitter digitals to final merger.
-                        builder.From(channelDataSplitterShape.Out2).To(channelDataMergerShape.In2);
-                    }
-
-                    // Analog merger to final merger.
-                    builder.From(analogMergerShape.Out).To(channelDataMergerShape.In1);
-
-
-                    //=====Merger=====
-                    //Channel Data Merger to sink
-                    builder.From(channelDataMergerShape.Out).To(sinkShape);
-                }
-
-                return ClosedShape.Instance;
-            });
-
-            return RunnableGraph.FromGraph(graph);
+            var configs = _configs.Select(x => new Streams.ChannelAdjusterConfig(
+                                                    x.Name,
+                                                    x.Scale,
+                                                    x.Offset,
+                                                    x.TemporalOffset,
+                                                    (Streams.FilterOption)x.Option,
+                                                    x.Detectors));
+
+            var arrivals = _arrivals;
+
+            var adjusted = Source.Queue<SampleBlock<float>>(10000, OverflowStrategy.Backpressure)
+                                 .Select(block =>
+                                 {
+                                     _queueDepth.Decrement();
+                                     return block;
+                                 })
+                                 .Via(new FusedChannelAdjuster(configs, $"{_name}.Fused"))
+                                 .Select(block =>
+                                 {
+                                     arrivals?.RecordLatency(block.SampleIndices[0], _latency);
+                                     return block;
+                                 });
+
+            return emitSamples
+                    ? adjusted.SelectMany(block => block.ToChannelData()).To(Sink.ActorRef<ChannelData<float>>(target, false))
+                    : adjusted.To(Sink.ActorRef<SampleBlock<float>>(target, false));
         }
     }
-}
\ No newline at end of file
+}
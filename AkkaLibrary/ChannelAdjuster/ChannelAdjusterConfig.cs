@@ -12,13 +12,24 @@ namespace AkkaLibrary
 
         public int TemporalOffset { get; }
 
+        /// <summary>
+        /// Limits for the digitals created with <see cref="FilterOption.CreateDigitals"/>
+        /// </summary>
+        public Streams.ChannelDetectorConfig Detectors { get; }
+
         public ChannelAdjusterConfig(string name, float scale, float offset, int temporalOffset, FilterOption option)
+            : this(name, scale, offset, temporalOffset, option, Streams.ChannelDetectorConfig.Disabled)
+        {
+        }
+
+        public ChannelAdjusterConfig(string name, float scale, float offset, int temporalOffset, FilterOption option, Streams.ChannelDetectorConfig detectors)
         {
             Name = name;
             Scale = scale;
             Offset = offset;
             Option = option;
             TemporalOffset = temporalOffset;
+            Detectors = detectors ?? Streams.ChannelDetectorConfig.Disabled;
         }
     }
 
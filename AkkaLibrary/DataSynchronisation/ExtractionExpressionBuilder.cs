@@ -10,7 +10,7 @@ namespace AkkaLibrary.DataSynchronisation
 
     public static class ExtractionExpressionBuilder
     {
-        private static Queue<string> CreateExtractionQueue(string extractionString)
+        internal static Queue<string> CreateExtractionQueue(string extractionString)
         {
             return new Queue<string>(extractionString.Split(new []{"."}, StringSplitOptions.RemoveEmptyEntries));
         }
@@ -151,7 +151,7 @@ namespace AkkaLibrary.DataSynchronisation
             return Expression.Property(sourceParameter, getter);
         }
 
-        private static IExtractionType DetermineExtractionType(string ext)
+        internal static IExtractionType DetermineExtractionType(string ext)
         {
             //Incorrectly formatted extraction string.
             if(string.IsNullOrWhiteSpace(ext))
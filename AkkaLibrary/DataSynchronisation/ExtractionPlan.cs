@@ -0,0 +1,52 @@
+using System;
+
+namespace AkkaLibrary.DataSynchronisation
+{
+    /// <summary>
+    /// The cached, compiled transforms of one <see cref="DataStream"/>
+    ///
+    /// The plan is compiled against the first sample it is given and reused
+    /// for every sample with the same schema, writing straight into a record
+    /// owned by the caller. It is compiled again only when a sample no longer
+    /// matches the schema it was resolved against. A plan is owned by a single
+    /// actor and is not thread safe.
+    /// </summary>
+    public sealed class ExtractionPlan<TOut> where TOut : class
+    {
+        private Func<object, TOut, bool> _apply;
+
+        public DataStream Stream { get; }
+
+        /// <summary>
+        /// Number of times the plan has been compiled
+        /// </summary>
+        public int Compilations { get; private set; }
+
+        public bool IsCompiled => _apply != null;
+
+        public ExtractionPlan(DataStream stream)
+        {
+            Stream = stream ?? throw new ArgumentNullException(nameof(stream));
+        }
+
+        /// <summary>
+        /// Writes the transforms of <paramref name="sample"/> into <paramref name="output"/>,
+        /// compiling the plan first if the sample's schema has changed
+        /// </summary>
+        public void Apply(object sample, TOut output)
+        {
+            if(_apply != null && _apply(sample, output))
+            {
+                return;
+            }
+
+            _apply = ExtractionPlanCompiler.Compile<TOut>(Stream, sample);
+            Compilations++;
+
+            if(!_apply(sample, output))
+            {
+                throw new InvalidOperationException($"Stream {Stream.Name} does not match the plan compiled against it.");
+            }
+        }
+    }
+}
@@ -0,0 +1,452 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Reflection;
+
+namespace AkkaLibrary.DataSynchronisation
+{
+    /// <summary>
+    /// Compiles the transforms of a <see cref="DataStream"/> into one delegate
+    /// resolved against the schema of a sample
+    ///
+    /// Keyed extractions such as Analogs[Name|Speed] are looked up once in the
+    /// sample and replaced by the position of the matching element, so the
+    /// compiled delegate reads fixed indices instead of searching by name. Each
+    /// resolved position is guarded by a bounds check and a comparison of its
+    /// key, each dictionary lookup by the key being present, and each value
+    /// read through by a null check; when a later sample no longer matches,
+    /// the delegate returns false and the plan must be compiled again against
+    /// that sample.
+    ///
+    /// A transform with a single extraction assigns it to its assignment path.
+    /// With several extractions the assignment must be an array or list in the
+    /// output record and extraction i is written to element i.
+    /// </summary>
+    public static class ExtractionPlanCompiler
+    {
+        /// <summary>
+        /// Creates an uncompiled plan for every stream in the configuration, keyed by stream name
+        /// </summary>
+        public static IReadOnlyDictionary<string, ExtractionPlan<TOut>> CreatePlans<TOut>(DataSyncConfiguration config) where TOut : class
+            => config.Streams.ToDictionary(x => x.Name, x => new ExtractionPlan<TOut>(x));
+
+        /// <summary>
+        /// Compiles every transform of the stream against the schema of <paramref name="sample"/>
+        /// </summary>
+        public static Func<object, TOut, bool> Compile<TOut>(DataStream stream, object sample) where TOut : class
+        {
+            if(sample == null)
+            {
+                throw new ArgumentNullException(nameof(sample));
+            }
+
+            var dataType = stream.DataType ?? sample.GetType();
+            if(!dataType.IsInstanceOfType(sample))
+            {
+                throw new ArgumentException($"Stream {stream.Name} expects {dataType.Name} but the sample is {sample.GetType().Name}.", nameof(sample));
+            }
+
+            var input = Expression.Parameter(typeof(object), "sample");
+            var output = Expression.Parameter(typeof(TOut), "output");
+            var plan = new PlanBuilder(Expression.Convert(input, dataType), sample, output);
+
+            foreach (var transform in stream.Transforms ?? new List<Transform>())
+            {
+                plan.AddTransform(transform);
+            }
+
+            return Expression.Lambda<Func<object, TOut, bool>>(plan.Build(), input, output).Compile();
+        }
+
+        /// <summary>
+        /// Accumulates the statements of a plan. Every prefix of an extraction
+        /// or assignment path is evaluated once into a variable and shared by
+        /// the paths that start with it.
+        /// </summary>
+        private sealed class PlanBuilder
+        {
+            private readonly List<ParameterExpression> _variables = new List<ParameterExpression>();
+            private readonly List<Expression> _body = new List<Expression>();
+            private readonly Dictionary<string, Step> _extracted = new Dictionary<string, Step>();
+            private readonly Dictionary<string, Expression> _assigned = new Dictionary<string, Expression>();
+            private readonly HashSet<Expression> _notNull = new HashSet<Expression>();
+            private readonly LabelTarget _return = Expression.Label(typeof(bool), "matched");
+            private readonly Step _sample;
+            private readonly Expression _output;
+
+            public PlanBuilder(Expression input, object sample, Expression output)
+            {
+                _sample = Store(input, sample);
+                _output = output;
+            }
+
+            public void AddTransform(Transform transform)
+            {
+                var extractions = transform.Extractions ?? new List<string>();
+                if(extractions.Count == 0)
+                {
+                    throw new ArgumentException($"Transform to {transform.Assignment} has no extractions.");
+                }
+
+                var values = extractions.Select(Extract).ToList();
+
+                if(values.Count == 1)
+                {
+                    var target = ResolveAssignment(transform.Assignment, true);
+                    _body.Add(Assign(target, values[0], transform.Assignment));
+                    return;
+                }
+
+                var collection = ResolveAssignment(transform.Assignment, false);
+                for (int i = 0; i < values.Count; i++)
+                {
+                    _body.Add(Assign(ElementAt(collection, i, $"{transform.Assignment}[{i}]"), values[i], transform.Assignment));
+                }
+            }
+
+            public Expression Build()
+            {
+                _body.Add(Expression.Label(_return, Expression.Constant(true)));
+                return Expression.Block(typeof(bool), _variables, _body);
+            }
+
+            /// <summary>
+            /// Resolves an extraction path against the sample, returning the expression of its value
+            /// </summary>
+            private Expression Extract(string extraction)
+            {
+                var step = _sample;
+                var path = string.Empty;
+
+                foreach (var segment in ExtractionExpressionBuilder.CreateExtractionQueue(extraction ?? string.Empty))
+                {
+                    var parent = path;
+                    path = parent.Length == 0 ? segment : $"{parent}.{segment}";
+                    if(_extracted.TryGetValue(path, out var cached))
+                    {
+                        step = cached;
+                        continue;
+                    }
+
+                    var type = ExtractionExpressionBuilder.DetermineExtractionType(segment);
+                    if(type is UnknownExtractionType)
+                    {
+                        throw new ArgumentException($"Could not parse extraction:{segment}");
+                    }
+
+                    // Every form starts with a property; bracketed forms then select an element of it
+                    var member = parent.Length == 0 ? type.Name : $"{parent}.{type.Name}";
+                    if(!_extracted.TryGetValue(member, out var owner))
+                    {
+                        owner = _extracted[member] = Member(step, type.Name, member);
+                    }
+                    step = owner;
+
+                    if(type is EnumerableExtractionType positional)
+                    {
+                        step = ElementAt(step, positional.Index, path);
+                    }
+                    else if(type is KeyEnumerableExtractionType keyed)
+                    {
+                        step = FindIndexer(step.Expression.Type, typeof(string)) is PropertyInfo lookup
+                             ? Lookup(step, lookup, keyed.Key, path)
+                             : ElementWhere(step, "Name", keyed.Key, path);
+                    }
+                    else if(type is KeyValueExtractionType keyValue)
+                    {
+                        step = ElementWhere(step, keyValue.KeyName, keyValue.KeyValue, path);
+                    }
+
+                    _extracted[path] = step;
+                }
+
+                if(step == _sample)
+                {
+                    throw new ArgumentException("Extraction is empty.");
+                }
+                return step.Expression;
+            }
+
+            private Step Member(Step source, string name, string path)
+            {
+                var property = FindProperty(source.Expression.Type, name);
+                if(property == null || property.GetGetMethod() == null)
+                {
+                    throw new ArgumentException($"{source.Expression.Type.Name} has no readable property {name} in extraction {path}.");
+                }
+                if(source.Value == null)
+                {
+                    throw new ArgumentException($"Extraction {path} reads through a null value in the sample.");
+                }
+
+                GuardNotNull(source);
+                return Store(Expression.Property(source.Expression, property), property.GetValue(source.Value));
+            }
+
+            /// <summary>
+            /// The element at a fixed position, guarded against the collection shrinking
+            /// </summary>
+            private Step ElementAt(Step collection, int index, string path)
+            {
+                var count = CountOf(collection.Expression);
+                if(collection.Value == null || index < 0 || index >= (int)Evaluate(count, collection))
+                {
+                    throw new ArgumentException($"Index {index} is outside the sample in extraction {path}.");
+                }
+
+                GuardNotNull(collection);
+                Guard(Expression.GreaterThan(count, Expression.Constant(index)));
+
+                var element = ElementAt(collection.Expression, index, path);
+                return Store(element, Evaluate(element, collection));
+            }
+
+            /// <summary>
+            /// The value under a key of a dictionary, which has no fixed position
+            /// to resolve, guarded by the key still being present
+            /// </summary>
+            private Step Lookup(Step dictionary, PropertyInfo indexer, string key, string path)
+            {
+                if(dictionary.Value == null)
+                {
+                    throw new ArgumentException($"Key {key} is not in the sample in extraction {path}.");
+                }
+
+                object value;
+                try
+                {
+                    value = indexer.GetValue(dictionary.Value, new object[] { key });
+                }
+                catch(TargetInvocationException)
+                {
+                    throw new ArgumentException($"Key {key} is not in the sample in extraction {path}.");
+                }
+
+                GuardNotNull(dictionary);
+                var tryGetValue = FindMethod(dictionary.Expression.Type, "TryGetValue", typeof(string), indexer.PropertyType.MakeByRefType());
+                if(tryGetValue == null)
+                {
+                    return Store(Expression.Property(dictionary.Expression, indexer, Expression.Constant(key)), value);
+                }
+
+                var variable = Expression.Variable(indexer.PropertyType);
+                _variables.Add(variable);
+                Guard(Expression.Call(dictionary.Expression, tryGetValue, Expression.Constant(key), variable));
+                return new Step(variable, value);
+            }
+
+            /// <summary>
+            /// The element whose <paramref name="keyName"/> equals <paramref name="keyValue"/>
+            /// in the sample, read by position and guarded by its key
+            /// </summary>
+            private Step ElementWhere(Step collection, string keyName, string keyValue, string path)
+            {
+                var count = CountOf(collection.Expression);
+                var elementType = ElementAt(collection.Expression, 0, path).Type;
+                var keyProperty = FindProperty(elementType, keyName);
+                if(keyProperty == null)
+                {
+                    throw new ArgumentException($"{elementType.Name} has no key {keyName} in extraction {path}.");
+                }
+
+                object key;
+                try
+                {
+                    key = Convert.ChangeType(keyValue, keyProperty.PropertyType, CultureInfo.InvariantCulture);
+                }
+                catch(Exception ex) when (ex is InvalidCastException || ex is FormatException || ex is OverflowException)
+                {
+                    throw new ArgumentException($"Key {keyValue} is not a {keyProperty.PropertyType.Name} in extraction {path}.");
+                }
+
+                var length = collection.Value == null ? 0 : (int)Evaluate(count, collection);
+                for (int i = 0; i < length; i++)
+                {
+                    var candidate = ElementAt(collection.Expression, i, path);
+                    var element = Evaluate(candidate, collection);
+                    if(element == null || !Equals(keyProperty.GetValue(element), key))
+                    {
+                        continue;
+                    }
+
+                    GuardNotNull(collection);
+                    Guard(Expression.GreaterThan(count, Expression.Constant(i)));
+                    var step = Store(candidate, element);
+                    GuardNotNull(step);
+                    Guard(Expression.Equal(Expression.Property(step.Expression, keyProperty), Expression.Constant(key, keyProperty.PropertyType)));
+                    return step;
+                }
+
+                throw new ArgumentException($"No element has {keyName} {keyValue} in extraction {path}.");
+            }
+
+            /// <summary>
+            /// Resolves an assignment path against the output record. Only the
+            /// final segment of an assigned path needs to be writable.
+            /// </summary>
+            private Expression ResolveAssignment(string assignment, bool writable)
+            {
+                var target = _output;
+                var path = string.Empty;
+                var segments = ExtractionExpressionBuilder.CreateExtractionQueue(assignment ?? string.Empty);
+
+                while(segments.Count > 0)
+                {
+                    var segment = segments.Dequeue();
+                    path = path.Length == 0 ? segment : $"{path}.{segment}";
+                    var last = writable && segments.Count == 0;
+
+                    if(!last && _assigned.TryGetValue(path, out var cached))
+                    {
+                        target = cached;
+                        continue;
+                    }
+
+                    var type = AssignmentExpressionBuilder.DetermineAssignmentType(segment);
+                    var property = FindProperty(target.Type, type.Name);
+                    if(type is UnknownAssignmentType || type is KeyValueAssignmentType || property == null)
+                    {
+                        throw new ArgumentException($"Could not resolve assignment:{path}");
+                    }
+
+                    target = Expression.Property(target, property);
+                    if(type is EnumerableAssignmentType positional)
+                    {
+                        target = ElementAt(target, positional.Index, path);
+                    }
+
+                    if(!last)
+                    {
+                        var variable = Expression.Variable(target.Type);
+                        _variables.Add(variable);
+                        _body.Add(Expression.Assign(variable, target));
+                        _assigned[path] = target = variable;
+                    }
+                }
+
+                if(target == _output)
+                {
+                    throw new ArgumentException("Assignment is empty.");
+                }
+                return target;
+            }
+
+            private static Expression Assign(Expression target, Expression value, string assignment)
+            {
+                try
+                {
+                    return Expression.Assign(target, value.Type == target.Type ? value : Expression.Convert(value, target.Type));
+                }
+                catch(InvalidOperationException ex)
+                {
+                    throw new ArgumentException($"Cannot assign {value.Type.Name} to {assignment}. {ex.Message}");
+                }
+            }
+
+            /// <summary>
+            /// Returns from the plan with false unless <paramref name="condition"/> holds
+            /// </summary>
+            private void Guard(Expression condition)
+                => _body.Add(Expression.IfThen(Expression.Not(condition), Expression.Return(_return, Expression.Constant(false))));
+
+            /// <summary>
+            /// Returns from the plan with false if a stored value that is read through is null
+            /// </summary>
+            private void GuardNotNull(Step step)
+            {
+                var type = step.Expression.Type;
+                if((type.IsValueType && Nullable.GetUnderlyingType(type) == null) || !_notNull.Add(step.Expression))
+                {
+                    return;
+                }
+
+                Guard(type.IsValueType
+                    ? Expression.NotEqual(step.Expression, Expression.Constant(null, type))
+                    : Expression.ReferenceNotEqual(step.Expression, Expression.Constant(null, type)));
+            }
+
+            private Step Store(Expression expression, object value)
+            {
+                var variable = Expression.Variable(expression.Type);
+                _variables.Add(variable);
+                _body.Add(Expression.Assign(variable, expression));
+                return new Step(variable, value);
+            }
+
+            /// <summary>
+            /// Evaluates an expression over a stored step against the sample while resolving
+            /// </summary>
+            private static object Evaluate(Expression expression, Step source)
+            {
+                var parameter = (ParameterExpression)source.Expression;
+                var body = Expression.Convert(expression, typeof(object));
+                return Expression.Lambda(body, parameter).Compile().DynamicInvoke(source.Value);
+            }
+
+            private static Expression CountOf(Expression collection)
+            {
+                if(collection.Type.IsArray)
+                {
+                    return Expression.ArrayLength(collection);
+                }
+
+                var count = FindProperty(collection.Type, "Count");
+                if(count == null || count.PropertyType != typeof(int))
+                {
+                    throw new ArgumentException($"{collection.Type.Name} has no Count and cannot be read by position.");
+                }
+                return Expression.Property(collection, count);
+            }
+
+            private static Expression ElementAt(Expression collection, int index, string path)
+            {
+                if(collection.Type.IsArray)
+                {
+                    return Expression.ArrayAccess(collection, Expression.Constant(index));
+                }
+
+                var indexer = FindIndexer(collection.Type, typeof(int));
+                if(indexer == null)
+                {
+                    throw new ArgumentException($"{collection.Type.Name} cannot be indexed by position in {path}.");
+                }
+                return Expression.Property(collection, indexer, Expression.Constant(index));
+            }
+        }
+
+        /// <summary>
+        /// Finds a property on a type or, for interfaces, on the interfaces it extends
+        /// </summary>
+        private static PropertyInfo FindProperty(Type type, string name)
+            => new[] { type }.Concat(type.IsInterface ? type.GetInterfaces() : Type.EmptyTypes)
+                             .Select(x => x.GetProperty(name, BindingFlags.Public | BindingFlags.Instance))
+                             .FirstOrDefault(x => x != null && x.GetIndexParameters().Length == 0);
+
+        private static MethodInfo FindMethod(Type type, string name, params Type[] parameterTypes)
+            => new[] { type }.Concat(type.IsInterface ? type.GetInterfaces() : Type.EmptyTypes)
+                             .Select(x => x.GetMethod(name, BindingFlags.Public | BindingFlags.Instance, null, parameterTypes, null))
+                             .FirstOrDefault(x => x != null && x.ReturnType == typeof(bool));
+
+        private static PropertyInfo FindIndexer(Type type, Type keyType)
+            => new[] { type }.Concat(type.IsInterface ? type.GetInterfaces() : Type.EmptyTypes)
+                             .SelectMany(x => x.GetProperties(BindingFlags.Public | BindingFlags.Instance))
+                             .FirstOrDefault(x => x.GetIndexParameters().Select(p => p.ParameterType).SequenceEqual(new[] { keyType }));
+
+        /// <summary>
+        /// A resolved path prefix: the variable holding it and its value in the sample
+        /// </summary>
+        private sealed class Step
+        {
+            public Expression Expression { get; }
+            public object Value { get; }
+
+            public Step(Expression expression, object value)
+            {
+                Expression = expression;
+                Value = value;
+            }
+        }
+    }
+}
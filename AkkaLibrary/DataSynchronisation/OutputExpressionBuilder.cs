@@ -63,7 +63,7 @@ namespace AkkaLibrary.DataSynchronisation
             return assignmentExpression;
         }
 
-        private static IAssignmentType DetermineAssignmentType(string assign)
+        internal static IAssignmentType DetermineAssignmentType(string assign)
         {
             if (string.IsNullOrWhiteSpace(assign))
             {
@@ -1,6 +1,107 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
 namespace AkkaLibrary.Exceedances
 {
+    /// <summary>
+    /// The limits checked by an <see cref="ExceedanceDetector"/>
+    /// </summary>
     public class ExceedanceConfiguration
     {
+        public IReadOnlyList<LimitConfiguration> Limits { get; }
+
+        /// <summary>
+        /// Tachos per metre, used to convert the persistence of distance limits
+        /// </summary>
+        public double TachosPerMetre { get; }
+
+        public ExceedanceConfiguration(IEnumerable<LimitConfiguration> limits, double tachosPerMetre = 1)
+        {
+            Limits = limits.ToArray();
+
+            if(tachosPerMetre <= 0)
+            {
+                throw new ArgumentException("Tachos per metre must be positive.", nameof(tachosPerMetre));
+            }
+
+            var duplicate = Limits.GroupBy(x => x.Name).FirstOrDefault(x => x.Count() > 1);
+            if(duplicate != null)
+            {
+                throw new ArgumentException($"Limit {duplicate.Key} is configured more than once.", nameof(limits));
+            }
+
+            TachosPerMetre = tachosPerMetre;
+        }
     }
-}
\ No newline at end of file
+
+    /// <summary>
+    /// A threshold on one analog channel
+    ///
+    /// An exceedance starts once the channel has been past the threshold for
+    /// the persistence, and ends once it is back inside by the hysteresis. The
+    /// start is reported at the first sample past the threshold.
+    /// </summary>
+    public class LimitConfiguration
+    {
+        public string Name { get; }
+
+        public string Channel { get; }
+
+        public LimitDirection Direction { get; }
+
+        public float Threshold { get; }
+
+        /// <summary>
+        /// Distance back inside the threshold before an exceedance ends
+        /// </summary>
+        public float Hysteresis { get; }
+
+        public PersistenceKind Persistence { get; }
+
+        /// <summary>
+        /// How long the channel must stay past the threshold, in timestamp
+        /// units for <see cref="PersistenceKind.Duration"/> or metres for
+        /// <see cref="PersistenceKind.Distance"/>. Zero starts an exceedance on
+        /// the first sample past the threshold.
+        /// </summary>
+        public double PersistenceLength { get; }
+
+        public LimitConfiguration(string name, string channel, LimitDirection direction, float threshold)
+            : this(name, channel, direction, threshold, 0, PersistenceKind.Duration, 0)
+        {
+        }
+
+        public LimitConfiguration(string name, string channel, LimitDirection direction, float threshold, float hysteresis, PersistenceKind persistence, double persistenceLength)
+        {
+            if(hysteresis < 0)
+            {
+                throw new ArgumentException("Hysteresis cannot be negative.", nameof(hysteresis));
+            }
+            if(persistenceLength < 0)
+            {
+                throw new ArgumentException("Persistence cannot be negative.", nameof(persistenceLength));
+            }
+
+            Name = name ?? throw new ArgumentNullException(nameof(name));
+            Channel = channel ?? throw new ArgumentNullException(nameof(channel));
+            Direction = direction;
+            Threshold = threshold;
+            Hysteresis = hysteresis;
+            Persistence = persistence;
+            PersistenceLength = persistenceLength;
+        }
+    }
+
+    public enum LimitDirection
+    {
+        Above,
+        Below
+    }
+
+    public enum PersistenceKind
+    {
+        Duration,
+        Distance
+    }
+}
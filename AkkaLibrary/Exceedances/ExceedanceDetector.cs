@@ -0,0 +1,93 @@
+using System.Collections.Generic;
+using System.Diagnostics;
+using Akka.Streams;
+using Akka.Streams.Stage;
+using AkkaLibrary.Common.Metrics;
+using AkkaLibrary.Common.Objects;
+
+namespace AkkaLibrary.Exceedances
+{
+    /// <summary>
+    /// Checks every configured limit against each <see cref="SampleBlock{TData}"/>
+    /// and emits the exceedances that start or end in it
+    ///
+    /// The limits are compiled into an <see cref="ExceedancePlan"/> per
+    /// materialisation. Blocks without any start or end emit nothing.
+    /// </summary>
+    public class ExceedanceDetector : GraphStage<FlowShape<SampleBlock<float>, ExceedanceEvent>>
+    {
+        #region Logic
+
+        private sealed class Logic : InAndOutGraphStageLogic
+        {
+            private readonly ExceedanceDetector _stage;
+            private readonly ExceedancePlan _plan;
+            private readonly List<ExceedanceEvent> _events = new List<ExceedanceEvent>();
+
+            public Logic(ExceedanceDetector stage) : base(stage.Shape)
+            {
+                _stage = stage;
+                _plan = new ExceedancePlan(stage._config);
+                SetHandler(stage.In, this);
+                SetHandler(stage.Out, this);
+            }
+
+            public override void OnPush()
+            {
+                var block = Grab(_stage.In);
+
+                var started = Stopwatch.GetTimestamp();
+                _events.Clear();
+                _plan.Evaluate(block, _events);
+                _stage._evaluateTime.RecordSince(started);
+                _stage._samples.Add(block.Length);
+
+                if(_events.Count > 0)
+                {
+                    _stage._events.Add(_events.Count);
+                    EmitMultiple(_stage.Out, _events.ToArray());
+                }
+                else
+                {
+                    Pull(_stage.In);
+                }
+            }
+
+            public override void OnPull() => Pull(_stage.In);
+        }
+
+        #endregion
+
+        private readonly ExceedanceConfiguration _config;
+
+        private readonly Counter _samples;
+        private readonly Counter _events;
+        private readonly LatencyHistogram _evaluateTime;
+
+        /// <param name="config">Limits to check</param>
+        /// <param name="name">Prefix of the published metric names. Defaults to one unique to this stage.</param>
+        /// <param name="registry">Registry to publish to. Defaults to <see cref="MetricsRegistry.Default"/>.</param>
+        public ExceedanceDetector(ExceedanceConfiguration config, string name = null, MetricsRegistry registry = null)
+        {
+            registry = registry ?? MetricsRegistry.Default;
+            name = name ?? MetricsRegistry.InstanceName("ExceedanceDetector");
+
+            _config = config;
+            _samples = registry.Counter($"{name}.Samples");
+            _events = registry.Counter($"{name}.Events");
+            _evaluateTime = registry.Histogram($"{name}.Evaluate");
+        }
+
+        public Inlet<SampleBlock<float>> In { get; } = new Inlet<SampleBlock<float>>("ExceedanceDetector.In");
+
+        public Outlet<ExceedanceEvent> Out { get; } = new Outlet<ExceedanceEvent>("ExceedanceDetector.Out");
+
+        public override FlowShape<SampleBlock<float>, ExceedanceEvent> Shape => new FlowShape<SampleBlock<float>, ExceedanceEvent>(In, Out);
+
+        public override string ToString() => "ExceedanceDetector";
+
+        protected override GraphStageLogic CreateLogic(Attributes inheritedAttributes) => new Logic(this);
+
+        protected override Attributes InitialAttributes => Attributes.CreateName("ExceedanceDetector");
+    }
+}
@@ -0,0 +1,50 @@
+namespace AkkaLibrary.Exceedances
+{
+    public enum ExceedanceEventKind
+    {
+        Start,
+        End
+    }
+
+    /// <summary>
+    /// The start or end of an exceedance of one limit
+    /// </summary>
+    public sealed class ExceedanceEvent
+    {
+        public string Limit { get; }
+
+        public string Channel { get; }
+
+        public ExceedanceEventKind Kind { get; }
+
+        /// <summary>
+        /// Sample at which the exceedance started or ended. A start is
+        /// reported at the first sample past the threshold, even when it is
+        /// only emitted once the persistence has been met.
+        /// </summary>
+        public long SampleIndex { get; }
+
+        public long TimeStamp { get; }
+
+        public long TachometerCount { get; }
+
+        /// <summary>
+        /// The furthest value past the threshold so far, or over the whole
+        /// exceedance for an end
+        /// </summary>
+        public float Peak { get; }
+
+        public ExceedanceEvent(string limit, string channel, ExceedanceEventKind kind, long sampleIndex, long timeStamp, long tachometerCount, float peak)
+        {
+            Limit = limit;
+            Channel = channel;
+            Kind = kind;
+            SampleIndex = sampleIndex;
+            TimeStamp = timeStamp;
+            TachometerCount = tachometerCount;
+            Peak = peak;
+        }
+
+        public override string ToString() => $"{Limit} {Kind} at {SampleIndex} (peak {Peak})";
+    }
+}
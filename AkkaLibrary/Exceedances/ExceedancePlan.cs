@@ -0,0 +1,384 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Numerics;
+using AkkaLibrary.Common.Objects;
+
+namespace AkkaLibrary.Exceedances
+{
+    /// <summary>
+    /// The configured limits compiled into flat arrays and evaluated a block at a time
+    ///
+    /// Below limits are stored negated, so every limit is a signed value rising
+    /// past a signed threshold. Each block starts with one vectorised min/max
+    /// pass per limited channel. A limit whose state the extremes show cannot
+    /// change costs a few comparisons; only the rest are walked, using
+    /// vectorised scans to find the next crossing. Limit state carries across
+    /// blocks and schema changes. A plan is owned by a single stage and is not
+    /// thread safe.
+    /// </summary>
+    public sealed class ExceedancePlan
+    {
+        private const byte Idle = 0;
+        private const byte Pending = 1;
+        private const byte Active = 2;
+
+        private readonly LimitConfiguration[] _limits;
+
+        // Compiled limits, in signed space
+        private readonly float[] _signs;
+        private readonly float[] _thresholds;
+        private readonly float[] _clears;
+        private readonly bool[] _byDistance;
+        private readonly long[] _persistence;
+
+        // Limit state
+        private readonly byte[] _states;
+        private readonly float[] _peaks;
+        private readonly long[] _onsetIndices;
+        private readonly long[] _onsetTimes;
+        private readonly long[] _onsetTachos;
+
+        // Resolved against the current schema
+        private ChannelSchema _schema;
+        private int[] _columns;
+        private int[] _limitedColumns;
+        private float[] _minimums;
+        private float[] _maximums;
+
+        public int LimitCount => _limits.Length;
+
+        public ExceedancePlan(ExceedanceConfiguration config)
+        {
+            _limits = config.Limits.ToArray();
+            var count = _limits.Length;
+
+            _signs = new float[count];
+            _thresholds = new float[count];
+            _clears = new float[count];
+            _byDistance = new bool[count];
+            _persistence = new long[count];
+
+            for (int i = 0; i < count; i++)
+            {
+                var limit = _limits[i];
+                var sign = limit.Direction == LimitDirection.Above ? 1f : -1f;
+
+                _signs[i] = sign;
+                _thresholds[i] = sign * limit.Threshold;
+                _clears[i] = sign * limit.Threshold - limit.Hysteresis;
+                _byDistance[i] = limit.Persistence == PersistenceKind.Distance;
+                _persistence[i] = (long)Math.Ceiling(_byDistance[i] ? limit.PersistenceLength * config.TachosPerMetre : limit.PersistenceLength);
+            }
+
+            _states = new byte[count];
+            _peaks = new float[count];
+            _onsetIndices = new long[count];
+            _onsetTimes = new long[count];
+            _onsetTachos = new long[count];
+        }
+
+        /// <summary>
+        /// True while the limit at <paramref name="limit"/> in the configuration is exceeded
+        /// </summary>
+        public bool IsExceeding(int limit) => _states[limit] == Active;
+
+        /// <summary>
+        /// Advances every limit over the block, adding the exceedances that
+        /// start or end in it to <paramref name="events"/> in order of limit
+        /// </summary>
+        public void Evaluate(SampleBlock<float> block, List<ExceedanceEvent> events)
+        {
+            if(!ReferenceEquals(block.Schema, _schema))
+            {
+                Resolve(block.Schema);
+            }
+
+            var length = block.Length;
+            if(length == 0)
+            {
+                return;
+            }
+
+            foreach (var column in _limitedColumns)
+            {
+                MinMax(block.Analogs, column * length, column * length + length, out _minimums[column], out _maximums[column]);
+            }
+
+            for (int i = 0; i < _limits.Length; i++)
+            {
+                var column = _columns[i];
+                var upper = _signs[i] > 0 ? _maximums[column] : -_minimums[column];
+                var lower = _signs[i] > 0 ? _minimums[column] : -_maximums[column];
+
+                switch(_states[i])
+                {
+                    case Idle:
+                        if(upper <= _thresholds[i])
+                        {
+                            continue;
+                        }
+                        break;
+
+                    case Pending:
+                        if(lower > _thresholds[i] && !Persisted(i, block, length - 1))
+                        {
+                            _peaks[i] = Math.Max(_peaks[i], upper);
+                            continue;
+                        }
+                        break;
+
+                    default:
+                        if(lower >= _clears[i])
+                        {
+                            _peaks[i] = Math.Max(_peaks[i], upper);
+                            continue;
+                        }
+                        break;
+                }
+
+                Walk(i, block, events);
+            }
+        }
+
+        private void Resolve(ChannelSchema schema)
+        {
+            _columns = _limits.Select(limit =>
+            {
+                var column = schema.IndexOfAnalog(limit.Channel);
+                if(column < 0)
+                {
+                    throw new ArgumentException($"Channel {limit.Channel} of limit {limit.Name} is not present in the input.");
+                }
+                return column;
+            }).ToArray();
+
+            _limitedColumns = _columns.Distinct().ToArray();
+            _minimums = new float[schema.AnalogCount];
+            _maximums = new float[schema.AnalogCount];
+            _schema = schema;
+        }
+
+        /// <summary>
+        /// Steps one limit through the block from crossing to crossing
+        /// </summary>
+        private void Walk(int i, SampleBlock<float> block, List<ExceedanceEvent> events)
+        {
+            var values = block.Analogs;
+            var start = _columns[i] * block.Length;
+            var end = start + block.Length;
+            var positive = _signs[i] > 0;
+            var threshold = _thresholds[i];
+            var clear = _clears[i];
+            var position = start;
+
+            while(position < end)
+            {
+                switch(_states[i])
+                {
+                    case Idle:
+                    {
+                        var onset = positive
+                                    ? FindFirst(values, position, end, threshold, Comparison.Greater)
+                                    : FindFirst(values, position, end, -threshold, Comparison.Less);
+                        if(onset == end)
+                        {
+                            return;
+                        }
+
+                        var sample = onset - start;
+                        _states[i] = Pending;
+                        _peaks[i] = float.NegativeInfinity;
+                        _onsetIndices[i] = block.SampleIndices[sample];
+                        _onsetTimes[i] = block.TimeStamps[sample];
+                        _onsetTachos[i] = block.TachometerCounts[sample];
+                        position = onset;
+                        break;
+                    }
+
+                    case Pending:
+                    {
+                        var back = positive
+                                   ? FindFirst(values, position, end, threshold, Comparison.LessOrEqual)
+                                   : FindFirst(values, position, end, -threshold, Comparison.GreaterOrEqual);
+                        var persisted = start + FirstPersisted(i, block, position - start, back - start);
+
+                        if(persisted < back)
+                        {
+                            _peaks[i] = Math.Max(_peaks[i], SignedMax(values, position, persisted + 1, positive));
+                            _states[i] = Active;
+                            events.Add(CreateEvent(i, ExceedanceEventKind.Start, _onsetIndices[i], _onsetTimes[i], _onsetTachos[i]));
+                            position = persisted;
+                            break;
+                        }
+
+                        _peaks[i] = Math.Max(_peaks[i], SignedMax(values, position, back, positive));
+                        if(back == end)
+                        {
+                            return;
+                        }
+                        _states[i] = Idle;
+                        position = back;
+                        break;
+                    }
+
+                    default:
+                    {
+                        var ended = positive
+                                    ? FindFirst(values, position, end, clear, Comparison.Less)
+                                    : FindFirst(values, position, end, -clear, Comparison.Greater);
+
+                        _peaks[i] = Math.Max(_peaks[i], SignedMax(values, position, ended, positive));
+                        if(ended == end)
+                        {
+                            return;
+                        }
+
+                        var sample = ended - start;
+                        events.Add(CreateEvent(i, ExceedanceEventKind.End, block.SampleIndices[sample], block.TimeStamps[sample], block.TachometerCounts[sample]));
+                        _states[i] = Idle;
+                        position = ended;
+                        break;
+                    }
+                }
+            }
+        }
+
+        private ExceedanceEvent CreateEvent(int i, ExceedanceEventKind kind, long sampleIndex, long timeStamp, long tachometerCount)
+            => new ExceedanceEvent(_limits[i].Name, _limits[i].Channel, kind, sampleIndex, timeStamp, tachometerCount, _signs[i] * _peaks[i]);
+
+        /// <summary>
+        /// True once a pending limit has persisted up to and including the sample
+        /// </summary>
+        private bool Persisted(int i, SampleBlock<float> block, int sample)
+            => _byDistance[i]
+               ? block.TachometerCounts[sample] - _onsetTachos[i] >= _persistence[i]
+               : block.TimeStamps[sample] - _onsetTimes[i] >= _persistence[i];
+
+        /// <summary>
+        /// First sample in [from, to) at which a pending limit has persisted,
+        /// or <paramref name="to"/>. Timestamps and tacho counts rise
+        /// monotonically, so this is a binary search.
+        /// </summary>
+        private int FirstPersisted(int i, SampleBlock<float> block, int from, int to)
+        {
+            var low = from;
+            var high = to;
+            while(low < high)
+            {
+                var middle = low + (high - low) / 2;
+                if(Persisted(i, block, middle))
+                {
+                    high = middle;
+                }
+                else
+                {
+                    low = middle + 1;
+                }
+            }
+            return low;
+        }
+
+        private static float SignedMax(float[] values, int from, int to, bool positive)
+        {
+            MinMax(values, from, to, out var min, out var max);
+            return positive ? max : -min;
+        }
+
+        /// <summary>
+        /// Minimum and maximum of values[from..to), or +/-infinity when empty
+        /// </summary>
+        internal static void MinMax(float[] values, int from, int to, out float min, out float max)
+        {
+            min = float.PositiveInfinity;
+            max = float.NegativeInfinity;
+            var i = from;
+
+            var width = Vector<float>.Count;
+            if(Vector.IsHardwareAccelerated && to - from >= width)
+            {
+                var minimums = new Vector<float>(values, i);
+                var maximums = minimums;
+                for (i += width; i <= to - width; i += width)
+                {
+                    var chunk = new Vector<float>(values, i);
+                    minimums = Vector.Min(minimums, chunk);
+                    maximums = Vector.Max(maximums, chunk);
+                }
+
+                for (int lane = 0; lane < width; lane++)
+                {
+                    min = Math.Min(min, minimums[lane]);
+                    max = Math.Max(max, maximums[lane]);
+                }
+            }
+
+            for (; i < to; i++)
+            {
+                min = Math.Min(min, values[i]);
+                max = Math.Max(max, values[i]);
+            }
+        }
+
+        private enum Comparison
+        {
+            Greater,
+            GreaterOrEqual,
+            Less,
+            LessOrEqual
+        }
+
+        /// <summary>
+        /// Index of the first of values[from..to) that compares true against
+        /// <paramref name="bound"/>, or <paramref name="to"/> if none does
+        /// </summary>
+        private static int FindFirst(float[] values, int from, int to, float bound, Comparison comparison)
+        {
+            var i = from;
+
+            if(Vector.IsHardwareAccelerated)
+            {
+                var width = Vector<float>.Count;
+                var bounds = new Vector<float>(bound);
+                for (; i <= to - width; i += width)
+                {
+                    if(Any(new Vector<float>(values, i), bounds, comparison))
+                    {
+                        break;
+                    }
+                }
+            }
+
+            for (; i < to; i++)
+            {
+                if(Compare(values[i], bound, comparison))
+                {
+                    return i;
+                }
+            }
+            return to;
+        }
+
+        private static bool Any(Vector<float> values, Vector<float> bounds, Comparison comparison)
+        {
+            switch(comparison)
+            {
+                case Comparison.Greater: return Vector.GreaterThanAny(values, bounds);
+                case Comparison.GreaterOrEqual: return Vector.GreaterThanOrEqualAny(values, bounds);
+                case Comparison.Less: return Vector.LessThanAny(values, bounds);
+                default: return Vector.LessThanOrEqualAny(values, bounds);
+            }
+        }
+
+        private static bool Compare(float value, float bound, Comparison comparison)
+        {
+            switch(comparison)
+            {
+                case Comparison.Greater: return value > bound;
+                case Comparison.GreaterOrEqual: return value >= bound;
+                case Comparison.Less: return value < bound;
+                default: return value <= bound;
+            }
+        }
+    }
+}
@@ -2,6 +2,7 @@ using System;
 using System.Collections.Generic;
 using Akka.Actor;
 using Akka.IO;
+using AkkaLibrary.Common.Metrics;
 
 namespace AkkaLibrary
 {
@@ -13,7 +14,11 @@ namespace AkkaLibrary
         public int SamplesPerPacket { get; set; }
         public ByteString Delimiter { get; set; }
         public int MaxFrameLength { get; set; }
+        public int MaxBufferedPackets { get; set; } = 64;
+        public int ChunkPackets { get; set; } = 64;
         public IActorRef OutputTarget { get; set; }
+        public string RecordingPath { get; set; }
+        public SampleArrivals Arrivals { get; set; }
         public TimeSpan RetryConnectionTimeout { get; set; }
     }
 
@@ -24,12 +29,33 @@ namespace AkkaLibrary
         List<FpgaChannel> ChannelList { get; set; }
         
         IActorRef OutputTarget { get; set; }
+
+        /// <summary>
+        /// Path to record raw packets to, or null to disable recording
+        /// </summary>
+        string RecordingPath { get; set; }
+
+        /// <summary>
+        /// Arrival times of this pipeline's samples, shared with its later
+        /// stages so they can measure their latency. Null to not mark them.
+        /// </summary>
+        SampleArrivals Arrivals { get; set; }
     }
 
     internal interface IFpgaFramingConfig
     {
         ByteString Delimiter { get; set; }
-        int MaxFrameLength { get; set; }        
+        int MaxFrameLength { get; set; }
+
+        /// <summary>
+        /// Packets framed but not yet decoded before the socket stops being read
+        /// </summary>
+        int MaxBufferedPackets { get; set; }
+
+        /// <summary>
+        /// Packets held by each pooled chunk the framer reads into. At least two.
+        /// </summary>
+        int ChunkPackets { get; set; }
     }
 
     public interface IFpgaConnectionConfig
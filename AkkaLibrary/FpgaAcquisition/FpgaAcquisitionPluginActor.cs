@@ -46,26 +46,31 @@ namespace AkkaLibrary
 
         private void ReConfigureSelf(FpgaAcquisitionConfiguration configuration)
         {
-            if(ShouldReconfigureAssembler(configuration))
+            var reconfigureAssembler = ShouldReconfigureAssembler(configuration);
+            if(reconfigureAssembler)
             {
                 //Reconfigure assembler
                 Context.Stop(_assembler);
                 _assembler = CreateAssemblerChild(configuration);
             }
             
-            if(ShouldReconfigureDelimiter(configuration))
+            // The framing actor sizes packets from the assembler config
+            var reconfigureFraming = reconfigureAssembler || ShouldReconfigureFraming(configuration);
+            if(reconfigureFraming)
             {
-                //Reconfigure delimiter
+                //Reconfigure framing
                 Context.Stop(_framing);
-                _framing = CreateDelimiterChild(configuration, _assembler);
+                _framing = CreateFramingChild(configuration, configuration, _assembler);
             }
 
-            if(ShouldReconfigureConnection(configuration))
+            if(reconfigureFraming || ShouldReconfigureConnection(configuration))
             {
                 //Reconfigure connection
                 Context.Stop(_connector);
                 _connector = CreateConnectionChild(configuration, _framing);
             }
+
+            _config = configuration;
         }
 
         private bool ShouldReconfigureConnection(IFpgaConnectionConfig config)
@@ -76,12 +81,14 @@ namespace AkkaLibrary
                    config.Port != oldReceiverConfig.Port;
         }
 
-        private bool ShouldReconfigureDelimiter(IFpgaFramingConfig config)
+        private bool ShouldReconfigureFraming(IFpgaFramingConfig config)
         {
             var oldReceiverConfig = _config as IFpgaFramingConfig;
 
             return config.Delimiter != oldReceiverConfig.Delimiter ||
-                   config.MaxFrameLength != oldReceiverConfig.MaxFrameLength;
+                   config.MaxFrameLength != oldReceiverConfig.MaxFrameLength ||
+                   config.MaxBufferedPackets != oldReceiverConfig.MaxBufferedPackets ||
+                   config.ChunkPackets != oldReceiverConfig.ChunkPackets;
         }
 
         private bool ShouldReconfigureAssembler(IFpgaAssemblerConfig config)
@@ -90,14 +97,16 @@ namespace AkkaLibrary
 
             return config.OutputTarget != oldReceiverConfig.OutputTarget ||
                    config.SamplesPerPacket != oldReceiverConfig.SamplesPerPacket ||
-                   Enumerable.SequenceEqual(config.ChannelList, oldReceiverConfig.ChannelList);
+                   config.RecordingPath != oldReceiverConfig.RecordingPath ||
+                   config.Arrivals != oldReceiverConfig.Arrivals ||
+                   !Enumerable.SequenceEqual(config.ChannelList, oldReceiverConfig.ChannelList);
         }
 
         private void ConfigureSelf(FpgaAcquisitionConfiguration config)
         {
             _config = config;
             _assembler = CreateAssemblerChild(config);
-            _framing = CreateDelimiterChild(config, _assembler);
+            _framing = CreateFramingChild(config, config, _assembler);
             _connector = CreateConnectionChild(config, _framing);
         }
 
@@ -111,14 +120,20 @@ namespace AkkaLibrary
             return actor;
         }
 
-        private IActorRef CreateDelimiterChild(IFpgaFramingConfig config, IActorRef assembler)
+        private IActorRef CreateFramingChild(IFpgaFramingConfig config, IFpgaAssemblerConfig assemblerConfig, IActorRef assembler)
         {
-            return Context.ActorOf(FpgaDelimitingActor.GetProps(config.Delimiter, config.MaxFrameLength, assembler));
+            var packetLength = FpgaPacketDecoder.GetPacketLength(assemblerConfig.ChannelList, assemblerConfig.SamplesPerPacket);
+            if(packetLength > config.MaxFrameLength)
+            {
+                throw new ArgumentException($"Packets of {packetLength} bytes exceed the maximum frame length of {config.MaxFrameLength}.");
+            }
+
+            return Context.ActorOf(FpgaFramingActor.GetProps(config.Delimiter, packetLength, config.MaxBufferedPackets, assembler, config.ChunkPackets));
         }
 
         private IActorRef CreateAssemblerChild(IFpgaAssemblerConfig config)
         {
-            return Context.ActorOf(FpgaSampleAssemblerActor.GetProps(config.ChannelList, config.SamplesPerPacket, config.OutputTarget));
+            return Context.ActorOf(FpgaSampleAssemblerActor.GetProps(config.ChannelList, config.SamplesPerPacket, config.OutputTarget, config.RecordingPath, config.Arrivals));
         }
 
         public static Props GetProps() => Props.Create(() => new FpgaAcquisitionPluginActor());
@@ -6,11 +6,17 @@ using Serilog;
 
 namespace AkkaLibrary
 {
+    /// <summary>
+    /// Reads the FPGA socket in pull mode. Each segment is forwarded to the
+    /// output target and the next read is only issued once the target replies
+    /// with <see cref="FpgaPluginMessages.ReadMore"/>.
+    /// </summary>
     public class FpgaConnectionActor : ReceiveActor
     {
         private readonly EndPoint _endPoint;
         private IActorRef _outputTarget;
         private TimeSpan _retryConnectionTimeout;
+        private IActorRef _connection;
 
         public FpgaConnectionActor(EndPoint endPoint, TimeSpan retryConnectionTimeout, IActorRef outputTarget)
         {
@@ -21,7 +27,7 @@ namespace AkkaLibrary
 
             Ready();
 
-            Context.System.Tcp().Tell(new Tcp.Connect(_endPoint));
+            Connect();
         }
 
         public static Props GetProps(EndPoint endPoint, TimeSpan timeout, IActorRef outputTarget) => Props.Create(() => new FpgaConnectionActor(endPoint, timeout, outputTarget));
@@ -31,26 +37,33 @@ namespace AkkaLibrary
             Receive<Tcp.Connected>(msg =>
             {
                 Log.Information($"Connected to {msg.RemoteAddress} from {msg.LocalAddress}. Registering.");
-                Sender.Tell(new Tcp.Register(Self, true));
+                _connection = Sender;
+                _outputTarget.Tell(FpgaPluginMessages.Connected.Instance);
+                _connection.Tell(new Tcp.Register(Self, true));
+                _connection.Tell(Tcp.ResumeReading.Instance);
             });
 
             Receive<Tcp.CommandFailed>(msg =>
             {
                 Log.Error($"Connection failed to open on {_endPoint} with {msg.Cmd}");
-                Context.System.Scheduler.ScheduleTellOnce(_retryConnectionTimeout, Context.System.Tcp(), new Tcp.Connect(_endPoint), Self);
+                ScheduleConnect();
             });
 
             Receive<Tcp.Received>(msg =>
             {
-                var received = msg.Data;
-                _outputTarget.Tell(received);
-                Log.Debug($"TCP Message received:{msg.Data}");
+                _outputTarget.Tell(msg.Data);
             });
 
-            Receive<Tcp.PeerClosed>(msg =>
+            Receive<FpgaPluginMessages.ReadMore>(msg =>
             {
-                Log.Information($"Remote connection closed on {_endPoint}. Retrying connection.");
-                Context.System.Scheduler.ScheduleTellOnce(_retryConnectionTimeout, Context.System.Tcp(), new Tcp.Connect(_endPoint), Self);
+                _connection?.Tell(Tcp.ResumeReading.Instance);
+            });
+
+            Receive<Tcp.ConnectionClosed>(msg =>
+            {
+                Log.Information($"Connection closed on {_endPoint} with {msg}. Retrying connection.");
+                _connection = null;
+                ScheduleConnect();
             });
 
             ReceiveAny(msg =>
@@ -58,5 +71,11 @@ namespace AkkaLibrary
                 Log.Information($"Received msg:{msg}");
             });
         }
+
+        private Tcp.Connect CreateConnect() => new Tcp.Connect(_endPoint, pullMode: true);
+
+        private void Connect() => Context.System.Tcp().Tell(CreateConnect());
+
+        private void ScheduleConnect() => Context.System.Scheduler.ScheduleTellOnce(_retryConnectionTimeout, Context.System.Tcp(), CreateConnect(), Self);
     }
 }
@@ -0,0 +1,65 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// Wrapper class around the external C++ FPGA packet decoder
+    /// 
+    /// Requires the accompanying fpgadecode cpp library built into
+    /// SharedLibraries/build
+    /// </summary>
+    internal static class FpgaDecodeWrapper
+    {
+        /// <summary>
+        /// Compiles a channel list into a decode plan
+        /// </summary>
+        /// <returns>0 for success, otherwise a fault code</returns>
+        [DllImport("SharedLibraries/build/libfpgadecode.so", EntryPoint = "create_plan")]
+        public static extern int CreatePlan(int[] channelTypes, int channelCount, int samplesPerPacket, out IntPtr plan);
+
+        /// <summary>
+        /// Length in bytes of a single sample
+        /// </summary>
+        [DllImport("SharedLibraries/build/libfpgadecode.so", EntryPoint = "sample_length")]
+        public static extern int SampleLength(IntPtr plan);
+
+        /// <summary>
+        /// Decodes a whole packet into the per-type column arrays
+        /// </summary>
+        /// <returns>0 for success, otherwise a fault code</returns>
+        [DllImport("SharedLibraries/build/libfpgadecode.so", EntryPoint = "decode_packet")]
+        public static extern unsafe int DecodePacket(
+            IntPtr plan,
+            byte* packet,
+            int length,
+            uint[] uint32s,
+            short[] int16s,
+            int[] int24s,
+            int[] int32s,
+            float[] floats,
+            double[] doubles,
+            byte[] bools);
+
+        /// <summary>
+        /// Releases a decode plan
+        /// </summary>
+        /// <returns>0 for success, otherwise a fault code</returns>
+        [DllImport("SharedLibraries/build/libfpgadecode.so", EntryPoint = "destroy_plan")]
+        public static extern int DestroyPlan(IntPtr plan);
+
+        /// <summary>
+        /// Converts packed 24-bit values into sign-extended 32-bit integers
+        /// </summary>
+        /// <returns>0 for success, otherwise a fault code</returns>
+        [DllImport("SharedLibraries/build/libfpgadecode.so", EntryPoint = "int24_to_int32")]
+        public static extern unsafe int Int24ToInt32(byte* source, int* destination, int count);
+
+        /// <summary>
+        /// Converts packed 24-bit values into scaled floats
+        /// </summary>
+        /// <returns>0 for success, otherwise a fault code</returns>
+        [DllImport("SharedLibraries/build/libfpgadecode.so", EntryPoint = "int24_to_float")]
+        public static extern unsafe int Int24ToFloat(byte* source, float* destination, int count, float scale);
+    }
+}
@@ -0,0 +1,113 @@
+using System;
+using System.Collections.Generic;
+using Akka.Actor;
+using Akka.IO;
+using AkkaLibrary.Common.Metrics;
+using Serilog;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// Frames raw TCP segments into whole packets for the sample assembler
+    ///
+    /// Packets are sent on as slices of pooled memory. Reads are acknowledged
+    /// with <see cref="FpgaPluginMessages.ReadMore"/> only while fewer than
+    /// maxBufferedPackets are waiting to be decoded, so a slow assembler holds
+    /// back the socket instead of filling a queue. A partial packet left by a
+    /// closed connection is dropped when the next one is made.
+    /// </summary>
+    public class FpgaFramingActor : ReceiveActor
+    {
+        /// <param name="chunkPackets">Packets held by each pooled chunk</param>
+        /// <param name="name">Prefix of the published metric names. Defaults to one unique to this actor.</param>
+        public FpgaFramingActor(ByteString delimiter, int packetLength, int maxBufferedPackets, IActorRef sampleAssembler, int chunkPackets = 64, string name = null)
+        {
+            name = name ?? MetricsRegistry.InstanceName("FpgaFraming");
+            _inFlightGauge = MetricsRegistry.Default.Gauge($"{name}.InFlight");
+            _discarded = MetricsRegistry.Default.Counter($"{name}.DiscardedBytes");
+
+            _sampleAssembler = sampleAssembler;
+            _maxBufferedPackets = maxBufferedPackets;
+            _framer = new FpgaPacketFramer(delimiter, packetLength, chunkPackets);
+
+            Working();
+        }
+
+        private void Working()
+        {
+            Receive<ByteString>(msg =>
+            {
+                var received = DateTime.UtcNow.Ticks;
+                _reader = Sender;
+                _framer.Write(msg);
+
+                var packets = new List<PooledPacket>();
+                while(_framer.TryRead(out var packet))
+                {
+                    packets.Add(packet);
+                }
+
+                if(packets.Count > 0)
+                {
+                    _inFlight += packets.Count;
+                    _inFlightGauge.Add(packets.Count);
+                    _sampleAssembler.Tell(new FpgaPluginMessages.Packets(packets, received));
+                }
+
+                if(_framer.DiscardedBytes != _lastDiscarded)
+                {
+                    Log.Warning("FPGA framing actor lost sync. Total bytes discarded:{0}", _framer.DiscardedBytes);
+                    _discarded.Add(_framer.DiscardedBytes - _lastDiscarded);
+                    _lastDiscarded = _framer.DiscardedBytes;
+                }
+
+                _readPending = true;
+                RequestRead();
+            });
+
+            Receive<FpgaPluginMessages.Connected>(msg =>
+            {
+                _framer.Reset();
+                _lastDiscarded = _framer.DiscardedBytes;
+                _readPending = false;
+            });
+
+            Receive<FpgaPluginMessages.PacketsDecoded>(msg =>
+            {
+                _inFlight -= msg.Count;
+                _inFlightGauge.Add(-msg.Count);
+                RequestRead();
+            });
+        }
+
+        private void RequestRead()
+        {
+            if(_readPending && _inFlight < _maxBufferedPackets)
+            {
+                _readPending = false;
+                _reader.Tell(FpgaPluginMessages.ReadMore.Instance);
+            }
+        }
+
+        protected override void PostStop()
+        {
+            _framer.Dispose();
+            _inFlightGauge.Add(-_inFlight);
+            base.PostStop();
+        }
+
+        public static Props GetProps(ByteString delimiter, int packetLength, int maxBufferedPackets, IActorRef sampleAssembler, int chunkPackets = 64, string name = null)
+                                => Props.Create(() => new FpgaFramingActor(delimiter, packetLength, maxBufferedPackets, sampleAssembler, chunkPackets, name));
+
+        private readonly IActorRef _sampleAssembler;
+        private readonly int _maxBufferedPackets;
+        private readonly FpgaPacketFramer _framer;
+        private IActorRef _reader;
+        private int _inFlight;
+        private bool _readPending;
+        private long _lastDiscarded;
+
+        private readonly Gauge _inFlightGauge;
+        private readonly Counter _discarded;
+    }
+}
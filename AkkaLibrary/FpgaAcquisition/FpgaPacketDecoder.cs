@@ -0,0 +1,285 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using AkkaLibrary.Common.Utilities;
+using Serilog;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// Decodes whole FPGA packets into preallocated per-type columns
+    /// 
+    /// The channel list is compiled once into a decode plan. Each column holds
+    /// <see cref="SamplesPerPacket"/> values and columns of the same type are
+    /// stored back to back in channel list order, so the value of the c-th
+    /// channel of a type for sample s is at [c * SamplesPerPacket + s].
+    /// 
+    /// Decoding uses libfpgadecode when it is available and otherwise falls
+    /// back to an equivalent managed decoder. Columns are overwritten by each
+    /// call to <see cref="Decode"/> so a decoder must not be shared between
+    /// threads.
+    /// </summary>
+    public sealed class FpgaPacketDecoder : IDisposable
+    {
+        private readonly IReadOnlyList<FpgaChannel> _channels;
+        private readonly (ChannelType type, int offset, int column)[] _steps;
+        private readonly int _digitalOffset;
+        private readonly int[] _int24Rows;
+        private IntPtr _plan;
+
+        public int SamplesPerPacket { get; }
+        public int SampleLength { get; }
+        public int PacketLength => SampleLength * SamplesPerPacket;
+
+        /// <summary>
+        /// True when packets are decoded by libfpgadecode
+        /// </summary>
+        public bool IsNative => _plan != IntPtr.Zero;
+
+        #region Columns
+
+        public uint[] UInt32s { get; }
+        public short[] Int16s { get; }
+        public int[] Int24s { get; }
+        public int[] Int32s { get; }
+        public float[] Floats { get; }
+        public double[] Doubles { get; }
+        public byte[] Bools { get; }
+
+        public IReadOnlyList<string> UInt32Names { get; }
+        public IReadOnlyList<string> Int16Names { get; }
+        public IReadOnlyList<string> Int24Names { get; }
+        public IReadOnlyList<string> Int32Names { get; }
+        public IReadOnlyList<string> FloatNames { get; }
+        public IReadOnlyList<string> DoubleNames { get; }
+        public IReadOnlyList<string> BoolNames { get; }
+
+        #endregion
+
+        public FpgaPacketDecoder(IEnumerable<FpgaChannel> channels, int samplesPerPacket, bool preferNative = true)
+        {
+            if(samplesPerPacket <= 0)
+            {
+                throw new ArgumentException("Samples per packet must be positive.", nameof(samplesPerPacket));
+            }
+
+            _channels = channels.ToArray();
+            SamplesPerPacket = samplesPerPacket;
+
+            UInt32Names = NamesOf(ChannelType.UInt32);
+            Int16Names = NamesOf(ChannelType.Int16);
+            Int24Names = NamesOf(ChannelType.Int24);
+            Int32Names = NamesOf(ChannelType.Int32);
+            FloatNames = NamesOf(ChannelType.Float);
+            DoubleNames = NamesOf(ChannelType.Double);
+            BoolNames = NamesOf(ChannelType.Bool);
+
+            UInt32s = new uint[UInt32Names.Count * samplesPerPacket];
+            Int16s = new short[Int16Names.Count * samplesPerPacket];
+            Int24s = new int[Int24Names.Count * samplesPerPacket];
+            Int32s = new int[Int32Names.Count * samplesPerPacket];
+            Floats = new float[FloatNames.Count * samplesPerPacket];
+            Doubles = new double[DoubleNames.Count * samplesPerPacket];
+            Bools = new byte[BoolNames.Count * samplesPerPacket];
+
+            // Build the managed plan. Digitals are packed after the analogs.
+            var steps = new List<(ChannelType type, int offset, int column)>();
+            var columnCounts = new Dictionary<ChannelType, int>();
+            var offset = 0;
+            foreach (var channel in _channels)
+            {
+                if(channel.DataType == ChannelType.Bool)
+                {
+                    continue;
+                }
+
+                var size = SizeOf(channel.DataType);
+                columnCounts.TryGetValue(channel.DataType, out var column);
+                columnCounts[channel.DataType] = column + 1;
+                steps.Add((channel.DataType, offset, column));
+                offset += size;
+            }
+
+            _steps = steps.ToArray();
+            _digitalOffset = offset;
+            SampleLength = offset + (BoolNames.Count + 7) / 8;
+
+            // A packet of only Int24 channels is one contiguous 24-bit buffer
+            if(BoolNames.Count == 0 && _steps.Length > 0 && _steps.All(x => x.type == ChannelType.Int24))
+            {
+                _int24Rows = new int[_steps.Length * samplesPerPacket];
+            }
+
+            if(preferNative)
+            {
+                _plan = TryCreateNativePlan();
+            }
+        }
+
+        /// <summary>
+        /// Decodes a packet of <see cref="PacketLength"/> bytes starting at
+        /// <paramref name="offset"/> into the columns
+        /// </summary>
+        public unsafe void Decode(byte[] packet, int offset)
+        {
+            if(packet.Length - offset < PacketLength)
+            {
+                throw new ArgumentException($"Packet holds {packet.Length - offset} bytes. Expected {PacketLength}.", nameof(packet));
+            }
+
+            if(IsNative)
+            {
+                fixed(byte* start = packet)
+                {
+                    var result = FpgaDecodeWrapper.DecodePacket(_plan, start + offset, packet.Length - offset,
+                                    UInt32s, Int16s, Int24s, Int32s, Floats, Doubles, Bools);
+                    if(result != 0)
+                    {
+                        throw new InvalidOperationException($"libfpgadecode failed to decode a packet with code {result}.");
+                    }
+                }
+                return;
+            }
+
+            DecodeManaged(packet, offset);
+        }
+
+        private void DecodeManaged(byte[] packet, int offset)
+        {
+            var n = SamplesPerPacket;
+            var stride = SampleLength;
+
+            if(_int24Rows != null)
+            {
+                DecodeInt24Rows(packet, offset);
+                return;
+            }
+
+            foreach (var (type, channelOffset, column) in _steps)
+            {
+                var index = offset + channelOffset;
+                var baseIndex = column * n;
+
+                switch (type)
+                {
+                    case ChannelType.UInt32:
+                        for (int s = 0; s < n; s++, index += stride) UInt32s[baseIndex + s] = BitConverter.ToUInt32(packet, index);
+                        break;
+                    case ChannelType.Int16:
+                        for (int s = 0; s < n; s++, index += stride) Int16s[baseIndex + s] = BitConverter.ToInt16(packet, index);
+                        break;
+                    case ChannelType.Int24:
+                        for (int s = 0; s < n; s++, index += stride)
+                        {
+                            Int24s[baseIndex + s] = (packet[index] << 8 | packet[index + 1] << 16 | packet[index + 2] << 24) >> 8;
+                        }
+                        break;
+                    case ChannelType.Int32:
+                        for (int s = 0; s < n; s++, index += stride) Int32s[baseIndex + s] = BitConverter.ToInt32(packet, index);
+                        break;
+                    case ChannelType.Float:
+                        for (int s = 0; s < n; s++, index += stride) Floats[baseIndex + s] = BitConverter.ToSingle(packet, index);
+                        break;
+                    case ChannelType.Double:
+                        for (int s = 0; s < n; s++, index += stride) Doubles[baseIndex + s] = BitConverter.ToDouble(packet, index);
+                        break;
+                }
+            }
+
+            // Unpack the digitals least significant bit first
+            for (int d = 0; d < BoolNames.Count; d++)
+            {
+                var index = offset + _digitalOffset + (d >> 3);
+                var mask = 1 << (d & 7);
+                var baseIndex = d * n;
+
+                for (int s = 0; s < n; s++, index += stride)
+                {
+                    Bools[baseIndex + s] = (byte)((packet[index] & mask) != 0 ? 1 : 0);
+                }
+            }
+        }
+
+        private void DecodeInt24Rows(byte[] packet, int offset)
+        {
+            var n = SamplesPerPacket;
+            var channels = _steps.Length;
+            Int24Converter.ToInt32(new ReadOnlySpan<byte>(packet, offset, PacketLength), _int24Rows);
+
+            for (int c = 0; c < channels; c++)
+            {
+                var baseIndex = c * n;
+                for (int s = 0, row = c; s < n; s++, row += channels)
+                {
+                    Int24s[baseIndex + s] = _int24Rows[row];
+                }
+            }
+        }
+
+        private IntPtr TryCreateNativePlan()
+        {
+            var types = _channels.Select(x => (int)x.DataType).ToArray();
+            try
+            {
+                var result = FpgaDecodeWrapper.CreatePlan(types, types.Length, SamplesPerPacket, out var plan);
+                if(result != 0)
+                {
+                    Log.Warning("libfpgadecode could not create a plan. Code:{Code}. Using the managed decoder.", result);
+                    return IntPtr.Zero;
+                }
+
+                if(FpgaDecodeWrapper.SampleLength(plan) != SampleLength)
+                {
+                    Log.Warning("libfpgadecode sample length does not match. Using the managed decoder.");
+                    FpgaDecodeWrapper.DestroyPlan(plan);
+                    return IntPtr.Zero;
+                }
+
+                return plan;
+            }
+            catch (Exception e) when (e is DllNotFoundException || e is EntryPointNotFoundException || e is BadImageFormatException)
+            {
+                Log.Information("libfpgadecode not available ({Reason}). Using the managed decoder.", e.Message);
+                return IntPtr.Zero;
+            }
+        }
+
+        private IReadOnlyList<string> NamesOf(ChannelType type)
+            => _channels.Where(x => x.DataType == type).Select(x => x.ChannelName).ToArray();
+
+        /// <summary>
+        /// Length in bytes of a packet for the channel list without building a decoder
+        /// </summary>
+        public static int GetPacketLength(IEnumerable<FpgaChannel> channels, int samplesPerPacket)
+        {
+            var list = channels.ToArray();
+            var analogs = list.Where(x => x.DataType != ChannelType.Bool).Sum(x => SizeOf(x.DataType));
+            var digitals = list.Count(x => x.DataType == ChannelType.Bool);
+            return (analogs + (digitals + 7) / 8) * samplesPerPacket;
+        }
+
+        private static int SizeOf(ChannelType type)
+        {
+            switch (type)
+            {
+                case ChannelType.UInt32: return 4;
+                case ChannelType.Int16: return 2;
+                case ChannelType.Int24: return 3;
+                case ChannelType.Int32: return 4;
+                case ChannelType.Float: return 4;
+                case ChannelType.Double: return 8;
+                default:
+                    throw new ArgumentException($"Channel type {type} cannot be decoded.");
+            }
+        }
+
+        public void Dispose()
+        {
+            if(_plan != IntPtr.Zero)
+            {
+                FpgaDecodeWrapper.DestroyPlan(_plan);
+                _plan = IntPtr.Zero;
+            }
+        }
+    }
+}
@@ -0,0 +1,165 @@
+using System;
+using System.Buffers;
+using Akka.IO;
+using AkkaLibrary.IOReceiveHandlers;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// Reassembles delimited FPGA packets from TCP segments into pooled memory
+    ///
+    /// Each packet on the wire is the delimiter followed by exactly
+    /// <see cref="PacketLength"/> bytes. Segments are copied once into a chunk
+    /// rented from an <see cref="ArrayPool{T}"/> and whole packets are handed
+    /// out as <see cref="PooledPacket"/> slices over that chunk, so a packet
+    /// split across any number of segments is decoded in place. When a chunk
+    /// fills, the unread tail moves to a fresh chunk and the old one returns
+    /// to the pool once every packet read from it has been disposed.
+    ///
+    /// Bytes that do not start with the delimiter are skipped up to the next
+    /// delimiter and counted in <see cref="DiscardedBytes"/>. A framer is
+    /// owned by a single actor; packets may be disposed from any thread.
+    /// </summary>
+    public sealed class FpgaPacketFramer : IDisposable
+    {
+        private readonly byte[] _delimiter;
+        private readonly int _stride;
+        private readonly int _chunkLength;
+        private readonly ArrayPool<byte> _pool;
+
+        private PooledChunk _chunk;
+        private int _read;
+        private int _write;
+
+        public int PacketLength { get; }
+
+        /// <summary>
+        /// Bytes received but not yet returned as packets
+        /// </summary>
+        public int BufferedBytes => _write - _read;
+
+        /// <summary>
+        /// Bytes skipped while looking for a delimiter
+        /// </summary>
+        public long DiscardedBytes { get; private set; }
+
+        /// <param name="delimiter">Bytes preceding every packet</param>
+        /// <param name="packetLength">Length of a packet after the delimiter</param>
+        /// <param name="chunkPackets">Number of packets held by each pooled chunk</param>
+        /// <param name="pool">Pool to rent chunks from. Defaults to the shared pool.</param>
+        public FpgaPacketFramer(ByteString delimiter, int packetLength, int chunkPackets = 64, ArrayPool<byte> pool = null)
+        {
+            if(packetLength <= 0)
+            {
+                throw new ArgumentException("Packet length must be positive.", nameof(packetLength));
+            }
+            if(chunkPackets < 2)
+            {
+                throw new ArgumentException("A chunk must hold at least two packets.", nameof(chunkPackets));
+            }
+
+            _delimiter = delimiter?.ToArray() ?? new byte[0];
+            PacketLength = packetLength;
+            _stride = _delimiter.Length + packetLength;
+            _chunkLength = _stride * chunkPackets;
+            _pool = pool ?? ArrayPool<byte>.Shared;
+
+            _chunk = new PooledChunk(_pool, _chunkLength);
+        }
+
+        /// <summary>
+        /// Appends a received segment
+        /// </summary>
+        public void Write(ByteString data)
+        {
+            var copied = 0;
+            while(copied < data.Count)
+            {
+                if(_write == _chunk.Buffer.Length)
+                {
+                    Compact(data.Count - copied);
+                }
+
+                var count = Math.Min(_chunk.Buffer.Length - _write, data.Count - copied);
+                data.Slice(copied, count).CopyTo(_chunk.Buffer, _write, count);
+                _write += count;
+                copied += count;
+            }
+        }
+
+        /// <summary>
+        /// Drops the buffered bytes, counting them as discarded, so the next
+        /// write starts a new stream. Packets already read stay valid.
+        /// </summary>
+        public void Reset()
+        {
+            DiscardedBytes += BufferedBytes;
+            _read = _write;
+        }
+
+        /// <summary>
+        /// Takes the next whole packet if one has been received. The packet
+        /// must be disposed once decoded to release its chunk.
+        /// </summary>
+        public bool TryRead(out PooledPacket packet)
+        {
+            packet = null;
+
+            if(!Synchronise() || BufferedBytes < _stride)
+            {
+                return false;
+            }
+
+            packet = new PooledPacket(_chunk, _read + _delimiter.Length, PacketLength);
+            _read += _stride;
+            return true;
+        }
+
+        /// <summary>
+        /// Moves the read position to the next delimiter. Returns false when
+        /// more data is needed to find one.
+        /// </summary>
+        private bool Synchronise()
+        {
+            if(BufferedBytes < _delimiter.Length)
+            {
+                return false;
+            }
+
+            var skipped = FrameParser.IndexOf(new ReadOnlySpan<byte>(_chunk.Buffer, _read, BufferedBytes), _delimiter);
+            if(skipped < 0)
+            {
+                // Keep a tail that may be the start of a split delimiter
+                skipped = BufferedBytes - _delimiter.Length + 1;
+            }
+
+            _read += skipped;
+            DiscardedBytes += skipped;
+            return BufferedBytes >= _delimiter.Length;
+        }
+
+        /// <summary>
+        /// Moves the unread bytes to a new chunk with room for all
+        /// <paramref name="required"/> more, so a segment larger than a chunk
+        /// is copied once rather than once per chunk it fills
+        /// </summary>
+        private void Compact(int required)
+        {
+            var unread = _write - _read;
+            var next = new PooledChunk(_pool, Math.Max(_chunkLength, unread + required));
+
+            Buffer.BlockCopy(_chunk.Buffer, _read, next.Buffer, 0, unread);
+            _chunk.Release();
+
+            _chunk = next;
+            _read = 0;
+            _write = unread;
+        }
+
+        public void Dispose()
+        {
+            _chunk?.Release();
+            _chunk = null;
+        }
+    }
+}
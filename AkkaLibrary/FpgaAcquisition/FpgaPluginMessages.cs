@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Generic;
 using System.Net;
 
 namespace AkkaLibrary
@@ -10,6 +11,78 @@ namespace AkkaLibrary
             
         }
 
+        /// <summary>
+        /// Sent to the framing actor when a connection is made. Bytes buffered
+        /// from an earlier connection are dropped.
+        /// </summary>
+        public sealed class Connected
+        {
+            public static Connected Instance { get; } = new Connected();
+
+            private Connected() { }
+        }
+
+        /// <summary>
+        /// Sent to the connection when the framing actor has room for another read
+        /// </summary>
+        public sealed class ReadMore
+        {
+            public static ReadMore Instance { get; } = new ReadMore();
+
+            private ReadMore() { }
+        }
+
+        /// <summary>
+        /// Whole packets in pooled memory. The receiver disposes each packet
+        /// and replies with <see cref="PacketsDecoded"/>.
+        /// </summary>
+        public sealed class Packets
+        {
+            public IReadOnlyList<PooledPacket> Items { get; }
+
+            /// <summary>
+            /// Sample index of the first sample in the batch, or zero to
+            /// continue from the previous batch
+            /// </summary>
+            public long FirstSampleIndex { get; }
+
+            /// <summary>
+            /// UTC time in ticks the bytes completing the batch were received,
+            /// or the recorded time of a replayed batch
+            /// </summary>
+            public long ReceivedAt { get; }
+
+            public Packets(IReadOnlyList<PooledPacket> items, long receivedAt, long firstSampleIndex = 0)
+            {
+                Items = items;
+                ReceivedAt = receivedAt;
+                FirstSampleIndex = firstSampleIndex;
+            }
+        }
+
+        /// <summary>
+        /// Moves a replay to the packet holding the sample index
+        /// </summary>
+        public sealed class Seek
+        {
+            public long SampleIndex { get; }
+
+            public Seek(long sampleIndex)
+            {
+                SampleIndex = sampleIndex;
+            }
+        }
+
+        public sealed class PacketsDecoded
+        {
+            public int Count { get; }
+
+            public PacketsDecoded(int count)
+            {
+                Count = count;
+            }
+        }
+
         public sealed class Configure
         {
             public FpgaAcquisitionConfiguration Configuration { get; }
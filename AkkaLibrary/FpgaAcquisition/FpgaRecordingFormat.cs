@@ -0,0 +1,153 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Linq;
+using System.Text;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// On-disk layout of an FPGA recording
+    ///
+    /// A recording at path P is made of:
+    ///  - P, the header: channel list, samples per packet, packet length,
+    ///    packets per segment and index interval
+    ///  - P.000000, P.000001 ... memory-mapped segments of fixed capacity, each
+    ///    a <see cref="SegmentHeaderLength"/> byte header holding the number of
+    ///    packets written followed by the raw packets back to back
+    ///  - P.idx, a sparse index with the first sample index and the receive
+    ///    time in ticks of every <see cref="Header.IndexInterval"/>-th packet
+    ///
+    /// Packets have a fixed length so packet n lives in segment
+    /// n / PacketsPerSegment at a computed offset.
+    /// </summary>
+    public static class FpgaRecordingFormat
+    {
+        public const int SegmentHeaderLength = 64;
+        public const int IndexEntryLength = 16;
+
+        private const string Magic = "FPGAREC";
+        private const int Version = 1;
+
+        public static string SegmentPath(string path, int segment) => $"{path}.{segment:D6}";
+
+        public static string IndexPath(string path) => $"{path}.idx";
+
+        public sealed class Header
+        {
+            public IReadOnlyList<FpgaChannel> Channels { get; }
+            public int SamplesPerPacket { get; }
+            public int PacketLength { get; }
+            public int PacketsPerSegment { get; }
+            public int IndexInterval { get; }
+
+            public Header(IEnumerable<FpgaChannel> channels, int samplesPerPacket, int packetsPerSegment, int indexInterval)
+            {
+                if(packetsPerSegment <= 0)
+                {
+                    throw new ArgumentException("Packets per segment must be positive.", nameof(packetsPerSegment));
+                }
+                if(indexInterval <= 0)
+                {
+                    throw new ArgumentException("Index interval must be positive.", nameof(indexInterval));
+                }
+
+                Channels = channels.ToArray();
+                SamplesPerPacket = samplesPerPacket;
+                PacketLength = FpgaPacketDecoder.GetPacketLength(Channels, samplesPerPacket);
+                PacketsPerSegment = packetsPerSegment;
+                IndexInterval = indexInterval;
+            }
+
+            public void Write(string path)
+            {
+                using (var writer = new BinaryWriter(File.Create(path), Encoding.UTF8))
+                {
+                    writer.Write(Magic);
+                    writer.Write(Version);
+                    writer.Write(SamplesPerPacket);
+                    writer.Write(PacketsPerSegment);
+                    writer.Write(IndexInterval);
+                    writer.Write(Channels.Count);
+                    foreach (var channel in Channels)
+                    {
+                        writer.Write(channel.ChannelName);
+                        writer.Write((int)channel.DataType);
+                    }
+                }
+            }
+
+            public static Header Read(string path)
+            {
+                using (var reader = new BinaryReader(File.OpenRead(path), Encoding.UTF8))
+                {
+                    if(reader.ReadString() != Magic || reader.ReadInt32() != Version)
+                    {
+                        throw new InvalidDataException($"{path} is not a version {Version} FPGA recording.");
+                    }
+
+                    var samplesPerPacket = reader.ReadInt32();
+                    var packetsPerSegment = reader.ReadInt32();
+                    var indexInterval = reader.ReadInt32();
+                    var channels = Enumerable.Range(0, reader.ReadInt32())
+                                             .Select(_ => new FpgaChannel(reader.ReadString(), (ChannelType)reader.ReadInt32()))
+                                             .ToList();
+
+                    return new Header(channels, samplesPerPacket, packetsPerSegment, indexInterval);
+                }
+            }
+        }
+
+        /// <summary>
+        /// One memory-mapped segment file
+        /// </summary>
+        internal sealed unsafe class Segment : IDisposable
+        {
+            private readonly MemoryMappedFile _file;
+            private readonly MemoryMappedViewAccessor _view;
+            private readonly byte* _base;
+
+            /// <summary>
+            /// First byte of the packet data
+            /// </summary>
+            public byte* Data => _base + SegmentHeaderLength;
+
+            public long PacketCount
+            {
+                get => *(long*)_base;
+                set => *(long*)_base = value;
+            }
+
+            private Segment(MemoryMappedFile file, MemoryMappedViewAccessor view)
+            {
+                _file = file;
+                _view = view;
+
+                byte* pointer = null;
+                _view.SafeMemoryMappedViewHandle.AcquirePointer(ref pointer);
+                _base = pointer + _view.PointerOffset;
+            }
+
+            public static Segment Create(string path, int packetLength, int packetsPerSegment)
+            {
+                var capacity = SegmentHeaderLength + (long)packetLength * packetsPerSegment;
+                var file = MemoryMappedFile.CreateFromFile(path, FileMode.CreateNew, null, capacity, MemoryMappedFileAccess.ReadWrite);
+                return new Segment(file, file.CreateViewAccessor(0, capacity, MemoryMappedFileAccess.ReadWrite));
+            }
+
+            public static Segment Open(string path)
+            {
+                var file = MemoryMappedFile.CreateFromFile(path, FileMode.Open, null, 0, MemoryMappedFileAccess.Read);
+                return new Segment(file, file.CreateViewAccessor(0, 0, MemoryMappedFileAccess.Read));
+            }
+
+            public void Dispose()
+            {
+                _view.SafeMemoryMappedViewHandle.ReleasePointer();
+                _view.Dispose();
+                _file.Dispose();
+            }
+        }
+    }
+}
@@ -0,0 +1,124 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Runtime.InteropServices;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// Random access to the packets of a <see cref="FpgaRecordingFormat"/> recording
+    ///
+    /// Every segment is mapped read-only when the recording is opened. Finding
+    /// a packet by number or by sample index is O(1); receive times between
+    /// index entries are interpolated, and those after the last entry are
+    /// extrapolated at the pace of the last interval.
+    /// </summary>
+    public sealed class FpgaRecordingReader : IDisposable
+    {
+        private readonly List<FpgaRecordingFormat.Segment> _segments = new List<FpgaRecordingFormat.Segment>();
+        private readonly long[] _indexSamples;
+        private readonly long[] _indexTimes;
+
+        public FpgaRecordingFormat.Header Header { get; }
+
+        public long PacketCount { get; }
+
+        public FpgaRecordingReader(string path)
+        {
+            Header = FpgaRecordingFormat.Header.Read(path);
+
+            for (int n = 0; File.Exists(FpgaRecordingFormat.SegmentPath(path, n)); n++)
+            {
+                var segment = FpgaRecordingFormat.Segment.Open(FpgaRecordingFormat.SegmentPath(path, n));
+                _segments.Add(segment);
+                PacketCount += segment.PacketCount;
+
+                // Only the last segment can be partly filled
+                if(segment.PacketCount < Header.PacketsPerSegment)
+                {
+                    break;
+                }
+            }
+
+            var index = File.ReadAllBytes(FpgaRecordingFormat.IndexPath(path));
+            var entries = index.Length / FpgaRecordingFormat.IndexEntryLength;
+            _indexSamples = new long[entries];
+            _indexTimes = new long[entries];
+            for (int i = 0; i < entries; i++)
+            {
+                _indexSamples[i] = BitConverter.ToInt64(index, i * FpgaRecordingFormat.IndexEntryLength);
+                _indexTimes[i] = BitConverter.ToInt64(index, i * FpgaRecordingFormat.IndexEntryLength + 8);
+            }
+        }
+
+        /// <summary>
+        /// Copies packet <paramref name="packet"/> into <paramref name="destination"/>
+        /// </summary>
+        public unsafe void ReadPacket(long packet, byte[] destination, int offset)
+        {
+            if(packet < 0 || packet >= PacketCount)
+            {
+                throw new ArgumentOutOfRangeException(nameof(packet));
+            }
+
+            var segment = _segments[(int)(packet / Header.PacketsPerSegment)];
+            var inSegment = packet % Header.PacketsPerSegment;
+            Marshal.Copy((IntPtr)(segment.Data + inSegment * Header.PacketLength), destination, offset, Header.PacketLength);
+        }
+
+        /// <summary>
+        /// Sample index of the first sample in <paramref name="packet"/>
+        /// </summary>
+        public long SampleIndexOf(long packet)
+        {
+            if(_indexSamples.Length == 0)
+            {
+                return packet * Header.SamplesPerPacket + 1;
+            }
+
+            var entry = EntryOf(packet);
+            return _indexSamples[entry] + (packet - (long)entry * Header.IndexInterval) * Header.SamplesPerPacket;
+        }
+
+        /// <summary>
+        /// The packet holding <paramref name="sampleIndex"/>, clamped to the recording
+        /// </summary>
+        public long PacketOf(long sampleIndex)
+        {
+            var packet = (sampleIndex - SampleIndexOf(0)) / Header.SamplesPerPacket;
+            return Math.Max(0, Math.Min(PacketCount - 1, packet));
+        }
+
+        /// <summary>
+        /// Receive time of <paramref name="packet"/> in ticks
+        /// </summary>
+        public long TimestampOf(long packet)
+        {
+            if(_indexTimes.Length == 0)
+            {
+                return 0;
+            }
+
+            var entry = EntryOf(packet);
+            var start = _indexTimes[entry];
+
+            // Past the last entry the pace of the interval before it continues
+            var next = entry + 1 < _indexTimes.Length ? entry + 1 : entry;
+            if(next == 0)
+            {
+                return start;
+            }
+
+            var fraction = (double)(packet - (long)entry * Header.IndexInterval) / Header.IndexInterval;
+            return start + (long)((_indexTimes[next] - _indexTimes[next - 1]) * fraction);
+        }
+
+        private int EntryOf(long packet) => (int)Math.Min(packet / Header.IndexInterval, _indexSamples.Length - 1);
+
+        public void Dispose()
+        {
+            _segments.ForEach(x => x.Dispose());
+            _segments.Clear();
+        }
+    }
+}
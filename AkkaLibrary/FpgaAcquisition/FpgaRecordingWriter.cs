@@ -0,0 +1,82 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Runtime.InteropServices;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// Appends raw FPGA packets to a <see cref="FpgaRecordingFormat"/> recording
+    ///
+    /// Packets are copied straight into the mapped segment and the segment's
+    /// packet count is updated after each one, and index entries are flushed
+    /// as they are written, so a recording cut short by a crash is readable up
+    /// to the last whole packet.
+    /// </summary>
+    public sealed class FpgaRecordingWriter : IDisposable
+    {
+        private readonly string _path;
+        private readonly FpgaRecordingFormat.Header _header;
+        private readonly BinaryWriter _index;
+        private FpgaRecordingFormat.Segment _segment;
+        private int _segmentNumber = -1;
+
+        public long PacketCount { get; private set; }
+
+        public FpgaRecordingWriter(string path, IEnumerable<FpgaChannel> channels, int samplesPerPacket, int packetsPerSegment = 4096, int indexInterval = 64)
+        {
+            _path = path;
+            _header = new FpgaRecordingFormat.Header(channels, samplesPerPacket, packetsPerSegment, indexInterval);
+
+            // Segments of an earlier recording at the same path would be read as ours
+            for (int n = 0; File.Exists(FpgaRecordingFormat.SegmentPath(path, n)); n++)
+            {
+                File.Delete(FpgaRecordingFormat.SegmentPath(path, n));
+            }
+
+            _header.Write(path);
+            _index = new BinaryWriter(File.Create(FpgaRecordingFormat.IndexPath(path)));
+        }
+
+        /// <summary>
+        /// Appends one packet of <see cref="FpgaRecordingFormat.Header.PacketLength"/> bytes
+        /// </summary>
+        /// <param name="packet">Buffer holding the packet</param>
+        /// <param name="offset">Start of the packet in the buffer</param>
+        /// <param name="firstSampleIndex">Sample index of the first sample in the packet</param>
+        /// <param name="timestamp">Receive time of the packet in ticks</param>
+        public unsafe void Append(byte[] packet, int offset, long firstSampleIndex, long timestamp)
+        {
+            var packetLength = _header.PacketLength;
+            if(packet.Length - offset < packetLength)
+            {
+                throw new ArgumentException($"Packet must hold {packetLength} bytes.", nameof(packet));
+            }
+
+            var inSegment = (int)(PacketCount % _header.PacketsPerSegment);
+            if(inSegment == 0)
+            {
+                _segment?.Dispose();
+                _segment = FpgaRecordingFormat.Segment.Create(FpgaRecordingFormat.SegmentPath(_path, ++_segmentNumber), packetLength, _header.PacketsPerSegment);
+            }
+
+            Marshal.Copy(packet, offset, (IntPtr)(_segment.Data + (long)inSegment * packetLength), packetLength);
+            _segment.PacketCount = inSegment + 1;
+
+            if(PacketCount % _header.IndexInterval == 0)
+            {
+                _index.Write(firstSampleIndex);
+                _index.Write(timestamp);
+                _index.Flush();
+            }
+
+            PacketCount++;
+        }
+
+        public void Dispose()
+        {
+            _segment?.Dispose();
+            _index.Dispose();
+        }
+    }
+}
@@ -0,0 +1,158 @@
+using System;
+using System.Buffers;
+using System.Collections.Generic;
+using System.Diagnostics;
+using Akka.Actor;
+using Serilog;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// Streams a recording back into a <see cref="FpgaSampleAssemblerActor"/>
+    ///
+    /// Stands in for the connection and framing actors: packets are sent as
+    /// pooled <see cref="FpgaPluginMessages.Packets"/> and no more than
+    /// maxBufferedPackets are left undecoded. With a positive speed packets are
+    /// paced by their recorded receive times divided by the speed, so 1 replays
+    /// in real time and 10 ten times faster. Zero or less replays as fast as
+    /// the assembler decodes.
+    /// </summary>
+    public class FpgaReplayActor : ReceiveActor
+    {
+        public FpgaReplayActor(string path, double speed, IActorRef sampleAssembler, int batchPackets = 16, int maxBufferedPackets = 64)
+        {
+            _reader = new FpgaRecordingReader(path);
+            _speed = speed;
+            _sampleAssembler = sampleAssembler;
+            _batchPackets = batchPackets;
+            _maxBufferedPackets = maxBufferedPackets;
+
+            Replaying();
+        }
+
+        protected override void PreStart()
+        {
+            _clock.Start();
+            Pump();
+        }
+
+        private void Replaying()
+        {
+            Receive<Continue>(msg =>
+            {
+                _continuePending = false;
+                Pump();
+            });
+
+            Receive<FpgaPluginMessages.PacketsDecoded>(msg =>
+            {
+                _inFlight -= msg.Count;
+                Pump();
+            });
+
+            Receive<FpgaPluginMessages.Seek>(msg =>
+            {
+                _packet = _reader.PacketOf(msg.SampleIndex);
+                _originPacket = _packet;
+                _clock.Restart();
+                _completed = false;
+                Pump();
+            });
+        }
+
+        private void Pump()
+        {
+            if(_continuePending || _inFlight >= _maxBufferedPackets)
+            {
+                return;
+            }
+
+            if(_packet >= _reader.PacketCount)
+            {
+                if(!_completed)
+                {
+                    _completed = true;
+                    Log.Information("Replay complete after {0} packets.", _packet);
+                    _sampleAssembler.Tell(new FpgaPluginMessages.StreamComplete());
+                }
+                return;
+            }
+
+            var delay = DelayUntil(_packet);
+            if(delay > TimeSpan.Zero)
+            {
+                _continuePending = true;
+                Context.System.Scheduler.ScheduleTellOnce(delay, Self, Continue.Instance, Self);
+                return;
+            }
+
+            SendBatch();
+
+            _continuePending = true;
+            Self.Tell(Continue.Instance);
+        }
+
+        /// <summary>
+        /// Sends the packets that are due, read from the mapped recording into one pooled chunk
+        /// </summary>
+        private void SendBatch()
+        {
+            var packetLength = _reader.Header.PacketLength;
+            var limit = Math.Min(_batchPackets, _maxBufferedPackets - _inFlight);
+            var chunk = new PooledChunk(ArrayPool<byte>.Shared, limit * packetLength);
+            var packets = new List<PooledPacket>(limit);
+            var firstSampleIndex = _reader.SampleIndexOf(_packet);
+            var receivedAt = _reader.TimestampOf(_packet);
+
+            while(packets.Count < limit && _packet < _reader.PacketCount && (packets.Count == 0 || DelayUntil(_packet) <= TimeSpan.Zero))
+            {
+                var offset = packets.Count * packetLength;
+                _reader.ReadPacket(_packet++, chunk.Buffer, offset);
+                packets.Add(new PooledPacket(chunk, offset, packetLength));
+            }
+
+            // The packets now hold the chunk
+            chunk.Release();
+
+            _inFlight += packets.Count;
+            _sampleAssembler.Tell(new FpgaPluginMessages.Packets(packets, receivedAt, firstSampleIndex));
+        }
+
+        private TimeSpan DelayUntil(long packet)
+        {
+            if(_speed <= 0)
+            {
+                return TimeSpan.Zero;
+            }
+
+            var recorded = _reader.TimestampOf(packet) - _reader.TimestampOf(_originPacket);
+            return TimeSpan.FromTicks((long)(recorded / _speed)) - _clock.Elapsed;
+        }
+
+        protected override void PostStop()
+        {
+            _reader.Dispose();
+            base.PostStop();
+        }
+
+        public static Props GetProps(string path, double speed, IActorRef sampleAssembler, int batchPackets = 16, int maxBufferedPackets = 64)
+                                => Props.Create(() => new FpgaReplayActor(path, speed, sampleAssembler, batchPackets, maxBufferedPackets));
+
+        private sealed class Continue
+        {
+            public static Continue Instance { get; } = new Continue();
+        }
+
+        private readonly FpgaRecordingReader _reader;
+        private readonly double _speed;
+        private readonly IActorRef _sampleAssembler;
+        private readonly int _batchPackets;
+        private readonly int _maxBufferedPackets;
+        private readonly Stopwatch _clock = new Stopwatch();
+        private long _packet;
+        private long _originPacket;
+        private int _inFlight;
+        private bool _continuePending;
+        private bool _completed;
+    }
+}
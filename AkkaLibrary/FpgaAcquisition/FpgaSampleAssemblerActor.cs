@@ -1,197 +1,104 @@
 using System;
-using System.Collections;
 using System.Collections.Generic;
-using System.IO;
 using System.Linq;
-using System.Threading.Tasks;
-using Akka;
+using System.Diagnostics;
 using Akka.Actor;
-using Akka.IO;
-using Akka.Streams;
-using Akka.Streams.Dsl;
-using AkkaLibrary.Common.Utilities;
-using Serilog;
+using AkkaLibrary.Common.Metrics;
+using AkkaLibrary.Common.Objects;
 
 namespace AkkaLibrary
 {
     public class FpgaSampleAssemblerActor : ReceiveActor
     {
-        public FpgaSampleAssemblerActor(IEnumerable<FpgaChannel> channelList, int samplesPerPacket, IActorRef outputTarget)
+        /// <param name="recordingPath">When set, every raw packet is also recorded here with a <see cref="FpgaRecordingWriter"/></param>
+        /// <param name="arrivals">When set, the acquisition time of each block is marked here for later stages of the pipeline</param>
+        /// <param name="name">Prefix of the published metric names. Defaults to one unique to this actor.</param>
+        public FpgaSampleAssemblerActor(IEnumerable<FpgaChannel> channelList, int samplesPerPacket, IActorRef outputTarget, string recordingPath = null,
+                                        SampleArrivals arrivals = null, string name = null)
         {
+            name = name ?? MetricsRegistry.InstanceName("FpgaSampleAssembler");
+            _packetsDecoded = MetricsRegistry.Default.Counter($"{name}.Packets");
+            _samplesDecoded = MetricsRegistry.Default.Counter($"{name}.Samples");
+            _decodeTime = MetricsRegistry.Default.Histogram($"{name}.Decode");
+            _arrivals = arrivals;
+
             _outputTarget = outputTarget;
             _channelList = channelList.ToArray();
 
-            _digitalChannelNames = _channelList.Where(x => x.DataType == ChannelType.Bool)
-                                                .Select(x => x.ChannelName).ToList();
-
             _samplesPerPacket = samplesPerPacket;
 
-            _sampleLength = CalculateSampleLength(_channelList);
-
-            _assemblerFlow = CreateAssemblerLogic(_samplesPerPacket, _sampleLength, _outputTarget);
+            _decoder = new FpgaPacketDecoder(_channelList, _samplesPerPacket);
+            _schema = FpgaSampleBlock.CreateSchema(_decoder);
 
-            Ready();
-        }
+            _sampleLength = _decoder.SampleLength;
 
-        private ISourceQueueWithComplete<ByteString> CreateAssemblerLogic(int samplesPerPacket, int sampleLength, IActorRef outputTarget)
-        {
-            var assemblerLogic = Flow.Create<ByteString>()
-                                .SelectMany(bs =>
-                                {
-                                    var sliceList = new List<ByteString>();
-                                    for (int i = 0; i < (samplesPerPacket * sampleLength); i += sampleLength)
-                                    {
-                                        var stream = new MemoryStream();
-                                        sliceList.Add(bs.Slice(i, sampleLength));
-                                    }
-                                    return sliceList;
-                                })
-                                .Select(bytestring => (index: ++_sampleIndex, bytes: bytestring))
-                                .SelectAsync(4, tup => Task.Run(() => AssembleSample(tup.bytes, tup.index)))
-                                .To(Sink.ActorRef<FpgaSample>(outputTarget, new FpgaPluginMessages.StreamComplete()));
-
-            var source = Source.Queue<ByteString>(10000, OverflowStrategy.Backpressure);
-
-            return source.ToMaterialized(assemblerLogic, Keep.Left).Run(Context.System.Materializer());
-        }
-
-        private int CalculateSampleLength(IReadOnlyList<FpgaChannel> channelList)
-        {
-            var sampleLength = 0;
-
-            foreach (var item in channelList)
+            if(recordingPath != null)
             {
-                switch (item.DataType)
-                {
-                    case ChannelType.UInt32:
-                        sampleLength += 32;
-                        break;
-                    case ChannelType.Int16:
-                        sampleLength += 16;
-                        break;
-                    case ChannelType.Int24:
-                        sampleLength += 24;
-                        break;
-                    case ChannelType.Int32:
-                        sampleLength += 32;
-                        break;
-                    case ChannelType.Float:
-                        sampleLength += 32;
-                        break;
-                    case ChannelType.Double:
-                        sampleLength += 64;
-                        break;
-                    case ChannelType.Bool:
-                        sampleLength += 1;
-                        break;
-                    default:
-                        break;
-                }
+                _recorder = new FpgaRecordingWriter(recordingPath, _channelList, _samplesPerPacket);
             }
 
-            return sampleLength/8;
+            Ready();
         }
 
         private void Ready()
         {
-            Receive<ByteString>(msg =>
+            // The decoder reuses its columns so packets are decoded one at a time
+            Receive<FpgaPluginMessages.Packets>(msg =>
             {
-                _assemblerFlow.OfferAsync(msg).PipeTo(Self);
-            });
-
-            Receive<IQueueOfferResult>(enqueueTask =>
-            {
-                enqueueTask.Match()
-                        .With<QueueOfferResult.Enqueued>(msg => ++_messagesEnqueued)
-                        .With<QueueOfferResult.Dropped>(msg => Log.Warning("FPGA assembler actor dropped a message. Total dropped:{0}", ++_messagesDropped))
-                        .With<QueueOfferResult.Failure>(msg => throw msg.Cause)
-                        .With<QueueOfferResult.QueueClosed>(msg => throw new Exception("The stream queue was closed."));
-            });
-        }
+                if(msg.FirstSampleIndex > 0)
+                {
+                    _sampleIndex = msg.FirstSampleIndex - 1;
+                }
 
-        private FpgaSample AssembleSample(ByteString bytes, int sampleIndex)
-        {
-            using(var stream = new MemoryStream(bytes.ToArray()))
-            {
-                using (var reader = new BinaryReader(stream))
+                foreach (var packet in msg.Items)
                 {
-                    var uint32s = new List<(string, UInt32)>();
-                    var int16s = new List<(string, Int16)>();
-                    var int24s = new List<(string, Int24)>();
-                    var int32s = new List<(string, Int32)>();
-                    var floats = new List<(string, float)>();
-                    var doubles = new List<(string, Double)>();
-                    var bools = new List<(string, bool)>();
-
-                    var boolsToRead = 0;
-                    foreach (var channel in _channelList)
-                    {
-                        switch (channel.DataType)
-                        {
-                            case ChannelType.UInt32:
-                                uint32s.Add((channel.ChannelName, reader.ReadUInt32()));
-                                break;
-                            case ChannelType.Int16:
-                                int16s.Add((channel.ChannelName, reader.ReadInt16()));
-                                break;
-                            case ChannelType.Int24:
-                                int24s.Add((channel.ChannelName, reader.ReadInt24()));
-                                break;
-                            case ChannelType.Int32:
-                                int32s.Add((channel.ChannelName, reader.ReadInt32()));
-                                break;
-                            case ChannelType.Float:
-                                floats.Add((channel.ChannelName, reader.ReadSingle()));
-                                break;
-                            case ChannelType.Double:
-                                doubles.Add((channel.ChannelName, reader.ReadDouble()));
-                                break;
-                            case ChannelType.Bool:
-                                //Add the bools to a separate array and handle afterwards.
-                                ++boolsToRead;
-                                break;
-                            default:
-                                break;
-                        }
-                    }
+                    // Later stages measure their latency from here by sample index
+                    var arrival = Stopwatch.GetTimestamp();
+                    _arrivals?.Mark(_sampleIndex + 1, arrival);
 
-                    //Assemble the bools
-                    if (boolsToRead > 0)
+                    using (packet)
                     {
-                        var digitalBytes = reader.ReadBytes(boolsToRead / 8);
-                        var bits = new BitArray(digitalBytes);
-
-                        for (var i = 0; i < bits.Length; i++)
-                        {
-                            bools.Add((_digitalChannelNames[i], bits[i]));
-                        }
+                        _recorder?.Append(packet.Array, packet.Offset, _sampleIndex + 1, msg.ReceivedAt);
+                        _decoder.Decode(packet.Array, packet.Offset);
                     }
 
-                    var sample = new FpgaSample(0, 0, 0, false, sampleIndex,
-                                        uint32s, 
-                                        int16s,
-                                        int24s,
-                                        int32s,
-                                        floats,
-                                        doubles,
-                                        bools
-                                        );
-
-                    return sample;
+                    _outputTarget.Tell(new FpgaSampleBlock(_schema, _decoder, _sampleIndex + 1));
+                    _sampleIndex += _samplesPerPacket;
+                    _decodeTime.RecordSince(arrival);
                 }
-            }
+
+                _packetsDecoded.Add(msg.Items.Count);
+                _samplesDecoded.Add(msg.Items.Count * _samplesPerPacket);
+
+                Sender.Tell(new FpgaPluginMessages.PacketsDecoded(msg.Items.Count));
+            });
+
+            Receive<FpgaPluginMessages.StreamComplete>(msg => _outputTarget.Tell(msg));
+        }
+
+        protected override void PostStop()
+        {
+            _decoder.Dispose();
+            _recorder?.Dispose();
+            base.PostStop();
         }
 
-        public static Props GetProps(IEnumerable<FpgaChannel> channels, int samplesPerPacket, IActorRef outputTarget) => Props.Create(() => new FpgaSampleAssemblerActor(channels, samplesPerPacket, outputTarget));
+        public static Props GetProps(IEnumerable<FpgaChannel> channels, int samplesPerPacket, IActorRef outputTarget, string recordingPath = null,
+                                     SampleArrivals arrivals = null, string name = null)
+                                => Props.Create(() => new FpgaSampleAssemblerActor(channels, samplesPerPacket, outputTarget, recordingPath, arrivals, name));
 
         private int _samplesPerPacket;
         private IActorRef _outputTarget;
         private IReadOnlyList<FpgaChannel> _channelList;
-        private List<string> _digitalChannelNames;
         private int _sampleLength;
-        private ISourceQueueWithComplete<ByteString> _assemblerFlow;
-        private int _messagesEnqueued;
-        private int _messagesDropped;
-        private int _sampleIndex;
+        private FpgaPacketDecoder _decoder;
+        private ChannelSchema _schema;
+        private FpgaRecordingWriter _recorder;
+        private long _sampleIndex;
+
+        private readonly SampleArrivals _arrivals;
+        private readonly Counter _packetsDecoded;
+        private readonly Counter _samplesDecoded;
+        private readonly LatencyHistogram _decodeTime;
     }
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+using System;
+using System.Linq;
+using AkkaLibrary.Common.Objects;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// The decoded samples of one FPGA packet in their native types
+    ///
+    /// Columns use the <see cref="FpgaPacketDecoder"/> layout, one column per
+    /// channel of each type in channel list order, so the value of the c-th
+    /// channel of a type for sample s is at [c * Length + s].
+    /// </summary>
+    public sealed class FpgaSampleBlock
+    {
+        /// <summary>
+        /// Schema of the converted block. Analogs are ordered UInt32, Int16,
+        /// Int24, Int32, Float then Double, matching <see cref="FpgaSample.GetAnalogsAsFloats"/>.
+        /// </summary>
+        public ChannelSchema Schema { get; }
+
+        public int Length { get; }
+        public long FirstSampleIndex { get; }
+
+        #region Columns
+
+        public uint[] UInt32s { get; }
+        public short[] Int16s { get; }
+        public int[] Int24s { get; }
+        public int[] Int32s { get; }
+        public float[] Floats { get; }
+        public double[] Doubles { get; }
+        public byte[] Bools { get; }
+
+        #endregion
+
+        /// <summary>
+        /// Copies the current columns of the decoder into a new block
+        /// </summary>
+        public FpgaSampleBlock(ChannelSchema schema, FpgaPacketDecoder decoder, long firstSampleIndex)
+        {
+            Schema = schema;
+            Length = decoder.SamplesPerPacket;
+            FirstSampleIndex = firstSampleIndex;
+
+            UInt32s = (uint[])decoder.UInt32s.Clone();
+            Int16s = (short[])decoder.Int16s.Clone();
+            Int24s = (int[])decoder.Int24s.Clone();
+            Int32s = (int[])decoder.Int32s.Clone();
+            Floats = (float[])decoder.Floats.Clone();
+            Doubles = (double[])decoder.Doubles.Clone();
+            Bools = (byte[])decoder.Bools.Clone();
+        }
+
+        /// <summary>
+        /// Creates the schema shared by every block from a decoder
+        /// </summary>
+        public static ChannelSchema CreateSchema(FpgaPacketDecoder decoder)
+        {
+            var analogs = decoder.UInt32Names
+                            .Concat(decoder.Int16Names)
+                            .Concat(decoder.Int24Names)
+                            .Concat(decoder.Int32Names)
+                            .Concat(decoder.FloatNames)
+                            .Concat(decoder.DoubleNames);
+
+            return new ChannelSchema(analogs, decoder.BoolNames);
+        }
+
+        /// <summary>
+        /// Converts the block to single precision analogs, one pass per column group
+        /// </summary>
+        public SampleBlock<float> ToFloats()
+        {
+            var block = new SampleBlock<float>(Schema, Length);
+            var analogs = block.Analogs;
+            var index = 0;
+
+            for (int i = 0; i < UInt32s.Length; i++) analogs[index++] = UInt32s[i];
+            for (int i = 0; i < Int16s.Length; i++) analogs[index++] = Int16s[i];
+            for (int i = 0; i < Int24s.Length; i++) analogs[index++] = Int24s[i];
+            for (int i = 0; i < Int32s.Length; i++) analogs[index++] = Int32s[i];
+            Array.Copy(Floats, 0, analogs, index, Floats.Length);
+            index += Floats.Length;
+            for (int i = 0; i < Doubles.Length; i++) analogs[index++] = (float)Doubles[i];
+
+            var digitals = block.Digitals;
+            for (int i = 0; i < Bools.Length; i++)
+            {
+                digitals[i] = Bools[i] != 0;
+            }
+
+            for (int s = 0; s < Length; s++)
+            {
+                block.SampleIndices[s] = FirstSampleIndex + s;
+            }
+
+            return block;
+        }
+    }
+}
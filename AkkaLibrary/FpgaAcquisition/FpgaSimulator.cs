@@ -0,0 +1,262 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+using System.Threading.Tasks;
+using Akka.IO;
+using Serilog;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// Local TCP server standing in for the FPGA
+    ///
+    /// Serves delimited packets for any channel list so the acquisition
+    /// chain can be driven without hardware. Channel c of sample n holds
+    /// n + c in the channel's type and digitals alternate with n. Packets are
+    /// sent as fast as the socket allows or paced to packetsPerSecond, and
+    /// the send time of each recent packet is kept so receivers can measure
+    /// end-to-end latency with <see cref="Stopwatch.GetTimestamp"/>. Packets
+    /// are numbered across every client, so a client that reconnects carries
+    /// on from where the last one stopped and the packet limit is never
+    /// exceeded in total.
+    /// </summary>
+    public sealed class FpgaSimulator : IDisposable
+    {
+        private const int SendTimeHistory = 1 << 16;
+        private const int SendBufferLength = 64 * 1024;
+
+        private readonly IReadOnlyList<FpgaChannel> _channels;
+        private readonly int _samplesPerPacket;
+        private readonly byte[] _delimiter;
+        private readonly double _packetsPerSecond;
+        private readonly long _packetLimit;
+        private readonly TcpListener _listener;
+        private readonly CancellationTokenSource _cancellation = new CancellationTokenSource();
+        private readonly long[] _sendTimes = new long[SendTimeHistory];
+        private long _packetsSent;
+        private long _packetsReserved;
+
+        public int Port { get; }
+
+        public int PacketLength { get; }
+
+        public long PacketsSent => Interlocked.Read(ref _packetsSent);
+
+        /// <param name="channels">Channels in each sample</param>
+        /// <param name="samplesPerPacket">Samples in each packet</param>
+        /// <param name="delimiter">Bytes sent before every packet</param>
+        /// <param name="port">Port to listen on. Zero picks a free port.</param>
+        /// <param name="packetsPerSecond">Target send rate. Zero or less sends unthrottled.</param>
+        /// <param name="packetLimit">Packets to send in total, across every client. Zero or less sends until disposed.</param>
+        public FpgaSimulator(IEnumerable<FpgaChannel> channels, int samplesPerPacket, ByteString delimiter, int port = 0, double packetsPerSecond = 0, long packetLimit = 0)
+        {
+            _channels = channels.ToArray();
+            _samplesPerPacket = samplesPerPacket;
+            _delimiter = delimiter.ToArray();
+            _packetsPerSecond = packetsPerSecond;
+            _packetLimit = packetLimit;
+
+            PacketLength = FpgaPacketDecoder.GetPacketLength(_channels, samplesPerPacket);
+
+            _listener = new TcpListener(IPAddress.Loopback, port);
+            _listener.Start();
+            Port = ((IPEndPoint)_listener.LocalEndpoint).Port;
+
+            Task.Run(AcceptClients);
+        }
+
+        /// <summary>
+        /// <see cref="Stopwatch"/> timestamp at which packet <paramref name="packet"/> was
+        /// sent. Only the most recent packets are kept.
+        /// </summary>
+        public long SendTimeOf(long packet) => Volatile.Read(ref _sendTimes[packet % SendTimeHistory]);
+
+        private async Task AcceptClients()
+        {
+            while(!_cancellation.IsCancellationRequested)
+            {
+                Socket client;
+                try
+                {
+                    client = await _listener.AcceptSocketAsync();
+                }
+                catch (Exception) when (_cancellation.IsCancellationRequested)
+                {
+                    return;
+                }
+
+                Log.Information($"FPGA simulator accepted {client.RemoteEndPoint}.");
+                var _ = Task.Run(() => Serve(client));
+            }
+        }
+
+        private void Serve(Socket client)
+        {
+            var stride = _delimiter.Length + PacketLength;
+            var buffer = new byte[Math.Max(stride, SendBufferLength / stride * stride)];
+            var stopwatch = Stopwatch.StartNew();
+            long sent = 0;
+
+            try
+            {
+                using (client)
+                {
+                    while(!_cancellation.IsCancellationRequested)
+                    {
+                        var due = (int)Math.Min(buffer.Length / stride, PacketsDue(sent, stopwatch));
+                        if(due == 0)
+                        {
+                            Thread.Sleep(1);
+                            continue;
+                        }
+
+                        var count = Reserve(due, out var packet);
+                        if(count == 0)
+                        {
+                            break;
+                        }
+
+                        for (int i = 0; i < count; i++)
+                        {
+                            WritePacket(packet + i, buffer, i * stride);
+                        }
+
+                        var now = Stopwatch.GetTimestamp();
+                        for (int i = 0; i < count; i++)
+                        {
+                            Volatile.Write(ref _sendTimes[(packet + i) % SendTimeHistory], now);
+                        }
+
+                        client.Send(buffer, 0, count * stride, SocketFlags.None);
+                        sent += count;
+                        Interlocked.Add(ref _packetsSent, count);
+                    }
+
+                    client.Shutdown(SocketShutdown.Send);
+                }
+            }
+            catch (SocketException e)
+            {
+                Log.Information($"FPGA simulator client closed: {e.Message}");
+            }
+        }
+
+        /// <summary>
+        /// Packets the client is due at the target rate, given the packets it has been sent
+        /// </summary>
+        private long PacketsDue(long sent, Stopwatch stopwatch)
+        {
+            if(_packetsPerSecond <= 0)
+            {
+                return long.MaxValue;
+            }
+
+            var due = (long)(stopwatch.Elapsed.TotalSeconds * _packetsPerSecond) - sent;
+            return Math.Max(0, due);
+        }
+
+        /// <summary>
+        /// Claims up to <paramref name="wanted"/> packet numbers from the
+        /// simulator-wide sequence, returning how many were claimed. Zero once
+        /// the packet limit has been reached.
+        /// </summary>
+        private int Reserve(int wanted, out long first)
+        {
+            while(true)
+            {
+                first = Interlocked.Read(ref _packetsReserved);
+                var count = _packetLimit > 0 ? (int)Math.Min(wanted, _packetLimit - first) : wanted;
+                if(count <= 0)
+                {
+                    return 0;
+                }
+                if(Interlocked.CompareExchange(ref _packetsReserved, first + count, first) == first)
+                {
+                    return count;
+                }
+            }
+        }
+
+        private void WritePacket(long packet, byte[] buffer, int offset)
+        {
+            Buffer.BlockCopy(_delimiter, 0, buffer, offset, _delimiter.Length);
+            offset += _delimiter.Length;
+
+            for (int s = 0; s < _samplesPerPacket; s++)
+            {
+                var n = packet * _samplesPerPacket + s;
+
+                // Analogs in channel order, then the digitals packed into whole bytes
+                for (int c = 0; c < _channels.Count; c++)
+                {
+                    if(_channels[c].DataType != ChannelType.Bool)
+                    {
+                        offset += WriteValue(buffer, offset, _channels[c].DataType, n + c);
+                    }
+                }
+
+                var digitalCount = 0;
+                for (int c = 0; c < _channels.Count; c++)
+                {
+                    if(_channels[c].DataType != ChannelType.Bool)
+                    {
+                        continue;
+                    }
+
+                    if(digitalCount % 8 == 0)
+                    {
+                        buffer[offset++] = 0;
+                    }
+                    if((n + c) % 2 == 0)
+                    {
+                        buffer[offset - 1] |= (byte)(1 << (digitalCount % 8));
+                    }
+                    digitalCount++;
+                }
+            }
+        }
+
+        private static unsafe int WriteValue(byte[] buffer, int offset, ChannelType type, long value)
+        {
+            if(type == ChannelType.Int24)
+            {
+                buffer[offset] = (byte)value;
+                buffer[offset + 1] = (byte)(value >> 8);
+                buffer[offset + 2] = (byte)(value >> 16);
+                return 3;
+            }
+
+            fixed (byte* destination = &buffer[offset])
+            {
+                switch (type)
+                {
+                    case ChannelType.UInt32:
+                    case ChannelType.Int32:
+                        *(int*)destination = (int)value;
+                        return 4;
+                    case ChannelType.Int16:
+                        *(short*)destination = (short)value;
+                        return 2;
+                    case ChannelType.Float:
+                        *(float*)destination = value;
+                        return 4;
+                    case ChannelType.Double:
+                        *(double*)destination = value;
+                        return 8;
+                    default:
+                        throw new ArgumentException($"Channel type {type} cannot be simulated.");
+                }
+            }
+        }
+
+        public void Dispose()
+        {
+            _cancellation.Cancel();
+            _listener.Stop();
+        }
+    }
+}
@@ -0,0 +1,120 @@
+using System;
+using System.Runtime.InteropServices;
+using AkkaLibrary.Common.Utilities;
+using Serilog;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// Bulk conversion of packed little-endian 24-bit buffers
+    ///
+    /// Uses the SSSE3/AVX2 kernels in libfpgadecode when the library is
+    /// available, otherwise <see cref="Int24Converter"/>. The native library
+    /// picks the widest kernel the CPU supports and uses a scalar loop on
+    /// non-x86 targets.
+    /// </summary>
+    public static class Int24Kernels
+    {
+        private static readonly Lazy<bool> _native = new Lazy<bool>(ProbeNative);
+
+        /// <summary>
+        /// True when conversions run in libfpgadecode
+        /// </summary>
+        public static bool IsNative => _native.Value;
+
+        /// <summary>
+        /// Converts packed 24-bit values into sign-extended 32-bit integers
+        /// </summary>
+        /// <param name="source">Packed little-endian 24-bit values</param>
+        /// <param name="destination">Destination for the converted values</param>
+        /// <returns>The number of values converted</returns>
+        public static unsafe int ToInt32(ReadOnlySpan<byte> source, Span<int> destination)
+        {
+            if(!IsNative)
+            {
+                return Int24Converter.ToInt32(source, destination);
+            }
+
+            var count = CountOf(source, destination.Length);
+            if(count == 0)
+            {
+                return 0;
+            }
+
+            fixed(byte* src = &MemoryMarshal.GetReference(source))
+            fixed(int* dst = &MemoryMarshal.GetReference(destination))
+            {
+                Check(FpgaDecodeWrapper.Int24ToInt32(src, dst, count));
+            }
+            return count;
+        }
+
+        /// <summary>
+        /// Converts packed 24-bit values into scaled single precision floats
+        /// </summary>
+        /// <param name="source">Packed little-endian 24-bit values</param>
+        /// <param name="destination">Destination for the converted values</param>
+        /// <param name="scale">Multiplier applied to each value</param>
+        /// <returns>The number of values converted</returns>
+        public static unsafe int ToSingle(ReadOnlySpan<byte> source, Span<float> destination, float scale = 1f)
+        {
+            if(!IsNative)
+            {
+                return Int24Converter.ToSingle(source, destination, scale);
+            }
+
+            var count = CountOf(source, destination.Length);
+            if(count == 0)
+            {
+                return 0;
+            }
+
+            fixed(byte* src = &MemoryMarshal.GetReference(source))
+            fixed(float* dst = &MemoryMarshal.GetReference(destination))
+            {
+                Check(FpgaDecodeWrapper.Int24ToFloat(src, dst, count, scale));
+            }
+            return count;
+        }
+
+        private static int CountOf(ReadOnlySpan<byte> source, int destinationLength)
+        {
+            if(source.Length % Int24Converter.BytesPerValue != 0)
+            {
+                throw new ArgumentException($"Source length {source.Length} is not a multiple of {Int24Converter.BytesPerValue}", nameof(source));
+            }
+
+            var count = source.Length / Int24Converter.BytesPerValue;
+            if(destinationLength < count)
+            {
+                throw new ArgumentException($"Destination holds {destinationLength} values but {count} are required", "destination");
+            }
+
+            return count;
+        }
+
+        private static void Check(int result)
+        {
+            if(result != 0)
+            {
+                throw new InvalidOperationException($"libfpgadecode failed to convert Int24 values with code {result}.");
+            }
+        }
+
+        private static unsafe bool ProbeNative()
+        {
+            try
+            {
+                var value = stackalloc byte[3];
+                int converted;
+                value[0] = 0xFF; value[1] = 0xFF; value[2] = 0xFF;
+                return FpgaDecodeWrapper.Int24ToInt32(value, &converted, 1) == 0 && converted == -1;
+            }
+            catch (Exception e) when (e is DllNotFoundException || e is EntryPointNotFoundException || e is BadImageFormatException)
+            {
+                Log.Information("libfpgadecode not available ({Reason}). Using managed Int24 conversion.", e.Message);
+                return false;
+            }
+        }
+    }
+}
@@ -6,7 +6,9 @@ using Akka.Configuration;
 using Akka.IO;
 using Akka.Streams;
 using AkkaLibrary.Common.Logging;
+using AkkaLibrary.Common.Metrics;
 using AkkaLibrary.Common.Objects;
+using AkkaLibrary.Common.Serialization;
 using Serilog;
 
 namespace AkkaLibrary
@@ -21,15 +23,24 @@ namespace AkkaLibrary
 
             var systemConfig = GetSystemConfig();
 
+            // --simulate serves generated packets on the configured port instead of needing an FPGA
+            var simulator = Array.IndexOf(args, "--simulate") >= 0
+                                ? CreateSimulator(GetFpgaConfig(ActorRefs.Nobody))
+                                : null;
+
             using (var system = ActorSystem.Create("FpgaAcquisition", systemConfig))
             using (var materializer = system.Materializer())
             {
                 var loggerActor = system.ActorOf<LoggerActor>("logger-writer");
 
-                var fpgaConversion = system.ActorOf(FpgaConversionPluginActor.GetProps(loggerActor), "fpga-conversion-actor");
+                var fpgaConfig = GetFpgaConfig(ActorRefs.Nobody);
+                fpgaConfig.Arrivals = new SampleArrivals();
+
+                var fpgaConversion = system.ActorOf(FpgaConversionPluginActor.GetProps(loggerActor, fpgaConfig.Arrivals), "fpga-conversion-actor");
+                fpgaConfig.OutputTarget = fpgaConversion;
 
                 var fpgaAcquisition = system.ActorOf<FpgaAcquisitionPluginActor>("fpga-plugin-actor");
-                fpgaAcquisition.Tell(new FpgaPluginMessages.Configure(GetFpgaConfig(fpgaConversion)));
+                fpgaAcquisition.Tell(new FpgaPluginMessages.Configure(fpgaConfig));
 
 
                 var terminatedTask = system.WhenTerminated;
@@ -38,9 +49,16 @@ namespace AkkaLibrary
                 Log.Information($"System completed: {terminatedTask.IsCompleted}");
             }
 
+            simulator?.Dispose();
             Log.CloseAndFlush();
         }
 
+        private static FpgaSimulator CreateSimulator(FpgaAcquisitionConfiguration config)
+        {
+            Log.Information($"Simulating the FPGA on port {config.Port}.");
+            return new FpgaSimulator(config.ChannelList, config.SamplesPerPacket, config.Delimiter, config.Port);
+        }
+
         private static FpgaAcquisitionConfiguration GetFpgaConfig(IActorRef outputTarget)
         {
             return new FpgaAcquisitionConfiguration
@@ -82,7 +100,8 @@ namespace AkkaLibrary
                 suppress-json-serializer-warning=true,
                 loglevel=INFO,
                 loggers=[""Akka.Logger.Serilog.SerilogLogger, Akka.Logger.Serilog""]
-            }");
+            }")
+            .WithFallback(SampleSerializer.Configuration);
         }
 
         public sealed class RequestInputTarget { }
@@ -106,17 +125,24 @@ namespace AkkaLibrary
                 Log.Information(msg);
             });
 
-            Receive<FpgaSample>(msg =>
+            Receive<SampleBlock<float>>(msg =>
             {
-                if(++sampleCount == _numSamples)
+                var first = msg.SampleIndices[0];
+                if( (first - _lastSampleIndex) != 1)
+                {
+                    Log.Fatal($"Sample index incremented by {first - _lastSampleIndex}");
+                }
+                _lastSampleIndex = msg.SampleIndices[msg.Length - 1];
+
+                sampleCount += msg.Length;
+                if(sampleCount >= _numSamples)
                 {
-                    sampleCount = 0;
                     var elapsed = _stopwatch.ElapsedMilliseconds;
-                    Log.Information($"Sample Index Difference {msg.SampleIndex} - {_latestSampleIndex} = {msg.SampleIndex - _latestSampleIndex}.{Environment.NewLine}{elapsed/1000.0} seconds for {_numSamples} samples. Samples per second:{((double)_numSamples)/elapsed * 1000.0}.");
-                    _latestSampleIndex = msg.SampleIndex;
+                    Log.Information($"Sample Index Difference {_lastSampleIndex} - {_latestSampleIndex} = {_lastSampleIndex - _latestSampleIndex}.{Environment.NewLine}{elapsed/1000.0} seconds for {sampleCount} samples. Samples per second:{((double)sampleCount)/elapsed * 1000.0}.");
+                    sampleCount = 0;
+                    _latestSampleIndex = _lastSampleIndex;
                     _stopwatch.Restart();
                 }
-                
             });
 
             Receive<ChannelData<float>>(msg =>
@@ -1,11 +1,11 @@
 using System;
-using System.Linq;
-using System.Threading.Tasks;
 using Akka;
 using Akka.Actor;
 using Akka.Streams;
 using Akka.Streams.Dsl;
+using AkkaLibrary.Common.Metrics;
 using AkkaLibrary.Common.Objects;
+using AkkaLibrary.Streams;
 using Serilog;
 
 namespace AkkaLibrary
@@ -15,63 +15,77 @@ namespace AkkaLibrary
         private IActorRef _outputTarget;
         private IActorRef _converter;
 
-        public FpgaConversionPluginActor(IActorRef outputTarget)
+        /// <param name="arrivals">Arrival times marked by the acquisition of this pipeline, to measure latency against</param>
+        public FpgaConversionPluginActor(IActorRef outputTarget, SampleArrivals arrivals = null)
         {
             _outputTarget = outputTarget;
 
-            _converter = Context.ActorOf(ConverterActor.GetProps(_outputTarget));
+            _converter = Context.ActorOf(ConverterActor.GetProps(_outputTarget, arrivals));
 
-            Receive<FpgaSample>(msg => _converter.Tell(msg));
+            Receive<FpgaSampleBlock>(msg => _converter.Tell(msg));
         }
 
-        public static Props GetProps(IActorRef outputTarget) => Props.Create(() => new FpgaConversionPluginActor(outputTarget));
+        public static Props GetProps(IActorRef outputTarget, SampleArrivals arrivals = null) => Props.Create(() => new FpgaConversionPluginActor(outputTarget, arrivals));
     }
 
     public class ConverterActor : ReceiveActor
     {
-        private int _messagesEnqueued;
-        private int _messagesDropped;
+        private readonly Gauge _queueDepth;
+        private readonly Counter _enqueued;
+        private readonly Counter _dropped;
+        private readonly LatencyHistogram _latency;
 
-        public ConverterActor(IActorRef outputTarget)
+        public ConverterActor(IActorRef outputTarget, SampleArrivals arrivals = null)
         {
-            var flowLogic = Flow.Create<FpgaSample>()
-                                .SelectAsync(4, sample => Task.Run(() => ConvertSample(sample)))
-                                .To(Sink.ActorRef<ChannelData<float>>(outputTarget, new FpgaConversionCompleted()));
+            var name = $"Converter[{Self.Path.ToStringWithoutAddress()}]";
+            _queueDepth = MetricsRegistry.Default.Gauge($"{name}.QueueDepth");
+            _enqueued = MetricsRegistry.Default.Counter($"{name}.Enqueued");
+            _dropped = MetricsRegistry.Default.Counter($"{name}.Dropped");
+            _latency = MetricsRegistry.Default.Histogram($"{name}.Latency");
 
-            var source = Source.Queue<FpgaSample>(10000, OverflowStrategy.Backpressure);
+            // Each block is converted column by column. Blocks queued while the
+            // workers are busy are converted together.
+            var flowLogic = Flow.Create<FpgaSampleBlock>()
+                                .Select(block =>
+                                {
+                                    _queueDepth.Decrement();
+                                    return block;
+                                })
+                                .Via(ParallelOrderedFlow.Create<FpgaSampleBlock, SampleBlock<float>>(block => block.ToFloats(), 4, name: $"{name}.Convert"))
+                                .Select(block =>
+                                {
+                                    arrivals?.RecordLatency(block.SampleIndices[0], _latency);
+                                    return block;
+                                })
+                                .To(Sink.ActorRef<SampleBlock<float>>(outputTarget, new FpgaConversionCompleted()));
+
+            var source = Source.Queue<FpgaSampleBlock>(10000, OverflowStrategy.Backpressure);
 
             var queue = source.ToMaterialized(flowLogic, Keep.Left).Run(Context.System.Materializer());
 
-            Receive<FpgaSample>(msg =>
+            Receive<FpgaSampleBlock>(msg =>
             {
+                _queueDepth.Increment();
                 queue.OfferAsync(msg).PipeTo(Self);
             });
 
             Receive<IQueueOfferResult>(enqueueTask =>
             {
                 enqueueTask.Match()
-                        .With<QueueOfferResult.Enqueued>(msg => ++_messagesEnqueued)
-                        .With<QueueOfferResult.Dropped>(msg => Log.Warning("FPGA conversion actor dropped a message. Total dropped:{0}", ++_messagesDropped))
+                        .With<QueueOfferResult.Enqueued>(msg => _enqueued.Increment())
+                        .With<QueueOfferResult.Dropped>(msg =>
+                        {
+                            _queueDepth.Decrement();
+                            _dropped.Increment();
+                            Log.Warning("FPGA conversion actor dropped a message. Total dropped:{0}", _dropped.Value);
+                        })
                         .With<QueueOfferResult.Failure>(msg => throw msg.Cause)
                         .With<QueueOfferResult.QueueClosed>(msg => throw new Exception("The stream queue was closed."));
             });
         }
 
-        private ChannelData<float> ConvertSample(FpgaSample sample)
-        {
-            return new ChannelData<float>(
-                sample.GetAnalogsAsFloats().Select(x => new DataChannel<float>(x.name, x.value)),
-                sample.Bools.Select(x => new DataChannel<bool>(x.name, x.value)),
-                sample.TimeStamp,
-                sample.TachometerCount,
-                sample.MasterSyncIncrement,
-                sample.MasterSyncState,
-                sample.SampleIndex
-                );
-        }
-
         public sealed class FpgaConversionCompleted { }
 
-        public static Props GetProps(IActorRef outputTarget) => Props.Create(() => new ConverterActor(outputTarget));
+        public static Props GetProps(IActorRef outputTarget, SampleArrivals arrivals = null) => Props.Create(() => new ConverterActor(outputTarget, arrivals));
     }
 }
\ No newline at end of file
@@ -0,0 +1,361 @@
+using System;
+using System.Buffers;
+using System.IO;
+using Akka.IO;
+
+namespace AkkaLibrary.IOReceiveHandlers
+{
+    /// <summary>
+    /// Splits a byte stream into frames held in pooled memory
+    ///
+    /// Received data is copied once into a chunk rented from an
+    /// <see cref="ArrayPool{T}"/> and frames are handed out as
+    /// <see cref="PooledPacket"/> slices over that chunk, so nothing is copied
+    /// per frame. When a chunk fills, the unread tail moves to a fresh chunk
+    /// and the old one returns to the pool once every frame read from it has
+    /// been disposed.
+    ///
+    /// Three modes are supported:
+    /// <list type="bullet">
+    /// <item><see cref="Delimited"/> frames end with a delimiter, found with a
+    /// vectorised scan for its first byte. Bytes already scanned are not
+    /// searched again when more data arrives. A frame longer than
+    /// maxFrameLength is skipped up to the next delimiter and counted in
+    /// <see cref="OversizedFrames"/>.</item>
+    /// <item><see cref="LengthPrefixed"/> frames start with a 1, 2 or 4 byte
+    /// unsigned length. A length over maxFrameLength means the stream can no
+    /// longer be followed and throws <see cref="InvalidDataException"/>.</item>
+    /// <item><see cref="FixedLength"/> frames are all the same length.</item>
+    /// </list>
+    /// A parser is owned by a single actor; frames may be disposed from any thread.
+    /// </summary>
+    public sealed class FrameParser : IDisposable
+    {
+        private enum Mode
+        {
+            Delimited,
+            LengthPrefixed,
+            FixedLength
+        }
+
+        private readonly Mode _mode;
+        private readonly byte[] _delimiter;
+        private readonly bool _includeDelimiter;
+        private readonly int _prefixLength;
+        private readonly bool _bigEndian;
+        private readonly int _chunkLength;
+        private readonly ArrayPool<byte> _pool;
+
+        private PooledChunk _chunk;
+        private int _read;
+        private int _write;
+
+        // Delimited mode: bytes after _read known not to start a delimiter,
+        // and whether the frame being received is too long to keep
+        private int _scanned;
+        private bool _discarding;
+
+        /// <summary>
+        /// Longest frame, excluding any delimiter or length prefix
+        /// </summary>
+        public int MaxFrameLength { get; }
+
+        /// <summary>
+        /// Bytes received but not yet returned as frames
+        /// </summary>
+        public int BufferedBytes => _write - _read;
+
+        /// <summary>
+        /// Bytes skipped as part of oversized frames
+        /// </summary>
+        public long DiscardedBytes { get; private set; }
+
+        /// <summary>
+        /// Delimited frames skipped for exceeding <see cref="MaxFrameLength"/>
+        /// </summary>
+        public long OversizedFrames { get; private set; }
+
+        private FrameParser(Mode mode, int maxFrameLength, int overhead, byte[] delimiter, bool includeDelimiter, int prefixLength, bool bigEndian, int chunkLength, ArrayPool<byte> pool)
+        {
+            if(maxFrameLength <= 0)
+            {
+                throw new ArgumentException("Frame length must be positive.", nameof(maxFrameLength));
+            }
+
+            _mode = mode;
+            MaxFrameLength = maxFrameLength;
+            _delimiter = delimiter;
+            _includeDelimiter = includeDelimiter;
+            _prefixLength = prefixLength;
+            _bigEndian = bigEndian;
+            _pool = pool ?? ArrayPool<byte>.Shared;
+
+            // Room for at least two whole frames so compaction always makes progress
+            _chunkLength = Math.Max(chunkLength, 2 * (maxFrameLength + overhead));
+            _chunk = new PooledChunk(_pool, _chunkLength);
+        }
+
+        /// <summary>
+        /// Frames that end with <paramref name="delimiter"/>
+        /// </summary>
+        /// <param name="delimiter">Bytes ending every frame</param>
+        /// <param name="maxFrameLength">Longest frame to return, excluding the delimiter</param>
+        /// <param name="includeDelimiter">True to keep the delimiter at the end of each frame</param>
+        /// <param name="chunkLength">Length of each pooled chunk</param>
+        /// <param name="pool">Pool to rent chunks from. Defaults to the shared pool.</param>
+        public static FrameParser Delimited(byte[] delimiter, int maxFrameLength, bool includeDelimiter = false, int chunkLength = 64 * 1024, ArrayPool<byte> pool = null)
+        {
+            if(delimiter == null || delimiter.Length == 0)
+            {
+                throw new ArgumentException("A delimiter must have at least one byte.", nameof(delimiter));
+            }
+            return new FrameParser(Mode.Delimited, maxFrameLength, delimiter.Length, (byte[])delimiter.Clone(), includeDelimiter, 0, false, chunkLength, pool);
+        }
+
+        /// <summary>
+        /// Frames that start with their length
+        /// </summary>
+        /// <param name="prefixLength">Bytes in the length prefix. One of 1, 2 or 4.</param>
+        /// <param name="maxFrameLength">Longest frame allowed, excluding the prefix</param>
+        /// <param name="bigEndian">True if the prefix is big endian</param>
+        /// <param name="chunkLength">Length of each pooled chunk</param>
+        /// <param name="pool">Pool to rent chunks from. Defaults to the shared pool.</param>
+        public static FrameParser LengthPrefixed(int prefixLength, int maxFrameLength, bool bigEndian = false, int chunkLength = 64 * 1024, ArrayPool<byte> pool = null)
+        {
+            if(prefixLength != 1 && prefixLength != 2 && prefixLength != 4)
+            {
+                throw new ArgumentException("Length prefix must be 1, 2 or 4 bytes.", nameof(prefixLength));
+            }
+            return new FrameParser(Mode.LengthPrefixed, maxFrameLength, prefixLength, null, false, prefixLength, bigEndian, chunkLength, pool);
+        }
+
+        /// <summary>
+        /// Frames of exactly <paramref name="frameLength"/> bytes
+        /// </summary>
+        /// <param name="frameLength">Length of every frame</param>
+        /// <param name="chunkLength">Length of each pooled chunk</param>
+        /// <param name="pool">Pool to rent chunks from. Defaults to the shared pool.</param>
+        public static FrameParser FixedLength(int frameLength, int chunkLength = 64 * 1024, ArrayPool<byte> pool = null)
+            => new FrameParser(Mode.FixedLength, frameLength, 0, null, false, 0, false, chunkLength, pool);
+
+        /// <summary>
+        /// Appends received bytes
+        /// </summary>
+        public void Write(ReadOnlySpan<byte> data)
+        {
+            while(data.Length > 0)
+            {
+                if(_write == _chunk.Buffer.Length)
+                {
+                    Compact(data.Length);
+                }
+
+                var count = Math.Min(_chunk.Buffer.Length - _write, data.Length);
+                data.Slice(0, count).CopyTo(new Span<byte>(_chunk.Buffer, _write, count));
+                _write += count;
+                data = data.Slice(count);
+            }
+        }
+
+        /// <summary>
+        /// Appends a received segment
+        /// </summary>
+        public void Write(ByteString data)
+        {
+            var copied = 0;
+            while(copied < data.Count)
+            {
+                if(_write == _chunk.Buffer.Length)
+                {
+                    Compact(data.Count - copied);
+                }
+
+                var count = Math.Min(_chunk.Buffer.Length - _write, data.Count - copied);
+                data.Slice(copied, count).CopyTo(_chunk.Buffer, _write, count);
+                _write += count;
+                copied += count;
+            }
+        }
+
+        /// <summary>
+        /// Takes the next whole frame if one has been received. The frame
+        /// must be disposed once read to release its chunk.
+        /// </summary>
+        public bool TryRead(out PooledPacket frame)
+        {
+            switch (_mode)
+            {
+                case Mode.Delimited:
+                    return TryReadDelimited(out frame);
+                case Mode.LengthPrefixed:
+                    return TryReadLengthPrefixed(out frame);
+                default:
+                    return TryReadFixed(out frame);
+            }
+        }
+
+        private bool TryReadDelimited(out PooledPacket frame)
+        {
+            frame = null;
+
+            while(true)
+            {
+                var unscanned = new ReadOnlySpan<byte>(_chunk.Buffer, _read + _scanned, BufferedBytes - _scanned);
+                var found = IndexOf(unscanned, _delimiter);
+
+                if(found < 0)
+                {
+                    // A delimiter may start in the last few bytes
+                    _scanned = Math.Max(_scanned, BufferedBytes - _delimiter.Length + 1);
+
+                    if(_scanned > MaxFrameLength)
+                    {
+                        // Too long to return, so drop what has been scanned and skip to the next delimiter
+                        if(!_discarding)
+                        {
+                            _discarding = true;
+                            OversizedFrames++;
+                        }
+                        Discard(_scanned);
+                    }
+                    return false;
+                }
+
+                var length = _scanned + found;
+                var end = _read + length + _delimiter.Length;
+                _scanned = 0;
+
+                if(_discarding || length > MaxFrameLength)
+                {
+                    if(!_discarding)
+                    {
+                        OversizedFrames++;
+                    }
+                    _discarding = false;
+                    Discard(end - _read);
+                    continue;
+                }
+
+                frame = new PooledPacket(_chunk, _read, _includeDelimiter ? length + _delimiter.Length : length);
+                _read = end;
+                return true;
+            }
+        }
+
+        private bool TryReadLengthPrefixed(out PooledPacket frame)
+        {
+            frame = null;
+
+            if(BufferedBytes < _prefixLength)
+            {
+                return false;
+            }
+
+            var length = ReadPrefix(_chunk.Buffer, _read);
+            if(length > MaxFrameLength)
+            {
+                throw new InvalidDataException($"Frame length {length} exceeds the maximum of {MaxFrameLength}.");
+            }
+            if(BufferedBytes < _prefixLength + length)
+            {
+                return false;
+            }
+
+            frame = new PooledPacket(_chunk, _read + _prefixLength, (int)length);
+            _read += _prefixLength + (int)length;
+            return true;
+        }
+
+        private bool TryReadFixed(out PooledPacket frame)
+        {
+            frame = null;
+
+            if(BufferedBytes < MaxFrameLength)
+            {
+                return false;
+            }
+
+            frame = new PooledPacket(_chunk, _read, MaxFrameLength);
+            _read += MaxFrameLength;
+            return true;
+        }
+
+        private long ReadPrefix(byte[] buffer, int offset)
+        {
+            long length = 0;
+            for (int i = 0; i < _prefixLength; i++)
+            {
+                var shift = 8 * (_bigEndian ? _prefixLength - 1 - i : i);
+                length |= (long)buffer[offset + i] << shift;
+            }
+            return length;
+        }
+
+        private void Discard(int count)
+        {
+            _read += count;
+            _scanned = Math.Max(0, _scanned - count);
+            DiscardedBytes += count;
+        }
+
+        /// <summary>
+        /// Moves the unread bytes to a new chunk with room for at least
+        /// <paramref name="required"/> more
+        /// </summary>
+        private void Compact(int required)
+        {
+            var unread = BufferedBytes;
+            var next = new PooledChunk(_pool, Math.Max(_chunkLength, unread + Math.Min(required, _chunkLength)));
+
+            Buffer.BlockCopy(_chunk.Buffer, _read, next.Buffer, 0, unread);
+            _chunk.Release();
+
+            _chunk = next;
+            _read = 0;
+            _write = unread;
+        }
+
+        /// <summary>
+        /// Position of the first occurrence of <paramref name="delimiter"/>, or -1
+        ///
+        /// Candidates are found with the vectorised single byte
+        /// span IndexOf from <see cref="MemoryExtensions"/> on the
+        /// delimiter's first byte and then verified, so each byte of the data is
+        /// compared once unless it starts a partial match.
+        /// </summary>
+        public static int IndexOf(ReadOnlySpan<byte> data, ReadOnlySpan<byte> delimiter)
+        {
+            if(delimiter.Length == 0)
+            {
+                return 0;
+            }
+
+            var first = delimiter[0];
+            var rest = delimiter.Slice(1);
+            var searched = 0;
+
+            while(data.Length - searched >= delimiter.Length)
+            {
+                var candidate = data.Slice(searched, data.Length - searched - rest.Length).IndexOf(first);
+                if(candidate < 0)
+                {
+                    return -1;
+                }
+
+                var position = searched + candidate;
+                if(data.Slice(position + 1, rest.Length).SequenceEqual(rest))
+                {
+                    return position;
+                }
+                searched = position + 1;
+            }
+            return -1;
+        }
+
+        public void Dispose()
+        {
+            _chunk?.Release();
+            _chunk = null;
+        }
+    }
+}
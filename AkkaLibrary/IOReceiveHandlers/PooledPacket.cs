@@ -0,0 +1,79 @@
+using System;
+using System.Buffers;
+using System.Threading;
+
+namespace AkkaLibrary
+{
+    /// <summary>
+    /// Reference counted pooled buffer. The owner holds one reference
+    /// while writing into it and each packet holds another.
+    /// </summary>
+    internal sealed class PooledChunk
+    {
+        private readonly ArrayPool<byte> _pool;
+        private int _references = 1;
+
+        public byte[] Buffer { get; }
+
+        public PooledChunk(ArrayPool<byte> pool, int length)
+        {
+            _pool = pool;
+            Buffer = pool.Rent(length);
+        }
+
+        public void Retain() => Interlocked.Increment(ref _references);
+
+        public void Release()
+        {
+            if(Interlocked.Decrement(ref _references) == 0)
+            {
+                _pool.Return(Buffer);
+            }
+        }
+    }
+
+    /// <summary>
+    /// A whole packet held in pooled memory. <see cref="Array"/> is only valid
+    /// until the packet is disposed.
+    /// </summary>
+    public sealed class PooledPacket : IDisposable
+    {
+        private PooledChunk _chunk;
+
+        public byte[] Array { get; }
+        public int Offset { get; }
+        public int Count { get; }
+
+        /// <summary>
+        /// The packet's bytes, valid until the packet is disposed
+        /// </summary>
+        public ReadOnlySpan<byte> Span => new ReadOnlySpan<byte>(Array, Offset, Count);
+
+        /// <summary>
+        /// The packet's bytes, valid until the packet is disposed
+        /// </summary>
+        public ReadOnlyMemory<byte> Memory => new ReadOnlyMemory<byte>(Array, Offset, Count);
+
+        internal PooledPacket(PooledChunk chunk, int offset, int count)
+        {
+            chunk.Retain();
+            _chunk = chunk;
+            Array = chunk.Buffer;
+            Offset = offset;
+            Count = count;
+        }
+
+        /// <summary>
+        /// Another packet over the same bytes, for a second receiver. Each
+        /// packet is disposed separately and the memory returns to the pool
+        /// when all are.
+        /// </summary>
+        public PooledPacket Share()
+            => new PooledPacket(_chunk ?? throw new ObjectDisposedException(nameof(PooledPacket)), Offset, Count);
+
+        public void Dispose()
+        {
+            Interlocked.Exchange(ref _chunk, null)?.Release();
+        }
+    }
+}
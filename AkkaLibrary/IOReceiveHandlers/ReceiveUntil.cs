@@ -3,127 +3,149 @@ using System.Collections.Generic;
 using System.Linq;
 using System.Text;
 using Akka.Actor;
-using NETCoreAsio.DataStructures;
-using NETCoreAsio.Interfaces;
 
 namespace AkkaLibrary.IOReceiveHandlers
 {
+    /// <summary>
+    /// Splits data read from a port into frames with a <see cref="FrameParser"/>
+    ///
+    /// Each frame is sent to the sender of the read as a
+    /// <see cref="FrameReceived"/> holding a pooled slice of the received
+    /// data, which the receiver must dispose. A read carrying an
+    /// <see cref="IOReadResult.Ack"/> is confirmed to its sender once parsed.
+    /// The parser is created again when the actor restarts.
+    /// </summary>
     public class ReceiveUntilActor : ReceiveActor
     {
+        public const int DefaultMaxFrameLength = 10000;
+
         public ReceiveUntilActor(string name, string delimiter) : this(name, Encoding.ASCII.GetBytes(delimiter))
         {
         }
 
         public ReceiveUntilActor(string name, byte delimiter) : this(name, new []{ delimiter })
         {
-            //Create match condition
-            _matchCondition = (start, end) =>
-            {
-                for (var i = start; i < end; ++i)
-                {
-                    if (_buffer[i] == delimiter)
-                    {
-                        return new Tuple<int, bool>(i + 1, true);
-                    }
-                }
-                return new Tuple<int, bool>(end, false);
-            };
         }
 
-        public ReceiveUntilActor(string name, byte[] delimiter) : this(name)
+        public ReceiveUntilActor(string name, byte[] delimiter) : this(name, () => FrameParser.Delimited(delimiter, DefaultMaxFrameLength))
         {
-            _matchCondition = (start, end) =>
-            {
-                var length = delimiter.Length;
-                for (var i = start; i <= end - length; ++i)
-                {
-                    var match = true;
-                    for (var j = 0; j < length; ++j)
-                    {
-                        if (_buffer[i + j] != delimiter[j])
-                        {
-                            match = false;
-                            break;
-                        }
-                    }
-                    if (match)
-                    {
-                        return new Tuple<int, bool>(i + length, true);
-                    }
-                }
-                return new Tuple<int, bool>(Math.Max(0, end - length), false);
-            };
         }
 
-        protected ReceiveUntilActor(string name) : base()
+        /// <param name="name">Name of the receiver</param>
+        /// <param name="createParser">Creates the parser that decides the framing</param>
+        public ReceiveUntilActor(string name, Func<FrameParser> createParser)
         {
-            _buffer = new CircularQueue<byte>(10000, true);                        
+            _name = name;
+            _parser = createParser();
+
+            Ready();
         }
 
         private void Ready()
         {
             Receive<IOReadResult>(msg =>
             {
-                foreach (var b in msg.ReadResult)
+                try
                 {
-                    _buffer.Add(b);
-                }
+                    using (msg)
+                    {
+                        _parser.Write(msg.Span);
+                    }
 
-                if (_buffer.Count > 0)
-                {
-                    var match = false;
-                    
-                    do
+                    while(_parser.TryRead(out var frame))
                     {
-                        var result = _matchCondition(_matchOffset, _buffer.Count);
-                        if (result.Item2)
-                        {
-                            //Success with offset 0
-                            Sender.Tell(result.Item1);
-                            match = true;
-                        }
-                        else if (_buffer.Count == _buffer.Capacity)
-                        {
-                            //Error. No buffer space available. Drop the buffer.
-                            _buffer.Clear();
-                            match = false;
-                        }
-                        else
-                        {
-                            //Normally request another read here. Wait until data arrives and retain the offset from the match condition
-                            _matchOffset = result.Item1;
-                            match = false;
-                        }
-                    } while (match);                
+                        Sender.Tell(new FrameReceived(_name, frame));
+                    }
                 }
-                else
+                finally
                 {
-                    //Request more data from the port. 0 is the match offset.
-                    _matchOffset = 0;
+                    if(msg.Ack != null)
+                    {
+                        Sender.Tell(msg.Ack);
+                    }
                 }
             });
         }
 
-        private int _matchOffset;
-        private MatchCondition _matchCondition;
-        private readonly CircularQueue<byte> _buffer;
+        protected override void PostStop()
+        {
+            _parser.Dispose();
+            base.PostStop();
+        }
+
+        private readonly string _name;
+        private readonly FrameParser _parser;
 
         public static Props GetProps(string name, string delimiter) => GetProps(name, Encoding.ASCII.GetBytes(delimiter));
 
         public static Props GetProps(string name, byte[] delimiter) => Props.Create(() => new ReceiveUntilActor(name, delimiter));
 
+        public static Props GetProps(string name, Func<FrameParser> createParser) => Props.Create(() => new ReceiveUntilActor(name, createParser));
+
         #region Messages
 
-        public sealed class IOReadResult
+        /// <summary>
+        /// Data read from a port. The receiver disposes it once written to the parser.
+        /// </summary>
+        public sealed class IOReadResult : IDisposable
         {
-            public IReadOnlyList<byte> ReadResult { get; }
+            private readonly byte[] _bytes;
+            private readonly PooledPacket _packet;
+
+            /// <summary>
+            /// The bytes read. Copies a pooled read.
+            /// </summary>
+            public IReadOnlyList<byte> ReadResult => _bytes ?? _packet.Span.ToArray();
+
+            internal ReadOnlySpan<byte> Span => _packet != null ? _packet.Span : _bytes;
+
+            /// <summary>
+            /// Told to the sender once the read has been parsed. Null for no reply.
+            /// </summary>
+            public object Ack { get; }
 
             public IOReadResult(IEnumerable<byte> result)
             {
-                ReadResult = result.ToArray();
+                _bytes = result.ToArray();
             }
+
+            /// <summary>
+            /// Wraps a read buffer without copying it. The buffer must not change afterwards.
+            /// </summary>
+            public IOReadResult(byte[] result)
+            {
+                _bytes = result;
+            }
+
+            /// <summary>
+            /// Wraps a pooled read without copying it
+            /// </summary>
+            public IOReadResult(PooledPacket packet, object ack = null)
+            {
+                _packet = packet;
+                Ack = ack;
+            }
+
+            public void Dispose() => _packet?.Dispose();
+        }
+
+        /// <summary>
+        /// A whole frame. Dispose the frame once read to return its memory to the pool.
+        /// </summary>
+        public sealed class FrameReceived : IDisposable
+        {
+            public string Name { get; }
+            public PooledPacket Frame { get; }
+
+            public FrameReceived(string name, PooledPacket frame)
+            {
+                Name = name;
+                Frame = frame;
+            }
+
+            public void Dispose() => Frame.Dispose();
         }
 
         #endregion
     }
-}
\ No newline at end of file
+}
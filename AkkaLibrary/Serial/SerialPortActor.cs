@@ -1,22 +1,28 @@
 using System;
-using System.Linq;
 using System.Text;
-using System.Threading.Tasks;
 using Akka.Actor;
-using RJCP.IO.Ports;
-using NETCoreAsio.DataStructures;
 using Akka.Event;
+using Akka.Streams;
+using Akka.Streams.Dsl;
 using AkkaLibrary.Common.Logging;
+using RJCP.IO.Ports;
 
 namespace AkkaLibrary.Serial
 {
+    /// <summary>
+    /// Reads an open serial port through a <see cref="SerialPortSource"/>
+    ///
+    /// Reads are sent to the supervisor as <see cref="PortReadResult"/>s, one
+    /// per coalesced read, and the next is only sent once the supervisor has
+    /// replied <see cref="Ack"/>, so a busy supervisor pauses the port. The
+    /// supervisor disposes each read to return its memory to the pool.
+    /// </summary>
     public class SerialPortReadActor : ReceiveActor
     {
         private readonly ILoggingAdapter _logger;
 
         public SerialPortReadActor(string name, IActorRef supervisor)
         {
-            _buffer = new CircularQueue<byte>(10000, false);
             _supervisor = supervisor;
 
             _logger = Context.WithIdentity("SerialPortReader");
@@ -38,9 +44,9 @@ namespace AkkaLibrary.Serial
                     port.Open();
                     if(port.IsOpen)
                     {
-                        _port = port;
+                        _portName = port.PortName;
+                        _killSwitch = Read(port, msg.Policy);
                         Become(Running);
-                        Self.Tell(new AsyncReceive());
                     }
                 }
                 catch(Exception ex)
@@ -53,32 +59,6 @@ namespace AkkaLibrary.Serial
 
         private void Running()
         {
-            Receive<AsyncReceive>(msg =>
-            {
-                //Read into buffer
-                var buffer = _buffer.ArraySegmentsFree.First();
-                
-                _port
-                .ReadAsync(buffer.Array, buffer.Offset, buffer.Count)
-                .ContinueWith(bytes =>
-                {
-                    var bytesTransferred = bytes.Result;
-                    _buffer.UpdateAfterItemsReceived(bytesTransferred);
-
-                    var resultBuffer = new byte[bytesTransferred];
-
-                    _buffer.CopyTo(0, resultBuffer, 0, bytesTransferred);
-                    _buffer.Drop(bytesTransferred);
-                    
-                    _logger.Info($"Buffer Count:{_buffer.Count} and number of bytes parsed:{bytesTransferred}");
-
-                    Self.Tell(new AsyncReceive());
-
-                    return new PortReadResult(_port.PortName,resultBuffer);
-                }, TaskContinuationOptions.AttachedToParent & TaskContinuationOptions.ExecuteSynchronously)
-                .PipeTo(_supervisor);
-            });
-
             Receive<ClosePortRequest>(result =>
             {
                 ClosePort();
@@ -87,25 +67,44 @@ namespace AkkaLibrary.Serial
 
             Receive<OpenPortRequest>(msg =>
             {
-                _logger.Error($"Port {_port.PortName} is already open. Request that this port be closed and reopened or open another port.");
+                _logger.Error($"Port {_portName} is already open. Request that this port be closed and reopened or open another port.");
             });
         }
 
+        /// <summary>
+        /// Streams the port to the supervisor. The port closes when the stream stops.
+        /// </summary>
+        private IKillSwitch Read(SerialPortStream port, SerialReadPolicy policy)
+        {
+            var portName = port.PortName;
+
+            return SerialPortSource.FromPort(port, policy)
+                                   .ViaMaterialized(KillSwitches.Single<PooledPacket>(), Keep.Right)
+                                   .Select(packet => new PortReadResult(portName, packet))
+                                   .To(Sink.ActorRefWithAck<PortReadResult>(_supervisor, StreamInit.Instance, Ack.Instance, new PortClosed(portName)))
+                                   .Run(Context.Materializer());
+        }
+
         private void ClosePort()
         {
-            _logger.Info($"Closing serial port {_port.PortName}");            
-            _port.Close();
-            _port.Dispose();
+            if(_killSwitch == null)
+            {
+                return;
+            }
+
+            _logger.Info($"Closing serial port {_portName}");
+            _killSwitch.Shutdown();
+            _killSwitch = null;
         }
 
-        public override void AroundPostStop()
+        protected override void PostStop()
         {
-            ClosePort();            
-            base.AroundPostStop();
+            ClosePort();
+            base.PostStop();
         }
 
-        private SerialPortStream _port;
-        private CircularQueue<byte> _buffer;
+        private string _portName;
+        private IKillSwitch _killSwitch;
         private readonly IActorRef _supervisor;
 
 
@@ -120,10 +119,16 @@ namespace AkkaLibrary.Serial
 
             public int BaudRate { get; }
 
-            public OpenPortRequest(string name, int baudRate)
+            /// <summary>
+            /// When reads are passed on. Defaults to <see cref="SerialReadPolicy.Immediate"/>.
+            /// </summary>
+            public SerialReadPolicy Policy { get; }
+
+            public OpenPortRequest(string name, int baudRate, SerialReadPolicy policy = null)
             {
                 PortName = name;
                 BaudRate = baudRate;
+                Policy = policy;
             }
         }
 
@@ -158,18 +163,50 @@ namespace AkkaLibrary.Serial
             }
         }
 
-        private sealed class AsyncReceive { }
+        /// <summary>
+        /// Sent to the supervisor before the first read. Reply with <see cref="Ack"/>.
+        /// </summary>
+        public sealed class StreamInit
+        {
+            public static StreamInit Instance { get; } = new StreamInit();
+        }
+
+        /// <summary>
+        /// Requests the next read
+        /// </summary>
+        public sealed class Ack
+        {
+            public static Ack Instance { get; } = new Ack();
+        }
+
+        /// <summary>
+        /// Sent to the supervisor when the port has been closed or reached its end
+        /// </summary>
+        public sealed class PortClosed
+        {
+            public string PortName { get; }
+
+            public PortClosed(string portName)
+            {
+                PortName = portName;
+            }
+        }
 
-        public sealed class PortReadResult
+        /// <summary>
+        /// A read from the port. Dispose it once read to return its memory to the pool.
+        /// </summary>
+        public sealed class PortReadResult : IDisposable
         {
             public string PortName { get; }
-            public byte[] Buffer { get; }
+            public PooledPacket Packet { get; }
 
-            public PortReadResult(string portName, byte[] buffer)
+            public PortReadResult(string portName, PooledPacket packet)
             {
                 PortName = portName;
-                Buffer = buffer;
+                Packet = packet;
             }
+
+            public void Dispose() => Packet.Dispose();
         }
 
         #endregion
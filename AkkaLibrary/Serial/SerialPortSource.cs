@@ -0,0 +1,321 @@
+using System;
+using System.Buffers;
+using System.Diagnostics;
+using System.IO;
+using System.Threading.Tasks;
+using Akka;
+using Akka.Streams;
+using Akka.Streams.Dsl;
+using Akka.Streams.Stage;
+using AkkaLibrary.Common.Metrics;
+using RJCP.IO.Ports;
+
+namespace AkkaLibrary.Serial
+{
+    /// <summary>
+    /// When <see cref="SerialPortSource"/> emits the bytes it has read
+    ///
+    /// Bytes are emitted once at least <see cref="MinBytes"/> have been read
+    /// or the oldest has waited <see cref="MaxLatency"/>, whichever is
+    /// sooner. A larger minimum means fewer, larger elements and fewer
+    /// wakeups downstream at the cost of latency.
+    /// </summary>
+    public sealed class SerialReadPolicy
+    {
+        /// <summary>
+        /// Emits whatever each read returns
+        /// </summary>
+        public static SerialReadPolicy Immediate { get; } = new SerialReadPolicy(1, TimeSpan.FromMilliseconds(1));
+
+        public int MinBytes { get; }
+
+        public TimeSpan MaxLatency { get; }
+
+        /// <summary>
+        /// Length of each pooled buffer. Reads pause when downstream has not
+        /// taken a full buffer.
+        /// </summary>
+        public int BufferLength { get; }
+
+        public SerialReadPolicy(int minBytes, TimeSpan maxLatency, int bufferLength = 16 * 1024)
+        {
+            if(minBytes < 1)
+            {
+                throw new ArgumentException("Minimum must be at least one byte.", nameof(minBytes));
+            }
+            if(maxLatency <= TimeSpan.Zero)
+            {
+                throw new ArgumentException("Latency must be positive.", nameof(maxLatency));
+            }
+            if(bufferLength < minBytes)
+            {
+                throw new ArgumentException("Buffer must hold at least the minimum number of bytes.", nameof(bufferLength));
+            }
+
+            MinBytes = minBytes;
+            MaxLatency = maxLatency;
+            BufferLength = bufferLength;
+        }
+    }
+
+    /// <summary>
+    /// Source of the bytes read from a serial port, or any other stream,
+    /// as slices of pooled buffers
+    ///
+    /// Reads go straight into a buffer rented from <see cref="ArrayPool{T}.Shared"/>
+    /// and are emitted as <see cref="PooledPacket"/>s, which downstream must
+    /// dispose. Bytes read while downstream is busy are coalesced into the
+    /// next element. Once a whole buffer is waiting, reads pause until
+    /// downstream pulls, so a slow consumer holds data back in the port's own
+    /// buffer rather than in memory.
+    ///
+    /// Publishes "{name}.Bytes", "{name}.BytesPerSecond" and "{name}.Pauses",
+    /// counting each time reads paused for downstream. Sources made by
+    /// <see cref="FromPort"/> also count "{name}.Overruns" reported by the port.
+    /// </summary>
+    public class SerialPortSource : GraphStage<SourceShape<PooledPacket>>
+    {
+        private readonly string _name;
+        private readonly Func<Stream> _open;
+        private readonly SerialReadPolicy _policy;
+        private readonly Counter _bytes;
+        private readonly Gauge _bytesPerSecond;
+        private readonly Counter _pauses;
+
+        /// <param name="name">Name of the port, used as the metric prefix</param>
+        /// <param name="open">Opens the stream to read. The stream is disposed when the stage stops.</param>
+        /// <param name="policy">When to emit. Defaults to <see cref="SerialReadPolicy.Immediate"/>.</param>
+        /// <param name="registry">Registry to publish to. Defaults to <see cref="MetricsRegistry.Default"/>.</param>
+        public SerialPortSource(string name, Func<Stream> open, SerialReadPolicy policy = null, MetricsRegistry registry = null)
+        {
+            registry = registry ?? MetricsRegistry.Default;
+
+            _name = name;
+            _open = open;
+            _policy = policy ?? SerialReadPolicy.Immediate;
+            _bytes = registry.Counter($"{name}.Bytes");
+            _bytesPerSecond = registry.Gauge($"{name}.BytesPerSecond");
+            _pauses = registry.Counter($"{name}.Pauses");
+
+            Shape = new SourceShape<PooledPacket>(Out);
+        }
+
+        /// <summary>
+        /// Source over a stream opened by <paramref name="open"/>
+        /// </summary>
+        public static Source<PooledPacket, NotUsed> Create(string name, Func<Stream> open, SerialReadPolicy policy = null, MetricsRegistry registry = null)
+            => Source.FromGraph(new SerialPortSource(name, open, policy, registry));
+
+        /// <summary>
+        /// Source over an open serial port
+        /// </summary>
+        public static Source<PooledPacket, NotUsed> FromPort(SerialPortStream port, SerialReadPolicy policy = null, MetricsRegistry registry = null)
+        {
+            registry = registry ?? MetricsRegistry.Default;
+
+            var overruns = registry.Counter($"{port.PortName}.Overruns");
+            port.ErrorReceived += (sender, e) =>
+            {
+                if(e.EventType == SerialError.Overrun || e.EventType == SerialError.RXOver)
+                {
+                    overruns.Increment();
+                }
+            };
+
+            return Create(port.PortName, () => port, policy, registry);
+        }
+
+        public Outlet<PooledPacket> Out { get; } = new Outlet<PooledPacket>("SerialPortSource.Out");
+
+        public override SourceShape<PooledPacket> Shape { get; }
+
+        public override string ToString() => $"SerialPortSource({_name})";
+
+        protected override Attributes InitialAttributes => Attributes.CreateName("SerialPortSource");
+
+        protected override GraphStageLogic CreateLogic(Attributes inheritedAttributes) => new Logic(this);
+
+        private sealed class Logic : TimerGraphStageLogic, IOutHandler
+        {
+            private const string FlushTimer = "Flush";
+            private const string RateTimer = "Rate";
+
+            private readonly SerialPortSource _source;
+            private readonly SerialReadPolicy _policy;
+            private Action<Task<int>> _onRead;
+            private Stream _stream;
+
+            // Bytes from _start to _write have been read but not emitted
+            private PooledChunk _chunk;
+            private int _start;
+            private int _write;
+
+            private bool _reading;
+            private bool _paused;
+            private bool _flushDue;
+            private bool _ended;
+            private long _bytesAtLastTick;
+            private long _lastTick;
+
+            public Logic(SerialPortSource source) : base(source.Shape)
+            {
+                _source = source;
+                _policy = source._policy;
+
+                SetHandler(source.Out, this);
+            }
+
+            private int Pending => _write - _start;
+
+            public override void PreStart()
+            {
+                _onRead = GetAsyncCallback<Task<int>>(OnRead);
+                _stream = _source._open();
+                _chunk = new PooledChunk(ArrayPool<byte>.Shared, _policy.BufferLength);
+
+                _lastTick = Stopwatch.GetTimestamp();
+                _bytesAtLastTick = _source._bytes.Value;
+                ScheduleRepeatedly(RateTimer, TimeSpan.FromSeconds(1));
+
+                Read();
+            }
+
+            public void OnPull()
+            {
+                TryEmit();
+                Read();
+            }
+
+            public void OnDownstreamFinish() => CompleteStage();
+
+            protected override void OnTimer(object timerKey)
+            {
+                if(FlushTimer.Equals(timerKey))
+                {
+                    _flushDue = true;
+                    TryEmit();
+                    return;
+                }
+
+                var now = Stopwatch.GetTimestamp();
+                var bytes = _source._bytes.Value;
+                _source._bytesPerSecond.Set((long)((bytes - _bytesAtLastTick) * (double)Stopwatch.Frequency / (now - _lastTick)));
+                _bytesAtLastTick = bytes;
+                _lastTick = now;
+            }
+
+            public override void PostStop()
+            {
+                _stream?.Dispose();
+                _chunk?.Release();
+                _chunk = null;
+            }
+
+            /// <summary>
+            /// Starts a read into the free end of the buffer unless one is running
+            /// </summary>
+            private void Read()
+            {
+                if(_reading || _ended)
+                {
+                    return;
+                }
+
+                if(_write == _chunk.Buffer.Length && !MakeRoom())
+                {
+                    if(!_paused)
+                    {
+                        _paused = true;
+                        _source._pauses.Increment();
+                    }
+                    return;
+                }
+                _paused = false;
+                _reading = true;
+
+                // The read holds its own reference so the buffer is not returned
+                // to the pool while the port can still write into it
+                var chunk = _chunk;
+                chunk.Retain();
+                _stream.ReadAsync(chunk.Buffer, _write, chunk.Buffer.Length - _write)
+                       .ContinueWith(read =>
+                       {
+                           chunk.Release();
+                           _onRead(read);
+                       }, TaskContinuationOptions.ExecuteSynchronously);
+            }
+
+            private void OnRead(Task<int> read)
+            {
+                _reading = false;
+
+                if(read.IsFaulted || read.IsCanceled)
+                {
+                    FailStage(read.Exception?.GetBaseException() ?? new TaskCanceledException(read));
+                    return;
+                }
+
+                if(read.Result == 0)
+                {
+                    _ended = true;
+                    _flushDue = true;
+                    TryEmit();
+                    return;
+                }
+
+                _write += read.Result;
+                _source._bytes.Add(read.Result);
+
+                // The oldest pending byte may wait at most the latency for the minimum
+                if(Pending < _policy.MinBytes && !IsTimerActive(FlushTimer))
+                {
+                    ScheduleOnce(FlushTimer, _policy.MaxLatency);
+                }
+
+                TryEmit();
+                Read();
+            }
+
+            /// <summary>
+            /// Emits the pending bytes if downstream wants them and the policy allows
+            /// </summary>
+            private void TryEmit()
+            {
+                if(Pending > 0 && IsAvailable(_source.Out) && (Pending >= _policy.MinBytes || _flushDue))
+                {
+                    Push(_source.Out, new PooledPacket(_chunk, _start, Pending));
+                    _start = _write;
+                    _flushDue = false;
+                    CancelTimer(FlushTimer);
+                }
+
+                if(_ended && Pending == 0)
+                {
+                    CompleteStage();
+                }
+            }
+
+            /// <summary>
+            /// Moves the pending bytes to a fresh buffer. Fails when a whole
+            /// buffer is waiting for downstream.
+            /// </summary>
+            private bool MakeRoom()
+            {
+                if(Pending == _chunk.Buffer.Length)
+                {
+                    return false;
+                }
+
+                var pending = Pending;
+                var next = new PooledChunk(ArrayPool<byte>.Shared, _policy.BufferLength);
+                Buffer.BlockCopy(_chunk.Buffer, _start, next.Buffer, 0, pending);
+                _chunk.Release();
+
+                _chunk = next;
+                _start = 0;
+                _write = pending;
+                return true;
+            }
+        }
+    }
+}
@@ -6,11 +6,20 @@ using AkkaLibrary.IOReceiveHandlers;
 
 namespace AkkaLibrary.Serial
 {
+    /// <summary>
+    /// Opens serial ports and hands their reads to the receivers registered for each port
+    ///
+    /// A port's reader is only acked once every receiver has parsed the
+    /// previous read, so a slow receiver pauses the port instead of queueing
+    /// reads in its mailbox.
+    /// </summary>
     public class SerialPortSupervisor : ReceiveActor
     {
         public SerialPortSupervisor(string name)
         {
             _logger = Context.WithIdentity(name);
+
+            Ready();
         }
 
         private void Ready()
@@ -39,20 +48,49 @@ namespace AkkaLibrary.Serial
                 }
             });
 
-            Receive<int>(msg =>
+            Receive<ReceiveUntilActor.FrameReceived>(msg =>
             {
-                _logger.Warning($"Bytes:{msg}");
+                using (msg)
+                {
+                    _logger.Warning($"Bytes:{msg.Frame.Count}");
+                }
             });
 
+            Receive<SerialPortReadActor.StreamInit>(msg => Sender.Tell(SerialPortReadActor.Ack.Instance));
+
             Receive<SerialPortReadActor.PortReadResult>(msg =>
             {
-                if(_portDataReceivers.ContainsKey(msg.PortName))
+                using (msg)
                 {
-                    foreach (var actor in _portDataReceivers[msg.PortName])
+                    if(_portDataReceivers.TryGetValue(msg.PortName, out var receivers) && receivers.Count > 0)
                     {
-                        actor.Tell(new ReceiveUntilActor.IOReadResult(msg.Buffer));
+                        // Each receiver holds its own reference to the pooled read
+                        var parsed = new ReadParsed(msg.PortName);
+                        _pendingReads[msg.PortName] = new PendingRead(Sender, receivers.Count);
+                        foreach (var actor in receivers)
+                        {
+                            actor.Tell(new ReceiveUntilActor.IOReadResult(msg.Packet.Share(), parsed));
+                        }
+                        return;
                     }
                 }
+
+                // Lets the port reader pass on its next read
+                Sender.Tell(SerialPortReadActor.Ack.Instance);
+            });
+
+            Receive<ReadParsed>(msg =>
+            {
+                if(_pendingReads.TryGetValue(msg.PortName, out var pending) && --pending.Remaining == 0)
+                {
+                    _pendingReads.Remove(msg.PortName);
+                    pending.Reader.Tell(SerialPortReadActor.Ack.Instance);
+                }
+            });
+
+            Receive<SerialPortReadActor.PortClosed>(msg =>
+            {
+                _logger.Info($"Serial port {msg.PortName} closed.");
             });
         }
 
@@ -61,6 +99,11 @@ namespace AkkaLibrary.Serial
         private Dictionary<string, IActorRef> _portHandlers = new Dictionary<string, IActorRef>();
 
         private Dictionary<string, List<IActorRef>> _portDataReceivers = new Dictionary<string, List<IActorRef>>();
+
+        /// <summary>
+        /// The read of each port waiting for its receivers. A port has at most one read in flight.
+        /// </summary>
+        private Dictionary<string, PendingRead> _pendingReads = new Dictionary<string, PendingRead>();
         private readonly ILoggingAdapter _logger;
 
         #region Messages
@@ -80,8 +123,38 @@ namespace AkkaLibrary.Serial
         public class ReceiveUntilOnPort
         {
             public string PortName { get; }
+
+            public ReceiveUntilOnPort(string portName)
+            {
+                PortName = portName;
+            }
+        }
+
+        /// <summary>
+        /// A receiver has parsed the last read of the port
+        /// </summary>
+        private sealed class ReadParsed
+        {
+            public string PortName { get; }
+
+            public ReadParsed(string portName)
+            {
+                PortName = portName;
+            }
         }
 
         #endregion
+
+        private sealed class PendingRead
+        {
+            public IActorRef Reader { get; }
+            public int Remaining { get; set; }
+
+            public PendingRead(IActorRef reader, int remaining)
+            {
+                Reader = reader;
+                Remaining = remaining;
+            }
+        }
     }
 }
\ No newline at end of file
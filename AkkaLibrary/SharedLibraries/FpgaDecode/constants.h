@@ -0,0 +1,25 @@
+#ifndef FPGA_CONSTANTS_H
+#define FPGA_CONSTANTS_H
+
+#include <stdint.h>
+
+// Channel type codes. These match the values of the managed ChannelType enum.
+const int32_t CHANNEL_NOT_SET = 0;
+const int32_t CHANNEL_UINT32 = 1;
+const int32_t CHANNEL_INT16 = 2;
+const int32_t CHANNEL_INT24 = 3;
+const int32_t CHANNEL_INT32 = 4;
+const int32_t CHANNEL_FLOAT = 5;
+const int32_t CHANNEL_DOUBLE = 6;
+const int32_t CHANNEL_BOOL = 7;
+
+// Number of column groups, one per channel type excluding CHANNEL_NOT_SET
+const int COLUMN_GROUPS = 7;
+
+// Return codes
+const int FPGA_OK = 0;
+const int FPGA_INVALID_ARGUMENT = 1;
+const int FPGA_UNKNOWN_CHANNEL_TYPE = 2;
+const int FPGA_PACKET_TOO_SHORT = 3;
+
+#endif
@@ -0,0 +1,182 @@
+#include <string.h>
+#ifdef DEBUG
+#include <iostream>
+#endif
+
+#include "fpgadecode.h"
+#include "int24.h"
+
+using namespace std;
+
+static int channelSize(int32_t type)
+{
+    switch(type)
+    {
+        case CHANNEL_UINT32: return 4;
+        case CHANNEL_INT16: return 2;
+        case CHANNEL_INT24: return 3;
+        case CHANNEL_INT32: return 4;
+        case CHANNEL_FLOAT: return 4;
+        case CHANNEL_DOUBLE: return 8;
+        default: return -1;
+    }
+}
+
+DecodePlan::DecodePlan(const int32_t channelTypes[], int channelCount, int samplesPerPacket)
+    : allInt24(false), digitalOffset(0), digitalCount(0), sampleLength(0), samplesPerPacket(samplesPerPacket), valid(true)
+{
+    memset(columnCounts, 0, sizeof(columnCounts));
+
+    int offset = 0;
+    for(int i = 0; i < channelCount; i++)
+    {
+        int32_t type = channelTypes[i];
+
+        if(type == CHANNEL_BOOL)
+        {
+            // Digitals are packed together after the analogs
+            digitalCount++;
+            continue;
+        }
+
+        int size = channelSize(type);
+        if(size < 0)
+        {
+            #ifdef DEBUG
+                cout << "Unknown channel type " << type << " at index " << i << endl;
+            #endif
+            valid = false;
+            return;
+        }
+
+        ChannelStep step;
+        step.type = type;
+        step.offset = offset;
+        step.column = columnCounts[type]++;
+        steps.push_back(step);
+
+        offset += size;
+    }
+
+    columnCounts[CHANNEL_BOOL] = digitalCount;
+    digitalOffset = offset;
+    sampleLength = offset + (digitalCount + 7) / 8;
+
+    // With only Int24 channels the packet is one contiguous 24-bit buffer
+    allInt24 = digitalCount == 0 && columnCounts[CHANNEL_INT24] == (int)steps.size();
+    if(allInt24)
+    {
+        int24Scratch.resize(steps.size() * samplesPerPacket);
+    }
+}
+
+int DecodePlan::getColumnCount(int32_t channelType) const
+{
+    if(channelType <= CHANNEL_NOT_SET || channelType > COLUMN_GROUPS)
+    {
+        return 0;
+    }
+    return columnCounts[channelType];
+}
+
+// Copies one little-endian value per sample into a column
+template <typename T>
+static inline void decodeColumn(const uint8_t *src, int stride, int samples, T *column)
+{
+    for(int s = 0; s < samples; s++, src += stride)
+    {
+        T value;
+        memcpy(&value, src, sizeof(T));
+        column[s] = value;
+    }
+}
+
+static inline void decodeInt24Column(const uint8_t *src, int stride, int samples, int32_t *column)
+{
+    for(int s = 0; s < samples; s++, src += stride)
+    {
+        // Place the three bytes in the top of the word then shift back down
+        // to sign-extend
+        uint32_t raw = ((uint32_t)src[0] << 8) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 24);
+        column[s] = ((int32_t)raw) >> 8;
+    }
+}
+
+int DecodePlan::decode(const uint8_t *packet, int length, const FpgaColumns &columns) const
+{
+    if(!valid)
+    {
+        return FPGA_UNKNOWN_CHANNEL_TYPE;
+    }
+    if(length < getPacketLength())
+    {
+        #ifdef DEBUG
+            cout << "Packet of " << length << " bytes is shorter than " << getPacketLength() << endl;
+        #endif
+        return FPGA_PACKET_TOO_SHORT;
+    }
+
+    const int n = samplesPerPacket;
+    const int stride = sampleLength;
+
+    if(allInt24)
+    {
+        const int channels = (int)steps.size();
+        int32_t *rows = &int24Scratch[0];
+        int24ToInt32(packet, rows, channels * n);
+
+        for(int c = 0; c < channels; c++)
+        {
+            int32_t *column = columns.int24s + c * n;
+            for(int s = 0; s < n; s++)
+            {
+                column[s] = rows[s * channels + c];
+            }
+        }
+        return FPGA_OK;
+    }
+
+    for(size_t i = 0; i < steps.size(); i++)
+    {
+        const ChannelStep &step = steps[i];
+        const uint8_t *src = packet + step.offset;
+        const int base = step.column * n;
+
+        switch(step.type)
+        {
+            case CHANNEL_UINT32:
+                decodeColumn<uint32_t>(src, stride, n, columns.uint32s + base);
+                break;
+            case CHANNEL_INT16:
+                decodeColumn<int16_t>(src, stride, n, columns.int16s + base);
+                break;
+            case CHANNEL_INT24:
+                decodeInt24Column(src, stride, n, columns.int24s + base);
+                break;
+            case CHANNEL_INT32:
+                decodeColumn<int32_t>(src, stride, n, columns.int32s + base);
+                break;
+            case CHANNEL_FLOAT:
+                decodeColumn<float>(src, stride, n, columns.floats + base);
+                break;
+            case CHANNEL_DOUBLE:
+                decodeColumn<double>(src, stride, n, columns.doubles + base);
+                break;
+        }
+    }
+
+    // Unpack digitals least significant bit first
+    for(int d = 0; d < digitalCount; d++)
+    {
+        const uint8_t *src = packet + digitalOffset + (d >> 3);
+        const uint8_t mask = (uint8_t)(1 << (d & 7));
+        uint8_t *column = columns.bools + d * n;
+
+        for(int s = 0; s < n; s++, src += stride)
+        {
+            column[s] = (*src & mask) != 0;
+        }
+    }
+
+    return FPGA_OK;
+}
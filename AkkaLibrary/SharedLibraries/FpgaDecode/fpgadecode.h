@@ -0,0 +1,70 @@
+// Include Guard
+#ifndef FPGADECODE_H
+#define FPGADECODE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "constants.h"
+
+/*
+ * Output columns for a decoded packet.
+ *
+ * Each pointer addresses a caller-owned array holding one column per channel
+ * of that type, each column samplesPerPacket long, in channel list order:
+ *     column[channel * samplesPerPacket + sample]
+ * Int24 values are sign-extended into int32. Bools are unpacked to one byte
+ * (0 or 1) per value.
+ */
+struct FpgaColumns
+{
+    uint32_t *uint32s;
+    int16_t *int16s;
+    int32_t *int24s;
+    int32_t *int32s;
+    float *floats;
+    double *doubles;
+    uint8_t *bools;
+};
+
+/*
+ * A decode plan compiled once from the channel list.
+ *
+ * Samples are laid out back to back in a packet. Within a sample, non-bool
+ * channels are packed little-endian in channel list order, followed by the
+ * digital channels packed least significant bit first.
+ */
+class DecodePlan
+{
+  private:
+    struct ChannelStep
+    {
+        int32_t type;
+        int offset;   // byte offset within the sample
+        int column;   // column index within the type
+    };
+
+    std::vector< ChannelStep > steps;
+    // Row-major scratch for packets made up only of Int24 channels, which
+    // are converted in one bulk pass and then transposed into columns
+    mutable std::vector< int32_t > int24Scratch;
+    bool allInt24;
+    int columnCounts[COLUMN_GROUPS + 1];
+    int digitalOffset;
+    int digitalCount;
+    int sampleLength;
+    int samplesPerPacket;
+    bool valid;
+
+  public:
+    DecodePlan(const int32_t channelTypes[], int channelCount, int samplesPerPacket);
+
+    bool isValid() const { return valid; }
+    int getSampleLength() const { return sampleLength; }
+    int getPacketLength() const { return sampleLength * samplesPerPacket; }
+    int getColumnCount(int32_t channelType) const;
+
+    int decode(const uint8_t *packet, int length, const FpgaColumns &columns) const;
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include "int24.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define INT24_X86
+#include <immintrin.h>
+#endif
+
+// Sign-extends three little-endian bytes by placing them in the top of the
+// word and shifting back down
+static inline int32_t readInt24(const uint8_t *src)
+{
+    uint32_t raw = ((uint32_t)src[0] << 8) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 24);
+    return ((int32_t)raw) >> 8;
+}
+
+static void int24ToInt32Scalar(const uint8_t *src, int32_t *dst, int count)
+{
+    for(int i = 0; i < count; i++, src += 3)
+    {
+        dst[i] = readInt24(src);
+    }
+}
+
+static void int24ToFloatScalar(const uint8_t *src, float *dst, int count, float scale)
+{
+    for(int i = 0; i < count; i++, src += 3)
+    {
+        dst[i] = (float)readInt24(src) * scale;
+    }
+}
+
+#ifdef INT24_X86
+
+/*
+ * Moves each group of three bytes into the top three bytes of a 32-bit lane,
+ * leaving the low byte zero, ready for an arithmetic shift right by 8.
+ */
+#define INT24_SHUFFLE_MASK \
+    -128, 0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11
+
+__attribute__((target("ssse3")))
+static inline __m128i loadInt24x4(const uint8_t *src, __m128i mask)
+{
+    // Reads 16 bytes of which the first 12 are used
+    __m128i bytes = _mm_loadu_si128((const __m128i *)src);
+    return _mm_srai_epi32(_mm_shuffle_epi8(bytes, mask), 8);
+}
+
+__attribute__((target("ssse3")))
+static void int24ToInt32Ssse3(const uint8_t *src, int32_t *dst, int count)
+{
+    const __m128i mask = _mm_setr_epi8(INT24_SHUFFLE_MASK);
+    int i = 0;
+    // Stop while a full 16 byte load is still inside the buffer
+    for(; i + 6 <= count; i += 4)
+    {
+        _mm_storeu_si128((__m128i *)(dst + i), loadInt24x4(src + i * 3, mask));
+    }
+    int24ToInt32Scalar(src + i * 3, dst + i, count - i);
+}
+
+__attribute__((target("ssse3")))
+static void int24ToFloatSsse3(const uint8_t *src, float *dst, int count, float scale)
+{
+    const __m128i mask = _mm_setr_epi8(INT24_SHUFFLE_MASK);
+    const __m128 scales = _mm_set1_ps(scale);
+    int i = 0;
+    for(; i + 6 <= count; i += 4)
+    {
+        __m128 values = _mm_cvtepi32_ps(loadInt24x4(src + i * 3, mask));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(values, scales));
+    }
+    int24ToFloatScalar(src + i * 3, dst + i, count - i, scale);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i loadInt24x8(const uint8_t *src, __m256i mask)
+{
+    // vpshufb works within 128-bit lanes so each lane gets its own 12 bytes
+    __m128i lo = _mm_loadu_si128((const __m128i *)src);
+    __m128i hi = _mm_loadu_si128((const __m128i *)(src + 12));
+    __m256i bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    return _mm256_srai_epi32(_mm256_shuffle_epi8(bytes, mask), 8);
+}
+
+__attribute__((target("avx2")))
+static void int24ToInt32Avx2(const uint8_t *src, int32_t *dst, int count)
+{
+    const __m256i mask = _mm256_setr_epi8(INT24_SHUFFLE_MASK, INT24_SHUFFLE_MASK);
+    int i = 0;
+    // The upper load reads bytes 12 to 27 of each group of 24
+    for(; i + 10 <= count; i += 8)
+    {
+        _mm256_storeu_si256((__m256i *)(dst + i), loadInt24x8(src + i * 3, mask));
+    }
+    int24ToInt32Ssse3(src + i * 3, dst + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void int24ToFloatAvx2(const uint8_t *src, float *dst, int count, float scale)
+{
+    const __m256i mask = _mm256_setr_epi8(INT24_SHUFFLE_MASK, INT24_SHUFFLE_MASK);
+    const __m256 scales = _mm256_set1_ps(scale);
+    int i = 0;
+    for(; i + 10 <= count; i += 8)
+    {
+        __m256 values = _mm256_cvtepi32_ps(loadInt24x8(src + i * 3, mask));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(values, scales));
+    }
+    int24ToFloatSsse3(src + i * 3, dst + i, count - i, scale);
+}
+
+#endif
+
+typedef void (*Int24ToInt32Kernel)(const uint8_t *, int32_t *, int);
+typedef void (*Int24ToFloatKernel)(const uint8_t *, float *, int, float);
+
+static Int24ToInt32Kernel selectInt32Kernel()
+{
+#ifdef INT24_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+    {
+        return int24ToInt32Avx2;
+    }
+    if(__builtin_cpu_supports("ssse3"))
+    {
+        return int24ToInt32Ssse3;
+    }
+#endif
+    return int24ToInt32Scalar;
+}
+
+static Int24ToFloatKernel selectFloatKernel()
+{
+#ifdef INT24_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+    {
+        return int24ToFloatAvx2;
+    }
+    if(__builtin_cpu_supports("ssse3"))
+    {
+        return int24ToFloatSsse3;
+    }
+#endif
+    return int24ToFloatScalar;
+}
+
+void int24ToInt32(const uint8_t *src, int32_t *dst, int count)
+{
+    static const Int24ToInt32Kernel kernel = selectInt32Kernel();
+    kernel(src, dst, count);
+}
+
+void int24ToFloat(const uint8_t *src, float *dst, int count, float scale)
+{
+    static const Int24ToFloatKernel kernel = selectFloatKernel();
+    kernel(src, dst, count, scale);
+}
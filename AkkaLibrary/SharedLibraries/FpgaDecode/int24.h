@@ -0,0 +1,16 @@
+// Include Guard
+#ifndef INT24_H
+#define INT24_H
+
+#include <stdint.h>
+
+/*
+ * Bulk conversion of packed little-endian 24-bit values.
+ *
+ * Uses AVX2 or SSSE3 byte shuffles when the CPU supports them and a scalar
+ * loop otherwise. The best available kernel is chosen once at first use.
+ */
+void int24ToInt32(const uint8_t *src, int32_t *dst, int count);
+void int24ToFloat(const uint8_t *src, float *dst, int count, float scale);
+
+#endif
@@ -0,0 +1,115 @@
+// Local headers
+#include "libfpgadecode.h"
+#include <new>
+#include <stddef.h>
+#ifdef DEBUG
+#include <iostream>
+#endif
+
+using namespace std;
+
+extern "C"
+{
+    int create_plan(const int32_t channel_types[], int32_t channel_count, int32_t samples_per_packet, void **plan)
+    {
+        if(plan == NULL || channel_types == NULL || channel_count <= 0 || samples_per_packet <= 0)
+        {
+            #ifdef DEBUG
+                cout << "create_plan called with invalid arguments" << endl;
+            #endif
+            return FPGA_INVALID_ARGUMENT;
+        }
+
+        DecodePlan *decodePlan = new (nothrow) DecodePlan(channel_types, channel_count, samples_per_packet);
+        if(decodePlan == NULL)
+        {
+            return FPGA_INVALID_ARGUMENT;
+        }
+
+        if(!decodePlan->isValid())
+        {
+            delete decodePlan;
+            return FPGA_UNKNOWN_CHANNEL_TYPE;
+        }
+
+        *plan = decodePlan;
+        return FPGA_OK;
+    }
+
+    int sample_length(void *plan)
+    {
+        if(plan == NULL)
+        {
+            return -1;
+        }
+        return static_cast<DecodePlan *>(plan)->getSampleLength();
+    }
+
+    int column_count(void *plan, int32_t channel_type)
+    {
+        if(plan == NULL)
+        {
+            return -1;
+        }
+        return static_cast<DecodePlan *>(plan)->getColumnCount(channel_type);
+    }
+
+    int decode_packet(
+        void *plan,
+        const uint8_t packet[],
+        int32_t length,
+        uint32_t uint32s[],
+        int16_t int16s[],
+        int32_t int24s[],
+        int32_t int32s[],
+        float floats[],
+        double doubles[],
+        uint8_t bools[])
+    {
+        if(plan == NULL || packet == NULL)
+        {
+            return FPGA_INVALID_ARGUMENT;
+        }
+
+        FpgaColumns columns;
+        columns.uint32s = uint32s;
+        columns.int16s = int16s;
+        columns.int24s = int24s;
+        columns.int32s = int32s;
+        columns.floats = floats;
+        columns.doubles = doubles;
+        columns.bools = bools;
+
+        return static_cast<DecodePlan *>(plan)->decode(packet, length, columns);
+    }
+
+    int destroy_plan(void *plan)
+    {
+        if(plan == NULL)
+        {
+            return FPGA_INVALID_ARGUMENT;
+        }
+        delete static_cast<DecodePlan *>(plan);
+        return FPGA_OK;
+    }
+
+    int int24_to_int32(const uint8_t src[], int32_t dst[], int32_t count)
+    {
+        if(src == NULL || dst == NULL || count < 0)
+        {
+            return FPGA_INVALID_ARGUMENT;
+        }
+        int24ToInt32(src, dst, count);
+        return FPGA_OK;
+    }
+
+    int int24_to_float(const uint8_t src[], float dst[], int32_t count, float scale)
+    {
+        if(src == NULL || dst == NULL || count < 0)
+        {
+            return FPGA_INVALID_ARGUMENT;
+        }
+        int24ToFloat(src, dst, count, scale);
+        return FPGA_OK;
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef LIBFPGADECODE_H
+#define LIBFPGADECODE_H
+
+#include "fpgadecode.h"
+#include "int24.h"
+#include "constants.h"
+
+/*
+ * Plans are opaque handles created by create_plan and released by
+ * destroy_plan. A plan may be used from one thread at a time.
+ */
+extern "C"
+{
+    int create_plan(const int32_t channel_types[], int32_t channel_count, int32_t samples_per_packet, void **plan);
+    int sample_length(void *plan);
+    int column_count(void *plan, int32_t channel_type);
+    int decode_packet(
+        void *plan,
+        const uint8_t packet[],
+        int32_t length,
+        uint32_t uint32s[],
+        int16_t int16s[],
+        int32_t int24s[],
+        int32_t int32s[],
+        float floats[],
+        double doubles[],
+        uint8_t bools[]);
+    int destroy_plan(void *plan);
+
+    // Bulk packed little-endian 24-bit conversion
+    int int24_to_int32(const uint8_t src[], int32_t dst[], int32_t count);
+    int int24_to_float(const uint8_t src[], float dst[], int32_t count, float scale);
+}
+
+#endif
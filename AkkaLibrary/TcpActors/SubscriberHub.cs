@@ -0,0 +1,257 @@
+using System;
+using System.Collections.Generic;
+using Akka.Actor;
+using AkkaLibrary.Common.Metrics;
+
+namespace AkkaLibrary.TcpActors
+{
+    /// <summary>
+    /// What a <see cref="SubscriberHub{T}"/> does when a subscriber's buffer is full
+    /// </summary>
+    public enum OverflowPolicy
+    {
+        /// <summary>
+        /// Drops the oldest buffered element to make room
+        /// </summary>
+        DropOldest,
+
+        /// <summary>
+        /// Drops the element being published
+        /// </summary>
+        DropNewest,
+
+        /// <summary>
+        /// Removes the subscriber
+        /// </summary>
+        Disconnect,
+
+        /// <summary>
+        /// Keeps the element and asks the producer to pause until the
+        /// subscriber has caught up to half its buffer
+        /// </summary>
+        Backpressure
+    }
+
+    /// <summary>
+    /// Fans elements out to subscriber actors, each with its own bounded buffer
+    ///
+    /// A subscriber is sent one element at a time and receives the next once
+    /// it has acknowledged the last, so its mailbox never holds more than one
+    /// element from the hub. Elements published meanwhile wait in the
+    /// subscriber's buffer of bufferSize, and what happens when that fills is
+    /// chosen per subscriber by <see cref="OverflowPolicy"/>, so one stalled
+    /// subscriber cannot hold up or exhaust memory for the rest. Every
+    /// subscriber is sent the same element instance.
+    ///
+    /// Publishes "{name}.{subscriber}.Lag" as the number of buffered elements,
+    /// plus "{name}.{subscriber}.Delivered" and "{name}.{subscriber}.Dropped".
+    /// A hub is owned by a single actor.
+    /// </summary>
+    public sealed class SubscriberHub<T>
+    {
+        private readonly string _name;
+        private readonly IActorRef _self;
+        private readonly MetricsRegistry _registry;
+        private readonly Dictionary<string, Subscriber> _byName = new Dictionary<string, Subscriber>();
+        private readonly Dictionary<IActorRef, Subscriber> _byRef = new Dictionary<IActorRef, Subscriber>();
+        private readonly List<Subscriber> _subscribers = new List<Subscriber>();
+
+        /// <param name="name">Prefix of the published metric names</param>
+        /// <param name="self">Sender of the elements, to which subscribers reply</param>
+        /// <param name="registry">Registry to publish to. Defaults to <see cref="MetricsRegistry.Default"/>.</param>
+        public SubscriberHub(string name, IActorRef self, MetricsRegistry registry = null)
+        {
+            _name = name;
+            _self = self;
+            _registry = registry ?? MetricsRegistry.Default;
+        }
+
+        public int Count => _subscribers.Count;
+
+        /// <summary>
+        /// Raised for each subscriber removed under <see cref="OverflowPolicy.Disconnect"/>
+        /// </summary>
+        public event Action<string, IActorRef> Disconnected;
+
+        /// <summary>
+        /// True while a subscriber under <see cref="OverflowPolicy.Backpressure"/> has a full buffer
+        /// </summary>
+        public bool IsBackpressured { get; private set; }
+
+        public bool Contains(string name) => _byName.ContainsKey(name);
+
+        public bool Add(string name, IActorRef subscriber, int bufferSize, OverflowPolicy policy)
+        {
+            if(bufferSize < 1)
+            {
+                throw new ArgumentException("A subscriber must buffer at least one element.", nameof(bufferSize));
+            }
+            if(_byName.ContainsKey(name) || _byRef.ContainsKey(subscriber))
+            {
+                return false;
+            }
+
+            var entry = new Subscriber(name, subscriber, bufferSize, policy, _registry, $"{_name}.{name}");
+            _byName.Add(name, entry);
+            _byRef.Add(subscriber, entry);
+            _subscribers.Add(entry);
+            return true;
+        }
+
+        public bool Remove(string name)
+            => _byName.TryGetValue(name, out var entry) && Remove(entry);
+
+        public bool Remove(IActorRef subscriber)
+            => _byRef.TryGetValue(subscriber, out var entry) && Remove(entry);
+
+        /// <summary>
+        /// Sends <paramref name="element"/> to every subscriber or buffers it
+        /// </summary>
+        public void Publish(T element)
+        {
+            List<Subscriber> disconnected = null;
+
+            foreach (var subscriber in _subscribers)
+            {
+                if(!subscriber.AwaitingAck)
+                {
+                    Send(subscriber, element);
+                }
+                else if(subscriber.Buffer.Count < subscriber.Capacity || subscriber.Policy == OverflowPolicy.Backpressure)
+                {
+                    subscriber.Buffer.Enqueue(element);
+                }
+                else
+                {
+                    switch (subscriber.Policy)
+                    {
+                        case OverflowPolicy.DropOldest:
+                            subscriber.Buffer.Dequeue();
+                            subscriber.Buffer.Enqueue(element);
+                            subscriber.Dropped.Increment();
+                            break;
+                        case OverflowPolicy.DropNewest:
+                            subscriber.Dropped.Increment();
+                            break;
+                        default:
+                            (disconnected = disconnected ?? new List<Subscriber>()).Add(subscriber);
+                            break;
+                    }
+                }
+                subscriber.Lag.Set(subscriber.Buffer.Count);
+            }
+
+            if(disconnected != null)
+            {
+                foreach (var subscriber in disconnected)
+                {
+                    Remove(subscriber);
+                    Disconnected?.Invoke(subscriber.Name, subscriber.Ref);
+                }
+            }
+
+            UpdateBackpressure();
+        }
+
+        /// <summary>
+        /// Sends the next buffered element to a subscriber that has acknowledged the last
+        /// </summary>
+        public void Acknowledge(IActorRef subscriber)
+        {
+            if(!_byRef.TryGetValue(subscriber, out var entry))
+            {
+                return;
+            }
+
+            if(entry.Buffer.Count > 0)
+            {
+                Send(entry, entry.Buffer.Dequeue());
+            }
+            else
+            {
+                entry.AwaitingAck = false;
+            }
+            entry.Lag.Set(entry.Buffer.Count);
+
+            UpdateBackpressure();
+        }
+
+        /// <summary>
+        /// Buffered elements for each subscriber
+        /// </summary>
+        public IReadOnlyDictionary<string, int> Lags()
+        {
+            var lags = new Dictionary<string, int>(_subscribers.Count);
+            foreach (var subscriber in _subscribers)
+            {
+                lags.Add(subscriber.Name, subscriber.Buffer.Count);
+            }
+            return lags;
+        }
+
+        private void Send(Subscriber subscriber, T element)
+        {
+            subscriber.Ref.Tell(element, _self);
+            subscriber.AwaitingAck = true;
+            subscriber.Delivered.Increment();
+        }
+
+        private bool Remove(Subscriber subscriber)
+        {
+            _byName.Remove(subscriber.Name);
+            _byRef.Remove(subscriber.Ref);
+            _subscribers.Remove(subscriber);
+            subscriber.Lag.Set(0);
+
+            UpdateBackpressure();
+            return true;
+        }
+
+        /// <summary>
+        /// Pauses on a full buffer and resumes once every buffer is at most half full
+        /// </summary>
+        private void UpdateBackpressure()
+        {
+            var full = false;
+            var draining = false;
+            foreach (var subscriber in _subscribers)
+            {
+                if(subscriber.Policy != OverflowPolicy.Backpressure)
+                {
+                    continue;
+                }
+                full |= subscriber.Buffer.Count >= subscriber.Capacity;
+                draining |= subscriber.Buffer.Count > subscriber.Capacity / 2;
+            }
+
+            IsBackpressured = full || (IsBackpressured && draining);
+        }
+
+        private sealed class Subscriber
+        {
+            public string Name { get; }
+            public IActorRef Ref { get; }
+            public int Capacity { get; }
+            public OverflowPolicy Policy { get; }
+            public Queue<T> Buffer { get; }
+            public bool AwaitingAck { get; set; }
+
+            public Gauge Lag { get; }
+            public Counter Delivered { get; }
+            public Counter Dropped { get; }
+
+            public Subscriber(string name, IActorRef actor, int capacity, OverflowPolicy policy, MetricsRegistry registry, string prefix)
+            {
+                Name = name;
+                Ref = actor;
+                Capacity = capacity;
+                Policy = policy;
+                Buffer = new Queue<T>(Math.Min(capacity, 64));
+
+                Lag = registry.Gauge($"{prefix}.Lag");
+                Delivered = registry.Counter($"{prefix}.Delivered");
+                Dropped = registry.Counter($"{prefix}.Dropped");
+            }
+        }
+    }
+}
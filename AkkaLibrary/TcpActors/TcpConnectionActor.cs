@@ -6,6 +6,13 @@ using AkkaLibrary.Common.Logging;
 
 namespace AkkaLibrary.TcpActors
 {
+    /// <summary>
+    /// Connects to an endpoint and passes what it reads to the supervisor
+    ///
+    /// <see cref="SuspendReading"/> and <see cref="ResumeReading"/> are
+    /// remembered while the actor is not connected and applied to each new
+    /// connection once it is registered.
+    /// </summary>
     public class TcpConnectionActor : ReceiveActor
     {
         public TcpConnectionActor(string name, DnsEndPoint endpoint, IActorRef supervisor)
@@ -22,6 +29,8 @@ namespace AkkaLibrary.TcpActors
         private readonly DnsEndPoint _endpoint;
         private readonly IActorRef _supervisor;
         private readonly ILoggingAdapter _logger;
+        private IActorRef _connection;
+        private bool _readingSuspended;
 
         private void Ready()
         {
@@ -30,14 +39,24 @@ namespace AkkaLibrary.TcpActors
                 _logger.Info($"Connected to {msg.RemoteAddress}");
                 Become(Connected);
                 var self = Self;
+                _connection = Sender;
 
                 Sender.Tell(new Tcp.Register(self, true));
+                if(_readingSuspended)
+                {
+                    Sender.Tell(Tcp.SuspendReading.Instance);
+                }
             });
 
             Receive<Tcp.CommandFailed>(msg =>
             {
                 _logger.Error($"Connection failed to open on {_endpoint}");
             });
+
+            Receive<SuspendReading>(msg => _readingSuspended = true);
+
+            Receive<ResumeReading>(msg => _readingSuspended = false);
+
             ReceiveAny(msg => _logger.Info(msg.ToString()));
         }
 
@@ -50,6 +69,18 @@ namespace AkkaLibrary.TcpActors
                 _logger.Debug($"Message received:{msg.Data.Count}");
             });
 
+            Receive<SuspendReading>(msg =>
+            {
+                _readingSuspended = true;
+                _connection.Tell(Tcp.SuspendReading.Instance);
+            });
+
+            Receive<ResumeReading>(msg =>
+            {
+                _readingSuspended = false;
+                _connection.Tell(Tcp.ResumeReading.Instance);
+            });
+
             Receive<Tcp.PeerClosed>(msg =>
             {
                 _logger.Info($"Connection closed on {_endpoint} because {msg.Cause}");
@@ -76,6 +107,19 @@ namespace AkkaLibrary.TcpActors
             }
         }
 
+        /// <summary>
+        /// Stops reading from the socket until <see cref="ResumeReading"/>
+        /// </summary>
+        public sealed class SuspendReading
+        {
+            public static SuspendReading Instance { get; } = new SuspendReading();
+        }
+
+        public sealed class ResumeReading
+        {
+            public static ResumeReading Instance { get; } = new ResumeReading();
+        }
+
         #endregion
     }
 }
\ No newline at end of file
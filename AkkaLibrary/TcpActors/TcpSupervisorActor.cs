@@ -1,22 +1,43 @@
-using System.Collections.Generic;
 using System.Net;
 using Akka.Actor;
 using Akka.Event;
+using Akka.IO;
 using AkkaLibrary.Common.Logging;
+using AkkaLibrary.Common.Metrics;
 
 namespace AkkaLibrary.TcpActors
 {
+    /// <summary>
+    /// Owns a TCP connection and broadcasts what it receives to subscribers
+    ///
+    /// Each subscriber is sent the received <see cref="ByteString"/>s one at a
+    /// time and must reply <see cref="Ack"/> to receive the next. Data
+    /// arriving meanwhile is buffered per subscriber as set out in
+    /// <see cref="SubscriberHub{T}"/>, and reading from the socket is
+    /// suspended while a subscriber under <see cref="OverflowPolicy.Backpressure"/>
+    /// is full.
+    /// </summary>
     public class TcpSupervisorActor : ReceiveActor
     {
         private readonly string _name = Context.Self.Path.Name;
 
-        public TcpSupervisorActor(string name)
+        public TcpSupervisorActor(string name, MetricsRegistry registry = null)
         {
             _logger = Context.WithIdentity("TcpSupervisor");
+
+            var self = Self;
+            _subscribers = new SubscriberHub<ByteString>($"TcpSupervisor.{name}", self, registry);
+            _subscribers.Disconnected += (subscriber, actor) =>
+            {
+                _logger.Warning($"Subscriber {subscriber} fell too far behind and was disconnected.");
+                Context.Unwatch(actor);
+                actor.Tell(new Disconnected(subscriber), self);
+            };
+
             Ready();
         }
 
-        public static Props GetProps(string name) => Props.Create(() => new TcpSupervisorActor(name));
+        public static Props GetProps(string name, MetricsRegistry registry = null) => Props.Create(() => new TcpSupervisorActor(name, registry));
 
         private void Ready()
         {
@@ -27,6 +48,8 @@ namespace AkkaLibrary.TcpActors
                 var self = Self;
 
                 _connectionActor = Context.ActorOf(TcpConnectionActor.GetProps(name, _endpoint, self));
+                _readingSuspended = false;
+                UpdateReading();
 
                 Become(Working);
             });
@@ -46,22 +69,23 @@ namespace AkkaLibrary.TcpActors
                 var self = Self;
 
                 _connectionActor = Context.ActorOf(TcpConnectionActor.GetProps(name, _endpoint, self));
-                
+                _readingSuspended = false;
+                UpdateReading();
+
                 Become(Working);
             });
 
             Receive<CloseConnection>(msg =>
             {
                 Context.Stop(_connectionActor);
+                _connectionActor = null;
                 Become(Ready);
             });
 
             Receive<TcpConnectionActor.TcpDataReceived>(msg =>
             {
-                foreach (var sub in _subscribers)
-                {
-                    sub.Value.Tell(msg.Data);
-                }
+                _subscribers.Publish(msg.Data);
+                UpdateReading();
             });
 
             //Add subscription logic receive handlers
@@ -72,28 +96,60 @@ namespace AkkaLibrary.TcpActors
         {
             Receive<Subscribe>(msg =>
             {
-                if(_subscribers.ContainsKey(msg.Name))
+                if(_subscribers.Add(msg.Name, msg.Ref, msg.BufferSize, msg.Policy))
                 {
-                    _logger.Info($"Subscriber {msg.Name} is already subscribed.");
+                    Context.Watch(msg.Ref);
                 }
                 else
                 {
-                    _subscribers[msg.Name] = msg.Ref;
+                    _logger.Info($"Subscriber {msg.Name} is already subscribed.");
                 }
             });
 
             Receive<Unsubscribe>(msg =>
             {
-                if(_subscribers.ContainsKey(msg.Name))
-                {
-                    _subscribers.Remove(msg.Name);
-                }
+                _subscribers.Remove(msg.Name);
+                UpdateReading();
+            });
+
+            Receive<Ack>(msg =>
+            {
+                _subscribers.Acknowledge(Sender);
+                UpdateReading();
+            });
+
+            Receive<Terminated>(msg =>
+            {
+                _subscribers.Remove(msg.ActorRef);
+                UpdateReading();
             });
         }
 
+        /// <summary>
+        /// Suspends or resumes reading from the socket to match the subscribers
+        /// </summary>
+        private void UpdateReading()
+        {
+            if(_connectionActor == null || _readingSuspended == _subscribers.IsBackpressured)
+            {
+                return;
+            }
+
+            _readingSuspended = _subscribers.IsBackpressured;
+            if(_readingSuspended)
+            {
+                _connectionActor.Tell(TcpConnectionActor.SuspendReading.Instance);
+            }
+            else
+            {
+                _connectionActor.Tell(TcpConnectionActor.ResumeReading.Instance);
+            }
+        }
+
         private DnsEndPoint _endpoint;
         private IActorRef _connectionActor;
-        private Dictionary<string, IActorRef> _subscribers = new Dictionary<string, IActorRef>();
+        private bool _readingSuspended;
+        private readonly SubscriberHub<ByteString> _subscribers;
         private readonly ILoggingAdapter _logger;
 
 
@@ -116,10 +172,43 @@ namespace AkkaLibrary.TcpActors
             public string Name { get; }
             public IActorRef Ref { get; }
 
-            public Subscribe(string name, IActorRef actor)
+            /// <summary>
+            /// Received data held for the subscriber while it is busy
+            /// </summary>
+            public int BufferSize { get; }
+
+            /// <summary>
+            /// What to do when the buffer is full
+            /// </summary>
+            public OverflowPolicy Policy { get; }
+
+            public Subscribe(string name, IActorRef actor, int bufferSize = 64, OverflowPolicy policy = OverflowPolicy.DropOldest)
             {
                 Name = name;
                 Ref = actor;
+                BufferSize = bufferSize;
+                Policy = policy;
+            }
+        }
+
+        /// <summary>
+        /// Sent by a subscriber once it has handled received data
+        /// </summary>
+        public sealed class Ack
+        {
+            public static Ack Instance { get; } = new Ack();
+        }
+
+        /// <summary>
+        /// Sent to a subscriber removed under <see cref="OverflowPolicy.Disconnect"/>
+        /// </summary>
+        public sealed class Disconnected
+        {
+            public string Name { get; }
+
+            public Disconnected(string name)
+            {
+                Name = name;
             }
         }
 
@@ -1,15 +1,17 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.IO;
 using System.Linq;
 using System.Threading;
+using System.Threading.Tasks;
 using Akka.Actor;
-using Akka.Cluster.Tools.Singleton;
+using Akka.Cluster;
 using Akka.Configuration;
-using AkkaLibrary.Actors;
 using AkkaLibrary.Cluster.Actors;
 using AkkaLibrary.Common.Configuration;
 using AkkaLibrary.Common.Logging;
+using AkkaLibrary.Common.Metrics;
 using Serilog;
 using Serilog.Core;
 using Serilog.Events;
@@ -17,11 +19,21 @@ using Serilog.Sinks.Elasticsearch;
 
 namespace ClusterTestHarness
 {
+    /// <summary>
+    /// Starts clusters of growing size in this process and measures how long
+    /// the gossip actors take to converge on state written on every node, and
+    /// how many bytes each gossip round costs. Node counts may be given as
+    /// arguments.
+    /// </summary>
     class Program
     {
+        private const int KeysPerNode = 10;
+        private static readonly TimeSpan GossipInterval = TimeSpan.FromMilliseconds(250);
+        private static readonly TimeSpan Timeout = TimeSpan.FromSeconds(60);
+
         static void Main(string[] args)
         {
-            var loggingSwitch = new LoggingLevelSwitch(LogEventLevel.Debug);
+            var loggingSwitch = new LoggingLevelSwitch(LogEventLevel.Information);
                         
             var elasticSearchOptions = new ElasticsearchSinkOptions(new Uri("http://localhost:9200"))
             {
@@ -44,104 +56,114 @@ namespace ClusterTestHarness
             var configText = File.ReadAllText("hub.hocon");
             var clusterConfig = ConfigurationFactory.ParseString(configText);
 
-            var sysCount = 3;
-
-            var clusterConfigs = Enumerable.Range(4053, sysCount).Select(port =>
-                clusterConfig.WithFallback(ConfigurationFactory.ParseString($"akka.remote.dot-netty.tcp.port = {port}, akka.cluster.roles = [hub]")));
-
-            var systems = clusterConfigs.Select((cfg, i) => (name: $"System{i}", system: ActorSystem.Create("system", cfg)));
-
-            //Setup
-            var proxies = new List<IActorRef>();
-            var gossipNodes = new List<IActorRef>();
-
-            var count = 0;
+            var nodeCounts = args.Length > 0 ? args.Select(int.Parse).ToArray() : new[] { 3, 6, 12 };
+            var port = 4053;
 
-            foreach (var sys in systems)
+            foreach (var nodeCount in nodeCounts)
             {
-                sys.system.ActorOf(
-                    ClusterSingletonManager.Props(
-                    Props.Create(() => new EchoActor()),
-                    PoisonPill.Instance,
-                    ClusterSingletonManagerSettings.Create(sys.system)
-                ), "cluster-command");
-
-                proxies.Add(sys.system.ActorOf(
-                    ClusterSingletonProxy.Props(
-                        "/user/cluster-command",
-                        ClusterSingletonProxySettings.Create(sys.system).WithBufferSize(100)
-                        ),
-                    "cluster-command-proxy"
-                ));
-
-                var stateUpdater = new Func<HashSet<int>, HashSet<int>, HashSet<int>>((x, y) =>
-                {
-                    if (x == null)
-                    {
-                        return y;
-                    }
-                    if (y == null)
-                    {
-                        return x;
-                    }
-                    return x.Union(y).ToHashSet();
-                });
-
-                gossipNodes.Add(
-                    sys.system.ActorOf(
-                        Props.Create(() => new GossipActor<HashSet<int>>(
-                            (count + 1).ToString(),
-                            ActorRefs.Nobody,
-                            stateUpdater
-                            )), "gossip-node"));
-                count++;
+                Measure(clusterConfig, nodeCount, port, defaultLogger.ForContext(LoggingExtensions.Identity, "Output"));
+                port += nodeCount;
             }
 
-            // Wait
-            Thread.Sleep(1000);
-
-            gossipNodes[0].Tell(new GossipActor<HashSet<int>>.NewState(new[] {1,2,3,4,5}.ToHashSet()));
-
-            Thread.Sleep(5000);
-            
-            gossipNodes[2].Tell(new GossipActor<HashSet<int>>.NewState(new[] {10,20,30,40,50}.ToHashSet()));
+            Log.CloseAndFlush();
+        }
 
-            // Run
-            foreach (var gossiper in gossipNodes)
-            {
-                gossiper.Tell(true);
-            }
+        private static void Measure(Config clusterConfig, int nodeCount, int firstPort, ILogger output)
+        {
+            var systems = Enumerable.Range(firstPort, nodeCount)
+                                    .Select(port => ActorSystem.Create("system", ConfigurationFactory.ParseString(
+                                        $"akka.remote.dot-netty.tcp.port = {port}, akka.cluster.roles = [hub], akka.cluster.seed-nodes = [\"akka.tcp://system@127.0.0.1:{firstPort}\"]")
+                                        .WithFallback(clusterConfig)))
+                                    .ToList();
 
-            Console.CancelKeyPress += async (s, a) =>
+            try
             {
-                Console.WriteLine("Stopping Cluster...");
-
-                foreach (var ga in gossipNodes)
+                if (!WaitFor(() => systems.All(x => Akka.Cluster.Cluster.Get(x).State.Members.Count(m => m.Status == MemberStatus.Up) == nodeCount)))
                 {
-                    var response = ga.Ask<GossipActor<HashSet<int>>.StateRequestResponse>(new GossipActor<HashSet<int>>.StateRequest());
-                    response.Wait();
-                    defaultLogger
-                        .ForContext(LoggingExtensions.Identity, "Output")
-                        .Information("Final Data for actor:{Name} is {Items}", response.Result.Name, response.Result.State);
+                    output.Warning("{NodeCount} nodes did not form a cluster.", nodeCount);
+                    return;
                 }
 
-                foreach (var sys in systems)
+                var registry = new MetricsRegistry();
+                var gossipNodes = systems.Select((sys, i) => sys.ActorOf(
+                        Props.Create(() => new GossipActor<int, HashSet<int>>(
+                            $"Node{i}",
+                            ActorRefs.Nobody,
+                            (x, y) => x.Union(y).ToHashSet(),
+                            3,
+                            GossipInterval,
+                            registry,
+                            true
+                            )), "gossip-node"))
+                    .ToList();
+
+                // Each node writes keys of its own and its own value of a shared key
+                var stopwatch = Stopwatch.StartNew();
+                for (int i = 0; i < nodeCount; i++)
                 {
-                    await CoordinatedShutdown.Get(sys.system).Run();
+                    for (int k = 0; k < KeysPerNode; k++)
+                    {
+                        gossipNodes[i].Tell(new GossipActor<int, HashSet<int>>.Update(i * KeysPerNode + k, new HashSet<int> { i }));
+                    }
+                    gossipNodes[i].Tell(new GossipActor<int, HashSet<int>>.Update(-1, new HashSet<int> { i }));
                 }
-            };
 
-            foreach (var sys in systems)
+                var converged = WaitFor(() =>
+                {
+                    var states = gossipNodes.Select(x => x.Ask<GossipActor<int, HashSet<int>>.StateRequestResponse>(new GossipActor<int, HashSet<int>>.StateRequest()))
+                                            .Select(x => x.Result)
+                                            .ToList();
+                    return states.Select(x => x.Summary).Distinct().Count() == 1
+                        && states[0].State.Count == nodeCount * KeysPerNode + 1
+                        && states[0].State[-1].Count == nodeCount;
+                });
+                var elapsed = stopwatch.Elapsed;
+
+                long Total(string metric) => Enumerable.Range(0, nodeCount).Sum(i => registry.Counter($"Gossip.Node{i}.{metric}").Value);
+                var rounds = Math.Max(1, Total("Rounds"));
+
+                output.Information(
+                    "{NodeCount} nodes {Result} in {Elapsed} ms. {Rounds} rounds, {Messages} messages, {Entries} entries, {Bytes} bytes, {BytesPerRound} bytes per round.",
+                    nodeCount,
+                    converged ? "converged" : "did not converge",
+                    (long)elapsed.TotalMilliseconds,
+                    Total("Rounds"),
+                    Total("MessagesSent"),
+                    Total("EntriesSent"),
+                    Total("BytesSent"),
+                    Total("BytesSent") / rounds);
+
+                // Rounds after convergence only exchange summaries
+                var bytesBefore = Total("BytesSent");
+                var roundsBefore = Total("Rounds");
+                Thread.Sleep(GossipInterval + GossipInterval);
+                output.Information(
+                    "{NodeCount} nodes at rest: {BytesPerRound} bytes per round.",
+                    nodeCount,
+                    (Total("BytesSent") - bytesBefore) / Math.Max(1, Total("Rounds") - roundsBefore));
+            }
+            finally
             {
-                sys.system.WhenTerminated.Wait();
+                Task.WhenAll(systems.Select(x => x.Terminate())).Wait();
+                foreach (var sys in systems)
+                {
+                    sys.Dispose();
+                }
             }
+        }
 
-            foreach (var sys in systems)
+        private static bool WaitFor(Func<bool> condition)
+        {
+            var stopwatch = Stopwatch.StartNew();
+            while (stopwatch.Elapsed < Timeout)
             {
-                sys.system.Dispose();
+                if (condition())
+                {
+                    return true;
+                }
+                Thread.Sleep(50);
             }
-
-            Log.CloseAndFlush();
+            return false;
         }
     }
-}
\ No newline at end of file
+}
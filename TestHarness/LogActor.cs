@@ -22,19 +22,14 @@ namespace TestHarness
                 Log.Information(string.Join(",",stringBuilder.ToString()));
             });
 
-            Receive<ChannelData<float>>(msg =>
+            Receive<ChannelData<float>>(msg => LogSample(msg));
+
+            Receive<SampleBlock<float>>(msg =>
             {
-                var stringBuilder = new StringBuilder();
-                foreach (var item in msg.Analogs)
-                {
-                    stringBuilder.Append($"[{item.Name},{item.Value}],");
-                }
-                foreach (var item in msg.Digitals)
+                foreach (var sample in msg.ToChannelData())
                 {
-                    stringBuilder.Append($"[{item.Name},{item.Value}],");
+                    LogSample(sample);
                 }
-
-                Log.Information(string.Join(",",stringBuilder.ToString()));
             });
 
             ReceiveAny(msg =>
@@ -42,5 +37,20 @@ namespace TestHarness
                 Log.Information(msg.ToString());
             });
         }
+
+        private static void LogSample(ChannelData<float> msg)
+        {
+            var stringBuilder = new StringBuilder();
+            foreach (var item in msg.Analogs)
+            {
+                stringBuilder.Append($"[{item.Name},{item.Value}],");
+            }
+            foreach (var item in msg.Digitals)
+            {
+                stringBuilder.Append($"[{item.Name},{item.Value}],");
+            }
+
+            Log.Information(string.Join(",",stringBuilder.ToString()));
+        }
     }
 }
\ No newline at end of file